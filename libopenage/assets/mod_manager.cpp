@@ -1,11 +1,43 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2024 the openage authors. See copying.md for legal info.
 
 #include "mod_manager.h"
 
+#include <algorithm>
+#include <exception>
+#include <optional>
+#include <thread>
 #include <unordered_set>
 
+#include "assets/modpack_index.h"
+#include "job/job_manager.h"
+
+
 namespace openage::assets {
 
+namespace {
+
+/**
+ * Name of the modpack index file in a modpack directory.
+ */
+constexpr const char *index_filename = ".modpack_index";
+
+/**
+ * Modpack subdirectory found during enumeration.
+ */
+struct ModpackCandidate {
+	util::Path path;
+	ModpackIndex::Stamp dir_stamp;
+	ModpackIndex::Stamp def_stamp;
+
+	/// native path of the definition file, so that workers don't access the fslike
+	std::string def_native_path;
+
+	std::optional<ModpackInfo> info;
+};
+
+} // namespace
+
+
 ModManager::ModManager(const util::Path &asset_base_dir) :
 	asset_base_dir{asset_base_dir} {
 }
@@ -27,6 +59,16 @@ void ModManager::activate_modpacks(const std::vector<std::string> &load_order) {
 
 	for (const auto &modpack_id : load_order) {
 		auto &modpack = this->available.at(modpack_id);
+		if (modpack.header_only) {
+			// enumeration only parsed the header, validate the full definition now
+			auto info = parse_modepack_def(modpack.path / "modpack.toml");
+			if (info.id != modpack_id) {
+				throw Error{MSG(err) << "Modpack '" << modpack_id << "' at " << modpack.path
+				                     << " changed its ID to '" << info.id << "'"};
+			}
+			modpack = std::move(info);
+		}
+
 		this->active.emplace(modpack_id, std::make_shared<Modpack>(modpack));
 		log::log(MSG(info) << "Activated modpack: " << modpack_id);
 	}
@@ -72,4 +114,105 @@ const std::vector<std::string> &ModManager::get_load_order() const {
 	return this->load_order;
 }
 
+std::vector<ModpackInfo> ModManager::enumerate_modpacks(const util::Path &directory,
+                                                        const std::shared_ptr<job::JobManager> &job_mgr) {
+	if (not(directory.exists() and directory.is_dir())) {
+		throw Error{MSG(err) << "Modpack directory '" << directory << "' does not exist."};
+	}
+
+	auto index_file = directory / index_filename;
+	ModpackIndex index;
+	index.load(index_file);
+
+	// filesystem queries go through the fslike, so they stay in this thread
+	std::vector<ModpackCandidate> candidates;
+	std::vector<size_t> pending;
+	auto dir = const_cast<util::Path &>(directory);
+	for (auto entry : dir.iterdir()) {
+		if (not entry.is_dir()) {
+			continue;
+		}
+
+		auto info_file = entry / "modpack.toml";
+		if (not info_file.exists()) {
+			continue;
+		}
+
+		ModpackCandidate candidate{entry, ModpackIndex::stamp(entry), ModpackIndex::stamp(info_file), {}, {}};
+		candidate.info = index.lookup(entry.get_name(), candidate.dir_stamp, candidate.def_stamp);
+		if (not candidate.info) {
+			candidate.def_native_path = info_file.resolve_native_path();
+			pending.push_back(candidates.size());
+		}
+		candidates.push_back(std::move(candidate));
+	}
+
+	// parse the definition headers that are not cached
+	if (not pending.empty()) {
+		std::shared_ptr<job::JobManager> workers = job_mgr;
+		if (workers == nullptr) {
+			int worker_count = std::clamp<int>(std::thread::hardware_concurrency(),
+			                                   1,
+			                                   static_cast<int>(pending.size()));
+			workers = std::make_shared<job::JobManager>(worker_count);
+			workers->start();
+		}
+
+		std::vector<job::Job<ModpackInfo>> jobs;
+		jobs.reserve(pending.size());
+		for (size_t idx : pending) {
+			jobs.push_back(workers->enqueue<ModpackInfo>([native_path = candidates[idx].def_native_path]() {
+				return parse_modpack_header(native_path);
+			}));
+		}
+
+		for (size_t i = 0; i < jobs.size(); ++i) {
+			while (not jobs[i].is_finished()) {
+				std::this_thread::yield();
+			}
+
+			auto &candidate = candidates[pending[i]];
+			try {
+				candidate.info = jobs[i].get_result();
+			}
+			catch (const std::exception &err) {
+				log::log(WARN << "Skipping modpack at " << candidate.path << ": " << err.what());
+			}
+		}
+
+		if (workers != job_mgr) {
+			workers->stop();
+		}
+	}
+
+	std::vector<ModpackInfo> result;
+	ModpackIndex new_index;
+	for (auto &candidate : candidates) {
+		if (not candidate.info) {
+			continue;
+		}
+
+		new_index.update(candidate.path.get_name(),
+		                 candidate.dir_stamp,
+		                 candidate.def_stamp,
+		                 *candidate.info);
+
+		candidate.info->path = candidate.path;
+		result.push_back(std::move(*candidate.info));
+		log::log(INFO << "Found modpack: " << result.back().id);
+	}
+
+	if (not(new_index == index)) {
+		// the index is only a cache, e.g. read-only directories just don't get one
+		try {
+			new_index.save(index_file);
+		}
+		catch (const std::exception &err) {
+			log::log(DBG << "Could not save modpack index " << index_file << ": " << err.what());
+		}
+	}
+
+	return result;
+}
+
 } // namespace openage::assets
@@ -14,7 +14,12 @@
 #include "assets/modpack.h"
 #include "util/path.h"
 
-namespace openage::assets {
+namespace openage {
+namespace job {
+class JobManager;
+} // namespace job
+
+namespace assets {
 
 class ModManager {
 public:
@@ -77,32 +82,22 @@ public:
 	/**
 	 * Enumerates all modpack ids in a given directory.
 	 *
-	 * This also loads available modpack definition files.
+	 * This also loads the headers of available modpack definition files,
+	 * i.e. everything that is required to resolve a load order. The full
+	 * definition is parsed when the modpack is activated.
+	 *
+	 * Parsed headers are cached in an index file inside the directory and
+	 * reused as long as the modpack's modification times are unchanged.
+	 * Definition files that are not cached are parsed in parallel.
 	 *
 	 * @param directory Path to the directory to enumerate.
+	 * @param job_mgr Job manager used for parsing. If none is given, a temporary
+	 *                one is created when definition files have to be parsed.
 	 *
 	 * @return Infos of the identified modpacks.
 	 */
-	static std::vector<ModpackInfo> enumerate_modpacks(const util::Path &directory) {
-		std::vector<ModpackInfo> result;
-
-		if (not(directory.exists() and directory.is_dir())) {
-			throw Error{MSG(err) << "Modpack directory '" << directory << "' does not exist."};
-		}
-
-		auto dir = const_cast<util::Path &>(directory);
-		for (auto entry : dir.iterdir()) {
-			if (entry.is_dir()) {
-				auto info_file = entry / "modpack.toml";
-				if (info_file.exists()) {
-					result.push_back(parse_modepack_def(info_file));
-					log::log(INFO << "Found modpack: " << result.back().id);
-				}
-			}
-		}
-
-		return result;
-	}
+	static std::vector<ModpackInfo> enumerate_modpacks(const util::Path &directory,
+	                                                   const std::shared_ptr<job::JobManager> &job_mgr = nullptr);
 
 private:
 	/**
@@ -140,4 +135,5 @@ private:
 	std::vector<std::string> load_order;
 };
 
-} // namespace openage::assets
+} // namespace assets
+} // namespace openage
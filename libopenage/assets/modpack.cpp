@@ -1,4 +1,4 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2024 the openage authors. See copying.md for legal info.
 
 #include "modpack.h"
 
@@ -8,19 +8,26 @@
 
 namespace openage::assets {
 
-ModpackInfo parse_modepack_def(const util::Path &info_file) {
-	ModpackInfo def;
-	def.path = info_file.get_parent();
-
-	const auto modpack_def = toml::parse(info_file.resolve_native_path());
-
+namespace {
+
+/**
+ * Parse the parts of a modpack definition that are needed to identify
+ * the modpack and to resolve the load order.
+ *
+ * @param modpack_def Parsed TOML of the definition file.
+ * @param def Modpack info that is filled.
+ * @param filename Name of the definition file for error messages.
+ */
+void parse_header(const toml::value &modpack_def,
+                  ModpackInfo &def,
+                  const std::string &filename) {
 	// info table
 	const toml::table info = toml::find<toml::table>(modpack_def, "info");
 	if (info.contains("name")) {
 		def.id = info.at("name").as_string();
 	}
 	else {
-		throw Error{MSG(err) << "Modpack definition file at " << info_file
+		throw Error{MSG(err) << "Modpack definition file at " << filename
 		                     << " 'info' table misses 'name' parameter."};
 	}
 
@@ -28,7 +35,7 @@ ModpackInfo parse_modepack_def(const util::Path &info_file) {
 		def.version = info.at("version").as_string();
 	}
 	else {
-		throw Error{MSG(err) << "Modpack definition file at " << info_file
+		throw Error{MSG(err) << "Modpack definition file at " << filename
 		                     << " 'info' table misses 'version' parameter."};
 	}
 
@@ -62,30 +69,13 @@ ModpackInfo parse_modepack_def(const util::Path &info_file) {
 		def.licenses = licenses;
 	}
 
-	// assets table
-	const toml::table assets = toml::find<toml::table>(modpack_def, "assets");
-	std::vector<std::string> includes{};
-	for (const auto &include : assets.at("include").as_array()) {
-		includes.push_back(include.as_string());
-	}
-	def.includes = includes;
-
-	// optionals
-	if (assets.contains("exclude")) {
-		std::vector<std::string> excludes{};
-		for (const auto &exclude : assets.at("exclude").as_array()) {
-			excludes.push_back(exclude.as_string());
-		}
-		def.excludes = excludes;
-	}
-
 	// dependency table
 	if (modpack_def.contains("dependency")) {
 		const toml::table dependency = toml::find<toml::table>(modpack_def, "dependency");
 		std::vector<std::string> deps{};
 
 		if (not dependency.contains("modpacks")) {
-			throw Error{MSG(err) << "Modpack definition file at " << info_file
+			throw Error{MSG(err) << "Modpack definition file at " << filename
 			                     << " 'dependency' table misses 'modpacks' parameter."};
 		}
 
@@ -101,7 +91,7 @@ ModpackInfo parse_modepack_def(const util::Path &info_file) {
 		std::vector<std::string> conflicts{};
 
 		if (not conflict.contains("modpacks")) {
-			throw Error{MSG(err) << "Modpack definition file at " << info_file
+			throw Error{MSG(err) << "Modpack definition file at " << filename
 			                     << " 'conflict' table misses 'modpacks' parameter."};
 		}
 
@@ -110,6 +100,46 @@ ModpackInfo parse_modepack_def(const util::Path &info_file) {
 		}
 		def.conflicts = conflicts;
 	}
+}
+
+} // namespace
+
+
+ModpackInfo parse_modpack_header(const std::string &native_path) {
+	ModpackInfo def;
+	def.header_only = true;
+
+	const auto modpack_def = toml::parse(native_path);
+	parse_header(modpack_def, def, native_path);
+
+	return def;
+}
+
+
+ModpackInfo parse_modepack_def(const util::Path &info_file) {
+	ModpackInfo def;
+	def.path = info_file.get_parent();
+
+	const std::string native_path = info_file.resolve_native_path();
+	const auto modpack_def = toml::parse(native_path);
+	parse_header(modpack_def, def, native_path);
+
+	// assets table
+	const toml::table assets = toml::find<toml::table>(modpack_def, "assets");
+	std::vector<std::string> includes{};
+	for (const auto &include : assets.at("include").as_array()) {
+		includes.push_back(include.as_string());
+	}
+	def.includes = includes;
+
+	// optionals
+	if (assets.contains("exclude")) {
+		std::vector<std::string> excludes{};
+		for (const auto &exclude : assets.at("exclude").as_array()) {
+			excludes.push_back(exclude.as_string());
+		}
+		def.excludes = excludes;
+	}
 
 	// authors table
 	if (modpack_def.contains("authors")) {
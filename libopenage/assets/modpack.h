@@ -60,6 +60,9 @@ struct ModpackInfo {
 
 	std::vector<AuthorInfo> authors;
 	std::vector<AuthorGroupInfo> author_groups;
+
+	// only the header (info, dependency and conflict tables) was parsed
+	bool header_only = false;
 };
 
 /**
@@ -70,6 +73,19 @@ struct ModpackInfo {
  */
 ModpackInfo parse_modepack_def(const util::Path &info_file);
 
+/**
+ * Parse only the header of a modpack definition file, i.e. the info,
+ * dependency and conflict tables. This is enough to identify the modpack
+ * and resolve the load order.
+ *
+ * The file is accessed by its native path, so this can be called from
+ * worker threads.
+ *
+ * @param native_path Native filesystem path of the definition file.
+ * @return Modpack metadata information with \p header_only set.
+ */
+ModpackInfo parse_modpack_header(const std::string &native_path);
+
 /**
  * Modpack definition.
  *
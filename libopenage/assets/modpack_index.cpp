@@ -0,0 +1,216 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "modpack_index.h"
+
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+
+#include "error/error.h"
+#include "log/log.h"
+#include "util/file.h"
+#include "util/strings.h"
+
+
+namespace openage::assets {
+
+namespace {
+
+/**
+ * First line of an index file. Bump the version when the format changes.
+ */
+constexpr std::string_view index_header = "openage-modpack-index 2";
+
+/**
+ * Number of tab-separated fields in an index line:
+ * name, dir_mtime, dir_size, def_mtime, def_size, id, version, dependencies, conflicts
+ */
+constexpr size_t index_fields = 9;
+
+/**
+ * Placeholder for empty lists, so that no field is empty.
+ */
+constexpr std::string_view empty_list = "-";
+
+
+std::string join_list(const std::vector<std::string> &list) {
+	if (list.empty()) {
+		return std::string{empty_list};
+	}
+
+	std::string result;
+	for (const auto &item : list) {
+		if (not result.empty()) {
+			result += ',';
+		}
+		result += item;
+	}
+	return result;
+}
+
+
+std::vector<std::string> split_list(std::string_view field) {
+	std::vector<std::string> result;
+	if (field == empty_list) {
+		return result;
+	}
+
+	for (std::string_view item : util::split_view(field, ',')) {
+		result.emplace_back(item);
+	}
+	return result;
+}
+
+} // namespace
+
+
+void ModpackIndex::load(const util::Path &index_file) {
+	this->entries.clear();
+
+	if (not index_file.is_file()) {
+		return;
+	}
+
+	std::unordered_map<std::string, Entry> loaded;
+	try {
+		std::string content = index_file.open_r().read();
+
+		std::vector<std::string_view> fields;
+		bool header = true;
+		for (std::string_view line : util::split_newline_view(content)) {
+			if (header) {
+				if (line != index_header) {
+					log::log(INFO << "Ignoring modpack index with unknown format: " << index_file);
+					return;
+				}
+				header = false;
+				continue;
+			}
+
+			if (line.empty()) {
+				continue;
+			}
+
+			util::split_view(line, '\t', fields);
+			if (fields.size() != index_fields) {
+				throw Error{MSG(err) << "malformed modpack index line: " << line};
+			}
+
+			loaded.emplace(std::string{fields[0]},
+			               Entry{Stamp{util::parse_number<int64_t>(fields[1]),
+			                           util::parse_number<uint64_t>(fields[2])},
+			                     Stamp{util::parse_number<int64_t>(fields[3]),
+			                           util::parse_number<uint64_t>(fields[4])},
+			                     std::string{fields[5]},
+			                     std::string{fields[6]},
+			                     split_list(fields[7]),
+			                     split_list(fields[8])});
+		}
+	}
+	catch (const std::exception &err) {
+		log::log(INFO << "Ignoring malformed modpack index " << index_file << ": " << err.what());
+		return;
+	}
+
+	this->entries = std::move(loaded);
+}
+
+
+void ModpackIndex::save(const util::Path &index_file) const {
+	std::string content{index_header};
+	content += '\n';
+
+	for (const auto &[name, entry] : this->entries) {
+		content += name;
+		content += '\t' + std::to_string(entry.dir_stamp.mtime);
+		content += '\t' + std::to_string(entry.dir_stamp.size);
+		content += '\t' + std::to_string(entry.def_stamp.mtime);
+		content += '\t' + std::to_string(entry.def_stamp.size);
+		content += '\t' + entry.id;
+		content += '\t' + entry.version;
+		content += '\t' + join_list(entry.dependencies);
+		content += '\t' + join_list(entry.conflicts);
+		content += '\n';
+	}
+
+	auto file = index_file.open_w();
+	file.write(content);
+	file.close();
+}
+
+
+ModpackIndex::Stamp ModpackIndex::stamp(const util::Path &path) {
+	std::string native_path;
+	try {
+		native_path = path.resolve_native_path();
+	}
+	catch (const Error &) {
+		// not on the native filesystem
+	}
+
+	if (not native_path.empty()) {
+		std::error_code ec;
+		auto mtime = std::filesystem::last_write_time(native_path, ec);
+		if (not ec) {
+			uint64_t size = 0;
+			if (std::filesystem::is_regular_file(native_path, ec)) {
+				size = std::filesystem::file_size(native_path, ec);
+			}
+			if (not ec) {
+				auto since_epoch = mtime.time_since_epoch();
+				return Stamp{std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch).count(),
+				             size};
+			}
+		}
+	}
+
+	return Stamp{static_cast<int64_t>(path.get_mtime()) * 1'000'000'000,
+	             path.is_file() ? path.get_filesize() : 0};
+}
+
+
+std::optional<ModpackInfo> ModpackIndex::lookup(const std::string &name,
+                                                const Stamp &dir_stamp,
+                                                const Stamp &def_stamp) const {
+	auto it = this->entries.find(name);
+	if (it == std::end(this->entries)) {
+		return std::nullopt;
+	}
+
+	const Entry &entry = it->second;
+	if (entry.dir_stamp != dir_stamp or entry.def_stamp != def_stamp) {
+		return std::nullopt;
+	}
+
+	ModpackInfo info;
+	info.id = entry.id;
+	info.version = entry.version;
+	info.dependencies = entry.dependencies;
+	info.conflicts = entry.conflicts;
+	info.header_only = true;
+
+	return info;
+}
+
+
+void ModpackIndex::update(const std::string &name,
+                          const Stamp &dir_stamp,
+                          const Stamp &def_stamp,
+                          const ModpackInfo &info) {
+	this->entries.insert_or_assign(name,
+	                               Entry{dir_stamp,
+	                                     def_stamp,
+	                                     info.id,
+	                                     info.version,
+	                                     info.dependencies,
+	                                     info.conflicts});
+}
+
+
+size_t ModpackIndex::size() const {
+	return this->entries.size();
+}
+
+} // namespace openage::assets
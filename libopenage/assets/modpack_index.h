@@ -0,0 +1,125 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "assets/modpack.h"
+#include "util/path.h"
+
+
+namespace openage::assets {
+
+/**
+ * Cached modpack definition headers of a modpack directory.
+ *
+ * Entries are keyed by the name of the modpack subdirectory and are only
+ * valid as long as the stamps of the subdirectory and its definition file
+ * are unchanged. This allows skipping the TOML parsing of unchanged
+ * modpacks at startup.
+ */
+class ModpackIndex {
+public:
+	/**
+	 * Modification state of a file or directory.
+	 */
+	struct Stamp {
+		/// modification time in nanoseconds since the epoch of the filesystem clock
+		int64_t mtime;
+		/// size in bytes, 0 for directories
+		uint64_t size;
+
+		bool operator==(const Stamp &other) const = default;
+	};
+
+	/**
+	 * Cached header of one modpack.
+	 */
+	struct Entry {
+		Stamp dir_stamp;
+		Stamp def_stamp;
+
+		std::string id;
+		std::string version;
+		std::vector<std::string> dependencies;
+		std::vector<std::string> conflicts;
+
+		bool operator==(const Entry &other) const = default;
+	};
+
+	ModpackIndex() = default;
+	~ModpackIndex() = default;
+
+	/**
+	 * Load the index from a file.
+	 *
+	 * Missing or malformed files result in an empty index, as the cache
+	 * can always be rebuilt.
+	 *
+	 * @param index_file Path to the index file.
+	 */
+	void load(const util::Path &index_file);
+
+	/**
+	 * Save the index to a file.
+	 *
+	 * @param index_file Path to the index file.
+	 */
+	void save(const util::Path &index_file) const;
+
+	/**
+	 * Get the current stamp of a file or directory.
+	 *
+	 * Paths on the native filesystem get nanosecond modification times.
+	 * Other paths fall back to the whole-second mtime of the fslike.
+	 *
+	 * @param path Path to the file or directory.
+	 */
+	static Stamp stamp(const util::Path &path);
+
+	/**
+	 * Get the cached header of a modpack if it is still up to date.
+	 *
+	 * @param name Name of the modpack subdirectory.
+	 * @param dir_stamp Current stamp of the subdirectory.
+	 * @param def_stamp Current stamp of the definition file.
+	 *
+	 * @return Modpack info with \p header_only set, or nothing if the entry
+	 *         is missing or outdated.
+	 */
+	std::optional<ModpackInfo> lookup(const std::string &name,
+	                                  const Stamp &dir_stamp,
+	                                  const Stamp &def_stamp) const;
+
+	/**
+	 * Add or replace the cached header of a modpack.
+	 *
+	 * @param name Name of the modpack subdirectory.
+	 * @param dir_stamp Stamp of the subdirectory.
+	 * @param def_stamp Stamp of the definition file.
+	 * @param info Parsed modpack info.
+	 */
+	void update(const std::string &name,
+	            const Stamp &dir_stamp,
+	            const Stamp &def_stamp,
+	            const ModpackInfo &info);
+
+	/**
+	 * Get the number of cached modpacks.
+	 */
+	size_t size() const;
+
+	bool operator==(const ModpackIndex &other) const = default;
+
+private:
+	/**
+	 * Cached headers by subdirectory name.
+	 */
+	std::unordered_map<std::string, Entry> entries;
+};
+
+} // namespace openage::assets
@@ -0,0 +1,265 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "nyan_files.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <sstream>
+#include <string_view>
+#include <thread>
+
+#include "error/error.h"
+#include "job/job_manager.h"
+#include "log/log.h"
+#include "util/hash.h"
+#include "util/strings.h"
+
+
+namespace openage::assets {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/**
+ * Name of the cache file in the modpack directory.
+ */
+constexpr const char *cache_filename = ".nyan_files";
+
+/**
+ * Name of the manifest file in the modpack directory.
+ */
+constexpr const char *manifest_filename = "manifest.toml";
+
+/**
+ * First line of a cache file. Bump the version when the format changes.
+ */
+constexpr std::string_view cache_header = "openage-nyan-files 1";
+
+
+std::optional<std::string> read_file(const fs::path &path) {
+	std::ifstream file{path, std::ios::binary};
+	if (not file) {
+		return std::nullopt;
+	}
+
+	std::ostringstream content;
+	content << file.rdbuf();
+	return content.str();
+}
+
+
+/**
+ * Hash the manifest and the include patterns.
+ *
+ * @return Cache key, or nothing if the modpack has no manifest.
+ */
+std::optional<std::string> cache_key(const fs::path &modpack_dir,
+                                     const std::vector<std::string> &includes) {
+	auto manifest = read_file(modpack_dir / manifest_filename);
+	if (not manifest) {
+		return std::nullopt;
+	}
+
+	std::string data = std::move(*manifest);
+	for (const auto &include : includes) {
+		data += '\0';
+		data += include;
+	}
+
+	util::Siphash hasher{std::array<uint8_t, 16>{}};
+	return std::to_string(hasher.digest(reinterpret_cast<const uint8_t *>(data.data()),
+	                                    data.size()));
+}
+
+
+std::optional<std::vector<std::string>> load_cache(const fs::path &cache_file,
+                                                   const std::string &key) {
+	auto content = read_file(cache_file);
+	if (not content) {
+		return std::nullopt;
+	}
+
+	std::vector<std::string> files;
+	size_t line_nr = 0;
+	for (std::string_view line : util::split_newline_view(*content)) {
+		line_nr += 1;
+		if (line_nr == 1) {
+			if (line != cache_header) {
+				return std::nullopt;
+			}
+		}
+		else if (line_nr == 2) {
+			if (line != key) {
+				return std::nullopt;
+			}
+		}
+		else if (not line.empty()) {
+			files.emplace_back(line);
+		}
+	}
+
+	if (line_nr < 2) {
+		return std::nullopt;
+	}
+
+	return files;
+}
+
+
+void save_cache(const fs::path &cache_file,
+                const std::string &key,
+                const std::vector<std::string> &files) {
+	std::ofstream out{cache_file, std::ios::binary | std::ios::trunc};
+	out << cache_header << '\n'
+	    << key << '\n';
+	for (const auto &file : files) {
+		out << file << '\n';
+	}
+
+	if (not out) {
+		// the cache is optional, e.g. read-only modpacks just don't get one
+		log::log(DBG << "Could not save nyan file cache " << cache_file.string());
+	}
+}
+
+
+bool is_nyan_file(const fs::directory_entry &entry) {
+	return entry.is_regular_file() and entry.path().extension() == ".nyan";
+}
+
+
+void collect_files(const fs::path &modpack_dir,
+                   const std::string &include,
+                   std::vector<std::string> &files) {
+	// handle wildcards
+	auto parts = util::split(include, '/');
+	bool recursive = false;
+	std::string search = include;
+	if (not parts.empty() and parts.back() == "**") {
+		recursive = true;
+		if (parts.size() == 1) {
+			// include = "**"
+			// start in root directory
+			search = "";
+		}
+		else {
+			// include = "path/to/somewhere/**"
+			// remove the wildcard '**' and the slash '/'
+			search = include.substr(0, include.size() - 3);
+		}
+	}
+
+	auto search_path = modpack_dir / search;
+	auto add = [&](const fs::path &path) {
+		files.push_back(path.lexically_relative(modpack_dir).generic_string());
+	};
+
+	fs::directory_entry root{search_path};
+	if (is_nyan_file(root)) {
+		add(search_path);
+		return;
+	}
+
+	if (not root.is_directory()) {
+		return;
+	}
+
+	if (recursive) {
+		for (const auto &entry : fs::recursive_directory_iterator{
+				 search_path,
+				 fs::directory_options::follow_directory_symlink}) {
+			if (is_nyan_file(entry)) {
+				add(entry.path());
+			}
+		}
+	}
+	else {
+		// folders are skipped unless we read recursively
+		for (const auto &entry : fs::directory_iterator{search_path}) {
+			if (is_nyan_file(entry)) {
+				add(entry.path());
+			}
+		}
+	}
+}
+
+} // namespace
+
+
+std::vector<std::string> find_nyan_files(const std::string &modpack_dir,
+                                         const std::vector<std::string> &includes) {
+	fs::path dir{modpack_dir};
+	auto cache_file = dir / cache_filename;
+
+	auto key = cache_key(dir, includes);
+	if (key) {
+		auto cached = load_cache(cache_file, *key);
+		if (cached) {
+			return std::move(*cached);
+		}
+	}
+
+	std::vector<std::string> files;
+	for (const auto &include : includes) {
+		collect_files(dir, include, files);
+	}
+
+	// includes may overlap
+	std::sort(std::begin(files), std::end(files));
+	files.erase(std::unique(std::begin(files), std::end(files)), std::end(files));
+
+	if (key) {
+		save_cache(cache_file, *key, files);
+	}
+
+	return files;
+}
+
+
+std::vector<std::string> read_nyan_files(const std::vector<std::string> &native_paths,
+                                         job::JobManager &workers,
+                                         size_t chunk_count) {
+	std::vector<std::string> contents(native_paths.size());
+	if (native_paths.empty()) {
+		return contents;
+	}
+
+	chunk_count = std::max<size_t>(chunk_count, 1);
+	size_t chunk_size = (native_paths.size() + chunk_count - 1) / chunk_count;
+
+	std::vector<job::Job<bool>> jobs;
+	for (size_t begin = 0; begin < native_paths.size(); begin += chunk_size) {
+		size_t end = std::min(begin + chunk_size, native_paths.size());
+		jobs.push_back(workers.enqueue<bool>([&native_paths, &contents, begin, end]() {
+			for (size_t i = begin; i < end; ++i) {
+				auto content = read_file(native_paths[i]);
+				if (not content) {
+					throw Error{MSG(err) << "Could not open .nyan file: " << native_paths[i]};
+				}
+				contents[i] = std::move(*content);
+			}
+			return true;
+		}));
+	}
+
+	// the jobs write into the buffers of this function, so they
+	// must all be done before an error is passed on
+	for (auto &job : jobs) {
+		while (not job.is_finished()) {
+			std::this_thread::yield();
+		}
+	}
+	for (auto &job : jobs) {
+		job.get_result();
+	}
+
+	return contents;
+}
+
+} // namespace openage::assets
@@ -0,0 +1,56 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+namespace openage::job {
+class JobManager;
+} // namespace openage::job
+
+namespace openage::assets {
+
+/**
+ * Find the nyan files of a modpack that match its include patterns.
+ *
+ * Include patterns are paths relative to the modpack directory. A trailing
+ * "**" includes all files below a directory recursively, a directory without
+ * it only includes the files directly inside.
+ *
+ * If the modpack has a manifest, the file list is cached in the modpack
+ * directory and reused as long as the manifest and the include patterns
+ * are unchanged.
+ *
+ * Only the native filesystem is accessed, so this can run on worker threads.
+ *
+ * @param modpack_dir Native path of the modpack directory.
+ * @param includes Include patterns from the modpack definition.
+ *
+ * @return Sorted paths of the nyan files, relative to the modpack directory.
+ */
+std::vector<std::string> find_nyan_files(const std::string &modpack_dir,
+                                         const std::vector<std::string> &includes);
+
+/**
+ * Read the content of nyan files in parallel.
+ *
+ * The files are split into chunks that are read by the workers. All
+ * chunks are finished before this returns or throws, so no worker
+ * writes into the result after an error.
+ *
+ * @param native_paths Native paths of the files.
+ * @param workers Started job manager that reads the files.
+ * @param chunk_count Number of chunks that the files are split into.
+ *
+ * @return Content of the files, in the order of \p native_paths.
+ *
+ * @throws Error if a file could not be read.
+ */
+std::vector<std::string> read_nyan_files(const std::vector<std::string> &native_paths,
+                                         job::JobManager &workers,
+                                         size_t chunk_count);
+
+} // namespace openage::assets
@@ -0,0 +1,233 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "assets/mod_manager.h"
+#include "assets/modpack_index.h"
+#include "assets/nyan_files.h"
+#include "error/error.h"
+#include "job/job_manager.h"
+#include "testing/testing.h"
+#include "util/fslike/directory.h"
+#include "util/path.h"
+
+
+namespace openage::assets::tests {
+
+namespace {
+
+void write_file(const std::filesystem::path &path, const std::string &content) {
+	std::filesystem::create_directories(path.parent_path());
+	std::ofstream out{path, std::ios::binary};
+	out << content;
+}
+
+
+std::string read_file(const std::filesystem::path &path) {
+	std::ifstream in{path, std::ios::binary};
+	return std::string{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+}
+
+
+const ModpackInfo &find_modpack(const std::vector<ModpackInfo> &modpacks, const std::string &id) {
+	for (const auto &info : modpacks) {
+		if (info.id == id) {
+			return info;
+		}
+	}
+	throw Error{MSG(err) << "Modpack " << id << " was not found"};
+}
+
+
+std::string modpack_def(const std::string &name, const std::string &deps) {
+	std::string def;
+	def += "[info]\n";
+	def += "name = \"" + name + "\"\n";
+	def += "version = \"1.0\"\n";
+	def += "[assets]\n";
+	def += "include = [\"data/**\"]\n";
+	def += "[dependency]\n";
+	def += "modpacks = [" + deps + "]\n";
+	return def;
+}
+
+} // namespace
+
+
+void modpack_index() {
+	auto dir = std::filesystem::temp_directory_path() / "openage_modpack_test";
+	std::filesystem::remove_all(dir);
+	std::filesystem::create_directories(dir);
+	util::Path root{std::make_shared<util::fslike::Directory>(dir.string()), {}};
+
+	// index round trip
+	ModpackInfo info;
+	info.id = "base";
+	info.version = "0.1";
+	info.dependencies = {"engine", "extra"};
+
+	ModpackIndex::Stamp dir_stamp{10'000'000'001, 0};
+	ModpackIndex::Stamp def_stamp{20'000'000'002, 300};
+
+	ModpackIndex index;
+	index.update("base_dir", dir_stamp, def_stamp, info);
+	info.id = "engine";
+	info.dependencies = {};
+	info.conflicts = {"base"};
+	index.update("engine_dir", {30, 0}, {40, 50}, info);
+	index.save(root / "index");
+
+	ModpackIndex loaded;
+	loaded.load(root / "index");
+	TESTEQUALS(loaded.size(), 2u);
+	TESTEQUALS(loaded == index, true);
+
+	auto cached = loaded.lookup("base_dir", dir_stamp, def_stamp);
+	TESTEQUALS(cached.has_value(), true);
+	TESTEQUALS(cached->id, "base");
+	TESTEQUALS(cached->dependencies.size(), 2u);
+	TESTEQUALS(cached->dependencies[1], "extra");
+	TESTEQUALS(cached->conflicts.empty(), true);
+	TESTEQUALS(cached->header_only, true);
+	auto engine = loaded.lookup("engine_dir", {30, 0}, {40, 50});
+	TESTEQUALS(engine->conflicts.size(), 1u);
+	TESTEQUALS(engine->conflicts[0], "base");
+
+	// outdated or unknown entries are not used, even within the same second
+	TESTEQUALS(loaded.lookup("base_dir", {10'000'000'002, 0}, def_stamp).has_value(), false);
+	TESTEQUALS(loaded.lookup("base_dir", dir_stamp, {20'000'000'003, 300}).has_value(), false);
+	TESTEQUALS(loaded.lookup("base_dir", dir_stamp, {20'000'000'002, 301}).has_value(), false);
+	TESTEQUALS(loaded.lookup("other_dir", dir_stamp, def_stamp).has_value(), false);
+
+	// broken or outdated index files are ignored
+	write_file(dir / "broken", "openage-modpack-index 2\nbase_dir\tten\t0\t20\t300\tbase\t0.1\t-\t-\n");
+	loaded.load(root / "broken");
+	TESTEQUALS(loaded.size(), 0u);
+	write_file(dir / "old", "openage-modpack-index 1\nbase_dir\t10\t20\tbase\t0.1\t-\t-\n");
+	loaded.load(root / "old");
+	TESTEQUALS(loaded.size(), 0u);
+	loaded.load(root / "nonexistent");
+	TESTEQUALS(loaded.size(), 0u);
+
+	// enumeration parses in parallel and then uses the index
+	write_file(dir / "mods" / "engine" / "modpack.toml", modpack_def("engine", ""));
+	write_file(dir / "mods" / "base" / "modpack.toml", modpack_def("base", "\"engine\""));
+	write_file(dir / "mods" / "broken" / "modpack.toml", "[info]\nversion = \"1.0\"\n");
+	std::filesystem::create_directories(dir / "mods" / "empty");
+
+	auto job_mgr = std::make_shared<job::JobManager>(2);
+	job_mgr->start();
+	auto found = ModManager::enumerate_modpacks(root / "mods", job_mgr);
+	job_mgr->stop();
+	TESTEQUALS(found.size(), 2u);
+	TESTEQUALS(std::filesystem::exists(dir / "mods" / ".modpack_index"), true);
+
+	// a warm run takes the headers from the index instead of parsing the definitions
+	auto index_path = dir / "mods" / ".modpack_index";
+	std::string index_content = read_file(index_path);
+	for (size_t pos = index_content.find("\t1.0\t"); pos != std::string::npos;
+	     pos = index_content.find("\t1.0\t", pos)) {
+		index_content.replace(pos, 5, "\t9.9\t");
+	}
+	write_file(index_path, index_content);
+
+	auto again = ModManager::enumerate_modpacks(root / "mods");
+	TESTEQUALS(again.size(), 2u);
+	TESTEQUALS(find_modpack(again, "engine").version, "9.9");
+	TESTEQUALS(find_modpack(again, "base").version, "9.9");
+
+	// a definition that changed within the same second is parsed again
+	write_file(dir / "mods" / "engine" / "modpack.toml", modpack_def("engine", "") + "\n");
+	again = ModManager::enumerate_modpacks(root / "mods");
+	TESTEQUALS(again.size(), 2u);
+	TESTEQUALS(find_modpack(again, "engine").version, "1.0");
+	TESTEQUALS(find_modpack(again, "base").version, "9.9");
+
+	// activation parses the full definition
+	ModManager manager{root / "mods"};
+	for (const auto &mod : again) {
+		TESTEQUALS(mod.header_only, true);
+		manager.register_modpack(mod);
+	}
+	manager.activate_modpacks({"engine", "base"});
+	TESTEQUALS(manager.get_modpack("base")->get_info().header_only, false);
+	TESTEQUALS(manager.get_modpack("base")->get_info().includes.size(), 1u);
+	TESTTHROWS(manager.activate_modpacks({"base"}));
+
+	std::filesystem::remove_all(dir);
+}
+
+
+void nyan_files() {
+	auto dir = std::filesystem::temp_directory_path() / "openage_nyan_files_test";
+	std::filesystem::remove_all(dir);
+	write_file(dir / "data" / "a.nyan", "");
+	write_file(dir / "data" / "readme.txt", "");
+	write_file(dir / "data" / "sub" / "b.nyan", "");
+	write_file(dir / "other" / "c.nyan", "");
+	write_file(dir / "other" / "deep" / "d.nyan", "");
+
+	std::vector<std::string> expected{
+		"data/a.nyan",
+		"data/sub/b.nyan",
+		"other/c.nyan",
+	};
+	auto files = find_nyan_files(dir.string(), {"data/**", "other", "data/sub/b.nyan"});
+	TESTEQUALS(files == expected, true);
+	TESTEQUALS(find_nyan_files(dir.string(), {"**"}).size(), 4u);
+
+	// without a manifest, nothing is cached
+	TESTEQUALS(std::filesystem::exists(dir / ".nyan_files"), false);
+
+	// the file list is reused while the manifest is unchanged
+	write_file(dir / "manifest.toml", "[file_hashes]\n");
+	files = find_nyan_files(dir.string(), {"data/**"});
+	TESTEQUALS(files.size(), 2u);
+	TESTEQUALS(std::filesystem::exists(dir / ".nyan_files"), true);
+
+	write_file(dir / "data" / "e.nyan", "");
+	TESTEQUALS(find_nyan_files(dir.string(), {"data/**"}).size(), 2u);
+	TESTEQUALS(find_nyan_files(dir.string(), {"data/**", "other"}).size(), 4u);
+
+	write_file(dir / "manifest.toml", "[file_hashes]\n\"data/e.nyan\" = \"\"\n");
+	TESTEQUALS(find_nyan_files(dir.string(), {"data/**"}).size(), 3u);
+
+	// the files are read in parallel, in the order of the paths
+	write_file(dir / "data" / "a.nyan", "a");
+	write_file(dir / "data" / "e.nyan", "e");
+	std::vector<std::string> paths;
+	for (const auto &file : find_nyan_files(dir.string(), {"data/**"})) {
+		paths.push_back((dir / file).string());
+	}
+
+	auto workers = std::make_shared<job::JobManager>(2);
+	workers->start();
+	auto contents = read_nyan_files(paths, *workers, 3);
+	TESTEQUALS(contents.size(), 3u);
+	TESTEQUALS(contents[0], "a");
+	TESTEQUALS(contents[1], "e");
+	TESTEQUALS(contents[2], "");
+
+	// a file that was removed after it was cached is still listed,
+	// reading it fails after all other chunks are done
+	std::filesystem::remove(dir / "data" / "e.nyan");
+	TESTEQUALS(find_nyan_files(dir.string(), {"data/**"}).size(), 3u);
+	for (size_t i = 0; i < 100; ++i) {
+		paths.push_back((dir / "data" / "a.nyan").string());
+	}
+	TESTTHROWS(read_nyan_files(paths, *workers, 8));
+
+	// the workers can still be used afterwards
+	contents = read_nyan_files({paths[0]}, *workers, 2);
+	TESTEQUALS(contents.at(0), "a");
+	workers->stop();
+
+	std::filesystem::remove_all(dir);
+}
+
+} // namespace openage::assets::tests
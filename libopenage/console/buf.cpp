@@ -1,10 +1,12 @@
-// Copyright 2014-2019 the openage authors. See copying.md for legal info.
+// Copyright 2014-2024 the openage authors. See copying.md for legal info.
 
 #include "buf.h"
 
 #include "../util/unicode.h"
 
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
 
 namespace openage {
 namespace console {
@@ -40,6 +42,9 @@ Buf::Buf(term dims, term_t scrollback_lines, term_t min_width, buf_char default_
 	this->screen_chrdata = this->chrdata;
 	this->screen_linedata = this->linedata;
 
+	this->dirty_rows.resize(this->dims.y);
+	this->drawn_cursor_row = -1;
+
 	this->reset();
 }
 
@@ -64,6 +69,7 @@ void Buf::reset() {
 
 	//fully clear data and linedata
 	this->clear({0, (term_t) -this->scrollback_lines}, {0, this->dims.y});
+	this->mark_all_dirty();
 }
 
 /*
@@ -304,22 +310,51 @@ void Buf::resize(term new_dims) {
 	// copy
 
 	this->dims = new_dims;
+	this->dirty_rows.resize(this->dims.y);
+	this->mark_all_dirty();
 }
 
 void Buf::write(const char *c, ssize_t len) {
-	if (len >= 0) {
-		for (; len > 0; len--) {
-			this->write(*c);
-			c++;
-		}
-	} else {
-		for (; *c; c++) {
-			this->write(*c);
+	if (len < 0) {
+		len = strlen(c);
+	}
+	const char *end = c + len;
+
+	while (c < end) {
+		// printable ASCII outside of escape sequences and multi-byte
+		// characters needs no decoding, so whole runs of it are
+		// printed at once.
+		if (not this->escaped and this->streamdecoder.remaining == 0) {
+			const char *run_end = c;
+			while (run_end < end and *run_end >= 0x20 and *run_end < 0x7f) {
+				run_end++;
+			}
+
+			if (run_end > c) {
+				this->print_ascii(c, run_end - c);
+				c = run_end;
+				continue;
+			}
 		}
+
+		this->write(*c);
+		c++;
 	}
 }
 
+term_t Buf::scrollback_lines_for_budget(term dims, size_t byte_budget) {
+	size_t line_bytes = dims.x * sizeof(buf_char) + sizeof(buf_line);
+	size_t lines = byte_budget / line_bytes;
+
+	if (lines <= static_cast<size_t>(dims.y)) {
+		return 1;
+	}
+	return lines - dims.y;
+}
+
 void Buf::scroll(term_t lines) {
+	term_t old_pos = this->scrollback_pos;
+
 	if (lines < 0) {
 		// scroll down
 		lines = -lines;
@@ -336,6 +371,10 @@ void Buf::scroll(term_t lines) {
 			this->scrollback_pos = this->scrollback_possible;
 		}
 	}
+
+	if (this->scrollback_pos != old_pos) {
+		this->mark_all_dirty();
+	}
 }
 
 void Buf::advance(unsigned linecount) {
@@ -377,6 +416,9 @@ void Buf::advance(unsigned linecount) {
 	if (this->screen_linedata >= this->linedata_end) {
 		this->screen_linedata -= this->linedata_size;
 	}
+
+	// the visible lines and the scrollbar have moved
+	this->mark_all_dirty();
 }
 
 void Buf::write(char c) {
@@ -402,6 +444,7 @@ void Buf::pop_last_char() {
 		buf_char *ptr = this->chrdataptr(this->cursorpos);
 		*ptr = this->current_char_fmt;
 		ptr->cp = ' ';
+		this->mark_dirty(this->cursorpos.y);
 
 		if (this->cursorpos.x == 0 && this->linedataptr(this->cursorpos.y - 1)->type == LINE_WRAPPED) {
 			this->linedataptr(this->cursorpos.y)->type = LINE_EMPTY;
@@ -561,18 +604,7 @@ void Buf::print_codepoint(int cp) {
 	case 0x7f: // DEL: ignore
 		break;
 	default:   // regular, printable character
-		if (this->cursor_special_lastcol && (this->cursorpos.x == this->dims.x - 1)) {
-			this->cursor_special_lastcol = false;
-			// store the fact that this line was auto-wrapped
-			// and will continue in the next line
-			this->linedataptr(this->cursorpos.y)->type = LINE_WRAPPED;
-			this->cursorpos.x = 0;
-			if (this->cursorpos.y == this->dims.y - 1) {
-				this->advance(1);
-			} else {
-				this->cursorpos.y += 1;
-			}
-		}
+		this->autowrap();
 
 		// set char at current cursor pos
 		buf_char *ptr = this->chrdataptr(this->cursorpos);
@@ -584,6 +616,7 @@ void Buf::print_codepoint(int cp) {
 		if (lineptr->type == LINE_EMPTY) {
 			lineptr->type = LINE_REGULAR;
 		}
+		this->mark_dirty(this->cursorpos.y);
 
 		// advance cursor to the right
 		this->cursorpos.x++;
@@ -596,6 +629,52 @@ void Buf::print_codepoint(int cp) {
 	}
 }
 
+void Buf::print_ascii(const char *c, size_t len) {
+	while (len > 0) {
+		this->autowrap();
+
+		// all characters of a line are stored contiguously in chrdata,
+		// so the rest of the current line can be filled in one go.
+		size_t count = std::min<size_t>(len, this->dims.x - this->cursorpos.x);
+		buf_char *ptr = this->chrdataptr(this->cursorpos);
+		for (size_t i = 0; i < count; i++) {
+			ptr[i] = this->current_char_fmt;
+			ptr[i].cp = c[i];
+		}
+
+		buf_line *lineptr = this->linedataptr(this->cursorpos.y);
+		if (lineptr->type == LINE_EMPTY) {
+			lineptr->type = LINE_REGULAR;
+		}
+		this->mark_dirty(this->cursorpos.y);
+
+		// advance cursor to the right
+		this->cursorpos.x += count;
+		if (this->cursorpos.x == this->dims.x) {
+			this->cursorpos.x -= 1;
+			this->cursor_special_lastcol = true;
+		}
+
+		c += count;
+		len -= count;
+	}
+}
+
+void Buf::autowrap() {
+	if (this->cursor_special_lastcol && (this->cursorpos.x == this->dims.x - 1)) {
+		this->cursor_special_lastcol = false;
+		// store the fact that this line was auto-wrapped
+		// and will continue in the next line
+		this->linedataptr(this->cursorpos.y)->type = LINE_WRAPPED;
+		this->cursorpos.x = 0;
+		if (this->cursorpos.y == this->dims.y - 1) {
+			this->advance(1);
+		} else {
+			this->cursorpos.y += 1;
+		}
+	}
+}
+
 void print_cps(FILE *f, std::vector<int> *v) {
 	for (int i: *v) {
 		if (i >= 0x20 and i < 0x7f) {
@@ -1089,6 +1168,10 @@ void Buf::clear(term start, term end, bool clear_end) {
 		return;
 	}
 
+	for (term_t y = start.y; y < end.y or (y == end.y and end.x > 0); y++) {
+		this->mark_dirty(y);
+	}
+
 	// clear char info
 	chrdata_clear(chrdataptr(start), chrdataptr(end));
 
@@ -1163,5 +1246,20 @@ const coord::term &Buf::get_dims() const {
 	return this->dims;
 }
 
+void Buf::mark_dirty(term_t lineno) {
+	term_t row = lineno + this->scrollback_pos;
+	if (row >= 0 and row < this->dims.y) {
+		this->dirty_rows[row] = 1;
+	}
+}
+
+void Buf::mark_all_dirty() {
+	std::fill(this->dirty_rows.begin(), this->dirty_rows.end(), 1);
+}
+
+void Buf::clear_dirty() {
+	std::fill(this->dirty_rows.begin(), this->dirty_rows.end(), 0);
+}
+
 
 }} // openage::console
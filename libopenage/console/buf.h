@@ -149,6 +149,15 @@ public:
 	 */
 	void write(char c);
 
+	/**
+	 * returns the number of scrollback lines whose character and line data
+	 * fit into the given number of bytes, for a screen buffer of size dims.
+	 *
+	 * the screen buffer itself is part of the budget; at least one
+	 * scrollback line is returned.
+	 */
+	static coord::term_t scrollback_lines_for_budget(coord::term dims, size_t byte_budget);
+
 	/**
 	 * Pop the last char of the current line
 	 *
@@ -194,6 +203,21 @@ public:
 	 */
 	void print_codepoint(int cp);
 
+	/**
+	 * if the cursor is in the special last-column state, moves it to the
+	 * beginning of the next line and marks the current line as wrapped.
+	 * called before printing a character.
+	 */
+	void autowrap();
+
+	/**
+	 * prints a run of printable ASCII characters (0x20 to 0x7e).
+	 * equivalent to calling print_codepoint for each of them, but
+	 * writes whole line segments at once.
+	 * internally called by write(const char *, ssize_t).
+	 */
+	void print_ascii(const char *c, size_t len);
+
 	/**
 	 * aborts the current escape sequence
 	 * (e.g. because it contained an illegal
@@ -320,6 +344,26 @@ public:
 	 */
 	const coord::term &get_dims() const;
 
+	/**
+	 * marks the given line as changed, so that it is redrawn.
+	 *
+	 * lineno
+	 *   number of line in screen buffer, as in linedataptr().
+	 *   lines that are not visible at the current scroll position are ignored.
+	 */
+	void mark_dirty(coord::term_t lineno);
+
+	/**
+	 * marks all visible lines as changed, e.g. because the buffer advanced
+	 * or was scrolled.
+	 */
+	void mark_all_dirty();
+
+	/**
+	 * resets the changed state of all lines; called after drawing.
+	 */
+	void clear_dirty();
+
 public:
 	// following this line are all terminal buffer related variables
 
@@ -510,6 +554,23 @@ public:
 	 * must be >= 0 and <= scrollback_possible.
 	 */
 	coord::term_t scrollback_pos;
+
+	// following this line are all drawing related variables
+
+	/**
+	 * one entry for each visible row (0 <= row < dims.y), which is != 0 if
+	 * the row has changed since the last call of clear_dirty().
+	 *
+	 * drawing functions use this to redraw only the rows that changed.
+	 */
+	std::vector<uint8_t> dirty_rows;
+
+	/**
+	 * visible row where the cursor was drawn the last time,
+	 * so that it can be removed when the cursor moves.
+	 * -1 if the cursor has not been drawn.
+	 */
+	coord::term_t drawn_cursor_row;
 };
 
 } // namespace console
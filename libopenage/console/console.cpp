@@ -1,9 +1,10 @@
-// Copyright 2013-2023 the openage authors. See copying.md for legal info.
+// Copyright 2013-2024 the openage authors. See copying.md for legal info.
 
 #include "console.h"
 
 #include "../error/error.h"
 #include "../log/log.h"
+#include "../metrics/trace.h"
 #include "../util/strings.h"
 #include "../util/unicode.h"
 
@@ -21,13 +22,18 @@ namespace console {
  * log console, command console
  */
 
+/**
+ * memory budget for the characters of the console scrollback buffer.
+ */
+constexpr size_t scrollback_budget = 1024 * 1024;
+
 Console::Console(/* presenter::LegacyDisplay *display */) :
 	// display{display},
 	bottomleft{0, 0},
 	topright{1, 1},
 	charsize{1, 1},
 	visible(false),
-	buf{{80, 25}, 1337, 80},
+	buf{{80, 25}, Buf::scrollback_lines_for_budget({80, 25}, scrollback_budget), 80},
 	font{{"DejaVu Sans Mono", "Book", 12}} {
 	termcolors.reserve(256);
 
@@ -151,6 +157,25 @@ void Console::interpret(const std::string &command) {
 			                  << " but engine is not implemented yet.");
 		}
 	}
+	else if (command == "trace start") {
+		metrics::clear_trace();
+		metrics::set_tracing(true);
+		this->write("recording trace zones");
+	}
+	else if (command == "trace stop") {
+		metrics::set_tracing(false);
+		this->write("stopped recording trace zones");
+	}
+	else if (command.substr(0, 11) == "trace dump ") {
+		std::string filename = command.substr(11, std::string::npos);
+		try {
+			metrics::dump_trace(filename);
+			this->write(("trace written to " + filename).c_str());
+		}
+		catch (Error &err) {
+			this->write(err.what());
+		}
+	}
 	else if (command.substr(0, 3) == "get") {
 		std::size_t first_space = command.find(" ");
 		if (first_space != std::string::npos) {
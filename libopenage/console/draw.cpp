@@ -1,4 +1,4 @@
-// Copyright 2014-2023 the openage authors. See copying.md for legal info.
+// Copyright 2014-2024 the openage authors. See copying.md for legal info.
 
 #include "draw.h"
 
@@ -6,6 +6,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <string>
+
 #include "../util/fds.h"
 #include "../util/timing.h"
 #include <epoxy/gl.h>
@@ -87,29 +89,51 @@ void to_opengl(presenter::LegacyDisplay *engine, Console *console) {
 }
 */
 
+namespace {
+
+/**
+ * appends the utf-8 encoding of a codepoint to a string.
+ */
+void append_cp(std::string &out, int cp) {
+	char utf8buf[5];
+	if (util::utf8_encode(cp, utf8buf) == 0) {
+		//unrepresentable character (question mark in black rhombus)
+		out += "\uFFFD";
+	}
+	else {
+		out += utf8buf;
+	}
+}
+
+} // anonymous namespace
+
 void to_terminal(Buf *buf, util::FD *fd, bool clear) {
+	// the whole frame is collected in out and written with a single call.
+	std::string out;
+
 	//move cursor, draw top left corner
-	fd->puts("\x1b[H\u250c");
+	out += "\x1b[H\x1b[m\u250c";
 	if (clear) {
-		fd->puts("\x1b[J");
+		out += "\x1b[J";
+		buf->mark_all_dirty();
 	}
 	//draw top line, including title
 	for (coord::term_t x = 0; x < buf->dims.x; x++) {
 		if (x >= 3 && (x - 3) < (int)buf->title.size()) {
-			fd->putcp(buf->title[x - 3]);
+			append_cp(out, buf->title[x - 3]);
 		}
 		else if (x == 2) {
-			fd->putbyte('[');
+			out += '[';
 		}
 		else if (x - 3 == (int)buf->title.size()) {
-			fd->putbyte(']');
+			out += ']';
 		}
 		else {
-			fd->puts("\u2500");
+			out += "\u2500";
 		}
 	}
 	//draw top right corner
-	fd->puts("\u2510\n");
+	out += "\u2510\n";
 	//calculate pos/size of scrollbar
 	//scrollbar_top is the first line that has the scrollbar displayed
 	//scrollbar_bottom is the first line that doesn't have the scrollbar displayed
@@ -126,50 +150,95 @@ void to_terminal(Buf *buf, util::FD *fd, bool clear) {
 		}
 	}
 
-	//print lines -scrollback_pos to dims.y - scrollback_pos - 1
+	// the cursor has to be removed from the row it was drawn in before,
+	// and drawn in its current row.
+	coord::term_t cursor_row = buf->cursorpos.y + buf->scrollback_pos;
+	if (buf->drawn_cursor_row >= 0 and buf->drawn_cursor_row < buf->dims.y) {
+		buf->dirty_rows[buf->drawn_cursor_row] = 1;
+	}
+	if (cursor_row >= 0 and cursor_row < buf->dims.y) {
+		buf->dirty_rows[cursor_row] = 1;
+	}
+
+	//print lines -scrollback_pos to dims.y - scrollback_pos - 1,
+	//but only those which have changed since the last draw.
+	char position[32];
 	for (coord::term_t y = 0; y < buf->dims.y; y++) {
+		if (not buf->dirty_rows[y]) {
+			continue;
+		}
+
+		//move to the row (terminal rows start at 1, row 1 is the top line)
+		snprintf(position, sizeof(position), "\x1b[%d;1H\x1b[m", y + 2);
+		out += position;
+
 		//draw left line
-		fd->puts("\u2502");
-		//draw chars of this line
+		out += "\u2502";
+
+		//draw chars of this line. the graphics rendition is only
+		//changed when the next character needs a different one.
+		bool first = true;
+		buf_char previous;
+		bool previous_negative = false;
 		for (coord::term_t x = 0; x < buf->dims.x; x++) {
 			buf_char p = *(buf->chrdataptr({x, y - buf->scrollback_pos}));
 			if (p.cp < 32) {
 				p.cp = '?';
 			}
-			fd->printf("\x1b[38;5;%dm\x1b[48;5;%dm", p.fgcol, p.bgcol);
-			if (p.flags & CHR_BOLD) {
-				fd->puts("\x1b[1m");
-			}
-			if (p.flags & CHR_BLINKING) {
-				fd->puts("\x1b[5m");
-			}
+
 			bool cursor_visible_at_current_pos = buf->cursorpos == coord::term{x, y - buf->scrollback_pos};
 			cursor_visible_at_current_pos &= buf->cursor_visible;
-			if (((p.flags & CHR_NEGATIVE) != 0) xor cursor_visible_at_current_pos) {
-				//print char negative
-				fd->puts("\x1b[7m");
+			bool negative = ((p.flags & CHR_NEGATIVE) != 0) xor cursor_visible_at_current_pos;
+
+			if (first
+			    or p.fgcol != previous.fgcol
+			    or p.bgcol != previous.bgcol
+			    or (p.flags & (CHR_BOLD | CHR_BLINKING)) != (previous.flags & (CHR_BOLD | CHR_BLINKING))
+			    or negative != previous_negative) {
+				char sgr[48];
+				snprintf(sgr, sizeof(sgr), "\x1b[0;38;5;%d;48;5;%d%s%s%sm",
+				         p.fgcol,
+				         p.bgcol,
+				         (p.flags & CHR_BOLD) ? ";1" : "",
+				         (p.flags & CHR_BLINKING) ? ";5" : "",
+				         negative ? ";7" : "");
+				out += sgr;
+
+				first = false;
+				previous = p;
+				previous_negative = negative;
 			}
-			fd->putcp(p.cp);
-			fd->puts("\x1b[m");
+
+			append_cp(out, p.cp);
 		}
+		out += "\x1b[m";
+
 		//draw right line
 		if (y >= scrollbar_top and y < scrollbar_bottom) {
 			//draw scrollbar on this part of right line
-			fd->puts("\u2503");
+			out += "\u2503";
 		}
 		else {
-			fd->puts("\u2502");
+			out += "\u2502";
 		}
-		fd->putbyte('\n');
 	}
+
+	//move below the last row
+	snprintf(position, sizeof(position), "\x1b[%d;1H", buf->dims.y + 2);
+	out += position;
 	//draw bottom left corner
-	fd->puts("\u2514");
+	out += "\u2514";
 	//draw bottom line
 	for (coord::term_t x = 0; x < buf->dims.x; x++) {
-		fd->puts("\u2500");
+		out += "\u2500";
 	}
 	//draw bottom right corner
-	fd->puts("\u2518\n");
+	out += "\u2518\n";
+
+	fd->write(out.data(), out.size());
+
+	buf->clear_dirty();
+	buf->drawn_cursor_row = cursor_row;
 }
 
 } // namespace draw
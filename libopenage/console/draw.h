@@ -1,4 +1,4 @@
-// Copyright 2014-2023 the openage authors. See copying.md for legal info.
+// Copyright 2014-2024 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -22,7 +22,12 @@ namespace draw {
 // void to_opengl(presenter::LegacyDisplay *engine, Console *console);
 
 /**
- * very early and inefficient printing of the console to a pty.
+ * prints the console to a pty.
+ *
+ * only the rows that changed since the last call are redrawn,
+ * and the output is written with a single write call.
+ *
+ * clear: clear the terminal first, and redraw all rows.
  */
 void to_terminal(Buf *buf, util::FD *fd, bool clear = false);
 
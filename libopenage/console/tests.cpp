@@ -1,7 +1,10 @@
-// Copyright 2014-2019 the openage authors. See copying.md for legal info.
+// Copyright 2014-2024 the openage authors. See copying.md for legal info.
 
-#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <string>
+#include <vector>
 
 #ifdef _MSC_VER
 #define STDOUT_FILENO 1
@@ -17,6 +20,7 @@
 
 #include "../log/log.h"
 #include "../error/error.h"
+#include "../testing/testing.h"
 
 #include "buf.h"
 #include "console.h"
@@ -179,4 +183,100 @@ void interactive() {
 }
 
 
+/**
+ * log-like output with some colors and non-ascii characters.
+ */
+std::string log_chunk() {
+	std::string chunk;
+	for (int i = 0; i < 1000; i++) {
+		chunk += "INFO  [net] connection " + std::to_string(i) + " established, transferring game state to peer\n";
+		if (i % 10 == 0) {
+			chunk += "\x1b[31;1merror\x1b[m: unexpected \xc3\xbcmlaut in packet\n";
+		}
+	}
+	return chunk;
+}
+
+
+/**
+ * Fail if the two buffers don't have the same contents and state.
+ */
+void check_same_buf(const console::Buf &a, const console::Buf &b) {
+	TESTEQUALS(memcmp(a.chrdata, b.chrdata, a.chrdata_size * sizeof(buf_char)), 0);
+	TESTEQUALS(memcmp(a.linedata, b.linedata, a.linedata_size * sizeof(buf_line)), 0);
+	(a.cursorpos == b.cursorpos) or TESTFAIL;
+	TESTEQUALS(a.scrollback_possible, b.scrollback_possible);
+	TESTEQUALS(a.scrollback_pos, b.scrollback_pos);
+	TESTEQUALS(a.escaped, b.escaped);
+	(a.dirty_rows == b.dirty_rows) or TESTFAIL;
+}
+
+
+void buf() {
+	std::string chunk = log_chunk();
+
+	// the bulk write must produce the same buffer contents as
+	// writing each byte separately.
+	console::Buf bulk{{120, 40}, 4000, 80};
+	console::Buf bytewise{{120, 40}, 4000, 80};
+	bulk.write(chunk.c_str(), chunk.size());
+	for (char c : chunk) {
+		bytewise.write(c);
+	}
+	check_same_buf(bulk, bytewise);
+
+	// writes that split escape sequences and utf-8 characters
+	console::Buf split{{120, 40}, 4000, 80};
+	for (size_t pos = 0; pos < chunk.size(); pos += 7) {
+		split.write(chunk.c_str() + pos, std::min<size_t>(7, chunk.size() - pos));
+	}
+	check_same_buf(split, bytewise);
+
+	// lines that wrap around
+	std::string long_line(300, 'x');
+	long_line += "\x1b[1m";
+	long_line += std::string(50, 'y');
+	bulk.write(long_line.c_str(), long_line.size());
+	for (char c : long_line) {
+		bytewise.write(c);
+	}
+	check_same_buf(bulk, bytewise);
+
+	// text without a line break only changes the cursor row
+	bulk.clear_dirty();
+	bytewise.clear_dirty();
+	std::string text = "abc\x1b[32mdef";
+	bulk.write(text.c_str(), text.size());
+	for (char c : text) {
+		bytewise.write(c);
+	}
+	check_same_buf(bulk, bytewise);
+	TESTEQUALS(std::count(bulk.dirty_rows.begin(), bulk.dirty_rows.end(), 1), 1);
+
+	// the buffer advances on a line break in the last row
+	bulk.clear_dirty();
+	bulk.write("\n");
+	TESTEQUALS(std::count(bulk.dirty_rows.begin(), bulk.dirty_rows.end(), 1), 40);
+}
+
+
+void buf_benchmark() {
+	constexpr size_t total_size = 64 * 1024 * 1024;
+
+	std::string chunk = log_chunk();
+
+	console::Buf buf{{120, 40}, 4000, 80};
+	size_t written = 0;
+	auto start = std::chrono::steady_clock::now();
+	while (written < total_size) {
+		buf.write(chunk.c_str(), chunk.size());
+		written += chunk.size();
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	double mbytes = static_cast<double>(written) / (1024 * 1024);
+	log::log(INFO << "console buffer benchmark: " << mbytes / elapsed.count() << " MB/s");
+}
+
+
 } // namespace openage::console::tests
@@ -161,6 +161,23 @@ public:
 	 */
 	std::string str() const;
 
+	/**
+	 * Replace all keyframes of the curve, e.g. when restoring a snapshot.
+	 *
+	 * Dependent events are not notified, so this should only be used
+	 * while the simulation is not running. The parent notifier is called
+	 * with -Inf.
+	 *
+	 * @param keyframes New keyframes, sorted by time. The first keyframe
+	 *                  must be at -Inf.
+	 */
+	void restore(typename KeyframeContainer<T>::container_t &&keyframes) {
+		this->container.replace(std::move(keyframes));
+		this->last_element = this->container.size();
+
+		this->notify_parent(time::TIME_MIN);
+	}
+
 	/**
 	 * Get the container containing all keyframes of this curve.
 	 *
@@ -170,6 +187,17 @@ public:
 		return this->container;
 	}
 
+	/**
+	 * Get a hash of all keyframes of this curve.
+	 *
+	 * The hash is kept up to date on every change, so this is cheap to call.
+	 *
+	 * @return Hash of the keyframes.
+	 */
+	uint64_t get_hash() const {
+		return this->container.get_hash();
+	}
+
 protected:
 	/**
 	 * Stores all the keyframes
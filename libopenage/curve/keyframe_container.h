@@ -3,11 +3,18 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <list>
+#include <utility>
+#include <vector>
+
+#include "error/error.h"
+#include "log/message.h"
 
 #include "curve/keyframe.h"
+#include "curve/value_hash.h"
 #include "time/time.h"
 #include "util/fixed_point.h"
 
@@ -270,9 +277,17 @@ public:
 	 * Essentially, the container is reset to the state immediately after construction.
 	 */
 	void clear() {
-		this->container.erase(++this->begin(), this->end());
+		this->erase_after(0);
 	}
 
+	/**
+	 * Replace all keyframes of the container, e.g. when restoring a snapshot.
+	 *
+	 * @param keyframes New keyframes, sorted by time. The first keyframe
+	 *                  must be at -Inf.
+	 */
+	void replace(container_t &&keyframes);
+
 	/**
 	 * Copy keyframes from another container to this container.
 	 *
@@ -305,6 +320,18 @@ public:
 	              const std::function<T(const O &)> &converter,
 	              const time::time_t &start = time::TIME_MIN);
 
+	/**
+	 * Get a hash of all keyframes in the container.
+	 *
+	 * The hash is updated whenever keyframes are added or removed,
+	 * so this is cheap to call.
+	 *
+	 * @return Sum of the hashes of all keyframes.
+	 */
+	uint64_t get_hash() const {
+		return this->hash;
+	}
+
 	/**
 	 * Debugging method to be used from gdb to understand bugs better.
 	 */
@@ -322,10 +349,29 @@ private:
 	elem_ptr erase_group(const time::time_t &time,
 	                     const elem_ptr &last_elem);
 
+	/**
+	 * Add a keyframe to the hash of the container.
+	 */
+	void add_hash(const keyframe_t &e) {
+		this->hash += keyframe_hash(e.time(), e.val());
+	}
+
+	/**
+	 * Remove a keyframe from the hash of the container.
+	 */
+	void remove_hash(const keyframe_t &e) {
+		this->hash -= keyframe_hash(e.time(), e.val());
+	}
+
 	/**
 	 * The data store.
 	 */
 	container_t container;
+
+	/**
+	 * Sum of the hashes of all keyframes.
+	 */
+	uint64_t hash = 0;
 };
 
 
@@ -334,6 +380,7 @@ KeyframeContainer<T>::KeyframeContainer() {
 	// Create a default element at -Inf, that can always be dereferenced - so
 	// there will by definition never be a element that cannot be dereferenced
 	this->container.push_back(keyframe_t(time::TIME_MIN, T()));
+	this->add_hash(this->container.back());
 }
 
 
@@ -342,6 +389,7 @@ KeyframeContainer<T>::KeyframeContainer(const T &defaultval) {
 	// Create a default element at -Inf, that can always be dereferenced - so
 	// there will by definition never be a element that cannot be dereferenced
 	this->container.push_back(keyframe_t(time::TIME_MIN, defaultval));
+	this->add_hash(this->container.back());
 }
 
 
@@ -428,6 +476,8 @@ KeyframeContainer<T>::insert_before(const KeyframeContainer<T>::keyframe_t &e,
                                     const KeyframeContainer<T>::elem_ptr &hint) {
 	elem_ptr at = this->last(e.time(), hint);
 
+	this->add_hash(e);
+
 	if (at == this->container.size()) {
 		this->container.push_back(e);
 		return at;
@@ -462,6 +512,7 @@ KeyframeContainer<T>::insert_overwrite(const KeyframeContainer<T>::keyframe_t &e
 	else if (at != end) {
 		// overwrite the same-time element
 		if (this->get(at).time() == e.time()) {
+			this->remove_hash(this->get(at));
 			this->container.erase(this->begin() + at);
 		}
 		else {
@@ -469,6 +520,7 @@ KeyframeContainer<T>::insert_overwrite(const KeyframeContainer<T>::keyframe_t &e
 		}
 	}
 
+	this->add_hash(e);
 	this->container.insert(this->begin() + at, e);
 	return at;
 }
@@ -489,6 +541,7 @@ KeyframeContainer<T>::insert_after(const KeyframeContainer<T>::keyframe_t &e,
 		++at;
 	}
 
+	this->add_hash(e);
 	this->container.insert(this->begin() + at, e);
 	return at;
 }
@@ -504,6 +557,9 @@ KeyframeContainer<T>::erase_after(KeyframeContainer<T>::elem_ptr last_valid) {
 	if (last_valid != this->container.size()) {
 		// Delete everything to the end.
 		const elem_ptr delete_start = last_valid + 1;
+		for (elem_ptr i = delete_start; i < this->container.size(); ++i) {
+			this->remove_hash(this->container[i]);
+		}
 		this->container.erase(this->begin() + delete_start, this->end());
 	}
 
@@ -511,12 +567,34 @@ KeyframeContainer<T>::erase_after(KeyframeContainer<T>::elem_ptr last_valid) {
 }
 
 
+template <typename T>
+void KeyframeContainer<T>::replace(container_t &&keyframes) {
+	if (keyframes.empty() or keyframes.front().time() != time::TIME_MIN) {
+		throw Error{MSG(err) << "Keyframe container requires a first keyframe at -Inf"};
+	}
+
+	for (size_t i = 1; i < keyframes.size(); ++i) {
+		if (keyframes[i].time() < keyframes[i - 1].time()) {
+			throw Error{MSG(err) << "Keyframes are not sorted by time at t=" << keyframes[i].time()};
+		}
+	}
+
+	this->container = std::move(keyframes);
+
+	this->hash = 0;
+	for (const auto &e : this->container) {
+		this->add_hash(e);
+	}
+}
+
+
 /*
  * Delete the element from the list and call delete on it.
  */
 template <typename T>
 typename KeyframeContainer<T>::elem_ptr
 KeyframeContainer<T>::erase(KeyframeContainer<T>::elem_ptr e) {
+	this->remove_hash(this->container[e]);
 	this->container.erase(this->begin() + e);
 	return e;
 }
@@ -575,6 +653,7 @@ KeyframeContainer<T>::erase_group(const time::time_t &time,
 	// if the time what we're looking for
 	// erase elements until all element with that time are purged
 	while (at != this->container.size() and this->container.at(at).time() == time) {
+		this->remove_hash(this->container[at]);
 		this->container.erase(this->container.begin() + at);
 		--at;
 	}
@@ -1,11 +1,14 @@
-// Copyright 2017-2023 the openage authors. See copying.md for legal info.
+// Copyright 2017-2024 the openage authors. See copying.md for legal info.
 
 #pragma once
 
 #include <iostream>
+#include <cstddef>
 #include <optional>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "curve/map_filter_iterator.h"
 #include "time/time.h"
@@ -38,6 +41,11 @@ class UnorderedMap {
 	 */
 	std::unordered_map<key_t, map_element> container;
 
+	/**
+	 * Number of modifications of the map.
+	 */
+	size_t change_count = 0;
+
 public:
 	using const_iterator = typename std::unordered_map<key_t, map_element>::const_iterator;
 
@@ -73,6 +81,33 @@ public:
 	// remove all dead elements before that point in time
 	void clean(const time::time_t &);
 
+	/**
+	 * Get all elements of the map, including the ones that are not alive.
+	 *
+	 * @return Elements by their key.
+	 */
+	const std::unordered_map<key_t, map_element> &get_container() const {
+		return this->container;
+	}
+
+	/**
+	 * Get the number of modifications of the map.
+	 *
+	 * Modifications of the values themselves are not counted.
+	 *
+	 * @return Number of inserts, births and kills.
+	 */
+	size_t get_change_count() const {
+		return this->change_count;
+	}
+
+	/**
+	 * Replace all elements of the map, e.g. when restoring a snapshot.
+	 *
+	 * @param elements Key, alive time, dead time and value of each element.
+	 */
+	void restore(const std::vector<std::tuple<key_t, time::time_t, time::time_t, val_t>> &elements);
+
 	/**
 	 * gdb helper method.
 	 */
@@ -162,6 +197,7 @@ UnorderedMap<key_t, val_t>::insert(const time::time_t &alive,
                                    const val_t &value) {
 	map_element e(value, alive, dead);
 	auto it = this->container.insert(std::make_pair(key, e));
+	this->change_count += 1;
 	return MapFilterIterator<key_t, val_t, UnorderedMap<key_t, val_t>>(
 		it.first,
 		this,
@@ -175,6 +211,7 @@ void UnorderedMap<key_t, val_t>::birth(const time::time_t &time,
 	auto it = this->container.find(key);
 	if (it != this->container.end()) {
 		it->second.alive = time;
+		this->change_count += 1;
 	}
 }
 
@@ -182,6 +219,7 @@ template <typename key_t, typename val_t>
 void UnorderedMap<key_t, val_t>::birth(const time::time_t &time,
                                        const MapFilterIterator<val_t, val_t, UnorderedMap> &it) {
 	it->second.alive = time;
+	this->change_count += 1;
 }
 
 template <typename key_t, typename val_t>
@@ -190,6 +228,7 @@ void UnorderedMap<key_t, val_t>::kill(const time::time_t &time,
 	auto it = this->container.find(key);
 	if (it != this->container.end()) {
 		it->second.dead = time;
+		this->change_count += 1;
 	}
 }
 
@@ -197,6 +236,7 @@ template <typename key_t, typename val_t>
 void UnorderedMap<key_t, val_t>::kill(const time::time_t &time,
                                       const MapFilterIterator<val_t, val_t, UnorderedMap> &it) {
 	it->second.dead = time;
+	this->change_count += 1;
 }
 
 template <typename key_t, typename val_t>
@@ -204,4 +244,13 @@ void UnorderedMap<key_t, val_t>::clean(const time::time_t &) {
 	// TODO save everything to a file and be happy.
 }
 
+template <typename key_t, typename val_t>
+void UnorderedMap<key_t, val_t>::restore(const std::vector<std::tuple<key_t, time::time_t, time::time_t, val_t>> &elements) {
+	this->container.clear();
+	for (const auto &[key, alive, dead, value] : elements) {
+		this->container.insert(std::make_pair(key, map_element{value, alive, dead}));
+	}
+	this->change_count += 1;
+}
+
 } // namespace openage::curve
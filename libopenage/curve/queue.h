@@ -8,11 +8,15 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include "error/error.h"
 
 #include "curve/iterator.h"
 #include "curve/queue_filter_iterator.h"
+#include "curve/value_hash.h"
 #include "event/evententity.h"
 #include "time/time.h"
 #include "util/fixed_point.h"
@@ -189,6 +193,38 @@ public:
 	 */
 	void clear(const time::time_t &time);
 
+	/**
+	 * Get all elements of the queue, including dead ones.
+	 *
+	 * @return Elements sorted by insertion time.
+	 */
+	const container_t &get_container() const {
+		return this->container;
+	}
+
+	/**
+	 * Replace all elements of the queue, e.g. when restoring a snapshot.
+	 *
+	 * Dependent events are not notified, so this should only be used
+	 * while the simulation is not running. The parent notifier is called
+	 * with -Inf.
+	 *
+	 * @param elements Insertion time, erase time and value of each element,
+	 *                 sorted by insertion time.
+	 */
+	void restore(const std::vector<std::tuple<time::time_t, time::time_t, T>> &elements);
+
+	/**
+	 * Get a hash of all elements of the queue, including dead ones.
+	 *
+	 * The hash is kept up to date on every change, so this is cheap to call.
+	 *
+	 * @return Hash of the elements.
+	 */
+	uint64_t get_hash() const {
+		return this->hash;
+	}
+
 	/**
 	 * Print the queue to stdout.
 	 */
@@ -240,6 +276,14 @@ private:
 	 */
 	elem_ptr first_alive(const time::time_t &time) const;
 
+	/**
+	 * Hash an element of the queue.
+	 */
+	static uint64_t element_hash(const queue_wrapper &element) {
+		uint64_t hash = util::hash_append(value_hash(element.alive()), value_hash(element.dead()));
+		return util::hash_append(hash, value_hash(element.value));
+	}
+
 	/**
 	 * Identifier for the container
 	 */
@@ -266,6 +310,11 @@ private:
 	 * All positions before the index are guaranteed to be dead at t >= last_change.
 	 */
 	elem_ptr front_start;
+
+	/**
+	 * Sum of the hashes of all elements.
+	 */
+	uint64_t hash = 0;
 };
 
 
@@ -387,6 +436,7 @@ QueueFilterIterator<T, Queue<T>> Queue<T>::between(const time::time_t &begin,
 
 template <typename T>
 void Queue<T>::erase(const CurveIterator<T, Queue<T>> &it) {
+	this->hash -= element_hash(*it.get_base());
 	container.erase(it.get_base());
 }
 
@@ -394,7 +444,9 @@ void Queue<T>::erase(const CurveIterator<T, Queue<T>> &it) {
 template <class T>
 void Queue<T>::kill(const time::time_t &time,
                     elem_ptr at) {
+	this->hash -= element_hash(this->container[at]);
 	this->container[at].set_dead(time);
+	this->hash += element_hash(this->container[at]);
 }
 
 
@@ -413,6 +465,7 @@ QueueFilterIterator<T, Queue<T>> Queue<T>::insert(const time::time_t &time,
 	// Get the iterator to the insertion point
 	iterator insertion_point = std::next(this->container.begin(), at);
 	insertion_point = this->container.insert(insertion_point, queue_wrapper{time, e});
+	this->hash += element_hash(*insertion_point);
 
 	// TODO: Inserting before any dead elements shoud reset their death time
 	//       since by definition, they cannot be popped before the new element
@@ -442,6 +495,34 @@ QueueFilterIterator<T, Queue<T>> Queue<T>::insert(const time::time_t &time,
 }
 
 
+template <typename T>
+void Queue<T>::restore(const std::vector<std::tuple<time::time_t, time::time_t, T>> &elements) {
+	container_t restored;
+	restored.reserve(elements.size());
+	for (const auto &[alive, dead, value] : elements) {
+		if (not restored.empty() and alive < restored.back().alive()) {
+			throw Error{MSG(err) << "Queue elements are not sorted by insertion time at t=" << alive};
+		}
+
+		restored.emplace_back(alive, value);
+		restored.back().set_dead(dead);
+	}
+
+	this->container = std::move(restored);
+
+	this->hash = 0;
+	for (const auto &element : this->container) {
+		this->hash += element_hash(element);
+	}
+
+	// search from the first element on the next access
+	this->last_change = time::TIME_ZERO;
+	this->front_start = 0;
+
+	this->notify_parent(time::TIME_MIN);
+}
+
+
 template <typename T>
 void Queue<T>::clear(const time::time_t &time) {
 	elem_ptr at = this->first_alive(time);
@@ -456,7 +537,7 @@ void Queue<T>::clear(const time::time_t &time) {
 	while (this->container.at(at).alive() <= time
 	       and at != this->container.size()) {
 		if (this->container.at(at).dead() > time) {
-			this->container[at].set_dead(time);
+			this->kill(time, at);
 		}
 		++at;
 	}
@@ -0,0 +1,77 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include "time/time.h"
+#include "util/hash.h"
+
+
+namespace openage::curve {
+
+/**
+ * Hash a value that is stored in a curve.
+ *
+ * The hash is the same on all platforms. Supported are integers, enums,
+ * fixed point numbers, strings, coordinates and pointers to objects with a
+ * \p hash() method. Other values, e.g. pointers to nodes of a graph, hash
+ * to 0 and do not contribute to curve hashes.
+ *
+ * @param value Value to hash.
+ * @return Hash.
+ */
+template <typename T>
+uint64_t value_hash(const T &value) {
+	if constexpr (std::is_integral_v<T> or std::is_enum_v<T>) {
+		return util::hash_mix(static_cast<uint64_t>(value));
+	}
+	else if constexpr (requires { value.get_raw_value(); }) {
+		return util::hash_mix(static_cast<uint64_t>(value.get_raw_value()));
+	}
+	else if constexpr (requires { value.ne; value.se; value.up; }) {
+		uint64_t hash = value_hash(value.ne);
+		hash = util::hash_append(hash, value_hash(value.se));
+		return util::hash_append(hash, value_hash(value.up));
+	}
+	else if constexpr (requires { value.ne; value.se; }) {
+		return util::hash_append(value_hash(value.ne), value_hash(value.se));
+	}
+	else if constexpr (std::is_same_v<T, std::string>) {
+		// FNV-1a
+		uint64_t hash = 0xcbf29ce484222325;
+		for (char c : value) {
+			hash ^= static_cast<uint8_t>(c);
+			hash *= 0x100000001b3;
+		}
+		return util::hash_mix(hash);
+	}
+	else if constexpr (requires { value->hash(); }) {
+		if (value == nullptr) {
+			return 0;
+		}
+		return value->hash();
+	}
+	else {
+		return 0;
+	}
+}
+
+/**
+ * Hash a keyframe of a curve.
+ *
+ * Keyframe hashes of a curve are summed up, so the curve hash can be
+ * updated in constant time when a keyframe is added or removed.
+ *
+ * @param time Time of the keyframe.
+ * @param value Value of the keyframe.
+ * @return Hash.
+ */
+template <typename T>
+uint64_t keyframe_hash(const time::time_t &time, const T &value) {
+	return util::hash_append(value_hash(time), value_hash(value));
+}
+
+} // namespace openage::curve
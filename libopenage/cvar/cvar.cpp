@@ -1,7 +1,8 @@
-// Copyright 2013-2020 the openage authors. See copying.md for legal info.
+// Copyright 2013-2024 the openage authors. See copying.md for legal info.
 
 #include "cvar.h"
 
+#include "../error/error.h"
 #include "../log/log.h"
 
 
@@ -24,6 +25,35 @@ bool CVarManager::create(const std::string &name,
 }
 
 
+void CVarManager::create_typed(const std::string &name,
+                               const std::shared_ptr<CVarStorageBase> &storage) {
+	bool created = this->create(name, {
+		[storage]() {
+			return storage->get_string();
+		},
+		[storage](const std::string &value) {
+			storage->set_string(value);
+		},
+	});
+
+	if (not created) {
+		throw Error(MSG(err) << "cvar '" << name << "' already exists as untyped entry");
+	}
+
+	this->typed_store[name] = storage;
+}
+
+
+void CVarManager::missing_entry(const std::string &name) const {
+	throw Error(MSG(err) << "typed cvar '" << name << "' does not exist");
+}
+
+
+void CVarManager::type_mismatch(const std::string &name) const {
+	throw Error(MSG(err) << "cvar '" << name << "' was created with another type");
+}
+
+
 std::string CVarManager::get(const std::string &name) const {
 	auto it = this->store.find(name);
 	if (it != this->store.end()) {
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <stdlib.h>
 // pxd: from libcpp.string cimport string
 #include <string>
@@ -14,6 +15,8 @@
 // pxd: from libopenage.util.path cimport Path
 #include "../util/path.h"
 
+#include "typed_cvar.h"
+
 
 namespace openage {
 namespace cvar {
@@ -32,6 +35,14 @@ using set_func = std::function<void(std::string)>;
  * Actually it doesn't store data, instead functions
  * that perform/fetch the configuration at the appropriate place.
  *
+ * Entries can also be typed (see CVar), then the value is stored
+ * in an atomic and can be read through a handle without going
+ * through the string accessors. Typed entries can still be
+ * accessed with get() and set() by name.
+ *
+ * Creating and looking up entries is not thread-safe,
+ * reading and setting values through typed handles is.
+ *
  * pxd:
  *
  * cppclass CVarManager:
@@ -51,6 +62,51 @@ public:
 	bool create(const std::string &name,
 	            const std::pair<get_func, set_func> &accessors);
 
+	/**
+	 * Creates a typed configuration entry.
+	 *
+	 * If a typed entry of the same type and name already exists,
+	 * a handle to it is returned instead.
+	 * Throws if the name is used by an entry of another type
+	 * or an untyped entry.
+	 *
+	 * @param name Name of the entry.
+	 * @param initial Initial value.
+	 *
+	 * @return Handle to the entry.
+	 */
+	template <cvar_type T>
+	CVar<T> create(const std::string &name, T initial) {
+		auto it = this->typed_store.find(name);
+		if (it != this->typed_store.end()) {
+			return this->typed_handle<T>(name, it->second);
+		}
+
+		auto storage = std::make_shared<CVarStorage<T>>(initial);
+		this->create_typed(name, storage);
+		return CVar<T>{std::move(storage)};
+	}
+
+	/**
+	 * Resolves a typed configuration entry by name.
+	 *
+	 * The handle should be stored and reused, so that the name
+	 * lookup is not done for every access.
+	 * Throws if there is no typed entry with this name and type.
+	 *
+	 * @param name Name of the entry.
+	 *
+	 * @return Handle to the entry.
+	 */
+	template <cvar_type T>
+	CVar<T> lookup(const std::string &name) const {
+		auto it = this->typed_store.find(name);
+		if (it == this->typed_store.end()) {
+			this->missing_entry(name);
+		}
+		return this->typed_handle<T>(name, it->second);
+	}
+
 	/**
 	 * Gets the value of a config entry.
 	 * Internally calls the stored get function.
@@ -74,6 +130,30 @@ public:
 	void load_all();
 
 private:
+	/**
+	 * Registers typed storage under a name, including
+	 * string accessors for get() and set().
+	 */
+	void create_typed(const std::string &name,
+	                  const std::shared_ptr<CVarStorageBase> &storage);
+
+	/**
+	 * Creates a handle from type-erased storage.
+	 * Throws if the entry has another type.
+	 */
+	template <cvar_type T>
+	CVar<T> typed_handle(const std::string &name,
+	                     const std::shared_ptr<CVarStorageBase> &storage) const {
+		auto typed = std::dynamic_pointer_cast<CVarStorage<T>>(storage);
+		if (typed == nullptr) {
+			this->type_mismatch(name);
+		}
+		return CVar<T>{std::move(typed)};
+	}
+
+	[[noreturn]] void missing_entry(const std::string &name) const;
+	[[noreturn]] void type_mismatch(const std::string &name) const;
+
 	/**
 	 * Store the key-value pair of config options.
 	 * The clue is to store the "what does the config do",
@@ -82,6 +162,12 @@ private:
 	 */
 	std::unordered_map<std::string, std::pair<get_func, set_func>> store;
 
+	/**
+	 * Storage of typed config options.
+	 * These are also present in the store as string accessors.
+	 */
+	std::unordered_map<std::string, std::shared_ptr<CVarStorageBase>> typed_store;
+
 	/**
 	 * Magic path that stores config files.
 	 * Auto-redirects to the default and write paths in the home folder.
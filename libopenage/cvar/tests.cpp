@@ -0,0 +1,84 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include <string>
+#include <thread>
+
+#include "cvar/cvar.h"
+#include "testing/testing.h"
+
+
+namespace openage::cvar::tests {
+
+void typed_cvar() {
+	CVarManager manager{util::Path{}};
+
+	auto distance = manager.create<int>("render_distance", 20);
+	auto scale = manager.create<float>("ui_scale", 1.5f);
+	auto vsync = manager.create<bool>("vsync", true);
+
+	TESTEQUALS(distance.get(), 20);
+	TESTEQUALS(scale.get(), 1.5f);
+	TESTEQUALS(vsync.get(), true);
+
+	// typed entries are reachable by name as strings
+	TESTEQUALS(manager.get("render_distance"), "20");
+	TESTEQUALS(manager.get("ui_scale"), "1.5");
+	TESTEQUALS(manager.get("vsync"), "1");
+
+	manager.set("render_distance", "35");
+	manager.set("ui_scale", "0.25");
+	manager.set("vsync", "false");
+	TESTEQUALS(distance.get(), 35);
+	TESTEQUALS(scale.get(), 0.25f);
+	TESTEQUALS(vsync.get(), false);
+
+	TESTTHROWS(manager.set("render_distance", "far"));
+	TESTTHROWS(manager.set("render_distance", "12px"));
+	TESTTHROWS(manager.set("vsync", "maybe"));
+	TESTEQUALS(distance.get(), 35);
+
+	// handles resolve to the same storage
+	auto other = manager.lookup<int>("render_distance");
+	other.set(40);
+	TESTEQUALS(distance.get(), 40);
+	TESTEQUALS(manager.create<int>("render_distance", 0).get(), 40);
+
+	TESTTHROWS(manager.lookup<int>("nonexistent"));
+	TESTTHROWS(manager.lookup<float>("render_distance"));
+	TESTTHROWS(manager.create<bool>("render_distance", false));
+
+	// untyped entries can't be reused for typed ones
+	manager.create("untyped", {[]() { return std::string{"x"}; },
+	                           [](const std::string &) {}});
+	TESTTHROWS(manager.create<int>("untyped", 0));
+
+	// change notifications
+	int notified = 0;
+	int last_value = 0;
+	size_t id = distance.subscribe([&](int value) {
+		notified += 1;
+		last_value = value;
+	});
+	manager.set("render_distance", "50");
+	other.set(60);
+	TESTEQUALS(notified, 2);
+	TESTEQUALS(last_value, 60);
+
+	distance.unsubscribe(id);
+	distance.set(70);
+	TESTEQUALS(notified, 2);
+
+	// reads from another thread
+	std::thread reader{[&]() {
+		while (not vsync.get()) {
+			std::this_thread::yield();
+		}
+	}};
+	vsync.set(true);
+	reader.join();
+
+	TESTEQUALS(static_cast<bool>(CVar<int>{}), false);
+	TESTEQUALS(static_cast<bool>(distance), true);
+}
+
+} // namespace openage::cvar::tests
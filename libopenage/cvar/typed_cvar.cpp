@@ -0,0 +1,78 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "typed_cvar.h"
+
+#include <array>
+#include <charconv>
+#include <system_error>
+
+#include "error/error.h"
+#include "log/message.h"
+
+
+namespace openage::cvar {
+
+namespace {
+
+/**
+ * Parse a number with std::from_chars, the whole string has to be consumed.
+ */
+template <typename T>
+T parse_number(const std::string &value) {
+	T result{};
+	const char *end = value.data() + value.size();
+	auto [ptr, ec] = std::from_chars(value.data(), end, result);
+	if (ec != std::errc{} or ptr != end) [[unlikely]] {
+		throw Error(MSG(err) << "invalid numeric cvar value '" << value << "'");
+	}
+	return result;
+}
+
+} // namespace
+
+
+template <>
+bool parse_value<bool>(const std::string &value) {
+	if (value == "1" or value == "true" or value == "on") {
+		return true;
+	}
+	if (value == "0" or value == "false" or value == "off") {
+		return false;
+	}
+	throw Error(MSG(err) << "invalid boolean cvar value '" << value << "'");
+}
+
+
+template <>
+int parse_value<int>(const std::string &value) {
+	return parse_number<int>(value);
+}
+
+
+template <>
+float parse_value<float>(const std::string &value) {
+	return parse_number<float>(value);
+}
+
+
+template <>
+std::string format_value<bool>(bool value) {
+	return value ? "1" : "0";
+}
+
+
+template <>
+std::string format_value<int>(int value) {
+	return std::to_string(value);
+}
+
+
+template <>
+std::string format_value<float>(float value) {
+	// shortest representation that parses to the same value
+	std::array<char, 32> buf;
+	auto [ptr, ec] = std::to_chars(buf.data(), buf.data() + buf.size(), value);
+	return std::string(buf.data(), ptr);
+}
+
+} // namespace openage::cvar
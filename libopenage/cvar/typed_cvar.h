@@ -0,0 +1,232 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace openage::cvar {
+
+/**
+ * Value types that can be stored in a typed configuration entry.
+ */
+template <typename T>
+concept cvar_type = std::same_as<T, bool> or std::same_as<T, int> or std::same_as<T, float>;
+
+
+/**
+ * Convert a string to a configuration value.
+ * Throws if the string is not a valid value of the type.
+ */
+template <cvar_type T>
+T parse_value(const std::string &value);
+
+/**
+ * Convert a configuration value to a string that can be parsed again.
+ */
+template <cvar_type T>
+std::string format_value(T value);
+
+template <>
+bool parse_value<bool>(const std::string &value);
+template <>
+int parse_value<int>(const std::string &value);
+template <>
+float parse_value<float>(const std::string &value);
+
+template <>
+std::string format_value<bool>(bool value);
+template <>
+std::string format_value<int>(int value);
+template <>
+std::string format_value<float>(float value);
+
+
+/**
+ * Type-erased storage of a typed configuration entry.
+ */
+class CVarStorageBase {
+public:
+	virtual ~CVarStorageBase() = default;
+
+	/**
+	 * Get the value as a string.
+	 */
+	virtual std::string get_string() const = 0;
+
+	/**
+	 * Parse and set the value from a string.
+	 */
+	virtual void set_string(const std::string &value) = 0;
+};
+
+
+/**
+ * Storage of a typed configuration entry.
+ *
+ * The value is an atomic, so it can be read from any thread
+ * without locking. Subscribers are only touched when the value is set.
+ */
+template <cvar_type T>
+class CVarStorage : public CVarStorageBase {
+	static_assert(std::atomic<T>::is_always_lock_free,
+	              "cvar values must be lock-free atomics");
+
+public:
+	using callback_t = std::function<void(T)>;
+
+	explicit CVarStorage(T initial) :
+		value{initial} {}
+
+	std::string get_string() const override {
+		return format_value<T>(this->get());
+	}
+
+	void set_string(const std::string &value) override {
+		this->set(parse_value<T>(value));
+	}
+
+	T get() const {
+		return this->value.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * Set the value and notify all subscribers.
+	 *
+	 * Subscribers are called in the thread that sets the value,
+	 * after the new value is visible to readers.
+	 */
+	void set(T new_value) {
+		this->value.store(new_value, std::memory_order_relaxed);
+
+		// copy the callbacks so they may (un)subscribe themselves
+		std::vector<callback_t> callbacks;
+		{
+			std::unique_lock lock{this->subscriber_mutex};
+			callbacks.reserve(this->subscribers.size());
+			for (auto &subscriber : this->subscribers) {
+				callbacks.push_back(subscriber.second);
+			}
+		}
+
+		for (auto &callback : callbacks) {
+			callback(new_value);
+		}
+	}
+
+	size_t subscribe(callback_t callback) {
+		std::unique_lock lock{this->subscriber_mutex};
+		size_t id = this->next_subscriber_id++;
+		this->subscribers.emplace_back(id, std::move(callback));
+		return id;
+	}
+
+	void unsubscribe(size_t id) {
+		std::unique_lock lock{this->subscriber_mutex};
+		std::erase_if(this->subscribers, [id](const auto &subscriber) {
+			return subscriber.first == id;
+		});
+	}
+
+private:
+	/**
+	 * Current value.
+	 */
+	std::atomic<T> value;
+
+	/**
+	 * Protects the subscriber list.
+	 */
+	std::mutex subscriber_mutex;
+
+	/**
+	 * Change callbacks by subscription ID.
+	 */
+	std::vector<std::pair<size_t, callback_t>> subscribers;
+
+	/**
+	 * ID for the next subscription.
+	 */
+	size_t next_subscriber_id = 0;
+};
+
+
+/**
+ * Handle to a typed configuration entry.
+ *
+ * Obtained once by name from the CVarManager, and then stored by the
+ * code that uses the value. Reading the value is a single atomic load,
+ * so handles can be used in hot code paths that need tunable parameters.
+ *
+ * Handles are cheap to copy and stay valid after the manager is destroyed.
+ */
+template <cvar_type T>
+class CVar {
+public:
+	using callback_t = typename CVarStorage<T>::callback_t;
+
+	/**
+	 * Create an unbound handle.
+	 */
+	CVar() = default;
+
+	explicit CVar(std::shared_ptr<CVarStorage<T>> storage) :
+		storage{std::move(storage)} {}
+
+	/**
+	 * Get the current value.
+	 */
+	T get() const {
+		return this->storage->get();
+	}
+
+	/**
+	 * Set the value and notify all subscribers.
+	 */
+	void set(T value) const {
+		this->storage->set(value);
+	}
+
+	/**
+	 * Register a function that is called whenever the value changes.
+	 *
+	 * @param callback Called with the new value.
+	 *
+	 * @return ID of the subscription, used for unsubscribing.
+	 */
+	size_t subscribe(callback_t callback) const {
+		return this->storage->subscribe(std::move(callback));
+	}
+
+	/**
+	 * Remove a subscription.
+	 *
+	 * @param id ID returned by \p subscribe().
+	 */
+	void unsubscribe(size_t id) const {
+		this->storage->unsubscribe(id);
+	}
+
+	/**
+	 * Check if the handle is bound to a configuration entry.
+	 */
+	explicit operator bool() const {
+		return this->storage != nullptr;
+	}
+
+private:
+	/**
+	 * Shared storage of the entry.
+	 */
+	std::shared_ptr<CVarStorage<T>> storage;
+};
+
+} // namespace openage::cvar
@@ -0,0 +1,119 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+
+namespace openage::datastructure {
+
+/**
+ * A lock-free multi-producer single-consumer queue.
+ *
+ * Producers push onto an atomic list head, so pushing never blocks
+ * and never waits for the consumer. The consumer takes the whole list
+ * at once with \p drain() and processes it in push order.
+ *
+ * Items pushed by the same thread are drained in the order they were
+ * pushed. There is no ordering between items of different threads
+ * beyond the order in which their pushes took effect.
+ */
+template <typename T>
+class MPSCQueue {
+	struct Node {
+		T value;
+		Node *next;
+	};
+
+public:
+	MPSCQueue() = default;
+
+	~MPSCQueue() {
+		delete_list(this->head.exchange(nullptr, std::memory_order_acquire));
+	}
+
+	MPSCQueue(const MPSCQueue &) = delete;
+	MPSCQueue(MPSCQueue &&) = delete;
+
+	MPSCQueue &operator=(const MPSCQueue &) = delete;
+	MPSCQueue &operator=(MPSCQueue &&) = delete;
+
+	/**
+	 * Append an item to the queue. Can be called from any thread.
+	 */
+	void push(T item) {
+		Node *node = new Node{std::move(item), this->head.load(std::memory_order_relaxed)};
+		while (not this->head.compare_exchange_weak(node->next,
+		                                            node,
+		                                            std::memory_order_release,
+		                                            std::memory_order_relaxed)) {
+		}
+	}
+
+	/**
+	 * Check if the queue is empty. The result may be outdated
+	 * as soon as it is returned if other threads push items.
+	 */
+	bool empty() const {
+		return this->head.load(std::memory_order_relaxed) == nullptr;
+	}
+
+	/**
+	 * Remove all items from the queue and pass them to a function in push order.
+	 *
+	 * Must only be called from one thread at a time. Items pushed while
+	 * draining are left for the next call.
+	 *
+	 * @param func Called with an rvalue reference to each item.
+	 *
+	 * @return Number of drained items.
+	 */
+	template <typename F>
+	size_t drain(F &&func) {
+		Node *list = this->head.exchange(nullptr, std::memory_order_acquire);
+
+		// the list is in reverse push order
+		Node *ordered = nullptr;
+		while (list != nullptr) {
+			Node *next = list->next;
+			list->next = ordered;
+			ordered = list;
+			list = next;
+		}
+
+		size_t count = 0;
+		try {
+			while (ordered != nullptr) {
+				Node *next = ordered->next;
+				func(std::move(ordered->value));
+				delete ordered;
+				ordered = next;
+				count += 1;
+			}
+		}
+		catch (...) {
+			delete_list(ordered);
+			throw;
+		}
+
+		return count;
+	}
+
+private:
+	static void delete_list(Node *list) {
+		while (list != nullptr) {
+			Node *next = list->next;
+			delete list;
+			list = next;
+		}
+	}
+
+	/**
+	 * Most recently pushed item.
+	 */
+	std::atomic<Node *> head{nullptr};
+};
+
+} // namespace openage::datastructure
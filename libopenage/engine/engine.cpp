@@ -1,4 +1,4 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2024 the openage authors. See copying.md for legal info.
 
 #include "engine.h"
 
@@ -6,8 +6,11 @@
 #include "log/message.h"
 
 #include "cvar/cvar.h"
+#include "gamestate/replay.h"
 #include "gamestate/simulation.h"
+#include "metrics/trace.h"
 #include "presenter/presenter.h"
+#include "time/clock.h"
 #include "time/time_loop.h"
 
 
@@ -29,9 +32,35 @@ Engine::Engine(mode mode,
 	this->cvar_manager = std::make_shared<cvar::CVarManager>(this->root_dir["cfg"]);
 	cvar_manager->load_all();
 
+	// trace zones can be recorded and dumped at runtime.
+	// the console toggles tracing directly, so the value is read from
+	// the tracing state instead of being stored in the entry.
+	this->cvar_manager->create("trace_enabled", {
+		[]() {
+			return cvar::format_value<bool>(metrics::tracing_enabled());
+		},
+		[](const std::string &value) {
+			metrics::set_tracing(cvar::parse_value<bool>(value));
+		},
+	});
+	this->cvar_manager->create("trace_dump", {
+		[]() {
+			return std::string{};
+		},
+		[](const std::string &filename) {
+			metrics::dump_trace(filename);
+		},
+	});
+
 	// time loop
 	this->time_loop = std::make_shared<time::TimeLoop>();
 
+	// simulation speed can be changed at runtime
+	auto clock_speed = this->cvar_manager->create<float>("clock_speed", 1.0f);
+	clock_speed.subscribe([clock = this->time_loop->get_clock()](float speed) {
+		clock->set_speed(speed);
+	});
+
 	// game simulation
 	// this is run in the main thread
 	this->simulation = std::make_shared<gamestate::GameSimulation>(this->root_dir,
@@ -80,4 +109,18 @@ void Engine::loop() {
 	}
 }
 
+void Engine::record_replay(const std::string &path) {
+	this->simulation->set_replay_recorder(std::make_shared<gamestate::ReplayRecorder>(path));
+}
+
+bool Engine::replay(const std::string &path) {
+	auto result = this->simulation->replay(path);
+
+	this->simulation.reset();
+	this->time_loop->stop();
+	this->running = false;
+
+	return not result.diverged_at.has_value();
+}
+
 } // namespace openage::engine
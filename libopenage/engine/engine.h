@@ -91,6 +91,23 @@ public:
 	 */
 	void loop();
 
+	/**
+	 * Record the events of the match to a replay file.
+	 * Must be called before \p loop().
+	 *
+	 * @param path Native path of the replay file.
+	 */
+	void record_replay(const std::string &path);
+
+	/**
+	 * Play a recorded replay as fast as possible instead of running the main loop.
+	 *
+	 * @param path Native path of the replay file.
+	 *
+	 * @return true if the state hashes of the replay matched.
+	 */
+	bool replay(const std::string &path);
+
 	/**
 	 * current simulation state variable.
 	 * to be set to false to stop the simulation loop.
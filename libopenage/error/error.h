@@ -1,4 +1,4 @@
-// Copyright 2013-2023 the openage authors. See copying.md for legal info.
+// Copyright 2013-2024 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -62,7 +62,8 @@ public:
 	 *     traceback information (e.g.: backtrace (3))
 	 *     (default true).
 	 *     The performance impacts should be not too bad, as only
-	 *     program counter pointers are collected.
+	 *     program counter pointers are collected. Symbols are resolved
+	 *     when the backtrace is printed, and cached process-wide.
 	 * @param store_cause
 	 *     If true, a pointer to the causing exception is
 	 *     collected and stored (default true).
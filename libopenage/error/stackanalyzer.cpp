@@ -1,9 +1,13 @@
-// Copyright 2015-2023 the openage authors. See copying.md for legal info.
+// Copyright 2015-2024 the openage authors. See copying.md for legal info.
 
 #include "stackanalyzer.h"
 
+#include <array>
 #include <cstdint>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
 
 #include "config.h"
 #include "log/log.h"
@@ -25,6 +29,26 @@ constexpr uint64_t skip_entry_frames = 1;
  */
 constexpr uint64_t base_skip_frames = 1;
 
+/**
+ * Number of program counters that are captured without
+ * a heap allocation for the intermediate buffer.
+ * Deeper stacks are captured completely, with a heap allocation.
+ */
+constexpr size_t capture_buffer_size = 128;
+
+
+namespace {
+
+/**
+ * Resolves the symbols of one program counter value.
+ * Implemented by the platform specific parts below.
+ *
+ * One pc may resolve to more than one symbol, e.g. for inlined functions.
+ */
+std::vector<backtrace_symbol> resolve_symbols(void *pc);
+
+} // anonymous namespace
+
 } // namespace openage::error
 
 
@@ -68,11 +92,29 @@ util::OnInit init_backtrace_state([]() {
 });
 
 
-// called by backtrace_simple in StackAnalyzer::collect()
+/**
+ * Storage for the program counters collected by backtrace_simple.
+ * Frames that don't fit into the fixed-size part go to the overflow vector.
+ */
+struct capture_buffer_t {
+	std::array<void *, capture_buffer_size> pcs;
+	size_t count = 0;
+	std::vector<void *> overflow;
+};
+
+
+// called by backtrace_simple in StackAnalyzer::analyze()
 int backtrace_simple_callback(void *data, uintptr_t pc) {
-	// data is a pointer to the StackAnalyzer object
-	StackAnalyzer *bt = reinterpret_cast<StackAnalyzer *>(data);
-	bt->stack_addrs.push_back(reinterpret_cast<void *>(pc));
+	auto buffer = reinterpret_cast<capture_buffer_t *>(data);
+	if (buffer->count < buffer->pcs.size()) [[likely]] {
+		buffer->pcs[buffer->count] = reinterpret_cast<void *>(pc);
+		buffer->count += 1;
+	}
+	else {
+		buffer->overflow.push_back(reinterpret_cast<void *>(pc));
+	}
+
+	// continue the stack walk
 	return 0;
 }
 
@@ -96,7 +138,7 @@ void backtrace_syminfo_callback(
 }
 
 
-// called by backtrace_pcinfo in StackAnalyzer::get_symbols
+// called by backtrace_pcinfo in resolve_symbols
 int backtrace_pcinfo_callback(void *data, uintptr_t pc, const char *filename, int lineno, const char *function) {
 	backtrace_symbol result;
 
@@ -141,47 +183,40 @@ void backtrace_pcinfo_error_callback(void *data, const char *msg, int errorno) {
 	}
 }
 
+
+std::vector<backtrace_symbol> resolve_symbols(void *pc) {
+	info_cb_data_t info_cb_data;
+	info_cb_data.pc = reinterpret_cast<uintptr_t>(pc);
+
+	// note: a call to backtrace_pcinfo may, in semi-rare cases, push back
+	// multiple symbols to result. That's nothing to worry about, though.
+	// If you decide you don't like it, make pcinfo_callback return 1.
+	backtrace_pcinfo(
+		bt_state,
+		info_cb_data.pc,
+		backtrace_pcinfo_callback,
+		backtrace_pcinfo_error_callback,
+		reinterpret_cast<void *>(&info_cb_data));
+
+	return std::move(info_cb_data.symbols);
+}
+
 } // anonymous namespace
 
 
 void StackAnalyzer::analyze() {
+	capture_buffer_t buffer;
+
 	backtrace_simple(
 		bt_state,
 		base_skip_frames, // skip some frames at "most recent call"
 		backtrace_simple_callback,
 		backtrace_error_callback,
-		reinterpret_cast<void *>(this));
-}
-
-
-void StackAnalyzer::get_symbols(std::function<void(const backtrace_symbol *)> cb, bool reversed) const {
-	info_cb_data_t info_cb_data;
-
-	for (void *pc : this->stack_addrs) {
-		info_cb_data.pc = reinterpret_cast<uintptr_t>(pc);
+		reinterpret_cast<void *>(&buffer));
 
-		// note: a call to backtrace_pcinfo may, in semi-rare cases, push back
-		// multiple symbols to result. That's nothing to worry about, though.
-		// If you decide you don't like it, make pcinfo_callback return 1.
-		backtrace_pcinfo(
-			bt_state,
-			info_cb_data.pc,
-			backtrace_pcinfo_callback,
-			backtrace_pcinfo_error_callback,
-			reinterpret_cast<void *>(&info_cb_data));
-	}
-
-	if (reversed) {
-		// this entire vector thing would only be needed for reversed=true...
-		for (size_t idx = info_cb_data.symbols.size(); idx-- > 0;) {
-			cb(&info_cb_data.symbols[idx]);
-		}
-	}
-	else {
-		for (backtrace_symbol &symbol : info_cb_data.symbols) {
-			cb(&symbol);
-		}
-	}
+	this->stack_addrs.reserve(buffer.count + buffer.overflow.size());
+	this->stack_addrs.assign(buffer.pcs.begin(), buffer.pcs.begin() + buffer.count);
+	this->stack_addrs.insert(this->stack_addrs.end(), buffer.overflow.begin(), buffer.overflow.end());
 }
 
 } // namespace error
@@ -195,14 +230,31 @@ void StackAnalyzer::get_symbols(std::function<void(const backtrace_symbol *)> cb
 namespace openage {
 namespace error {
 
+namespace {
+
+std::vector<backtrace_symbol> resolve_symbols(void *pc) {
+	return {backtrace_symbol{"", 0, util::symbol_name(pc, false, true), pc}};
+}
+
+} // anonymous namespace
+
 
 void StackAnalyzer::analyze() {
-	std::vector<void *> buffer{64};
-	auto count = RtlCaptureStackBackTrace(base_skip_frames, buffer.size(), buffer.data(), NULL);
-	if (count < buffer.size()) {
-		buffer.resize(count);
+	std::array<void *, capture_buffer_size> buffer;
+	this->stack_addrs.clear();
+
+	// deeper stacks are captured in chunks, skipping the frames
+	// that were captured already.
+	DWORD skip = base_skip_frames;
+	while (true) {
+		auto count = RtlCaptureStackBackTrace(skip, buffer.size(), buffer.data(), NULL);
+		this->stack_addrs.insert(this->stack_addrs.end(), buffer.begin(), buffer.begin() + count);
+
+		if (count < buffer.size()) {
+			break;
+		}
+		skip += count;
 	}
-	this->stack_addrs = std::move(buffer);
 }
 
 } // namespace error
@@ -215,88 +267,121 @@ void StackAnalyzer::analyze() {
 
 namespace openage::error {
 
+namespace {
+
+std::vector<backtrace_symbol> resolve_symbols(void *pc) {
+	return {backtrace_symbol{"", 0, util::symbol_name(pc, false, true), pc}};
+}
+
+} // anonymous namespace
+
 
 void StackAnalyzer::analyze() {
+	// try a buffer on the stack first, most backtraces fit in there.
+	std::array<void *, capture_buffer_size> stack_buffer;
+	std::vector<void *> heap_buffer;
+
+	void **pcs = stack_buffer.data();
+	size_t capacity = stack_buffer.size();
+	int elements = backtrace(pcs, capacity);
+
 	// unfortunately, backtrace won't tell us how big our buffer
 	// needs to be, so we have no choice but to try until it
 	// reports success.
-	std::vector<void *> buffer{64};
-
-	while (true) {
-		int elements = backtrace(buffer.data(), buffer.size());
-
-		// the buffer was large enough, so stop resizing.
-		if (elements < static_cast<ssize_t>(buffer.size())) {
-			buffer.resize(elements);
-			break;
-		}
-		else {
-			buffer.resize(buffer.size() * 2);
-		}
+	while (static_cast<size_t>(elements) >= capacity) {
+		capacity *= 2;
+		heap_buffer.resize(capacity);
+		pcs = heap_buffer.data();
+		elements = backtrace(pcs, capacity);
 	}
 
-	// now store the result, cut off at the front and back.
-
-	size_t idx = 0;
-	for (void *element : buffer) {
-		// start storing after skipping skip the first few frames
-		// so that e.g. this function does not show up in the trace.
-		// (most-recent-call)
-		if (idx >= base_skip_frames) {
-			this->stack_addrs.push_back(element);
-		}
-		idx += 1;
+	// now store the result, cut off at the front and back:
+	// skip the first few frames so that e.g. this function does not show
+	// up in the trace (most-recent-call), and remove some
+	// libc-garbage-frames (least-recent-call).
+	size_t count = static_cast<size_t>(elements);
+	if (count <= base_skip_frames + skip_entry_frames) {
+		this->stack_addrs.clear();
+		return;
 	}
 
-	// remove some libc-garbage-frames (least-recent-call)
-	for (uint64_t i = 0; i < skip_entry_frames; i++) {
-		this->stack_addrs.pop_back();
-	}
+	this->stack_addrs.assign(pcs + base_skip_frames, pcs + count - skip_entry_frames);
 }
 
 } // namespace openage::error
 
 #endif // for _MSC_VER or GNU execinfo
 
+#endif // WITHOUT_BACKTRACE
+
+
 namespace openage::error {
 
+namespace {
+
+/**
+ * Process-wide cache of resolved symbols, indexed by program counter.
+ *
+ * Symbol resolution has to parse debug info and demangle names,
+ * and the same frames show up in most backtraces.
+ * Entries are never removed, so references to them stay valid.
+ */
+class SymbolCache {
+public:
+	const std::vector<backtrace_symbol> &get(void *pc) {
+		{
+			std::shared_lock lock{this->mutex};
+			auto it = this->symbols.find(pc);
+			if (it != this->symbols.end()) {
+				return it->second;
+			}
+		}
+
+		// resolve without holding the lock, if another thread
+		// was faster its result is kept.
+		auto resolved = resolve_symbols(pc);
+
+		std::unique_lock lock{this->mutex};
+		return this->symbols.try_emplace(pc, std::move(resolved)).first->second;
+	}
+
+private:
+	std::shared_mutex mutex;
+	std::unordered_map<void *, std::vector<backtrace_symbol>> symbols;
+};
+
+
+SymbolCache &symbol_cache() {
+	static SymbolCache cache;
+	return cache;
+}
+
+} // anonymous namespace
+
 
 void StackAnalyzer::get_symbols(std::function<void(const backtrace_symbol *)> cb,
                                 bool reversed) const {
-	backtrace_symbol symbol;
-	symbol.filename = "";
-	symbol.lineno = 0;
+	auto &cache = symbol_cache();
 
 	if (reversed) {
-		// `for (auto pc : this->stack_addrs | <ranges-ns>::view::reverse)` after Ranges-TS
+		// `for (auto pc : this->stack_addrs | std::views::reverse)`
 		for (size_t idx = this->stack_addrs.size(); idx-- > 0;) {
-			void *pc = this->stack_addrs[idx];
-
-			symbol.functionname = util::symbol_name(pc, false, true);
-			symbol.pc = pc;
-
-			cb(&symbol);
+			auto &symbols = cache.get(this->stack_addrs[idx]);
+			for (size_t sym = symbols.size(); sym-- > 0;) {
+				cb(&symbols[sym]);
+			}
 		}
 	}
 	else {
 		for (void *pc : this->stack_addrs) {
-			symbol.functionname = util::symbol_name(pc, false, true);
-			symbol.pc = pc;
-
-			cb(&symbol);
+			for (auto &symbol : cache.get(pc)) {
+				cb(&symbol);
+			}
 		}
 	}
 }
 
 
-} // namespace openage::error
-
-#endif // WITHOUT_BACKTRACE
-
-
-namespace openage::error {
-
-
 void StackAnalyzer::trim_to_current_stack_frame() {
 	StackAnalyzer current;
 	current.analyze();
@@ -0,0 +1,73 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include <algorithm>
+#include <vector>
+
+#include "error/stackanalyzer.h"
+#include "testing/testing.h"
+
+
+namespace openage::error::tests {
+
+namespace {
+
+void capture_nested(int depth, StackAnalyzer &result);
+
+/**
+ * Called through a volatile pointer, so the recursion can't be inlined
+ * and every level gets its own stack frame.
+ */
+void (*volatile nested)(int, StackAnalyzer &) = capture_nested;
+
+int levels = 0;
+
+
+/**
+ * Capture a backtrace below depth nested calls.
+ */
+void capture_nested(int depth, StackAnalyzer &result) {
+	if (depth == 0) {
+		result.analyze();
+		return;
+	}
+
+	nested(depth - 1, result);
+
+	// not a tail call
+	levels += 1;
+}
+
+} // namespace
+
+
+void stackanalyzer() {
+	// stacks deeper than the fixed capture buffer are captured completely
+	StackAnalyzer deep;
+	capture_nested(300, deep);
+	TESTEQUALS(deep.stack_addrs.size() >= 300, true);
+
+	// another backtrace with the same frames resolves to the same symbols,
+	// which are taken from the process-wide cache.
+	StackAnalyzer copy;
+	copy.stack_addrs = deep.stack_addrs;
+
+	std::vector<const backtrace_symbol *> first;
+	std::vector<const backtrace_symbol *> second;
+	std::vector<const backtrace_symbol *> reversed;
+	auto collect = [](std::vector<const backtrace_symbol *> &symbols) {
+		return [&symbols](const backtrace_symbol *symbol) {
+			symbols.push_back(symbol);
+		};
+	};
+	deep.get_symbols(collect(first), false);
+	copy.get_symbols(collect(second), false);
+	copy.get_symbols(collect(reversed), true);
+	std::reverse(reversed.begin(), reversed.end());
+
+	TESTEQUALS(first.size() >= deep.stack_addrs.size(), true);
+	(first == second) or TESTFAIL;
+	(first == reversed) or TESTFAIL;
+}
+
+
+} // namespace openage::error::tests
@@ -1,4 +1,4 @@
-// Copyright 2017-2023 the openage authors. See copying.md for legal info.
+// Copyright 2017-2024 the openage authors. See copying.md for legal info.
 
 #include "event_loop.h"
 
@@ -16,11 +16,34 @@
 #include "event/eventhandler.h"
 #include "event/eventqueue.h"
 #include "event/eventstore.h"
+#include "metrics/registry.h"
+#include "metrics/scoped_timer.h"
+#include "metrics/trace.h"
 #include "util/fixed_point.h"
 
 
 namespace openage::event {
 
+namespace {
+
+metrics::Histogram &reach_time_metric = metrics::registry().histogram(
+	"event_loop_reach_time_ns",
+	"Time needed to execute all events up to the requested time");
+
+metrics::Counter &events_executed_metric = metrics::registry().counter(
+	"event_loop_events_executed_total",
+	"Number of executed events");
+
+metrics::Counter &events_posted_metric = metrics::registry().counter(
+	"event_loop_events_posted_total",
+	"Number of events created from requests of other threads");
+
+metrics::Gauge &queue_size_metric = metrics::registry().gauge(
+	"event_loop_queue_size",
+	"Number of pending events after the last reach_time call");
+
+} // namespace
+
 
 void EventLoop::add_event_handler(const std::shared_ptr<EventHandler> eventhandler) {
 	std::unique_lock lock{this->mutex};
@@ -68,10 +91,47 @@ std::shared_ptr<Event> EventLoop::create_event(const std::shared_ptr<EventHandle
 }
 
 
+std::shared_ptr<Event> EventLoop::restore_event(const std::string &name,
+                                                const std::shared_ptr<EventEntity> &target,
+                                                const std::shared_ptr<State> &state,
+                                                const time::time_t &time,
+                                                const EventHandler::param_map &params) {
+	std::unique_lock lock{this->mutex};
+
+	auto it = this->classstore.find(name);
+	if (it == this->classstore.end()) {
+		throw Error{MSG(err) << "Trying to restore event of eventhandler "
+		                     << name << ", which does not exist."};
+	}
+
+	return this->queue.restore_event(target, it->second, state, time, params);
+}
+
+
+void EventLoop::post_event(const std::string &eventhandler,
+                           const std::shared_ptr<EventEntity> &target,
+                           const std::shared_ptr<State> &state,
+                           const time::time_t &reference_time,
+                           const EventHandler::param_map &params) {
+	this->inbox.push(PostedEvent{eventhandler, target, state, reference_time, params});
+}
+
+
+void EventLoop::set_post_observer(const post_observer_t &observer) {
+	std::unique_lock lock{this->mutex};
+
+	this->post_observer = observer;
+}
+
+
 void EventLoop::reach_time(const time::time_t &time_until,
                            const std::shared_ptr<State> &state) {
+	OA_TRACE_SCOPE("EventLoop::reach_time");
+	metrics::ScopedTimer timer{reach_time_metric};
 	std::unique_lock lock{this->mutex};
 
+	this->process_inbox(time_until);
+
 	// TODO detect infinite loops (is this a halting problem?)
 	// this happens when the events don't settle:
 	// at least one processed event adds another event so
@@ -103,10 +163,40 @@ void EventLoop::reach_time(const time::time_t &time_until,
 	// Swap in the end of the execution, else we might skip changes that happen
 	// in the main loop for one frame - which is bad btw.
 	this->queue.swap_changesets();
+	queue_size_metric.set(this->queue.get_event_queue().size());
 	log::log(SPAM << "Loop: t=" << time_until << " was reached! ========");
 }
 
 
+size_t EventLoop::process_inbox(const time::time_t &time_until) {
+	size_t cnt = this->inbox.drain([&, this](PostedEvent &&posted) {
+		auto it = this->classstore.find(posted.eventhandler);
+		if (it == this->classstore.end()) [[unlikely]] {
+			log::log(WARN << "Loop: dropping posted event for eventhandler "
+			              << posted.eventhandler << ", which does not exist.");
+			return;
+		}
+
+		this->queue.create_event(posted.target,
+		                         it->second,
+		                         posted.state,
+		                         posted.reference_time,
+		                         posted.params);
+
+		if (this->post_observer) {
+			this->post_observer(time_until,
+			                    posted.eventhandler,
+			                    posted.target,
+			                    posted.reference_time,
+			                    posted.params);
+		}
+	});
+
+	events_posted_metric.add(cnt);
+	return cnt;
+}
+
+
 int EventLoop::execute_events(const time::time_t &time_until,
                               const std::shared_ptr<State> &state) {
 	log::log(SPAM << "Loop: Pending events in the queue (# = "
@@ -170,6 +260,8 @@ int EventLoop::execute_events(const time::time_t &time_until,
 			             << "\" for time t=" << event->get_time());
 		}
 	}
+
+	events_executed_metric.add(cnt);
 	return cnt;
 }
 
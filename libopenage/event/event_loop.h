@@ -2,11 +2,13 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
 
+#include "datastructure/mpsc_queue.h"
 #include "event/eventhandler.h"
 #include "event/eventqueue.h"
 #include "time/time.h"
@@ -32,6 +34,21 @@ class EventLoop {
 	friend int demo::curvepong();
 
 public:
+	/**
+	 * Called for every event that is created from a \p post_event() request.
+	 *
+	 * @param time_until Time passed to the \p reach_time() call that created the event.
+	 * @param eventhandler Event handler ID.
+	 * @param target Target entity. Can be \p nullptr.
+	 * @param reference_time Simulation time the request was issued for.
+	 * @param params Event parameters map.
+	 */
+	using post_observer_t = std::function<void(const time::time_t &time_until,
+	                                           const std::string &eventhandler,
+	                                           const std::shared_ptr<EventEntity> &target,
+	                                           const time::time_t &reference_time,
+	                                           const EventHandler::param_map &params)>;
+
 	/**
 	 * Create a new event loop.
 	 */
@@ -87,9 +104,63 @@ public:
 	                                    const time::time_t reference_time,
 	                                    const EventHandler::param_map params = EventHandler::param_map({}));
 
+	/**
+	 * Add an event that executes at a given time, e.g. when restoring a snapshot.
+	 *
+	 * The execution time is used as is and not predicted by the event handler.
+	 * Only events of ONCE and REPEAT event handlers can be restored.
+	 *
+	 * @param eventhandler Event handler ID. The handler must already be registered on the loop.
+	 * @param target Target entity.
+	 * @param state Global state.
+	 * @param time Execution time of the event.
+	 * @param params Event parameters map (default = {}). Passed to the event handler on event execution.
+	 */
+	std::shared_ptr<Event> restore_event(const std::string &eventhandler,
+	                                     const std::shared_ptr<EventEntity> &target,
+	                                     const std::shared_ptr<State> &state,
+	                                     const time::time_t &time,
+	                                     const EventHandler::param_map &params = EventHandler::param_map({}));
+
+	/**
+	 * Request a new event from another thread, e.g. for player input.
+	 *
+	 * Unlike \p create_event() this never blocks: the request is put into
+	 * a lock-free inbox and the event is created at the start of the next
+	 * \p reach_time() call. Requests from the same thread are created in the
+	 * order they were posted.
+	 *
+	 * Requests for event handlers that are not registered are dropped
+	 * with a warning when the inbox is processed.
+	 *
+	 * @param eventhandler Event handler ID. The handler must be registered on the loop.
+	 * @param target Target entity. Can be \p nullptr.
+	 * @param state Global state.
+	 * @param reference_time Simulation time the request was issued for.
+	 * @param params Event parameters map (default = {}). Passed to the event handler on event execution.
+	 */
+	void post_event(const std::string &eventhandler,
+	                const std::shared_ptr<EventEntity> &target,
+	                const std::shared_ptr<State> &state,
+	                const time::time_t &reference_time,
+	                const EventHandler::param_map &params = EventHandler::param_map({}));
+
+	/**
+	 * Set a function that is notified about all events created from
+	 * \p post_event() requests, e.g. for recording player input.
+	 *
+	 * The observer is called from \p reach_time() in the order the
+	 * events are created.
+	 *
+	 * @param observer Observer function. Pass \p nullptr to remove it.
+	 */
+	void set_post_observer(const post_observer_t &observer);
+
 	/**
 	 * Execute events in the queue with execution time <= a given point in time.
 	 *
+	 * Events requested with \p post_event() are created first.
+	 *
 	 * @param time_until Maximum time until which events are executed.
 	 * @param state Global state.
 	 */
@@ -121,6 +192,26 @@ public:
 	}
 
 private:
+	/**
+	 * Event requested with \p post_event().
+	 */
+	struct PostedEvent {
+		std::string eventhandler;
+		std::shared_ptr<EventEntity> target;
+		std::shared_ptr<State> state;
+		time::time_t reference_time;
+		EventHandler::param_map params;
+	};
+
+	/**
+	 * Create the events for all requests in the inbox.
+	 *
+	 * @param time_until Time passed to the current \p reach_time() call.
+	 *
+	 * @returns number of processed requests
+	 */
+	size_t process_inbox(const time::time_t &time_until);
+
 	/**
 	 *  Execute events in the queue with execution time <= a given point in time.
 	 *
@@ -155,6 +246,16 @@ private:
 	 */
 	std::shared_ptr<Event> active_event;
 
+	/**
+	 * Event requests from other threads. Does not need the mutex.
+	 */
+	datastructure::MPSCQueue<PostedEvent> inbox;
+
+	/**
+	 * Notified about events created from the inbox.
+	 */
+	post_observer_t post_observer;
+
 	/**
 	 * Mutex for protecting threaded access.
 	 */
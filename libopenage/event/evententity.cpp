@@ -1,4 +1,4 @@
-// Copyright 2017-2023 the openage authors. See copying.md for legal info.
+// Copyright 2017-2024 the openage authors. See copying.md for legal info.
 
 #include "evententity.h"
 
@@ -19,6 +19,7 @@ namespace openage::event {
 void EventEntity::changes(const time::time_t &time) {
 	// This target has some change, so we have to notify all dependents
 	// that subscribed on this entity.
+	this->change_count += 1;
 
 	if (this->parent_notifier or this->dependents.size()) {
 		log::log(DBG << "Target: processing change request at t=" << time
@@ -76,6 +77,13 @@ void EventEntity::changes(const time::time_t &time) {
 }
 
 
+void EventEntity::notify_parent(const time::time_t &change_time) {
+	if (this->parent_notifier != nullptr) {
+		this->parent_notifier(change_time);
+	}
+}
+
+
 void EventEntity::trigger(const time::time_t &last_valid_time) {
 	// notify all dependent events that are triggered `on_keyframe`
 	// that the this target changed.
@@ -1,4 +1,4 @@
-// Copyright 2017-2023 the openage authors. See copying.md for legal info.
+// Copyright 2017-2024 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -56,6 +56,26 @@ public:
 	 */
 	void show_dependents() const;
 
+	/**
+	 * Get the number of changes of this entity so far.
+	 *
+	 * Can be compared with an earlier value to find out if the
+	 * entity changed in the meantime, e.g. for incremental snapshots.
+	 */
+	size_t get_change_count() const {
+		return this->change_count;
+	}
+
+	/**
+	 * Set the function that propagates changes of this entity to a
+	 * parent structure. Replaces the notifier given on construction.
+	 *
+	 * @param notifier Notifier function. Can be \p nullptr.
+	 */
+	void set_parent_notifier(const single_change_notifier &notifier) {
+		this->parent_notifier = notifier;
+	}
+
 protected:
 	/**
 	 * Call this whenever some data in the target changes.
@@ -63,6 +83,12 @@ protected:
 	 */
 	void changes(const time::time_t &change_time);
 
+	/**
+	 * Only call the parent notifier, without reevaluating dependent events.
+	 * Used for changes that happen while the simulation is not running.
+	 */
+	void notify_parent(const time::time_t &change_time);
+
 	/**
 	 * Call this when depending TriggerEventHandleres should be invoked.
 	 */
@@ -76,6 +102,9 @@ private:
 	std::list<std::weak_ptr<Event>> dependents;
 
 	single_change_notifier parent_notifier;
+
+	/** Number of calls to \p changes() */
+	size_t change_count = 0;
 };
 
 } // namespace openage::event
@@ -1,4 +1,4 @@
-// Copyright 2017-2023 the openage authors. See copying.md for legal info.
+// Copyright 2017-2024 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -103,6 +103,13 @@ public:
 			return map.find(key) != map.end();
 		}
 
+		/**
+		 * Get all entries of the map.
+		 */
+		const map_t &get_map() const {
+			return this->map;
+		}
+
 		/**
 		 * Check if the type of a map entry is correct.
 		 */
@@ -1,4 +1,4 @@
-// Copyright 2017-2023 the openage authors. See copying.md for legal info.
+// Copyright 2017-2024 the openage authors. See copying.md for legal info.
 
 #include "eventqueue.h"
 
@@ -6,6 +6,7 @@
 #include <string>
 #include <utility>
 
+#include "error/error.h"
 #include "log/message.h"
 
 #include "event/event.h"
@@ -76,6 +77,30 @@ std::shared_ptr<Event> EventQueue::create_event(const std::shared_ptr<EventEntit
 }
 
 
+std::shared_ptr<Event> EventQueue::restore_event(const std::shared_ptr<EventEntity> &trgt,
+                                                 const std::shared_ptr<EventHandler> &cls,
+                                                 const std::shared_ptr<State> &state,
+                                                 const time::time_t &time,
+                                                 const EventHandler::param_map &params) {
+	if (cls->type != EventHandler::trigger_type::ONCE
+	    and cls->type != EventHandler::trigger_type::REPEAT) [[unlikely]] {
+		throw Error{MSG(err) << "Can not restore event of EventHandler " << cls->id()
+		                     << " because it is not executed at a fixed time"};
+	}
+
+	auto event = std::make_shared<Event>(trgt, cls, params);
+
+	cls->setup_event(event, state);
+	event->set_time(time);
+
+	log::log(DBG << "Queue: restoring event " << event->get_eventhandler()->id() << " to be executed at t=" << event->get_time());
+
+	this->event_queue.push(event);
+
+	return event;
+}
+
+
 EventQueue::EventQueue() :
 	changes(&changeset_A),
 	future_changes(&changeset_B) {}
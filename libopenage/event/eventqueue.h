@@ -1,4 +1,4 @@
-// Copyright 2017-2023 the openage authors. See copying.md for legal info.
+// Copyright 2017-2024 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -70,6 +70,19 @@ public:
 	                                    const time::time_t &reference_time,
 	                                    const EventHandler::param_map &params);
 
+	/**
+	 * Add an event that executes at a given time, e.g. one that was
+	 * stored in a snapshot.
+	 *
+	 * Unlike \p create_event() the execution time is not predicted by
+	 * the event handler. Only ONCE and REPEAT events can be restored.
+	 */
+	std::shared_ptr<Event> restore_event(const std::shared_ptr<EventEntity> &evententity,
+	                                     const std::shared_ptr<EventHandler> &eventhandler,
+	                                     const std::shared_ptr<State> &state,
+	                                     const time::time_t &time,
+	                                     const EventHandler::param_map &params);
+
 	/**
 	 * Remove the given event from the queue.
 	 */
@@ -1,5 +1,6 @@
-// Copyright 2017-2023 the openage authors. See copying.md for legal info.
+// Copyright 2017-2024 the openage authors. See copying.md for legal info.
 
+#include <atomic>
 #include <compare>
 #include <cstring>
 #include <iostream>
@@ -7,7 +8,9 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "log/log.h"
 #include "log/message.h"
@@ -593,4 +596,76 @@ void eventtrigger() {
 	}
 }
 
+
+void command_inbox() {
+	constexpr int producer_count = 4;
+	constexpr int events_per_producer = 500;
+
+	/**
+	 * Records the sequence numbers of executed events per producer.
+	 */
+	class InboxTestClass : public EventHandler {
+	public:
+		InboxTestClass() :
+			EventHandler("inbox", EventHandler::trigger_type::ONCE),
+			executed(producer_count) {}
+
+		void setup_event(const std::shared_ptr<Event> & /*target*/,
+		                 const std::shared_ptr<State> & /*state*/) override {}
+
+		void invoke(EventLoop & /*loop*/,
+		            const std::shared_ptr<EventEntity> & /*target*/,
+		            const std::shared_ptr<State> & /*state*/,
+		            const time::time_t & /*time*/,
+		            const EventHandler::param_map &param) override {
+			this->executed.at(param.get<int>("producer")).push_back(param.get<int>("seq"));
+		}
+
+		time::time_t predict_invoke_time(const std::shared_ptr<EventEntity> & /*target*/,
+		                                 const std::shared_ptr<State> & /*state*/,
+		                                 const time::time_t &at) override {
+			return at;
+		}
+
+		std::vector<std::vector<int>> executed;
+	};
+
+	auto loop = std::make_shared<EventLoop>();
+	auto handler = std::make_shared<InboxTestClass>();
+	loop->add_event_handler(handler);
+	auto state = std::make_shared<TestState>(loop);
+	auto gstate = std::dynamic_pointer_cast<State>(state);
+
+	// producers post while the simulation keeps executing events
+	std::atomic<int> finished_producers = 0;
+	std::vector<std::thread> producers;
+	for (int p = 0; p < producer_count; ++p) {
+		producers.emplace_back([&, p]() {
+			for (int i = 0; i < events_per_producer; ++i) {
+				loop->post_event("inbox", state->objectA, gstate, i, {{"producer", p}, {"seq", i}});
+			}
+			finished_producers += 1;
+		});
+	}
+
+	while (finished_producers < producer_count) {
+		loop->reach_time(events_per_producer, gstate);
+	}
+	for (auto &producer : producers) {
+		producer.join();
+	}
+
+	// requests for unknown handlers are dropped
+	loop->post_event("nonexistent", state->objectA, gstate, 0);
+	loop->reach_time(events_per_producer, gstate);
+
+	for (const auto &executed : handler->executed) {
+		TESTEQUALS(executed.size(), static_cast<size_t>(events_per_producer));
+		for (int i = 0; i < events_per_producer; ++i) {
+			TESTEQUALS(executed[i], i);
+		}
+	}
+	TESTEQUALS(loop->get_queue().get_event_queue().size(), 0u);
+}
+
 } // namespace openage::event::tests
@@ -1,7 +1,9 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2024 the openage authors. See copying.md for legal info.
 
 #include "activity.h"
 
+#include "gamestate/activity/compiled_activity.h"
+
 
 namespace openage::gamestate::activity {
 
@@ -25,4 +27,11 @@ const std::shared_ptr<Node> &Activity::get_start() const {
 	return this->start;
 }
 
+const std::shared_ptr<CompiledActivity> &Activity::get_compiled() const {
+	std::call_once(this->compile_flag, [this]() {
+		this->compiled = std::make_shared<CompiledActivity>(*this);
+	});
+	return this->compiled;
+}
+
 } // namespace openage::gamestate::activity
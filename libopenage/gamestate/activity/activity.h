@@ -4,10 +4,12 @@
 
 #include <cstddef>
 #include <memory>
+#include <mutex>
 #include <string>
 
 
 namespace openage::gamestate::activity {
+class CompiledActivity;
 class Node;
 
 using activity_id = size_t;
@@ -50,6 +52,15 @@ public:
 	 */
 	const std::shared_ptr<Node> &get_start() const;
 
+	/**
+	 * Get the compiled form of the node graph that is executed by the activity system.
+	 *
+	 * The graph is compiled on the first call, so it must not be changed afterwards.
+	 *
+	 * @return Compiled activity.
+	 */
+	const std::shared_ptr<CompiledActivity> &get_compiled() const;
+
 private:
 	/**
 	 * Unique ID.
@@ -65,6 +76,16 @@ private:
 	 * Start node.
 	 */
 	std::shared_ptr<Node> start;
+
+	/**
+	 * Compiled node graph, created on first use.
+	 */
+	mutable std::shared_ptr<CompiledActivity> compiled;
+
+	/**
+	 * Ensures that the graph is only compiled once.
+	 */
+	mutable std::once_flag compile_flag;
 };
 
 } // namespace openage::gamestate::activity
@@ -0,0 +1,191 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "compiled_activity.h"
+
+#include <deque>
+#include <unordered_map>
+
+#include "error/error.h"
+#include "log/message.h"
+
+#include "gamestate/activity/activity.h"
+#include "gamestate/activity/condition/command_in_queue.h"
+#include "gamestate/activity/condition/next_command.h"
+#include "gamestate/activity/event/command_in_queue.h"
+#include "gamestate/activity/start_node.h"
+#include "gamestate/activity/task_system_node.h"
+
+
+namespace openage::gamestate::activity {
+
+namespace {
+
+using condition_fn_t = bool (*)(const time::time_t &,
+                                const std::shared_ptr<gamestate::GameEntity> &);
+
+using primer_fn_t = std::shared_ptr<openage::event::Event> (*)(const time::time_t &,
+                                                               const std::shared_ptr<gamestate::GameEntity> &,
+                                                               const std::shared_ptr<openage::event::EventLoop> &,
+                                                               const std::shared_ptr<gamestate::GameState> &,
+                                                               size_t);
+
+/**
+ * Find the opcode for a condition that wraps a built-in function.
+ */
+condition_op_t condition_op(const condition_t &condition) {
+	auto func = condition.target<condition_fn_t>();
+	if (func == nullptr) {
+		return condition_op_t::CUSTOM;
+	}
+
+	if (*func == &command_in_queue) {
+		return condition_op_t::COMMAND_IN_QUEUE;
+	}
+	if (*func == &next_command_idle) {
+		return condition_op_t::NEXT_COMMAND_IDLE;
+	}
+	if (*func == &next_command_move) {
+		return condition_op_t::NEXT_COMMAND_MOVE;
+	}
+	return condition_op_t::CUSTOM;
+}
+
+/**
+ * Find the opcode for an event primer that wraps a built-in function.
+ */
+primer_op_t primer_op(const event_primer_t &primer) {
+	auto func = primer.target<primer_fn_t>();
+	if (func != nullptr and *func == &primer_command_in_queue) {
+		return primer_op_t::COMMAND_IN_QUEUE;
+	}
+	return primer_op_t::CUSTOM;
+}
+
+} // namespace
+
+
+CompiledActivity::CompiledActivity(const Activity &activity) :
+	start{0} {
+	if (activity.get_start() == nullptr) {
+		throw Error{MSG(err) << "Activity " << activity.get_label() << " has no start node"};
+	}
+
+	// assign an instruction to each reachable node in breadth-first order
+	std::unordered_map<const Node *, pc_t> pcs;
+	std::deque<std::shared_ptr<Node>> pending{activity.get_start()};
+	while (not pending.empty()) {
+		auto node = pending.front();
+		pending.pop_front();
+
+		if (pcs.contains(node.get())) {
+			continue;
+		}
+
+		pcs.emplace(node.get(), static_cast<pc_t>(this->nodes.size()));
+		this->nodes.push_back(node);
+
+		for (const auto &output : node->get_outputs()) {
+			pending.push_back(output.second);
+		}
+	}
+
+	auto pc_of = [&](const std::shared_ptr<Node> &node, node_id_t id) {
+		return pcs.at(node->next(id).get());
+	};
+
+	auto single_next = [&](const std::shared_ptr<Node> &node) {
+		if (node->get_outputs().size() != 1) {
+			throw Error{MSG(err) << "Activity node " << node->str()
+			                     << " must have exactly one output, but has "
+			                     << node->get_outputs().size()};
+		}
+		return pcs.at(node->get_outputs().begin()->second.get());
+	};
+
+	// translate the nodes
+	this->program.reserve(this->nodes.size());
+	for (const auto &node : this->nodes) {
+		Instruction ins{node->get_type()};
+
+		switch (ins.type) {
+		case node_t::START:
+			ins.next = single_next(node);
+			break;
+		case node_t::END:
+			break;
+		case node_t::TASK_CUSTOM: {
+			auto task = std::static_pointer_cast<TaskCustom>(node);
+			ins.func = static_cast<uint32_t>(this->tasks.size());
+			this->tasks.push_back(task->get_task_func());
+			ins.next = single_next(node);
+		} break;
+		case node_t::TASK_SYSTEM: {
+			auto task = std::static_pointer_cast<TaskSystemNode>(node);
+			ins.system_id = task->get_system_id();
+			ins.next = single_next(node);
+		} break;
+		case node_t::XOR_GATE: {
+			auto gate = std::static_pointer_cast<XorGate>(node);
+			if (gate->get_default() == nullptr) {
+				throw Error{MSG(err) << "XorGate " << node->str() << " has no default node"};
+			}
+
+			ins.first = static_cast<uint32_t>(this->gate_branches.size());
+			for (const auto &[next_id, condition] : gate->get_conditions()) {
+				CompiledBranch branch{condition_op(condition), 0, pc_of(node, next_id)};
+				if (branch.op == condition_op_t::CUSTOM) {
+					branch.func = static_cast<uint32_t>(this->conditions.size());
+					this->conditions.push_back(condition);
+				}
+				this->gate_branches.push_back(branch);
+			}
+			ins.count = static_cast<uint32_t>(this->gate_branches.size()) - ins.first;
+			ins.next = pcs.at(gate->get_default().get());
+		} break;
+		case node_t::XOR_EVENT_GATE: {
+			auto gate = std::static_pointer_cast<XorEventGate>(node);
+
+			ins.first = static_cast<uint32_t>(this->gate_event_branches.size());
+			for (const auto &[next_id, primer] : gate->get_primers()) {
+				CompiledEventBranch branch{primer_op(primer), 0, pc_of(node, next_id), next_id};
+				if (branch.op == primer_op_t::CUSTOM) {
+					branch.func = static_cast<uint32_t>(this->primers.size());
+					this->primers.push_back(primer);
+				}
+				this->gate_event_branches.push_back(branch);
+			}
+			ins.count = static_cast<uint32_t>(this->gate_event_branches.size()) - ins.first;
+		} break;
+		default:
+			throw Error{ERR << "Unhandled node type for node " << node->str()};
+		}
+
+		this->program.push_back(ins);
+	}
+}
+
+pc_t CompiledActivity::get_start() const {
+	return this->start;
+}
+
+const std::shared_ptr<Node> &CompiledActivity::get_node(pc_t pc) const {
+	return this->nodes.at(pc);
+}
+
+pc_t CompiledActivity::resume(pc_t pc, node_id_t next_id) const {
+	const Instruction &ins = this->at(pc);
+	const CompiledEventBranch *branches = this->event_branches(ins);
+	for (uint32_t i = 0; i < ins.count; ++i) {
+		if (branches[i].next_id == next_id) {
+			return branches[i].target;
+		}
+	}
+
+	throw Error{MSG(err) << "Node " << this->get_node(pc)->str() << " has no output with id " << next_id};
+}
+
+size_t CompiledActivity::size() const {
+	return this->program.size();
+}
+
+} // namespace openage::gamestate::activity
@@ -0,0 +1,233 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "gamestate/activity/node.h"
+#include "gamestate/activity/task_node.h"
+#include "gamestate/activity/types.h"
+#include "gamestate/activity/xor_event_gate.h"
+#include "gamestate/activity/xor_gate.h"
+#include "gamestate/system/types.h"
+
+
+namespace openage::gamestate::activity {
+
+class Activity;
+
+/**
+ * Index of an instruction in a compiled activity.
+ */
+using pc_t = uint32_t;
+
+/**
+ * Marks an unset program counter.
+ */
+constexpr pc_t invalid_pc = std::numeric_limits<pc_t>::max();
+
+/**
+ * Built-in conditions that are evaluated without calling
+ * through a \p condition_t.
+ */
+enum class condition_op_t : uint8_t {
+	CUSTOM,
+	COMMAND_IN_QUEUE,
+	NEXT_COMMAND_IDLE,
+	NEXT_COMMAND_MOVE,
+};
+
+/**
+ * Built-in event primers that are executed without calling
+ * through an \p event_primer_t.
+ */
+enum class primer_op_t : uint8_t {
+	CUSTOM,
+	COMMAND_IN_QUEUE,
+};
+
+/**
+ * Output of an exclusive gateway.
+ */
+struct CompiledBranch {
+	condition_op_t op;
+	/// index of the condition function for CUSTOM conditions
+	uint32_t func;
+	/// instruction that the branch continues with
+	pc_t target;
+};
+
+/**
+ * Output of an exclusive event gateway.
+ */
+struct CompiledEventBranch {
+	primer_op_t op;
+	/// index of the primer function for CUSTOM primers
+	uint32_t func;
+	/// instruction that the branch continues with
+	pc_t target;
+	/// node ID of the target, passed to the primer
+	node_id_t next_id;
+};
+
+/**
+ * Instruction of a compiled activity. Each node of the graph
+ * becomes one instruction.
+ */
+struct Instruction {
+	node_t type;
+
+	/// system that is run by TASK_SYSTEM
+	system::system_id_t system_id = system::system_id_t::NONE;
+
+	/// next instruction of START, TASK_CUSTOM and TASK_SYSTEM,
+	/// default branch of XOR_GATE
+	pc_t next = invalid_pc;
+
+	/// index of the task function of TASK_CUSTOM
+	uint32_t func = 0;
+
+	/// branches of XOR_GATE and XOR_EVENT_GATE, as [first, first + count)
+	/// in the branch arrays of the activity
+	uint32_t first = 0;
+	uint32_t count = 0;
+};
+
+
+/**
+ * Activity node graph flattened into an index-based program.
+ *
+ * Nodes are stored in one array and reference each other by index.
+ * The built-in conditions and event primers are encoded as opcodes,
+ * only custom ones are called through their function objects.
+ *
+ * A compiled activity is immutable, so game entities with the same
+ * activity share it.
+ */
+class CompiledActivity {
+public:
+	/**
+	 * Compile the node graph of an activity.
+	 *
+	 * Throws if the graph is malformed, e.g. if a node misses an output.
+	 *
+	 * @param activity Activity to compile.
+	 */
+	explicit CompiledActivity(const Activity &activity);
+	~CompiledActivity() = default;
+
+	/**
+	 * Get the instruction of the start node.
+	 */
+	pc_t get_start() const;
+
+	/**
+	 * Get an instruction.
+	 *
+	 * @param pc Index of the instruction.
+	 */
+	const Instruction &at(pc_t pc) const {
+		return this->program[pc];
+	}
+
+	/**
+	 * Get the node that an instruction was compiled from.
+	 *
+	 * @param pc Index of the instruction.
+	 */
+	const std::shared_ptr<Node> &get_node(pc_t pc) const;
+
+	/**
+	 * Get the outputs of an exclusive gateway.
+	 *
+	 * @param ins XOR_GATE instruction.
+	 */
+	const CompiledBranch *branches(const Instruction &ins) const {
+		return this->gate_branches.data() + ins.first;
+	}
+
+	/**
+	 * Get the outputs of an exclusive event gateway.
+	 *
+	 * @param ins XOR_EVENT_GATE instruction.
+	 */
+	const CompiledEventBranch *event_branches(const Instruction &ins) const {
+		return this->gate_event_branches.data() + ins.first;
+	}
+
+	/**
+	 * Find the instruction that an event gateway continues with
+	 * after the event for one of its outputs was triggered.
+	 *
+	 * @param pc Index of the XOR_EVENT_GATE instruction.
+	 * @param next_id Node ID of the output.
+	 *
+	 * @return Index of the output's instruction.
+	 */
+	pc_t resume(pc_t pc, node_id_t next_id) const;
+
+	/**
+	 * Get a custom condition function.
+	 */
+	const condition_t &get_condition(uint32_t func) const {
+		return this->conditions[func];
+	}
+
+	/**
+	 * Get a custom task function.
+	 */
+	const task_func_t &get_task(uint32_t func) const {
+		return this->tasks[func];
+	}
+
+	/**
+	 * Get a custom event primer.
+	 */
+	const event_primer_t &get_primer(uint32_t func) const {
+		return this->primers[func];
+	}
+
+	/**
+	 * Get the number of instructions.
+	 */
+	size_t size() const;
+
+private:
+	/**
+	 * Instructions, one for each node.
+	 */
+	std::vector<Instruction> program;
+
+	/**
+	 * Nodes by instruction index, for debugging and error messages.
+	 */
+	std::vector<std::shared_ptr<Node>> nodes;
+
+	/**
+	 * Outputs of all exclusive gateways.
+	 */
+	std::vector<CompiledBranch> gate_branches;
+
+	/**
+	 * Outputs of all exclusive event gateways.
+	 */
+	std::vector<CompiledEventBranch> gate_event_branches;
+
+	/**
+	 * Custom functions referenced by the instructions.
+	 */
+	std::vector<condition_t> conditions;
+	std::vector<task_func_t> tasks;
+	std::vector<event_primer_t> primers;
+
+	/**
+	 * Instruction of the start node.
+	 */
+	pc_t start;
+};
+
+} // namespace openage::gamestate::activity
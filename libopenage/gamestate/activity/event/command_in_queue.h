@@ -1,4 +1,4 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2024 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -23,13 +23,16 @@ namespace activity {
 /**
  * Primer for command in queue events in the activity system.
  *
+ * Doesn't schedule an event. Instead, the entity is parked on the
+ * command wait list of the game state and woken when a command is sent to it.
+ *
  * @param time Current simulation time.
  * @param entity Game entity.
  * @param loop Event loop that the event is registered on.
  * @param state Game state.
  * @param next_id ID of the next node in the activity graph.
  *
- * @return Scheduled event.
+ * @return Always \p nullptr.
  */
 std::shared_ptr<openage::event::Event> primer_command_in_queue(const time::time_t &,
                                                                const std::shared_ptr<gamestate::GameEntity> &entity,
@@ -1,4 +1,4 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2024 the openage authors. See copying.md for legal info.
 
 #include "node.h"
 
@@ -50,4 +50,8 @@ const std::shared_ptr<Node> &Node::next(node_id_t id) const {
 	return this->outputs.at(id);
 }
 
+const std::unordered_map<node_id_t, std::shared_ptr<Node>> &Node::get_outputs() const {
+	return this->outputs;
+}
+
 } // namespace openage::gamestate::activity
@@ -1,9 +1,11 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2024 the openage authors. See copying.md for legal info.
 
 #include <cstddef>
 #include <functional>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "event/event_loop.h"
 #include "event/evententity.h"
@@ -13,14 +15,23 @@
 #include "error/error.h"
 #include "log/log.h"
 #include "log/message.h"
+#include "testing/testing.h"
 
+#include "gamestate/activity/activity.h"
+#include "gamestate/activity/compiled_activity.h"
+#include "gamestate/activity/condition/command_in_queue.h"
 #include "gamestate/activity/end_node.h"
 #include "gamestate/activity/node.h"
 #include "gamestate/activity/start_node.h"
 #include "gamestate/activity/task_node.h"
+#include "gamestate/activity/task_system_node.h"
 #include "gamestate/activity/types.h"
+#include "gamestate/activity/wait_list.h"
 #include "gamestate/activity/xor_event_gate.h"
 #include "gamestate/activity/xor_gate.h"
+#include "gamestate/component/internal/activity.h"
+#include "gamestate/game_entity.h"
+#include "gamestate/system/activity.h"
 #include "time/time.h"
 
 
@@ -286,4 +297,216 @@ void activity_demo() {
 	loop->reach_time(0, state);
 }
 
+
+void wait_list() {
+	activity::WaitList waiters;
+
+	for (entity_id_t id = 0; id < 100; ++id) {
+		waiters.park(id, id + 1000);
+	}
+	TESTEQUALS(waiters.size(), 100u);
+
+	// parking again replaces the next node
+	waiters.park(7, 5);
+	TESTEQUALS(waiters.size(), 100u);
+	TESTEQUALS(waiters.take(7).value(), 5u);
+	TESTEQUALS(waiters.take(7).has_value(), false);
+
+	// removing entries keeps the others reachable
+	for (entity_id_t id = 0; id < 100; id += 2) {
+		TESTEQUALS(waiters.unpark(id), true);
+	}
+	TESTEQUALS(waiters.unpark(0), false);
+	TESTEQUALS(waiters.size(), 49u);
+	TESTEQUALS(waiters.contains(98), false);
+	TESTEQUALS(waiters.contains(99), true);
+
+	for (entity_id_t id = 1; id < 100; id += 2) {
+		if (id == 7) {
+			continue;
+		}
+		TESTEQUALS(waiters.take(id).value(), id + 1000);
+	}
+	TESTEQUALS(waiters.size(), 0u);
+
+	// waking continues parked entities right away
+	waiters.park(1, 11);
+	waiters.park(2, 12);
+	waiters.park(3, 13);
+	TESTEQUALS(waiters.wake(1).value(), 11u);
+	TESTEQUALS(waiters.wake(1).has_value(), false);
+
+	// inside a batch, woken entities are collected in wake order
+	waiters.begin_batch();
+	TESTEQUALS(waiters.wake(3).has_value(), false);
+	TESTEQUALS(waiters.wake(4).has_value(), false);
+	TESTEQUALS(waiters.wake(2).has_value(), false);
+	auto woken = waiters.end_batch();
+	TESTEQUALS(woken.size(), 2u);
+	TESTEQUALS(woken[0].first, 3u);
+	TESTEQUALS(woken[0].second, 13u);
+	TESTEQUALS(woken[1].first, 2u);
+	TESTEQUALS(waiters.size(), 0u);
+	TESTEQUALS(waiters.end_batch().empty(), true);
+}
+
+
+void compiled_activity() {
+	auto start = std::make_shared<activity::StartNode>(0);
+	auto task = std::make_shared<activity::TaskCustom>(1);
+	auto xor_node = std::make_shared<activity::XorGate>(2);
+	auto event_node = std::make_shared<activity::XorEventGate>(3);
+	auto system_node = std::make_shared<activity::TaskSystemNode>(4);
+	auto end = std::make_shared<activity::EndNode>(5);
+
+	int task_runs = 0;
+	start->add_output(task);
+	task->add_output(xor_node);
+	task->set_task_func([&](const time::time_t &,
+	                        const std::shared_ptr<gamestate::GameEntity> &) {
+		task_runs += 1;
+	});
+
+	activity::condition_t loop_back = [&](const time::time_t &,
+	                                      const std::shared_ptr<gamestate::GameEntity> &) {
+		return task_runs < 3;
+	};
+	xor_node->add_output(task, loop_back);
+	xor_node->add_output(end, gamestate::activity::command_in_queue);
+	xor_node->set_default(event_node);
+
+	activity::event_primer_t primer = [](const time::time_t &,
+	                                     const std::shared_ptr<gamestate::GameEntity> &,
+	                                     const std::shared_ptr<event::EventLoop> &,
+	                                     const std::shared_ptr<gamestate::GameState> &,
+	                                     size_t) {
+		return nullptr;
+	};
+	event_node->add_output(system_node, primer);
+	system_node->add_output(end);
+	system_node->set_system_id(system::system_id_t::IDLE);
+
+	auto activity = std::make_shared<activity::Activity>(0, start);
+	auto &program = *activity->get_compiled();
+
+	// compiled once and shared
+	TESTEQUALS(activity->get_compiled().get(), &program);
+	TESTEQUALS(program.size(), 6u);
+
+	// follow the jumps from the start
+	activity::pc_t pc = program.get_start();
+	TESTEQUALS(program.at(pc).type == activity::node_t::START, true);
+	pc = program.at(pc).next;
+	TESTEQUALS(program.at(pc).type == activity::node_t::TASK_CUSTOM, true);
+	program.get_task(program.at(pc).func)(0, nullptr);
+	TESTEQUALS(task_runs, 1);
+
+	activity::pc_t task_pc = pc;
+	pc = program.at(pc).next;
+	const activity::Instruction &gate = program.at(pc);
+	TESTEQUALS(gate.type == activity::node_t::XOR_GATE, true);
+	TESTEQUALS(gate.count, 2u);
+
+	// conditions keep the order of the output node IDs
+	auto branches = program.branches(gate);
+	TESTEQUALS(branches[0].op == activity::condition_op_t::CUSTOM, true);
+	TESTEQUALS(branches[0].target, task_pc);
+	TESTEQUALS(program.get_condition(branches[0].func)(0, nullptr), true);
+	TESTEQUALS(branches[1].op == activity::condition_op_t::COMMAND_IN_QUEUE, true);
+	TESTEQUALS(program.at(branches[1].target).type == activity::node_t::END, true);
+
+	pc = gate.next;
+	const activity::Instruction &event_gate = program.at(pc);
+	TESTEQUALS(event_gate.type == activity::node_t::XOR_EVENT_GATE, true);
+	TESTEQUALS(event_gate.count, 1u);
+	TESTEQUALS(program.event_branches(event_gate)[0].op == activity::primer_op_t::CUSTOM, true);
+	TESTEQUALS(program.event_branches(event_gate)[0].next_id, 4u);
+
+	pc = program.resume(pc, 4);
+	TESTEQUALS(program.at(pc).type == activity::node_t::TASK_SYSTEM, true);
+	TESTEQUALS(program.at(pc).system_id == system::system_id_t::IDLE, true);
+	TESTEQUALS(program.get_node(pc) == system_node, true);
+	TESTTHROWS(program.resume(gate.next, 5));
+
+	// malformed graphs are rejected
+	auto bad_start = std::make_shared<activity::StartNode>(0);
+	auto bad_gate = std::make_shared<activity::XorGate>(1);
+	bad_start->add_output(bad_gate);
+	bad_gate->add_output(std::make_shared<activity::EndNode>(2), loop_back);
+	TESTTHROWS(activity::Activity(0, bad_start).get_compiled());
+}
+
+
+void batch_activity() {
+	auto start = std::make_shared<activity::StartNode>(0);
+	auto xor_node = std::make_shared<activity::XorGate>(1);
+	auto task_even = std::make_shared<activity::TaskCustom>(2);
+	auto task_odd = std::make_shared<activity::TaskCustom>(3);
+	auto task_all = std::make_shared<activity::TaskCustom>(4);
+	auto end = std::make_shared<activity::EndNode>(5);
+
+	// (task node ID, entity ID) of each task run
+	std::vector<std::pair<size_t, entity_id_t>> runs;
+	auto log_task = [&](size_t task_id) {
+		return [&runs, task_id](const time::time_t &,
+		                        const std::shared_ptr<gamestate::GameEntity> &entity) {
+			runs.emplace_back(task_id, entity->get_id());
+		};
+	};
+
+	start->add_output(xor_node);
+	xor_node->add_output(task_even, [](const time::time_t &,
+	                                   const std::shared_ptr<gamestate::GameEntity> &entity) {
+		return entity->get_id() % 2 == 0;
+	});
+	xor_node->set_default(task_odd);
+	task_even->add_output(task_all);
+	task_even->set_task_func(log_task(2));
+	task_odd->add_output(task_all);
+	task_odd->set_task_func(log_task(3));
+	task_all->add_output(end);
+	task_all->set_task_func(log_task(4));
+
+	auto loop = std::make_shared<event::EventLoop>();
+	auto activity = std::make_shared<activity::Activity>(0, start);
+
+	std::vector<system::ActivityTarget> targets;
+	std::vector<std::shared_ptr<component::Activity>> components;
+	for (entity_id_t id = 0; id < 4; ++id) {
+		auto entity = std::make_shared<GameEntity>(id);
+		auto component = std::make_shared<component::Activity>(loop, activity);
+		component->init(0);
+		entity->add_component(component);
+		components.push_back(component);
+		targets.push_back(system::ActivityTarget{entity});
+	}
+
+	// entities split up at the gateway and are merged again at the common task
+	system::Activity::advance(0, targets, loop, nullptr);
+
+	std::vector<std::pair<size_t, entity_id_t>> expected{
+		{2, 0},
+		{2, 2},
+		{3, 1},
+		{3, 3},
+		{4, 0},
+		{4, 2},
+		{4, 1},
+		{4, 3},
+	};
+	TESTEQUALS(runs == expected, true);
+
+	for (const auto &component : components) {
+		TESTEQUALS(component->get_node(0) == end, true);
+	}
+
+	// the single entity version runs the same program
+	runs.clear();
+	components[1]->init(1);
+	system::Activity::advance(1, targets[1].entity, loop, nullptr);
+	TESTEQUALS(runs.size(), 2u);
+	TESTEQUALS(runs[0].first, 3u);
+	TESTEQUALS(runs[1].first, 4u);
+}
+
 } // namespace openage::gamestate::tests
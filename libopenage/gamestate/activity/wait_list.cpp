@@ -0,0 +1,81 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "wait_list.h"
+
+#include <utility>
+
+
+namespace openage::gamestate::activity {
+
+void WaitList::park(entity_id_t entity, node_id_t next_id) {
+	auto it = this->index.find(entity);
+	if (it != std::end(this->index)) {
+		this->waiters[it->second].next_id = next_id;
+		return;
+	}
+
+	this->index.emplace(entity, this->waiters.size());
+	this->waiters.push_back({entity, next_id});
+}
+
+bool WaitList::unpark(entity_id_t entity) {
+	return this->take(entity).has_value();
+}
+
+std::optional<node_id_t> WaitList::take(entity_id_t entity) {
+	auto it = this->index.find(entity);
+	if (it == std::end(this->index)) {
+		return std::nullopt;
+	}
+
+	size_t pos = it->second;
+	node_id_t next_id = this->waiters[pos].next_id;
+	this->index.erase(it);
+
+	// fill the gap with the last waiter
+	if (pos != this->waiters.size() - 1) {
+		this->waiters[pos] = this->waiters.back();
+		this->index[this->waiters[pos].entity] = pos;
+	}
+	this->waiters.pop_back();
+
+	return next_id;
+}
+
+std::optional<node_id_t> WaitList::wake(entity_id_t entity) {
+	auto next_id = this->take(entity);
+	if (next_id.has_value() and this->batching) {
+		this->woken.emplace_back(entity, next_id.value());
+		return std::nullopt;
+	}
+
+	return next_id;
+}
+
+void WaitList::begin_batch() {
+	this->batching = true;
+}
+
+std::vector<std::pair<entity_id_t, node_id_t>> WaitList::end_batch() {
+	this->batching = false;
+	return std::exchange(this->woken, {});
+}
+
+std::optional<node_id_t> WaitList::get(entity_id_t entity) const {
+	auto it = this->index.find(entity);
+	if (it == std::end(this->index)) {
+		return std::nullopt;
+	}
+
+	return this->waiters[it->second].next_id;
+}
+
+bool WaitList::contains(entity_id_t entity) const {
+	return this->index.contains(entity);
+}
+
+size_t WaitList::size() const {
+	return this->waiters.size();
+}
+
+} // namespace openage::gamestate::activity
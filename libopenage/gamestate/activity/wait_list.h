@@ -0,0 +1,135 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "gamestate/activity/node.h"
+#include "gamestate/types.h"
+
+
+namespace openage::gamestate::activity {
+
+/**
+ * Game entities that are parked on an event gate until a condition
+ * is fulfilled, e.g. until a command arrives in their command queue.
+ *
+ * Parked entities don't have any scheduled events. Instead, the component
+ * whose change fulfills the condition wakes the entity, which continues its
+ * activity directly. This keeps idle entities out of the event queue.
+ */
+class WaitList {
+public:
+	WaitList() = default;
+	~WaitList() = default;
+
+	/**
+	 * Park a game entity.
+	 *
+	 * If the entity is already parked, its next node is replaced.
+	 *
+	 * @param entity ID of the game entity.
+	 * @param next_id ID of the node that the activity continues with when woken.
+	 */
+	void park(entity_id_t entity, node_id_t next_id);
+
+	/**
+	 * Remove a game entity without waking it, e.g. because the activity
+	 * continued on another branch of the event gate.
+	 *
+	 * @param entity ID of the game entity.
+	 *
+	 * @return true if the entity was parked.
+	 */
+	bool unpark(entity_id_t entity);
+
+	/**
+	 * Remove a game entity for waking it.
+	 *
+	 * @param entity ID of the game entity.
+	 *
+	 * @return ID of the node that the activity continues with,
+	 *         or nothing if the entity is not parked.
+	 */
+	std::optional<node_id_t> take(entity_id_t entity);
+
+	/**
+	 * Wake a game entity because its condition is fulfilled.
+	 *
+	 * Inside a batch, the entity is collected for \p end_batch() instead of
+	 * being returned.
+	 *
+	 * @param entity ID of the game entity.
+	 *
+	 * @return ID of the node that the activity continues with right away,
+	 *         or nothing if the entity is not parked or was collected.
+	 */
+	std::optional<node_id_t> wake(entity_id_t entity);
+
+	/**
+	 * Collect the entities that are woken from now on, so that
+	 * their activities can be continued in one batch.
+	 */
+	void begin_batch();
+
+	/**
+	 * Stop collecting woken entities.
+	 *
+	 * @return Entities woken since \p begin_batch() and the nodes
+	 *         they continue with, in the order they were woken.
+	 */
+	std::vector<std::pair<entity_id_t, node_id_t>> end_batch();
+
+	/**
+	 * Get the node that a parked game entity continues with.
+	 *
+	 * @param entity ID of the game entity.
+	 *
+	 * @return ID of the node, or nothing if the entity is not parked.
+	 */
+	std::optional<node_id_t> get(entity_id_t entity) const;
+
+	/**
+	 * Check if a game entity is parked.
+	 *
+	 * @param entity ID of the game entity.
+	 */
+	bool contains(entity_id_t entity) const;
+
+	/**
+	 * Get the number of parked game entities.
+	 */
+	size_t size() const;
+
+private:
+	struct Waiter {
+		entity_id_t entity;
+		node_id_t next_id;
+	};
+
+	/**
+	 * Parked entities, stored densely.
+	 */
+	std::vector<Waiter> waiters;
+
+	/**
+	 * Index into \p waiters by entity ID.
+	 */
+	std::unordered_map<entity_id_t, size_t> index;
+
+	/**
+	 * true if woken entities are collected for a batch.
+	 */
+	bool batching = false;
+
+	/**
+	 * Entities woken in the current batch.
+	 */
+	std::vector<std::pair<entity_id_t, node_id_t>> woken;
+};
+
+} // namespace openage::gamestate::activity
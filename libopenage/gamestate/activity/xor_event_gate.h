@@ -40,7 +40,8 @@ namespace activity {
  * @param state Game state.
  * @param next_id ID of the next node to visit. This is passed as an event parameter.
  *
- * @return Event registered on the event loop.
+ * @return Event registered on the event loop, or \p nullptr if the primer
+ *         parked the entity on a wait list instead.
  */
 using event_primer_t = std::function<std::shared_ptr<openage::event::Event>(const time::time_t &,
                                                                             const std::shared_ptr<gamestate::GameEntity> &,
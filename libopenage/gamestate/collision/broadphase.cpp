@@ -0,0 +1,243 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "broadphase.h"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <utility>
+
+#include "error/error.h"
+#include "job/job_manager.h"
+
+
+namespace openage::gamestate::collision {
+
+namespace {
+
+/**
+ * Minimum number of cells searched by one job.
+ */
+constexpr size_t cells_per_job = 64;
+
+} // namespace
+
+
+Broadphase::Broadphase(const coord::phys_t &cell_size) :
+	cell_size{cell_size.get_raw_value()},
+	reach{1},
+	max_radius{0},
+	bodies{},
+	order{},
+	cells{},
+	cell_index{} {
+	if (this->cell_size <= 0) {
+		throw Error{MSG(err) << "Broadphase cell size must be positive, got " << cell_size};
+	}
+}
+
+void Broadphase::clear() {
+	this->bodies.clear();
+	this->order.clear();
+	this->cells.clear();
+	this->cell_index.clear();
+	this->max_radius = 0;
+	this->reach = 1;
+}
+
+void Broadphase::insert(entity_id_t entity,
+                        const coord::phys2 &position,
+                        const coord::phys_t &radius) {
+	this->bodies.push_back(body{entity, position, radius});
+}
+
+void Broadphase::insert(entity_id_t entity,
+                        const curve::Continuous<coord::phys3> &positions,
+                        const time::time_t &time,
+                        const coord::phys_t &radius) {
+	this->insert(entity, positions.get(time).to_phys2(), radius);
+}
+
+void Broadphase::build() {
+	if (this->bodies.size() > std::numeric_limits<uint32_t>::max()) [[unlikely]] {
+		throw Error{MSG(err) << "Too many bodies in broadphase: " << this->bodies.size()};
+	}
+
+	this->order.clear();
+	this->cells.clear();
+	this->cell_index.clear();
+	this->max_radius = 0;
+
+	std::vector<std::pair<uint64_t, uint32_t>> keys;
+	keys.reserve(this->bodies.size());
+	for (uint32_t i = 0; i < this->bodies.size(); ++i) {
+		auto &body = this->bodies[i];
+		keys.emplace_back(cell_key(this->to_cell(body.position.ne), this->to_cell(body.position.se)), i);
+		this->max_radius = std::max(this->max_radius, body.radius);
+	}
+
+	// the key sorts by row, then by column, then by insertion order
+	std::sort(std::begin(keys), std::end(keys));
+
+	this->order.reserve(keys.size());
+	for (uint32_t i = 0; i < keys.size(); ++i) {
+		auto &[key, index] = keys[i];
+		if (this->cells.empty() or cell_key(this->cells.back().x, this->cells.back().y) != key) {
+			auto &pos = this->bodies[index].position;
+			this->cell_index.emplace(key, this->cells.size());
+			this->cells.push_back(cell{this->to_cell(pos.ne), this->to_cell(pos.se), i, i});
+		}
+		this->order.push_back(index);
+		this->cells.back().end = i + 1;
+	}
+
+	// overlapping bodies are at most two radii apart
+	auto diameter = 2 * this->max_radius.get_raw_value();
+	this->reach = static_cast<int32_t>(std::max<int64_t>(1, (diameter + this->cell_size - 1) / this->cell_size));
+}
+
+const std::vector<body> &Broadphase::get_bodies() const {
+	return this->bodies;
+}
+
+std::vector<size_t> Broadphase::query(const coord::phys2 &center,
+                                      const coord::phys_t &radius) const {
+	std::vector<size_t> result;
+
+	body circle{0, center, radius};
+	auto extent = radius + this->max_radius;
+	auto min_x = this->to_cell(center.ne - extent);
+	auto max_x = this->to_cell(center.ne + extent);
+	auto min_y = this->to_cell(center.se - extent);
+	auto max_y = this->to_cell(center.se + extent);
+
+	for (int64_t y = min_y; y <= max_y; ++y) {
+		for (int64_t x = min_x; x <= max_x; ++x) {
+			auto key = cell_key(static_cast<int32_t>(x), static_cast<int32_t>(y));
+			auto it = this->cell_index.find(key);
+			if (it == std::end(this->cell_index)) {
+				continue;
+			}
+
+			auto &cell = this->cells[it->second];
+			for (auto i = cell.begin; i < cell.end; ++i) {
+				if (this->overlaps(circle, this->bodies[this->order[i]])) {
+					result.push_back(this->order[i]);
+				}
+			}
+		}
+	}
+
+	return result;
+}
+
+std::vector<contact> Broadphase::find_contacts(const std::shared_ptr<job::JobManager> &job_mgr) const {
+	std::vector<contact> result;
+
+	if (job_mgr == nullptr or this->cells.size() <= cells_per_job) {
+		this->find_contacts(0, this->cells.size(), result);
+		return result;
+	}
+
+	std::vector<job::Job<std::vector<contact>>> jobs;
+	for (size_t begin = 0; begin < this->cells.size(); begin += cells_per_job) {
+		size_t end = std::min(begin + cells_per_job, this->cells.size());
+		jobs.push_back(job_mgr->enqueue<std::vector<contact>>([this, begin, end]() {
+			std::vector<contact> contacts;
+			this->find_contacts(begin, end, contacts);
+			return contacts;
+		}));
+	}
+
+	// concatenate in cell order so that the result does not depend on scheduling
+	for (auto &job : jobs) {
+		while (not job.is_finished()) {
+			std::this_thread::yield();
+		}
+		auto contacts = job.get_result();
+		result.insert(std::end(result), std::begin(contacts), std::end(contacts));
+	}
+
+	return result;
+}
+
+int32_t Broadphase::to_cell(const coord::phys_t &pos) const {
+	auto raw = pos.get_raw_value();
+	auto cell = raw / this->cell_size;
+	if (raw % this->cell_size < 0) {
+		// round towards negative infinity
+		cell -= 1;
+	}
+
+	return static_cast<int32_t>(std::clamp<int64_t>(cell,
+	                                                std::numeric_limits<int32_t>::min(),
+	                                                std::numeric_limits<int32_t>::max()));
+}
+
+uint64_t Broadphase::cell_key(int32_t x, int32_t y) {
+	// offset the coordinates so that keys sort like (y, x)
+	auto ux = static_cast<uint64_t>(static_cast<int64_t>(x) - std::numeric_limits<int32_t>::min());
+	auto uy = static_cast<uint64_t>(static_cast<int64_t>(y) - std::numeric_limits<int32_t>::min());
+	return (uy << 32) | ux;
+}
+
+void Broadphase::find_contacts(size_t begin, size_t end, std::vector<contact> &result) const {
+	auto add_contact = [&](uint32_t a, uint32_t b) {
+		if (this->overlaps(this->bodies[a], this->bodies[b])) {
+			result.push_back(contact{std::min(a, b), std::max(a, b)});
+		}
+	};
+
+	std::vector<uint32_t> neighbours;
+	for (size_t c = begin; c < end; ++c) {
+		auto &cell = this->cells[c];
+
+		// only visit the neighbours after this cell so that
+		// every pair of cells is compared once
+		neighbours.clear();
+		for (int64_t dy = 0; dy <= this->reach; ++dy) {
+			for (int64_t dx = -this->reach; dx <= this->reach; ++dx) {
+				if (dy == 0 and dx <= 0) {
+					continue;
+				}
+
+				auto key = cell_key(static_cast<int32_t>(cell.x + dx), static_cast<int32_t>(cell.y + dy));
+				auto it = this->cell_index.find(key);
+				if (it != std::end(this->cell_index)) {
+					neighbours.push_back(it->second);
+				}
+			}
+		}
+
+		for (auto i = cell.begin; i < cell.end; ++i) {
+			auto a = this->order[i];
+
+			// same cell
+			for (auto j = i + 1; j < cell.end; ++j) {
+				add_contact(a, this->order[j]);
+			}
+
+			for (auto n : neighbours) {
+				auto &other = this->cells[n];
+				for (auto j = other.begin; j < other.end; ++j) {
+					add_contact(a, this->order[j]);
+				}
+			}
+		}
+	}
+}
+
+bool Broadphase::overlaps(const body &a, const body &b) const {
+	auto distance = (a.radius + b.radius).get_raw_value();
+	auto dx = a.position.ne.get_raw_value() - b.position.ne.get_raw_value();
+	auto dy = a.position.se.get_raw_value() - b.position.se.get_raw_value();
+
+	// rejecting far away bodies first keeps the squares below from overflowing
+	if (dx >= distance or -dx >= distance or dy >= distance or -dy >= distance) {
+		return false;
+	}
+
+	return dx * dx + dy * dy < distance * distance;
+}
+
+} // namespace openage::gamestate::collision
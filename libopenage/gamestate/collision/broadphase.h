@@ -0,0 +1,213 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "coord/phys.h"
+#include "curve/continuous.h"
+#include "gamestate/types.h"
+#include "time/time.h"
+
+
+namespace openage {
+
+namespace job {
+class JobManager;
+}
+
+namespace gamestate::collision {
+
+/**
+ * Circular collision body of a game entity at one point in time.
+ */
+struct body {
+	/// ID of the game entity
+	entity_id_t entity;
+	/// center of the body
+	coord::phys2 position;
+	/// radius of the body
+	coord::phys_t radius;
+};
+
+
+/**
+ * Pair of overlapping bodies.
+ */
+struct contact {
+	/// index of the first body in \p Broadphase::get_bodies()
+	size_t a;
+	/// index of the second body in \p Broadphase::get_bodies()
+	size_t b;
+};
+
+
+/**
+ * Uniform grid over the ground plane for finding overlapping game entities.
+ *
+ * Bodies are sampled from the position curves of game entities at a point
+ * in time and sorted into square cells by their center. Overlap tests then
+ * only compare bodies in the same and the neighbouring cells.
+ *
+ * The grid is rebuilt from scratch for every time it is queried at.
+ * Results are deterministic, i.e. they only depend on the inserted bodies
+ * and their insertion order, not on the number of threads used.
+ */
+class Broadphase {
+public:
+	/**
+	 * Create a new broadphase grid.
+	 *
+	 * @param cell_size Side length of the grid cells. Should be at least twice
+	 *                  the radius of most bodies.
+	 */
+	Broadphase(const coord::phys_t &cell_size);
+
+	~Broadphase() = default;
+
+	/**
+	 * Remove all bodies.
+	 */
+	void clear();
+
+	/**
+	 * Add a body.
+	 *
+	 * @param entity ID of the game entity.
+	 * @param position Center of the body.
+	 * @param radius Radius of the body.
+	 */
+	void insert(entity_id_t entity,
+	            const coord::phys2 &position,
+	            const coord::phys_t &radius);
+
+	/**
+	 * Add a body at the position of a game entity at a given time.
+	 *
+	 * @param entity ID of the game entity.
+	 * @param positions Position curve of the game entity.
+	 * @param time Time at which the position is sampled.
+	 * @param radius Radius of the body.
+	 */
+	void insert(entity_id_t entity,
+	            const curve::Continuous<coord::phys3> &positions,
+	            const time::time_t &time,
+	            const coord::phys_t &radius);
+
+	/**
+	 * Sort the bodies into the grid cells.
+	 *
+	 * Must be called after inserting bodies and before querying.
+	 */
+	void build();
+
+	/**
+	 * Get the bodies in insertion order.
+	 *
+	 * @return Bodies.
+	 */
+	const std::vector<body> &get_bodies() const;
+
+	/**
+	 * Find the bodies that overlap a circle.
+	 *
+	 * @param center Center of the circle.
+	 * @param radius Radius of the circle.
+	 *
+	 * @return Indices of the overlapping bodies in \p get_bodies().
+	 */
+	std::vector<size_t> query(const coord::phys2 &center,
+	                          const coord::phys_t &radius) const;
+
+	/**
+	 * Find all pairs of overlapping bodies.
+	 *
+	 * Cells are processed in parallel if a job manager is given.
+	 *
+	 * @param job_mgr Running job manager, or \p nullptr to search in the calling thread.
+	 *
+	 * @return Overlapping pairs, ordered by the cell of their first body.
+	 */
+	std::vector<contact> find_contacts(const std::shared_ptr<job::JobManager> &job_mgr = nullptr) const;
+
+private:
+	/**
+	 * Range of bodies in one cell.
+	 */
+	struct cell {
+		int32_t x;
+		int32_t y;
+		/// first index of the cell's bodies in \p order
+		uint32_t begin;
+		/// end index of the cell's bodies in \p order
+		uint32_t end;
+	};
+
+	/**
+	 * Get the grid coordinate of a position on one axis.
+	 */
+	int32_t to_cell(const coord::phys_t &pos) const;
+
+	/**
+	 * Get the key of a cell in \p cell_index.
+	 */
+	static uint64_t cell_key(int32_t x, int32_t y);
+
+	/**
+	 * Find the overlapping pairs of the bodies in a range of cells
+	 * and their neighbours.
+	 *
+	 * @param begin First index in \p cells.
+	 * @param end End index in \p cells.
+	 * @param result Vector the pairs are appended to.
+	 */
+	void find_contacts(size_t begin, size_t end, std::vector<contact> &result) const;
+
+	/**
+	 * Check whether two bodies overlap.
+	 */
+	bool overlaps(const body &a, const body &b) const;
+
+	/**
+	 * Side length of the cells in raw fixed point units.
+	 */
+	int64_t cell_size;
+
+	/**
+	 * Number of neighbouring cells in each direction that
+	 * can contain overlapping bodies.
+	 */
+	int32_t reach;
+
+	/**
+	 * Largest radius of all bodies.
+	 */
+	coord::phys_t max_radius;
+
+	/**
+	 * Bodies in insertion order.
+	 */
+	std::vector<body> bodies;
+
+	/**
+	 * Indices of the bodies, sorted by their cell.
+	 */
+	std::vector<uint32_t> order;
+
+	/**
+	 * Cells that contain bodies, sorted by row and column.
+	 */
+	std::vector<cell> cells;
+
+	/**
+	 * Index of each cell in \p cells by its cell key.
+	 */
+	std::unordered_map<uint64_t, uint32_t> cell_index;
+};
+
+} // namespace gamestate::collision
+} // namespace openage
@@ -0,0 +1,127 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "separation.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "curve/continuous.h"
+#include "gamestate/component/internal/position.h"
+#include "gamestate/component/types.h"
+#include "gamestate/game_entity.h"
+#include "gamestate/game_state.h"
+
+
+namespace openage::gamestate::collision {
+
+namespace {
+
+/**
+ * Cells fit two entities side by side.
+ */
+constexpr int cell_size_factor = 2;
+
+/**
+ * Golden angle in radians. Spreads the push directions of
+ * entities that are at the same position.
+ */
+constexpr double golden_angle = 2.399963229728653;
+
+} // namespace
+
+
+Separation::Separation(const coord::phys_t &radius,
+                       const time::time_t &interval,
+                       const std::shared_ptr<job::JobManager> &job_mgr) :
+	radius{radius},
+	interval{interval},
+	job_mgr{job_mgr},
+	grid{radius * cell_size_factor} {}
+
+size_t Separation::step(const std::shared_ptr<GameState> &state,
+                        const time::time_t &time) {
+	std::vector<std::shared_ptr<GameEntity>> entities;
+	for (const auto &[id, entity] : state->get_game_entities()) {
+		if (entity->has_component(component::component_t::POSITION)
+		    and entity->has_component(component::component_t::MOVE)) {
+			entities.push_back(entity);
+		}
+	}
+
+	// the order of the hash map is not part of the game state
+	std::sort(std::begin(entities), std::end(entities), [](const auto &a, const auto &b) {
+		return a->get_id() < b->get_id();
+	});
+
+	return this->step(entities, time);
+}
+
+size_t Separation::step(const std::vector<std::shared_ptr<GameEntity>> &entities,
+                        const time::time_t &time) {
+	std::vector<component::Position *> positions;
+	positions.reserve(entities.size());
+
+	this->grid.clear();
+	for (const auto &entity : entities) {
+		auto position = std::dynamic_pointer_cast<component::Position>(
+			entity->get_component(component::component_t::POSITION));
+		this->grid.insert(entity->get_id(), position->get_positions(), time, this->radius);
+		positions.push_back(position.get());
+	}
+	this->grid.build();
+
+	auto contacts = this->grid.find_contacts(this->job_mgr);
+	if (contacts.empty()) {
+		return 0;
+	}
+
+	auto &bodies = this->grid.get_bodies();
+	std::vector<coord::phys2_delta> pushes(bodies.size(), coord::phys2_delta{0, 0});
+	for (const auto &contact : contacts) {
+		auto &a = bodies[contact.a];
+		auto &b = bodies[contact.b];
+
+		auto distance = b.position - a.position;
+		auto length = distance.length();
+		auto overlap = (a.radius + b.radius).to_double() - length;
+
+		coord::phys2_delta push;
+		if (length > 0) {
+			push = distance.normalize(overlap / 2);
+		}
+		else {
+			auto angle = static_cast<double>(b.entity) * golden_angle;
+			push = coord::phys2_delta{coord::phys_t::from_double(std::cos(angle) * overlap / 2),
+			                          coord::phys_t::from_double(std::sin(angle) * overlap / 2)};
+		}
+
+		pushes[contact.a] = pushes[contact.a] - push;
+		pushes[contact.b] = pushes[contact.b] + push;
+	}
+
+	size_t pushed = 0;
+	for (size_t i = 0; i < bodies.size(); ++i) {
+		auto push = pushes[i];
+		if (push.ne == 0 and push.se == 0) {
+			continue;
+		}
+
+		// entities in dense crowds are pushed from many sides,
+		// so they only move a bit per step to avoid overshooting
+		auto length = push.length();
+		if (length > this->radius.to_double()) {
+			push = push.normalize(this->radius.to_double());
+		}
+
+		positions[i]->displace(time, push.to_phys3(), this->interval);
+		pushed += 1;
+	}
+
+	return pushed;
+}
+
+const time::time_t &Separation::get_interval() const {
+	return this->interval;
+}
+
+} // namespace openage::gamestate::collision
@@ -0,0 +1,104 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "coord/phys.h"
+#include "gamestate/collision/broadphase.h"
+#include "time/time.h"
+
+
+namespace openage {
+
+namespace job {
+class JobManager;
+}
+
+namespace gamestate {
+class GameEntity;
+class GameState;
+
+namespace collision {
+
+/**
+ * Pushes overlapping game entities apart.
+ *
+ * Every step samples the positions of the game entities, finds the
+ * overlapping ones with a \p Broadphase and moves each entity of an
+ * overlapping pair away from the other by half of their overlap. The push
+ * is applied over one step interval by shifting the entity's position
+ * curve, so movement destinations are shifted along with it.
+ */
+class Separation {
+public:
+	/**
+	 * Create a new separation step.
+	 *
+	 * @param radius Radius of the game entities.
+	 * @param interval Time between two steps.
+	 * @param job_mgr Running job manager for searching the grid in parallel.
+	 *                If this is \p nullptr, the search runs in the calling thread.
+	 */
+	Separation(const coord::phys_t &radius,
+	           const time::time_t &interval,
+	           const std::shared_ptr<job::JobManager> &job_mgr = nullptr);
+
+	~Separation() = default;
+
+	/**
+	 * Separate all game entities in the game state that can move.
+	 *
+	 * @param state Game state.
+	 * @param time Time of the step.
+	 *
+	 * @return Number of game entities that were pushed.
+	 */
+	size_t step(const std::shared_ptr<GameState> &state,
+	            const time::time_t &time);
+
+	/**
+	 * Separate game entities.
+	 *
+	 * @param entities Game entities. They must have a position component.
+	 * @param time Time of the step.
+	 *
+	 * @return Number of game entities that were pushed.
+	 */
+	size_t step(const std::vector<std::shared_ptr<GameEntity>> &entities,
+	            const time::time_t &time);
+
+	/**
+	 * Get the time between two steps.
+	 *
+	 * @return Step interval.
+	 */
+	const time::time_t &get_interval() const;
+
+private:
+	/**
+	 * Radius of the game entities.
+	 */
+	coord::phys_t radius;
+
+	/**
+	 * Time between two steps.
+	 */
+	time::time_t interval;
+
+	/**
+	 * Job manager for searching the grid.
+	 */
+	std::shared_ptr<job::JobManager> job_mgr;
+
+	/**
+	 * Grid of the game entities, reused between steps.
+	 */
+	Broadphase grid;
+};
+
+} // namespace collision
+} // namespace gamestate
+} // namespace openage
@@ -0,0 +1,251 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "coord/phys.h"
+#include "error/error.h"
+#include "event/event_loop.h"
+#include "gamestate/collision/broadphase.h"
+#include "gamestate/collision/separation.h"
+#include "gamestate/component/internal/position.h"
+#include "gamestate/game_entity.h"
+#include "job/job_manager.h"
+#include "log/log.h"
+#include "testing/testing.h"
+
+
+namespace openage::gamestate::tests {
+
+namespace {
+
+/**
+ * Create a broadphase grid with randomly placed bodies.
+ */
+collision::Broadphase random_grid(size_t count, double area, unsigned int seed) {
+	std::mt19937 rng{seed};
+	std::uniform_real_distribution<double> pos{-area / 2, area / 2};
+	std::uniform_real_distribution<double> radius{0.1, 0.4};
+
+	collision::Broadphase grid{coord::phys_t::from_double(0.5)};
+	for (size_t i = 0; i < count; ++i) {
+		grid.insert(i,
+		            coord::phys2{coord::phys_t::from_double(pos(rng)), coord::phys_t::from_double(pos(rng))},
+		            coord::phys_t::from_double(radius(rng)));
+	}
+	grid.build();
+
+	return grid;
+}
+
+/**
+ * Find the overlapping pairs by comparing all bodies.
+ */
+std::vector<std::pair<size_t, size_t>> brute_force_contacts(const collision::Broadphase &grid) {
+	std::vector<std::pair<size_t, size_t>> result;
+	auto &bodies = grid.get_bodies();
+	for (size_t a = 0; a < bodies.size(); ++a) {
+		for (size_t b = a + 1; b < bodies.size(); ++b) {
+			auto distance = (bodies[a].position - bodies[b].position).length();
+			if (distance < (bodies[a].radius + bodies[b].radius).to_double()) {
+				result.emplace_back(a, b);
+			}
+		}
+	}
+	return result;
+}
+
+std::vector<std::pair<size_t, size_t>> sorted_pairs(const std::vector<collision::contact> &contacts) {
+	std::vector<std::pair<size_t, size_t>> result;
+	for (auto &contact : contacts) {
+		result.emplace_back(contact.a, contact.b);
+	}
+	std::sort(std::begin(result), std::end(result));
+	return result;
+}
+
+/**
+ * Create game entities with a position component.
+ */
+std::vector<std::shared_ptr<GameEntity>> make_units(const std::shared_ptr<event::EventLoop> &loop,
+                                                    const std::vector<coord::phys3> &positions) {
+	std::vector<std::shared_ptr<GameEntity>> units;
+	for (size_t i = 0; i < positions.size(); ++i) {
+		auto unit = std::make_shared<GameEntity>(i + 1);
+		auto position = std::make_shared<component::Position>(loop);
+		position->set_position(0, positions[i]);
+		unit->add_component(position);
+		units.push_back(unit);
+	}
+	return units;
+}
+
+const curve::Continuous<coord::phys3> &positions_of(const std::shared_ptr<GameEntity> &unit) {
+	auto position = std::dynamic_pointer_cast<component::Position>(
+		unit->get_component(component::component_t::POSITION));
+	return position->get_positions();
+}
+
+} // namespace
+
+
+void collision() {
+	// grid search finds the same pairs as comparing all bodies,
+	// including bodies larger than a cell
+	auto grid = random_grid(500, 20, 42);
+	auto expected = brute_force_contacts(grid);
+	TESTEQUALS(expected.empty(), false);
+	TESTEQUALS(sorted_pairs(grid.find_contacts()) == expected, true);
+
+	collision::Broadphase large{coord::phys_t::from_double(0.25)};
+	large.insert(1, coord::phys2{0, 0}, 1);
+	large.insert(2, coord::phys2{1, 1}, 1);
+	large.insert(3, coord::phys2{-3, 0}, 1);
+	large.build();
+	TESTEQUALS(sorted_pairs(large.find_contacts()) == brute_force_contacts(large), true);
+	TESTEQUALS(large.find_contacts().size(), 1u);
+
+	// parallel search has the same result in the same order
+	auto job_mgr = std::make_shared<job::JobManager>(4);
+	job_mgr->start();
+	auto big_grid = random_grid(5000, 60, 1337);
+	auto serial = big_grid.find_contacts();
+	auto parallel = big_grid.find_contacts(job_mgr);
+	job_mgr->stop();
+	TESTEQUALS(serial.size(), parallel.size());
+	for (size_t i = 0; i < serial.size(); ++i) {
+		TESTEQUALS(serial[i].a, parallel[i].a);
+		TESTEQUALS(serial[i].b, parallel[i].b);
+	}
+
+	// circle queries
+	collision::Broadphase small{1};
+	small.insert(1, coord::phys2{0, 0}, coord::phys_t::from_double(0.5));
+	small.insert(2, coord::phys2{3, 0}, coord::phys_t::from_double(0.5));
+	small.insert(3, coord::phys2{-2, -2}, coord::phys_t::from_double(0.5));
+	small.build();
+	TESTEQUALS(small.query(coord::phys2{1, 0}, 1).size(), 1u);
+	TESTEQUALS(small.query(coord::phys2{1, 0}, 2).size(), 2u);
+	TESTEQUALS(small.query(coord::phys2{-1, -1}, 1).size(), 2u);
+	TESTEQUALS(small.query(coord::phys2{10, 10}, 1).empty(), true);
+
+	TESTTHROWS(collision::Broadphase{0});
+
+	// bodies are sampled from the position curves
+	auto loop = std::make_shared<event::EventLoop>();
+	auto position = std::make_shared<component::Position>(loop);
+	position->set_position(0, coord::phys3{0, 0, 0});
+	position->set_position(10, coord::phys3{10, 0, 0});
+	collision::Broadphase sampled{1};
+	sampled.insert(1, position->get_positions(), 5, coord::phys_t::from_double(0.5));
+	sampled.build();
+	TESTEQUALS(sampled.get_bodies()[0].position == coord::phys2(5, 0), true);
+
+	// displacing keeps the past and shifts the movement destination
+	position->displace(2, coord::phys3_delta{0, 1, 0}, 1);
+	TESTEQUALS(position->get_positions().get(2) == coord::phys3(2, 0, 0), true);
+	TESTEQUALS(position->get_positions().get(3) == coord::phys3(3, 1, 0), true);
+	TESTEQUALS(position->get_positions().get(10) == coord::phys3(10, 1, 0), true);
+	TESTEQUALS(position->get_positions().get(1) == coord::phys3(1, 0, 0), true);
+
+	// units at the same position are pushed apart
+	auto units = make_units(loop, {coord::phys3{5, 5, 0}, coord::phys3{5, 5, 0}, coord::phys3{20, 20, 0}});
+	collision::Separation separation{coord::phys_t::from_double(0.25), 1};
+	TESTEQUALS(separation.step(units, 1), 2u);
+	auto first = positions_of(units[0]).get(2).to_phys2();
+	auto second = positions_of(units[1]).get(2).to_phys2();
+	TESTEQUALS((first - second).length() > 0.49, true);
+	TESTEQUALS(positions_of(units[0]).get(1) == coord::phys3(5, 5, 0), true);
+	TESTEQUALS(positions_of(units[2]).get(2) == coord::phys3(20, 20, 0), true);
+
+	// separated units are not pushed again
+	TESTEQUALS(separation.step(units, 2), 0u);
+
+	// a clump of units spreads out over a few steps
+	std::vector<coord::phys3> clump;
+	for (int i = 0; i < 25; ++i) {
+		clump.push_back(coord::phys3{coord::phys_t::from_double(0.1 * (i % 5)),
+		                             coord::phys_t::from_double(0.1 * (i / 5)),
+		                             0});
+	}
+	auto crowd = make_units(loop, clump);
+	time::time_t time = 0;
+	for (int i = 0; i < 50; ++i) {
+		separation.step(crowd, time);
+		time += separation.get_interval();
+	}
+	collision::Broadphase spread{coord::phys_t::from_double(0.5)};
+	for (auto &unit : crowd) {
+		spread.insert(unit->get_id(), positions_of(unit), time, coord::phys_t::from_double(0.2));
+	}
+	spread.build();
+	TESTEQUALS(spread.find_contacts().empty(), true);
+}
+
+
+void collision_benchmark() {
+	constexpr size_t unit_count = 10000;
+	constexpr int rounds = 50;
+
+	// about one unit per tile, so units in formations touch their neighbours
+	auto job_mgr = std::make_shared<job::JobManager>(std::max(1u, std::thread::hardware_concurrency()));
+	job_mgr->start();
+	auto grid = random_grid(unit_count, 100, 1);
+
+	size_t contacts = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < rounds; i++) {
+		contacts += grid.find_contacts().size();
+	}
+	std::chrono::duration<double> serial = std::chrono::steady_clock::now() - start;
+
+	size_t parallel_contacts = 0;
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < rounds; i++) {
+		parallel_contacts += grid.find_contacts(job_mgr).size();
+	}
+	std::chrono::duration<double> parallel = std::chrono::steady_clock::now() - start;
+
+	if (contacts != parallel_contacts) {
+		job_mgr->stop();
+		throw Error{ERR << "collision benchmark: parallel search found "
+		                << parallel_contacts << " instead of " << contacts << " contacts"};
+	}
+
+	log::log(INFO << "collision benchmark: " << unit_count << " units, "
+	              << contacts / rounds << " contacts");
+	log::log(INFO << "collision benchmark: broadphase "
+	              << serial.count() * 1000 / rounds << " ms serial, "
+	              << parallel.count() * 1000 / rounds << " ms parallel");
+
+	// full separation steps, including sampling and changing the curves
+	auto loop = std::make_shared<event::EventLoop>();
+	std::vector<coord::phys3> positions;
+	for (auto &body : grid.get_bodies()) {
+		positions.push_back(body.position.to_phys3());
+	}
+	auto units = make_units(loop, positions);
+	collision::Separation separation{coord::phys_t::from_double(0.25), time::time_t::from_double(0.25), job_mgr};
+
+	time::time_t time = 0;
+	size_t pushed = 0;
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < rounds; i++) {
+		pushed += separation.step(units, time);
+		time += separation.get_interval();
+	}
+	std::chrono::duration<double> steps = std::chrono::steady_clock::now() - start;
+	job_mgr->stop();
+
+	log::log(INFO << "collision benchmark: separation "
+	              << steps.count() * 1000 / rounds << " ms per step, "
+	              << pushed / rounds << " units pushed per step");
+}
+
+} // namespace openage::gamestate::tests
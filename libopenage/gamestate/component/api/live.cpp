@@ -1,4 +1,4 @@
-// Copyright 2021-2023 the openage authors. See copying.md for legal info.
+// Copyright 2021-2024 the openage authors. See copying.md for legal info.
 
 #include "live.h"
 
@@ -34,4 +34,9 @@ void Live::set_attribute(const time::time_t &time,
 		// TODO: fail here
 	}
 }
+
+Live::attribute_storage_t &Live::get_attributes() {
+	return this->attribute_values;
+}
+
 } // namespace openage::gamestate::component
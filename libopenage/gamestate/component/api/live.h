@@ -16,6 +16,9 @@
 namespace openage::gamestate::component {
 class Live final : public APIComponent {
 public:
+	using attribute_storage_t = curve::UnorderedMap<nyan::fqon_t,
+	                                                std::shared_ptr<curve::Discrete<int64_t>>>;
+
 	using APIComponent::APIComponent;
 
 	component_t get_type() const override;
@@ -42,10 +45,14 @@ public:
 	                   const nyan::fqon_t &attribute,
 	                   int64_t value);
 
-private:
-	using attribute_storage_t = curve::UnorderedMap<nyan::fqon_t,
-	                                                std::shared_ptr<curve::Discrete<int64_t>>>;
+	/**
+	 * Get the attribute values of the component.
+	 *
+	 * @return Map of attribute values by attribute type.
+	 */
+	attribute_storage_t &get_attributes();
 
+private:
 	/**
 	 * Map of attribute values by attribute type.
 	 */
@@ -1,4 +1,4 @@
-// Copyright 2021-2023 the openage authors. See copying.md for legal info.
+// Copyright 2021-2024 the openage authors. See copying.md for legal info.
 
 #include "api_component.h"
 
@@ -25,4 +25,12 @@ const nyan::Object &APIComponent::get_ability() const {
 	return this->ability;
 }
 
+uint64_t APIComponent::get_hash() const {
+	return this->enabled.get_hash();
+}
+
+void APIComponent::set_change_notifier(const change_notifier_t &notifier) {
+	this->enabled.set_parent_notifier(notifier);
+}
+
 } // namespace openage::gamestate::component
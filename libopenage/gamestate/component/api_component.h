@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 
 #include <nyan/nyan.h>
@@ -56,6 +57,10 @@ public:
 	 */
 	const nyan::Object &get_ability() const;
 
+	uint64_t get_hash() const override;
+
+	void set_change_notifier(const change_notifier_t &notifier) override;
+
 private:
 	/**
 	 * nyan object holding the data for the component.
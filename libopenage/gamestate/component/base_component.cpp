@@ -1,8 +1,13 @@
-// Copyright 2021-2023 the openage authors. See copying.md for legal info.
+// Copyright 2021-2024 the openage authors. See copying.md for legal info.
 
 #include "base_component.h"
 
 namespace openage::gamestate::component {
 
+uint64_t Component::get_hash() const {
+	return 0;
+}
+
+void Component::set_change_notifier(const change_notifier_t & /* notifier */) {}
 
 } // namespace openage::gamestate::component
@@ -2,7 +2,11 @@
 
 #pragma once
 
+#include <cstdint>
+#include <functional>
+
 #include "gamestate/component/types.h"
+#include "time/time.h"
 
 namespace openage::gamestate::component {
 
@@ -11,6 +15,11 @@ namespace openage::gamestate::component {
  */
 class Component {
 public:
+	/**
+	 * Called with the time of the change whenever the data of a component changes.
+	 */
+	using change_notifier_t = std::function<void(const time::time_t &)>;
+
 	virtual ~Component() = default;
 
 	/**
@@ -19,6 +28,23 @@ public:
 	 * @return Component type of the component.
 	 */
 	virtual component_t get_type() const = 0;
+
+	/**
+	 * Get the hash of the component's data.
+	 *
+	 * The hash is maintained incrementally by the curves of the component,
+	 * so this is cheap to call.
+	 *
+	 * @return Hash of the component data. Components without hashed data return 0.
+	 */
+	virtual uint64_t get_hash() const;
+
+	/**
+	 * Set the function that is notified when the data of the component changes.
+	 *
+	 * @param notifier Change notifier. Can be \p nullptr.
+	 */
+	virtual void set_change_notifier(const change_notifier_t &notifier);
 };
 
 } // namespace openage::gamestate::component
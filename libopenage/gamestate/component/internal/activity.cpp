@@ -1,7 +1,9 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2024 the openage authors. See copying.md for legal info.
 
 #include "activity.h"
 
+#include <utility>
+
 #include "event/event.h"
 #include "gamestate/activity/activity.h"
 #include "gamestate/component/internal/activity.h"
@@ -12,28 +14,61 @@ namespace openage::gamestate::component {
 Activity::Activity(const std::shared_ptr<openage::event::EventLoop> &loop,
                    const std::shared_ptr<activity::Activity> &start_activity) :
 	start_activity{start_activity},
-	node{loop, 0} {
+	program{start_activity->get_compiled()},
+	pc{loop, 0, "", nullptr, activity::invalid_pc} {
 }
 
 component_t Activity::get_type() const {
 	return component_t::ACTIVITY;
 }
 
+uint64_t Activity::get_hash() const {
+	return this->pc.get_hash();
+}
+
+void Activity::set_change_notifier(const change_notifier_t &notifier) {
+	this->pc.set_parent_notifier(notifier);
+}
+
 const std::shared_ptr<activity::Activity> &Activity::get_start_activity() const {
 	return this->start_activity;
 }
 
+const activity::CompiledActivity &Activity::get_program() const {
+	return *this->program;
+}
+
 const std::shared_ptr<activity::Node> Activity::get_node(const time::time_t &time) const {
-	return this->node.get(time);
+	auto pc = this->pc.get(time);
+	if (pc == activity::invalid_pc) {
+		return nullptr;
+	}
+	return this->program->get_node(pc);
+}
+
+activity::pc_t Activity::get_pc(const time::time_t &time) const {
+	return this->pc.get(time);
+}
+
+void Activity::set_pc(const time::time_t &time,
+                      activity::pc_t pc) {
+	this->pc.set_last(time, pc);
+}
+
+const curve::Discrete<activity::pc_t> &Activity::get_pcs() const {
+	return this->pc;
+}
+
+const std::vector<std::shared_ptr<event::Event>> &Activity::get_events() const {
+	return this->scheduled_events;
 }
 
-void Activity::set_node(const time::time_t &time,
-                        const std::shared_ptr<activity::Node> &node) {
-	this->node.set_last(time, node);
+void Activity::restore(curve::KeyframeContainer<activity::pc_t>::container_t &&pcs) {
+	this->pc.restore(std::move(pcs));
 }
 
 void Activity::init(const time::time_t &time) {
-	this->set_node(time, this->start_activity->get_start());
+	this->set_pc(time, this->program->get_start());
 }
 
 void Activity::add_event(const std::shared_ptr<event::Event> &event) {
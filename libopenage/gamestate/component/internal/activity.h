@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "curve/discrete.h"
+#include "gamestate/activity/compiled_activity.h"
 #include "gamestate/component/internal_component.h"
 #include "gamestate/component/types.h"
 #include "time/time.h"
@@ -22,7 +23,6 @@ namespace gamestate {
 
 namespace activity {
 class Activity;
-class Node;
 } // namespace activity
 
 namespace component {
@@ -40,6 +40,10 @@ public:
 
 	component_t get_type() const override;
 
+	uint64_t get_hash() const override;
+
+	void set_change_notifier(const change_notifier_t &notifier) override;
+
 	/**
 	 * Get the initial activity.
 	 *
@@ -47,22 +51,38 @@ public:
 	 */
 	const std::shared_ptr<activity::Activity> &get_start_activity() const;
 
+	/**
+	 * Get the compiled flow graph of the initial activity.
+	 *
+	 * @return Compiled activity.
+	 */
+	const activity::CompiledActivity &get_program() const;
+
 	/**
 	 * Get the node in the activity flow graph at a given time.
 	 *
 	 * @param time Time at which the node is requested.
-	 * @return Current node in the flow graph.
+	 * @return Current node in the flow graph, or \p nullptr if the activity is not initialized.
 	 */
 	const std::shared_ptr<activity::Node> get_node(const time::time_t &time) const;
 
 	/**
-	 * Sets the current node in the activity flow graph at a given time.
+	 * Get the instruction of the current node in the compiled flow graph at a given time.
+	 *
+	 * @param time Time at which the instruction is requested.
+	 * @return Index of the current instruction, or \p activity::invalid_pc
+	 *         if the activity is not initialized.
+	 */
+	activity::pc_t get_pc(const time::time_t &time) const;
+
+	/**
+	 * Sets the instruction of the current node in the compiled flow graph at a given time.
 	 *
 	 * @param time Time at which the node is set.
-	 * @param node Current node in the flow graph.
+	 * @param pc Index of the current instruction.
 	 */
-	void set_node(const time::time_t &time,
-	              const std::shared_ptr<activity::Node> &node);
+	void set_pc(const time::time_t &time,
+	            activity::pc_t pc);
 
 	/**
 	 * Set the current node to the start node of the start activity.
@@ -71,6 +91,27 @@ public:
 	 */
 	void init(const time::time_t &time);
 
+	/**
+	 * Get the instructions of the current node over time.
+	 *
+	 * @return Instruction curve.
+	 */
+	const curve::Discrete<activity::pc_t> &get_pcs() const;
+
+	/**
+	 * Get the scheduled events that are waited for.
+	 */
+	const std::vector<std::shared_ptr<openage::event::Event>> &get_events() const;
+
+	/**
+	 * Replace the instruction curve, e.g. when restoring a snapshot.
+	 *
+	 * Scheduled events are not changed.
+	 *
+	 * @param pcs Keyframes of the instruction curve.
+	 */
+	void restore(curve::KeyframeContainer<activity::pc_t>::container_t &&pcs);
+
 	/**
 	 * Add a scheduled event that is waited for to progress in the node graph.
 	 *
@@ -97,9 +138,15 @@ private:
 	std::shared_ptr<activity::Activity> start_activity;
 
 	/**
-	 * Current node in the activity flow graph.
+	 * Compiled flow graph of the initial activity. Shared by all entities
+	 * with the same activity.
+	 */
+	std::shared_ptr<activity::CompiledActivity> program;
+
+	/**
+	 * Instruction of the current node in the compiled flow graph.
 	 */
-	curve::Discrete<std::shared_ptr<activity::Node>> node;
+	curve::Discrete<activity::pc_t> pc;
 
 	/**
 	 * Scheduled events that are waited for to progress in the node graph.
@@ -1,4 +1,4 @@
-// Copyright 2021-2023 the openage authors. See copying.md for legal info.
+// Copyright 2021-2024 the openage authors. See copying.md for legal info.
 
 #include "command_queue.h"
 
@@ -17,9 +17,25 @@ inline component_t CommandQueue::get_type() const {
 	return component_t::COMMANDQUEUE;
 }
 
+uint64_t CommandQueue::get_hash() const {
+	return this->command_queue.get_hash();
+}
+
+void CommandQueue::set_change_notifier(const change_notifier_t &notifier) {
+	this->command_queue.set_parent_notifier(notifier);
+}
+
+void CommandQueue::set_command_listener(const change_notifier_t &listener) {
+	this->command_listener = listener;
+}
+
 void CommandQueue::add_command(const time::time_t &time,
                                const std::shared_ptr<command::Command> &command) {
 	this->command_queue.insert(time, command);
+
+	if (this->command_listener) {
+		this->command_listener(time);
+	}
 }
 
 curve::Queue<std::shared_ptr<command::Command>> &CommandQueue::get_queue() {
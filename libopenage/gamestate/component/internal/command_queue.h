@@ -30,8 +30,20 @@ public:
 
 	component_t get_type() const override;
 
+	uint64_t get_hash() const override;
+
+	void set_change_notifier(const change_notifier_t &notifier) override;
+
 	/**
-	 * Adds a command to the queue.
+	 * Set the function that is called after a command is added to the queue,
+	 * e.g. for waking the entity if it is waiting for a command.
+	 *
+	 * @param listener Command listener. Can be \p nullptr.
+	 */
+	void set_command_listener(const change_notifier_t &listener);
+
+	/**
+	 * Adds a command to the queue and notifies the command listener.
 	 *
 	 * @param time Time at which the command is added.
 	 * @param command New command.
@@ -60,6 +72,11 @@ private:
 	 * Command queue.
 	 */
 	curve::Queue<std::shared_ptr<command::Command>> command_queue;
+
+	/**
+	 * Called after a command is added.
+	 */
+	change_notifier_t command_listener;
 };
 
 } // namespace gamestate::component
@@ -1,3 +1,14 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2024 the openage authors. See copying.md for legal info.
 
 #include "base_command.h"
+
+#include "curve/value_hash.h"
+
+
+namespace openage::gamestate::component::command {
+
+uint64_t Command::hash() const {
+	return curve::value_hash(this->get_type());
+}
+
+} // namespace openage::gamestate::component::command
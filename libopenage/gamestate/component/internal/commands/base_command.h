@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include "gamestate/component/internal/commands/types.h"
 
 
@@ -20,6 +22,13 @@ public:
 	 * @return Command type.
 	 */
 	virtual command_t get_type() const = 0;
+
+	/**
+	 * Get a hash of the command, e.g. for hashing the game state.
+	 *
+	 * @return Hash of the command type and parameters.
+	 */
+	virtual uint64_t hash() const;
 };
 
 } // namespace openage::gamestate::component::command
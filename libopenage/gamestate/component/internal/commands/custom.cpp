@@ -1,12 +1,21 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2024 the openage authors. See copying.md for legal info.
 
 #include "custom.h"
 
+#include "curve/value_hash.h"
+
 
 namespace openage::gamestate::component::command {
 
 CustomCommand::CustomCommand(const std::string &id) :
 	id{id} {}
 
+const std::string &CustomCommand::get_id() const {
+	return this->id;
+}
+
+uint64_t CustomCommand::hash() const {
+	return util::hash_append(Command::hash(), curve::value_hash(this->id));
+}
 
 } // namespace openage::gamestate::component::command
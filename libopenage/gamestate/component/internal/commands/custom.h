@@ -34,6 +34,8 @@ public:
 	 */
 	const std::string &get_id() const;
 
+	uint64_t hash() const override;
+
 private:
 	/**
 	 * Command identifier.
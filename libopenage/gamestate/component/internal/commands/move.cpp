@@ -1,7 +1,9 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2024 the openage authors. See copying.md for legal info.
 
 #include "move.h"
 
+#include "curve/value_hash.h"
+
 
 namespace openage::gamestate::component::command {
 
@@ -12,4 +14,8 @@ const coord::phys3 &MoveCommand::get_target() const {
 	return this->target;
 }
 
+uint64_t MoveCommand::hash() const {
+	return util::hash_append(Command::hash(), curve::value_hash(this->target));
+}
+
 } // namespace openage::gamestate::component::command
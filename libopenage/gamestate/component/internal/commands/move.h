@@ -33,6 +33,8 @@ public:
 	 */
 	const coord::phys3 &get_target() const;
 
+	uint64_t hash() const override;
+
 private:
 	/**
 	 * Target position.
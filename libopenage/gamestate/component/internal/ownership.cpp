@@ -1,7 +1,9 @@
-// Copyright 2021-2023 the openage authors. See copying.md for legal info.
+// Copyright 2021-2024 the openage authors. See copying.md for legal info.
 
 #include "ownership.h"
 
+#include <utility>
+
 #include "gamestate/component/types.h"
 
 
@@ -22,6 +24,14 @@ inline component_t Ownership::get_type() const {
 	return component_t::OWNERSHIP;
 }
 
+uint64_t Ownership::get_hash() const {
+	return this->owner.get_hash();
+}
+
+void Ownership::set_change_notifier(const change_notifier_t &notifier) {
+	this->owner.set_parent_notifier(notifier);
+}
+
 void Ownership::set_owner(const time::time_t &time, const player_id_t owner_id) {
 	this->owner.set_last(time, owner_id);
 }
@@ -30,4 +40,8 @@ const curve::Discrete<player_id_t> &Ownership::get_owners() const {
 	return this->owner;
 }
 
+void Ownership::restore(curve::KeyframeContainer<player_id_t>::container_t &&owners) {
+	this->owner.restore(std::move(owners));
+}
+
 } // namespace openage::gamestate::component
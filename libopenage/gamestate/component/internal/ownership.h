@@ -41,6 +41,10 @@ public:
 
 	component_t get_type() const override;
 
+	uint64_t get_hash() const override;
+
+	void set_change_notifier(const change_notifier_t &notifier) override;
+
 	/**
 	 * Set the owner ID at a given time.
 	 *
@@ -56,6 +60,13 @@ public:
 	 */
 	const curve::Discrete<player_id_t> &get_owners() const;
 
+	/**
+	 * Replace the owner curve, e.g. when restoring a snapshot.
+	 *
+	 * @param owners Keyframes of the owner curve.
+	 */
+	void restore(curve::KeyframeContainer<player_id_t>::container_t &&owners);
+
 private:
 	/**
 	 * Owner ID storage over time.
@@ -1,10 +1,14 @@
-// Copyright 2021-2023 the openage authors. See copying.md for legal info.
+// Copyright 2021-2024 the openage authors. See copying.md for legal info.
 
 #include "position.h"
 
+#include <utility>
+#include <vector>
+
 #include "gamestate/component/types.h"
 #include "gamestate/definitions.h"
 #include "util/fixed_point.h"
+#include "util/hash.h"
 
 
 namespace openage::gamestate::component {
@@ -46,6 +50,15 @@ inline component_t Position::get_type() const {
 	return component_t::POSITION;
 }
 
+uint64_t Position::get_hash() const {
+	return util::hash_append(this->position.get_hash(), this->angle.get_hash());
+}
+
+void Position::set_change_notifier(const change_notifier_t &notifier) {
+	this->position.set_parent_notifier(notifier);
+	this->angle.set_parent_notifier(notifier);
+}
+
 const curve::Continuous<coord::phys3> &Position::get_positions() const {
 	return this->position;
 }
@@ -54,6 +67,28 @@ void Position::set_position(const time::time_t &time, const coord::phys3 &pos) {
 	this->position.set_last(time, pos);
 }
 
+void Position::displace(const time::time_t &time,
+                        const coord::phys3_delta &offset,
+                        const time::time_t &duration) {
+	auto end = time + duration;
+	auto start_pos = this->position.get(time);
+	auto end_pos = this->position.get(end) + offset;
+
+	// keyframes after the shift keep their relative positions
+	std::vector<std::pair<time::time_t, coord::phys3>> later;
+	auto &container = this->position.get_container();
+	for (auto i = container.last(end) + 1; i < container.size(); ++i) {
+		auto &keyframe = container.get(i);
+		later.emplace_back(keyframe.time(), keyframe.val() + offset);
+	}
+
+	this->position.set_last(time, start_pos);
+	this->position.set_insert(end, end_pos);
+	for (auto &[keyframe_time, pos] : later) {
+		this->position.set_insert(keyframe_time, pos);
+	}
+}
+
 const curve::Segmented<coord::phys_angle_t> &Position::get_angles() const {
 	return this->angle;
 }
@@ -63,4 +98,10 @@ void Position::set_angle(const time::time_t &time, const coord::phys_angle_t &an
 	this->angle.set_insert_jump(time, old_angle, angle);
 }
 
+void Position::restore(curve::KeyframeContainer<coord::phys3>::container_t &&positions,
+                       curve::KeyframeContainer<coord::phys_angle_t>::container_t &&angles) {
+	this->position.restore(std::move(positions));
+	this->angle.restore(std::move(angles));
+}
+
 } // namespace openage::gamestate::component
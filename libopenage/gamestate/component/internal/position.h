@@ -42,6 +42,10 @@ public:
 
 	component_t get_type() const override;
 
+	uint64_t get_hash() const override;
+
+	void set_change_notifier(const change_notifier_t &notifier) override;
+
 	/**
 	 * Get the positions in the world coordinate system over time.
 	 *
@@ -76,6 +80,32 @@ public:
 	 */
 	void set_angle(const time::time_t &time, const coord::phys_angle_t &angle);
 
+	/**
+	 * Shift the position curve after a given time, e.g. to push the entity
+	 * away from another one.
+	 *
+	 * The entity moves by the offset between \p time and \p time + \p duration.
+	 * All later keyframes, e.g. the destination of the current movement, are
+	 * shifted by the offset. Keyframes between \p time and \p time + \p duration
+	 * are dropped.
+	 *
+	 * @param time Time at which the shift starts.
+	 * @param offset Offset added to the positions.
+	 * @param duration Time until the full offset is reached.
+	 */
+	void displace(const time::time_t &time,
+	              const coord::phys3_delta &offset,
+	              const time::time_t &duration);
+
+	/**
+	 * Replace the position and angle curves, e.g. when restoring a snapshot.
+	 *
+	 * @param positions Keyframes of the position curve.
+	 * @param angles Keyframes of the angle curve.
+	 */
+	void restore(curve::KeyframeContainer<coord::phys3>::container_t &&positions,
+	             curve::KeyframeContainer<coord::phys_angle_t>::container_t &&angles);
+
 private:
 	/**
 	 * Position storage over time.
@@ -1,4 +1,4 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2024 the openage authors. See copying.md for legal info.
 
 #include "entity_factory.h"
 
@@ -158,6 +158,13 @@ void EntityFactory::init_components(const std::shared_ptr<openage::event::EventL
 	entity->add_component(ownership);
 
 	auto command_queue = std::make_shared<component::CommandQueue>(loop);
+	// entities waiting for a command continue their activity when one is added
+	command_queue->set_command_listener([weak_entity = std::weak_ptr<GameEntity>{entity}](const time::time_t &time) {
+		auto entity = weak_entity.lock();
+		if (entity and entity->get_manager()) {
+			entity->get_manager()->wake_for_command(time);
+		}
+	});
 	entity->add_component(command_queue);
 
 	auto nyan_obj = owner_db_view->get_object(nyan_entity);
@@ -214,7 +221,10 @@ void EntityFactory::init_components(const std::shared_ptr<openage::event::EventL
 		init_activity(loop, owner_db_view, entity, activity_ability.value());
 	}
 	else {
-		auto activity = std::make_shared<component::Activity>(loop, create_test_activity());
+		if (this->default_activity == nullptr) {
+			this->default_activity = create_test_activity();
+		}
+		auto activity = std::make_shared<component::Activity>(loop, this->default_activity);
 		entity->add_component(activity);
 	}
 }
@@ -352,6 +362,9 @@ void EntityFactory::init_activity(const std::shared_ptr<openage::event::EventLoo
 	}
 
 	auto activity = std::make_shared<activity::Activity>(0, start_node, graph.get_name());
+
+	// compile the graph before caching, so errors show up when it is loaded
+	activity->get_compiled();
 	this->activity_cache.insert({graph.get_name(), activity});
 
 	auto component = std::make_shared<component::Activity>(loop, activity);
@@ -135,9 +135,17 @@ private:
 
 	/**
 	 * Cache for activities.
+	 *
+	 * Activities are compiled when they are added, so all game entities
+	 * with the same activity share one compiled graph.
 	 */
 	std::unordered_map<nyan::fqon_t, std::shared_ptr<activity::Activity>> activity_cache;
 
+	/**
+	 * Activity for game entities without an activity ability.
+	 */
+	std::shared_ptr<activity::Activity> default_activity;
+
 	/**
 	 * Mutex for thread safety.
 	 */
@@ -1,16 +1,19 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2024 the openage authors. See copying.md for legal info.
 
 #include "send_command.h"
 
 #include <vector>
 
 #include "coord/phys.h"
+#include "gamestate/activity/wait_list.h"
 #include "gamestate/component/internal/command_queue.h"
 #include "gamestate/component/internal/commands/idle.h"
 #include "gamestate/component/internal/commands/move.h"
 #include "gamestate/component/types.h"
 #include "gamestate/game_entity.h"
 #include "gamestate/game_state.h"
+#include "gamestate/manager.h"
+#include "gamestate/system/activity.h"
 #include "gamestate/types.h"
 
 
@@ -58,26 +61,43 @@ void SendCommandHandler::invoke(openage::event::EventLoop & /* loop */,
 	auto command_type = params.get("type", component::command::command_t::NONE);
 	std::vector<gamestate::entity_id_t> ids = params.get("entity_ids",
 	                                                     std::vector<gamestate::entity_id_t>{});
+
+	std::shared_ptr<component::command::Command> command;
+	switch (command_type) {
+	case component::command::command_t::IDLE:
+		command = std::make_shared<component::command::IdleCommand>();
+		break;
+	case component::command::command_t::MOVE:
+		command = std::make_shared<component::command::MoveCommand>(
+			params.get("target",
+		               coord::phys3{0, 0, 0}));
+		break;
+	default:
+		return;
+	}
+
+	std::vector<std::shared_ptr<component::CommandQueue>> command_queues;
+	command_queues.reserve(ids.size());
 	for (auto id : ids) {
 		auto entity = gstate->get_game_entity(id);
-		auto command_queue = std::dynamic_pointer_cast<component::CommandQueue>(
-			entity->get_component(component::component_t::COMMANDQUEUE));
-
-		switch (command_type) {
-		case component::command::command_t::IDLE:
-			command_queue->add_command(time, std::make_shared<component::command::IdleCommand>());
-			break;
-		case component::command::command_t::MOVE:
-			command_queue->add_command(
-				time,
-				std::make_shared<component::command::MoveCommand>(
-					params.get("target",
-			                   coord::phys3{0, 0, 0})));
-			break;
-		default:
-			break;
-		}
+		command_queues.push_back(std::dynamic_pointer_cast<component::CommandQueue>(
+			entity->get_component(component::component_t::COMMANDQUEUE)));
+	}
+
+	// adding the commands wakes the entities that wait for a command,
+	// they continue their activity together
+	auto &wait_list = gstate->get_command_wait_list();
+	wait_list.begin_batch();
+	for (auto &command_queue : command_queues) {
+		command_queue->add_command(time, command);
+	}
+
+	std::vector<system::ActivityTarget> resumed;
+	for (auto &[id, next_id] : wait_list.end_batch()) {
+		resumed.push_back(system::ActivityTarget{gstate->get_game_entity(id), next_id});
 	}
+
+	GameEntityManager::run_activity_system(time, resumed);
 }
 
 time::time_t SendCommandHandler::predict_invoke_time(const std::shared_ptr<openage::event::EventEntity> & /* target */,
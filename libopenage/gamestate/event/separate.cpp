@@ -0,0 +1,48 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "separate.h"
+
+#include "gamestate/collision/separation.h"
+#include "gamestate/game_state.h"
+
+
+namespace openage::gamestate::event {
+
+Separator::Separator(const std::shared_ptr<openage::event::EventLoop> &loop) :
+	EventEntity(loop) {
+}
+
+size_t Separator::id() const {
+	return 0;
+}
+
+std::string Separator::idstr() const {
+	return "separator";
+}
+
+
+SeparateHandler::SeparateHandler(const std::shared_ptr<collision::Separation> &separation) :
+	RepeatEventHandler{"game.separate"},
+	separation{separation} {}
+
+void SeparateHandler::setup_event(const std::shared_ptr<openage::event::Event> & /* event */,
+                                  const std::shared_ptr<openage::event::State> & /* state */) {
+	// no dependencies
+}
+
+void SeparateHandler::invoke(openage::event::EventLoop & /* loop */,
+                             const std::shared_ptr<openage::event::EventEntity> & /* target */,
+                             const std::shared_ptr<openage::event::State> &state,
+                             const time::time_t &time,
+                             const param_map & /* params */) {
+	auto gstate = std::dynamic_pointer_cast<gamestate::GameState>(state);
+	this->separation->step(gstate, time);
+}
+
+time::time_t SeparateHandler::predict_invoke_time(const std::shared_ptr<openage::event::EventEntity> & /* target */,
+                                                  const std::shared_ptr<openage::event::State> & /* state */,
+                                                  const time::time_t &at) {
+	return at + this->separation->get_interval();
+}
+
+} // namespace openage::gamestate::event
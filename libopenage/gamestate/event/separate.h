@@ -0,0 +1,80 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "event/evententity.h"
+#include "event/eventhandler.h"
+#include "time/time.h"
+
+
+namespace openage {
+
+namespace event {
+class EventLoop;
+class Event;
+class State;
+} // namespace event
+
+namespace gamestate {
+
+namespace collision {
+class Separation;
+}
+
+namespace event {
+
+/**
+ * Target of the separation events.
+ */
+class Separator : public openage::event::EventEntity {
+public:
+	Separator(const std::shared_ptr<openage::event::EventLoop> &loop);
+	~Separator() = default;
+
+	size_t id() const override;
+	std::string idstr() const override;
+};
+
+/**
+ * Pushes overlapping game entities apart in regular intervals.
+ */
+class SeparateHandler : public openage::event::RepeatEventHandler {
+public:
+	/**
+	 * Creates a new SeparateHandler.
+	 *
+	 * @param separation Separation step that is run for every event.
+	 */
+	SeparateHandler(const std::shared_ptr<collision::Separation> &separation);
+	~SeparateHandler() = default;
+
+	void setup_event(const std::shared_ptr<openage::event::Event> &event,
+	                 const std::shared_ptr<openage::event::State> &state) override;
+
+	void invoke(openage::event::EventLoop &loop,
+	            const std::shared_ptr<openage::event::EventEntity> &target,
+	            const std::shared_ptr<openage::event::State> &state,
+	            const time::time_t &time,
+	            const param_map &params) override;
+
+	/**
+	 * Events are repeated after the interval of the separation step.
+	 */
+	time::time_t predict_invoke_time(const std::shared_ptr<openage::event::EventEntity> &target,
+	                                 const std::shared_ptr<openage::event::State> &state,
+	                                 const time::time_t &at) override;
+
+private:
+	/**
+	 * Separation step.
+	 */
+	std::shared_ptr<collision::Separation> separation;
+};
+
+} // namespace event
+} // namespace gamestate
+} // namespace openage
@@ -1,23 +1,29 @@
-// Copyright 2018-2023 the openage authors. See copying.md for legal info.
+// Copyright 2018-2024 the openage authors. See copying.md for legal info.
 
 #include "game.h"
 
+#include <algorithm>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include <nyan/nyan.h>
 
+#include "error/error.h"
+
 #include "log/log.h"
 #include "log/message.h"
 
 #include "assets/mod_manager.h"
 #include "assets/modpack.h"
+#include "assets/nyan_files.h"
 #include "gamestate/entity_factory.h"
 #include "gamestate/game_state.h"
 #include "gamestate/terrain.h"
 #include "gamestate/terrain_factory.h"
 #include "gamestate/universe.h"
+#include "job/job_manager.h"
 #include "util/path.h"
-#include "util/strings.h"
 
 #include "coord/tile.h"
 
@@ -56,72 +62,106 @@ void Game::attach_renderer(const std::shared_ptr<renderer::RenderFactory> &rende
 	this->state->get_terrain()->attach_renderer(render_factory);
 }
 
+namespace {
+
+/**
+ * nyan files of one modpack.
+ */
+struct ModpackFiles {
+	/// native path of the directory containing the modpack
+	std::string base_path;
+	/// name of the modpack directory
+	std::string mod_dir;
+	/// native path of the modpack directory
+	std::string native_path;
+	std::vector<std::string> includes;
+	/// file paths relative to the modpack directory
+	std::vector<std::string> files;
+};
+
+
+template <typename T>
+T wait_for(job::Job<T> &job) {
+	while (not job.is_finished()) {
+		std::this_thread::yield();
+	}
+	return job.get_result();
+}
+
+} // namespace
+
+
 void Game::load_data(const std::shared_ptr<assets::ModManager> &mod_manager) {
 	auto load_order = mod_manager->get_load_order();
 
+	// fslike paths are resolved here, the workers only use native paths
+	std::vector<ModpackFiles> modpacks;
 	for (auto &mod_id : load_order) {
 		auto mod = mod_manager->get_modpack(mod_id);
-		auto info = mod->get_info();
-
-		auto includes = info.includes;
-		for (const auto &include : includes) {
-			// handle wildcards
-			auto parts = util::split(include, '/');
-			auto last_part = parts.back();
-			bool recursive = false;
-			auto search = include;
-			if (last_part == "**") {
-				recursive = true;
-				if (parts.size() == 1) {
-					// include = "**"
-					// start in root directory
-					search = "";
-				}
-				else {
-					// include = "path/to/somewhere/**"
-					// remove the wildcard '**' and the slash '/'
-					search = include.substr(0, include.size() - 3);
-				}
-			}
+		auto &info = mod->get_info();
+
+		modpacks.push_back(ModpackFiles{info.path.get_parent().resolve_native_path(),
+		                                info.path.get_name(),
+		                                info.path.resolve_native_path(),
+		                                info.includes,
+		                                {}});
+	}
+
+	int worker_count = std::max<int>(std::thread::hardware_concurrency(), 1);
+	auto workers = std::make_shared<job::JobManager>(worker_count);
+	workers->start();
+
+	// find the files of each modpack
+	std::vector<job::Job<std::vector<std::string>>> find_jobs;
+	for (const auto &modpack : modpacks) {
+		find_jobs.push_back(workers->enqueue<std::vector<std::string>>([&modpack]() {
+			return assets::find_nyan_files(modpack.native_path, modpack.includes);
+		}));
+	}
 
-			this->load_path(info.path.get_parent(), info.path.get_name(), search, recursive);
+	// file names as nyan sees them, i.e. relative to the base path
+	std::vector<std::string> names;
+	std::vector<std::string> native_paths;
+	for (size_t i = 0; i < modpacks.size(); ++i) {
+		auto &modpack = modpacks[i];
+		modpack.files = wait_for(find_jobs[i]);
+		for (const auto &file : modpack.files) {
+			names.push_back(modpack.mod_dir + "/" + file);
+			native_paths.push_back(modpack.native_path + "/" + file);
 		}
 	}
-}
 
-void Game::load_path(const util::Path &base_dir,
-                     const std::string &mod_dir,
-                     const std::string &search,
-                     bool recursive) {
-	auto base_path = base_dir.resolve_native_path();
-	auto search_path = base_dir / mod_dir / search;
-
-	auto fileload_func = [&base_path](const std::string &filename) {
-		// nyan wants a string filepath, so we have to construct it from the
-		// path and subpath parameters
-		log::log(INFO << "Loading .nyan file: " << filename);
-		auto loc = base_path + "/" + filename;
-		return std::make_shared<nyan::File>(loc);
-	};
-
-	// file loading
-	if (search_path.is_file() and search_path.get_suffix() == ".nyan") {
-		auto loc = mod_dir + "/" + search;
-		this->db->load(loc, fileload_func);
-		return;
+	auto contents = assets::read_nyan_files(native_paths, *workers, worker_count);
+
+	workers->stop();
+
+	std::unordered_map<std::string, std::string> preloaded;
+	preloaded.reserve(names.size());
+	for (size_t i = 0; i < names.size(); ++i) {
+		preloaded.emplace(names[i], std::move(contents[i]));
 	}
 
-	// directory loading
-	if (search_path.is_dir()) {
-		// load all files in a directory
-		for (auto p : search_path.iterdir()) {
-			if (p.is_dir() and not recursive) {
-				// folders are skipped unless we read recursively
-				continue;
+	// nyan parses the files in this thread
+	for (const auto &modpack : modpacks) {
+		auto fileload_func = [&base_path = modpack.base_path, &preloaded](const std::string &filename) {
+			// nyan wants a string filepath, so we have to construct it from the
+			// path and subpath parameters
+			log::log(INFO << "Loading .nyan file: " << filename);
+			auto loc = base_path + "/" + filename;
+
+			// files that are imported from outside the includes are read from disk
+			auto content = preloaded.find(filename);
+			if (content == std::end(preloaded)) {
+				return std::make_shared<nyan::File>(loc);
 			}
 
-			auto new_search = search + "/" + p.get_name();
-			this->load_path(base_dir, mod_dir, new_search, recursive);
+			auto file = std::make_shared<nyan::File>(loc, std::move(content->second));
+			preloaded.erase(content);
+			return file;
+		};
+
+		for (const auto &file : modpack.files) {
+			this->db->load(modpack.mod_dir + "/" + file, fileload_func);
 		}
 	}
 }
@@ -23,10 +23,6 @@ namespace renderer {
 class RenderFactory;
 }
 
-namespace util {
-class Path;
-}
-
 namespace gamestate {
 class GameState;
 class EntityFactory;
@@ -76,24 +72,14 @@ private:
 	/**
 	 * Load game data from the filesystem.
 	 *
-	 * @param mod_manager Mod manager.
-	 */
-	void load_data(const std::shared_ptr<assets::ModManager> &mod_manager);
-
-	/**
-	 * Load game data from the filesystem recursively.
+	 * The nyan files of the loaded modpacks are found and read in parallel,
+	 * then handed to nyan from memory.
 	 *
 	 * TODO: Move this into nyan.
 	 *
-	 * @param base_dir Base directory where mods are stored.
-	 * @param mod_dir Name of the mod directory.
-	 * @param search Search path relative to the mod directory.
-	 * @param recursive if true, recursively search subfolders if the the search path is a directory.
+	 * @param mod_manager Mod manager.
 	 */
-	void load_path(const util::Path &base_dir,
-	               const std::string &mod_dir,
-	               const std::string &search,
-	               bool recursive = false);
+	void load_data(const std::shared_ptr<assets::ModManager> &mod_manager);
 
 	/**
 	 * Generate the terrain for the current game.
@@ -1,4 +1,4 @@
-// Copyright 2022-2023 the openage authors. See copying.md for legal info.
+// Copyright 2022-2024 the openage authors. See copying.md for legal info.
 
 #include "game_entity.h"
 
@@ -10,13 +10,15 @@
 #include "gamestate/component/base_component.h"
 #include "gamestate/component/internal/position.h"
 #include "renderer/stages/world/render_entity.h"
+#include "util/hash.h"
 
 namespace openage::gamestate {
 
 GameEntity::GameEntity(entity_id_t id) :
 	id{id},
 	components{},
-	render_entity{nullptr} {
+	render_entity{nullptr},
+	change_notifier{nullptr} {
 }
 
 std::shared_ptr<GameEntity> GameEntity::copy(entity_id_t id) {
@@ -50,12 +52,34 @@ const std::shared_ptr<component::Component> &GameEntity::get_component(component
 
 void GameEntity::add_component(const std::shared_ptr<component::Component> &component) {
 	this->components.insert({component->get_type(), component});
+
+	if (this->change_notifier) {
+		component->set_change_notifier(this->change_notifier);
+	}
 }
 
 bool GameEntity::has_component(component::component_t type) {
 	return this->components.contains(type);
 }
 
+uint64_t GameEntity::get_hash() const {
+	// sum is commutative, so the iteration order of the map does not matter
+	uint64_t components_hash = 0;
+	for (const auto &[type, component] : this->components) {
+		components_hash += util::hash_append(static_cast<uint64_t>(type),
+		                                     component->get_hash());
+	}
+
+	return util::hash_append(static_cast<uint64_t>(this->id), components_hash);
+}
+
+void GameEntity::set_change_notifier(const std::function<void(const time::time_t &)> &notifier) {
+	this->change_notifier = notifier;
+	for (auto &[type, component] : this->components) {
+		component->set_change_notifier(notifier);
+	}
+}
+
 void GameEntity::render_update(const time::time_t &time,
                                const std::string &animation_path) {
 	if (this->render_entity != nullptr) {
@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -99,6 +101,24 @@ public:
 	 */
 	bool has_component(component::component_t type);
 
+	/**
+	 * Get the hash of the entity's component data.
+	 *
+	 * Combines the hashes of all components, so the result does not depend
+	 * on the order in which components were added.
+	 *
+	 * @return Hash of the entity.
+	 */
+	uint64_t get_hash() const;
+
+	/**
+	 * Set the function that is notified when the data of one of the
+	 * entity's components changes. Components added later are notified too.
+	 *
+	 * @param notifier Change notifier. Can be \p nullptr.
+	 */
+	void set_change_notifier(const std::function<void(const time::time_t &)> &notifier);
+
 	/**
 	 * Update the render entity.
 	 *
@@ -148,6 +168,11 @@ private:
 	 * Event manager.
 	 */
 	std::shared_ptr<GameEntityManager> manager;
+
+	/**
+	 * Notified when the data of a component changes. Can be \p nullptr.
+	 */
+	std::function<void(const time::time_t &)> change_notifier;
 };
 
 } // namespace gamestate
@@ -1,4 +1,4 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2024 the openage authors. See copying.md for legal info.
 
 #include "game_state.h"
 
@@ -9,6 +9,7 @@
 
 #include "gamestate/game_entity.h"
 #include "gamestate/player.h"
+#include "gamestate/state_hasher.h"
 
 
 namespace openage::gamestate {
@@ -16,7 +17,8 @@ namespace openage::gamestate {
 GameState::GameState(const std::shared_ptr<nyan::Database> &db,
                      const std::shared_ptr<openage::event::EventLoop> &event_loop) :
 	event::State{event_loop},
-	db_view{db->new_view()} {
+	db_view{db->new_view()},
+	hasher{std::make_shared<StateHasher>()} {
 }
 
 const std::shared_ptr<nyan::View> &GameState::get_db_view() {
@@ -28,6 +30,16 @@ void GameState::add_game_entity(const std::shared_ptr<GameEntity> &entity) {
 		throw Error(MSG(err) << "Game entity with ID " << entity->get_id() << " already exists");
 	}
 	this->game_entities[entity->get_id()] = entity;
+	this->hasher->add(entity);
+}
+
+void GameState::remove_game_entity(entity_id_t id) {
+	if (not this->game_entities.contains(id)) [[unlikely]] {
+		throw Error(MSG(err) << "Game entity with ID " << id << " does not exist");
+	}
+	this->game_entities.erase(id);
+	this->command_wait_list.unpark(id);
+	this->hasher->remove(id);
 }
 
 void GameState::add_player(const std::shared_ptr<Player> &player) {
@@ -59,10 +71,22 @@ const std::shared_ptr<Player> &GameState::get_player(player_id_t id) const {
 	return this->players.at(id);
 }
 
+const std::unordered_map<player_id_t, std::shared_ptr<Player>> &GameState::get_players() const {
+	return this->players;
+}
+
 const std::shared_ptr<Terrain> &GameState::get_terrain() const {
 	return this->terrain;
 }
 
+activity::WaitList &GameState::get_command_wait_list() {
+	return this->command_wait_list;
+}
+
+uint64_t GameState::get_hash() {
+	return this->hasher->get_hash();
+}
+
 const std::shared_ptr<assets::ModManager> &GameState::get_mod_manager() const {
 	return this->mod_manager;
 }
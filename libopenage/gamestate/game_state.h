@@ -2,10 +2,12 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <unordered_map>
 
 #include "event/state.h"
+#include "gamestate/activity/wait_list.h"
 #include "gamestate/types.h"
 
 
@@ -27,6 +29,7 @@ class EventLoop;
 namespace gamestate {
 class GameEntity;
 class Player;
+class StateHasher;
 class Terrain;
 
 /**
@@ -62,6 +65,16 @@ public:
 	 */
 	void add_game_entity(const std::shared_ptr<GameEntity> &entity);
 
+	/**
+	 * Remove a game entity from the index.
+	 *
+	 * The entity is also removed from the command wait list and the state hash.
+	 * Pending events of the entity are not cancelled.
+	 *
+	 * @param id ID of the game entity.
+	 */
+	void remove_game_entity(entity_id_t id);
+
 	/**
 	 * Add a new player to the index.
 	 *
@@ -101,6 +114,13 @@ public:
 	 */
 	const std::shared_ptr<Player> &get_player(player_id_t id) const;
 
+	/**
+	 * Get all players in the current game.
+	 *
+	 * @return Map of all players in the current game by their ID.
+	 */
+	const std::unordered_map<player_id_t, std::shared_ptr<Player>> &get_players() const;
+
 	/**
 	 * Get the terrain of the current game.
 	 *
@@ -108,6 +128,22 @@ public:
 	 */
 	const std::shared_ptr<Terrain> &get_terrain() const;
 
+	/**
+	 * Get the game entities that wait for a command in their command queue.
+	 *
+	 * @return Wait list of the command queue condition.
+	 */
+	activity::WaitList &get_command_wait_list();
+
+	/**
+	 * Get the hash of all game entities in the current game.
+	 *
+	 * Only the game entities that changed since the last call are hashed again.
+	 *
+	 * @return Hash of the game entities.
+	 */
+	uint64_t get_hash();
+
 	/**
 	 * TODO: Only for testing.
 	 */
@@ -135,6 +171,16 @@ private:
 	 */
 	std::shared_ptr<Terrain> terrain;
 
+	/**
+	 * Game entities that wait for a command in their command queue.
+	 */
+	activity::WaitList command_wait_list;
+
+	/**
+	 * Incrementally updated hash of the game entities.
+	 */
+	std::shared_ptr<StateHasher> hasher;
+
 	/**
 	 * TODO: Only for testing
 	 */
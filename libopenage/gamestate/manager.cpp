@@ -1,4 +1,4 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2024 the openage authors. See copying.md for legal info.
 
 #include "manager.h"
 
@@ -6,7 +6,9 @@
 #include "log/message.h"
 
 #include "gamestate/component/internal/command_queue.h"
+#include "gamestate/activity/wait_list.h"
 #include "gamestate/game_entity.h"
+#include "gamestate/game_state.h"
 #include "gamestate/system/activity.h"
 
 
@@ -26,6 +28,27 @@ void GameEntityManager::run_activity_system(const time::time_t &time,
 	system::Activity::advance(time, this->game_entity, this->loop, this->state, ev_params);
 }
 
+void GameEntityManager::run_activity_system(const time::time_t &time,
+                                            const std::vector<system::ActivityTarget> &targets) {
+	if (targets.empty()) {
+		return;
+	}
+
+	log::log(DBG << "Running activity system for " << targets.size() << " entities");
+	const auto &mgr = targets[0].entity->get_manager();
+	system::Activity::advance(time, targets, mgr->loop, mgr->state);
+}
+
+void GameEntityManager::wake_for_command(const time::time_t &time) {
+	auto next_id = this->state->get_command_wait_list().wake(this->game_entity->get_id());
+	if (next_id.has_value()) {
+		system::Activity::advance(time,
+		                          {system::ActivityTarget{this->game_entity, next_id.value()}},
+		                          this->loop,
+		                          this->state);
+	}
+}
+
 size_t GameEntityManager::id() const {
 	// TODO
 	return this->game_entity->get_id();
@@ -1,4 +1,4 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2024 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -6,6 +6,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "event/evententity.h"
 #include "event/eventhandler.h"
@@ -21,6 +22,10 @@ namespace gamestate {
 class GameState;
 class GameEntity;
 
+namespace system {
+struct ActivityTarget;
+} // namespace system
+
 class GameEntityManager : public openage::event::EventEntity {
 public:
 	GameEntityManager(const std::shared_ptr<openage::event::EventLoop> &loop,
@@ -31,6 +36,26 @@ public:
 	void run_activity_system(const time::time_t &time,
 	                         const std::optional<openage::event::EventHandler::param_map> &ev_params = std::nullopt);
 
+	/**
+	 * Run the activity system for multiple game entities in one batch.
+	 *
+	 * All entities must belong to the same game state.
+	 *
+	 * @param time Current simulation time.
+	 * @param targets Game entities and the event gateway outputs they continue with.
+	 */
+	static void run_activity_system(const time::time_t &time,
+	                                const std::vector<system::ActivityTarget> &targets);
+
+	/**
+	 * Continue the activity of the game entity if it waits for a command.
+	 *
+	 * Called when a command is added to the command queue of the entity.
+	 *
+	 * @param time Time at which the command was added.
+	 */
+	void wake_for_command(const time::time_t &time);
+
 	size_t id() const override;
 	std::string idstr() const override;
 
@@ -0,0 +1,222 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "replay.h"
+
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <map>
+#include <string_view>
+#include <utility>
+
+#include "error/error.h"
+#include "log/log.h"
+#include "log/message.h"
+
+#include "event/event_loop.h"
+#include "event/evententity.h"
+#include "gamestate/game_state.h"
+#include "gamestate/serialize.h"
+#include "util/mmap.h"
+
+
+namespace openage::gamestate {
+
+namespace {
+
+using serialize::Decoder;
+using serialize::Encoder;
+
+/**
+ * First bytes of a replay. The last byte is the format version,
+ * bump it when the format changes.
+ */
+constexpr std::string_view replay_magic{"OAREPL\0\1", 8};
+
+enum class record_t : uint8_t {
+	EVENT,
+	STATE_HASH,
+};
+
+} // namespace
+
+
+ReplayRecorder::ReplayRecorder(const std::string &path,
+                               const time::time_t &hash_interval) :
+	file{path, std::ios::binary | std::ios::trunc},
+	buffer{std::begin(replay_magic), std::end(replay_magic)},
+	hash_interval{hash_interval},
+	last_hash{std::nullopt} {
+	if (not this->file) {
+		throw Error{MSG(err) << "Could not open replay file " << path};
+	}
+}
+
+ReplayRecorder::~ReplayRecorder() {
+	try {
+		this->flush();
+	}
+	catch (const std::exception &err) {
+		log::log(WARN << "Writing replay failed: " << err.what());
+	}
+}
+
+void ReplayRecorder::attach(const std::shared_ptr<event::EventLoop> &loop) {
+	loop->set_post_observer([this](const time::time_t &time_until,
+	                               const std::string &eventhandler,
+	                               const std::shared_ptr<event::EventEntity> &target,
+	                               const time::time_t &reference_time,
+	                               const event::EventHandler::param_map &params) {
+		this->record(time_until, eventhandler, target, reference_time, params);
+	});
+}
+
+void ReplayRecorder::detach(const std::shared_ptr<event::EventLoop> &loop) {
+	loop->set_post_observer(nullptr);
+	this->flush();
+}
+
+void ReplayRecorder::record(const time::time_t &time_until,
+                            const std::string &eventhandler,
+                            const std::shared_ptr<event::EventEntity> &target,
+                            const time::time_t &reference_time,
+                            const event::EventHandler::param_map &params) {
+	Encoder out;
+	out.buffer = std::move(this->buffer);
+
+	out.put(record_t::EVENT);
+	out.put(time_until);
+	out.put(eventhandler);
+
+	out.put<uint8_t>(target != nullptr);
+	if (target != nullptr) {
+		out.put(target->idstr());
+		out.put<uint64_t>(target->id());
+	}
+
+	out.put(reference_time);
+
+	serialize::put_params(out, params, eventhandler);
+
+	this->buffer = std::move(out.buffer);
+}
+
+void ReplayRecorder::checkpoint(const time::time_t &time,
+                                const std::shared_ptr<GameState> &state) {
+	if (this->last_hash.has_value() and time < *this->last_hash + this->hash_interval) {
+		return;
+	}
+
+	Encoder out;
+	out.buffer = std::move(this->buffer);
+	out.put(record_t::STATE_HASH);
+	out.put(time);
+	out.put(state->get_hash());
+	this->buffer = std::move(out.buffer);
+
+	this->last_hash = time;
+	this->flush();
+}
+
+void ReplayRecorder::flush() {
+	this->file.write(reinterpret_cast<const char *>(this->buffer.data()), this->buffer.size());
+	this->file.flush();
+	this->buffer.clear();
+
+	if (not this->file) {
+		throw Error{MSG(err) << "Could not write to replay file"};
+	}
+}
+
+
+ReplayResult play_replay(const uint8_t *data,
+                         size_t size,
+                         const std::shared_ptr<GameState> &state,
+                         const std::shared_ptr<event::EventLoop> &loop,
+                         const std::vector<std::shared_ptr<event::EventEntity>> &targets) {
+	std::map<std::pair<std::string, size_t>, std::shared_ptr<event::EventEntity>> targets_by_id;
+	for (const auto &target : targets) {
+		targets_by_id.emplace(std::make_pair(target->idstr(), target->id()), target);
+	}
+
+	Decoder in{data, size};
+	auto magic = in.take(replay_magic.size());
+	if (std::memcmp(magic, replay_magic.data(), replay_magic.size()) != 0) {
+		throw Error{MSG(err) << "Data is not a replay or has an unsupported version"};
+	}
+
+	ReplayResult result;
+
+	// events are created in batches and the loop only advances
+	// when the batch of the next loop step starts
+	std::optional<time::time_t> pending;
+	while (in.remaining() > 0) {
+		auto type = in.get<record_t>();
+		switch (type) {
+		case record_t::EVENT: {
+			auto time_until = in.get<time::time_t>();
+			if (pending.has_value() and *pending != time_until) {
+				loop->reach_time(*pending, state);
+			}
+			pending = time_until;
+
+			auto eventhandler = in.get_string();
+
+			std::shared_ptr<event::EventEntity> target = nullptr;
+			if (in.get<uint8_t>()) {
+				auto idstr = in.get_string();
+				auto id = in.get<uint64_t>();
+				auto it = targets_by_id.find(std::make_pair(idstr, id));
+				if (it == std::end(targets_by_id)) {
+					throw Error{MSG(err) << "Replay references unknown event target "
+					                     << idstr << " (" << id << ")"};
+				}
+				target = it->second;
+			}
+
+			auto reference_time = in.get<time::time_t>();
+
+			auto params = serialize::get_params(in);
+			loop->create_event(eventhandler, target, state, reference_time, params);
+
+			result.events += 1;
+			result.end_time = time_until;
+		} break;
+		case record_t::STATE_HASH: {
+			auto time = in.get<time::time_t>();
+			auto hash = in.get<uint64_t>();
+
+			loop->reach_time(time, state);
+			pending = std::nullopt;
+
+			result.checkpoints += 1;
+			result.end_time = time;
+
+			if (state->get_hash() != hash) {
+				log::log(WARN << "Replay diverged at t=" << time);
+				result.diverged_at = time;
+				return result;
+			}
+		} break;
+		default:
+			throw Error{MSG(err) << "Replay contains unknown record type "
+			                     << static_cast<int>(type)};
+		}
+	}
+
+	if (pending.has_value()) {
+		loop->reach_time(*pending, state);
+	}
+
+	return result;
+}
+
+ReplayResult play_replay(const std::string &path,
+                         const std::shared_ptr<GameState> &state,
+                         const std::shared_ptr<event::EventLoop> &loop,
+                         const std::vector<std::shared_ptr<event::EventEntity>> &targets) {
+	util::MMap file{path};
+	return play_replay(file.data(), file.size(), state, loop, targets);
+}
+
+} // namespace openage::gamestate
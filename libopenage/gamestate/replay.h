@@ -0,0 +1,179 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "event/eventhandler.h"
+#include "time/time.h"
+
+
+namespace openage {
+
+namespace event {
+class EventEntity;
+class EventLoop;
+} // namespace event
+
+namespace gamestate {
+class GameState;
+
+/**
+ * Records the events that enter the simulation from outside, i.e. the events
+ * requested with \p EventLoop::post_event(), to a binary replay file.
+ *
+ * Together with the initial game setup, the recorded events are enough to
+ * play the match again. The recorder also stores hashes of the game state
+ * in regular intervals so that playback can detect when it diverges.
+ *
+ * Event parameters that can not be stored, e.g. callbacks into the UI,
+ * are left out of the recording.
+ */
+class ReplayRecorder {
+public:
+	/**
+	 * Create a new replay recorder.
+	 *
+	 * @param path Native path of the replay file. Existing files are overwritten.
+	 * @param hash_interval Simulation time between two state hashes.
+	 */
+	ReplayRecorder(const std::string &path,
+	               const time::time_t &hash_interval = 1);
+
+	/**
+	 * Writes the remaining records to the file.
+	 */
+	~ReplayRecorder();
+
+	/**
+	 * Start recording the events posted to an event loop.
+	 *
+	 * The recorder must stay alive until \p detach() is called.
+	 *
+	 * @param loop Event loop.
+	 */
+	void attach(const std::shared_ptr<openage::event::EventLoop> &loop);
+
+	/**
+	 * Stop recording events of an event loop.
+	 *
+	 * @param loop Event loop.
+	 */
+	void detach(const std::shared_ptr<openage::event::EventLoop> &loop);
+
+	/**
+	 * Record an event.
+	 *
+	 * @param time_until Time that the event loop was advanced to after creating the event.
+	 * @param eventhandler Event handler ID.
+	 * @param target Target entity. Can be \p nullptr.
+	 * @param reference_time Reference time of the event.
+	 * @param params Event parameters.
+	 */
+	void record(const time::time_t &time_until,
+	            const std::string &eventhandler,
+	            const std::shared_ptr<openage::event::EventEntity> &target,
+	            const time::time_t &reference_time,
+	            const openage::event::EventHandler::param_map &params);
+
+	/**
+	 * Store a hash of the game state if the hash interval has passed since
+	 * the last one. Should be called after the event loop reached \p time.
+	 *
+	 * @param time Current simulation time.
+	 * @param state Game state.
+	 */
+	void checkpoint(const time::time_t &time,
+	                const std::shared_ptr<GameState> &state);
+
+	/**
+	 * Write buffered records to the file.
+	 */
+	void flush();
+
+private:
+	/**
+	 * Replay file.
+	 */
+	std::ofstream file;
+
+	/**
+	 * Records that were not written yet.
+	 */
+	std::vector<uint8_t> buffer;
+
+	/**
+	 * Simulation time between two state hashes.
+	 */
+	time::time_t hash_interval;
+
+	/**
+	 * Time of the last state hash.
+	 */
+	std::optional<time::time_t> last_hash;
+};
+
+
+/**
+ * Result of a replay playback.
+ */
+struct ReplayResult {
+	/// number of events that were replayed
+	size_t events = 0;
+	/// number of state hashes that were compared
+	size_t checkpoints = 0;
+	/// simulation time of the last record
+	time::time_t end_time = 0;
+	/// time of the first state hash that did not match, if any
+	std::optional<time::time_t> diverged_at = std::nullopt;
+};
+
+
+/**
+ * Play a recorded replay as fast as possible.
+ *
+ * The recorded events are created on the event loop and the loop is only
+ * advanced to the times where events were created or state hashes were
+ * taken. The game state must be set up the same way as it was when the
+ * recording started.
+ *
+ * Playback stops at the first state hash that does not match.
+ *
+ * @param data Start of the replay data.
+ * @param size Size of the replay data in bytes.
+ * @param state Game state.
+ * @param loop Event loop of the game state. Must have the event handlers of the recording.
+ * @param targets Event targets that recorded events may reference, e.g. the
+ *                spawner. Targets are identified by their \p idstr() and \p id().
+ *
+ * @return Playback statistics.
+ */
+ReplayResult play_replay(const uint8_t *data,
+                         size_t size,
+                         const std::shared_ptr<GameState> &state,
+                         const std::shared_ptr<openage::event::EventLoop> &loop,
+                         const std::vector<std::shared_ptr<openage::event::EventEntity>> &targets);
+
+/**
+ * Play a replay file as fast as possible.
+ *
+ * @param path Native path of the replay file.
+ * @param state Game state.
+ * @param loop Event loop of the game state.
+ * @param targets Event targets that recorded events may reference.
+ *
+ * @return Playback statistics.
+ */
+ReplayResult play_replay(const std::string &path,
+                         const std::shared_ptr<GameState> &state,
+                         const std::shared_ptr<openage::event::EventLoop> &loop,
+                         const std::vector<std::shared_ptr<openage::event::EventEntity>> &targets);
+
+} // namespace gamestate
+} // namespace openage
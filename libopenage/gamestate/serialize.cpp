@@ -0,0 +1,209 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "serialize.h"
+
+#include <cstring>
+#include <iterator>
+#include <typeinfo>
+#include <utility>
+
+#include <eigen3/Eigen/Dense>
+
+#include "log/log.h"
+
+#include "gamestate/component/internal/commands/types.h"
+#include "gamestate/types.h"
+
+
+namespace openage::gamestate::serialize {
+
+namespace {
+
+/**
+ * Types of event parameters that can be encoded.
+ *
+ * Values are stored in replays and snapshots, only append new types.
+ */
+enum class param_t : uint8_t {
+	BOOL,
+	INT32,
+	UINT32,
+	INT64,
+	UINT64,
+	SIZE,
+	FLOAT,
+	DOUBLE,
+	STRING,
+	TIME,
+	PHYS3,
+	COMMAND_TYPE,
+	ENTITY_IDS,
+	VECTOR2F,
+	MATRIX4F,
+};
+
+
+template <typename T>
+void put_value(Encoder &out, const T &value) {
+	out.put(value);
+}
+
+void put_value(Encoder &out, const std::vector<entity_id_t> &ids) {
+	out.put<uint64_t>(ids.size());
+	for (auto id : ids) {
+		out.put(id);
+	}
+}
+
+void put_value(Encoder &out, const Eigen::Vector2f &vector) {
+	out.put(vector.x());
+	out.put(vector.y());
+}
+
+void put_value(Encoder &out, const Eigen::Matrix4f &matrix) {
+	for (int i = 0; i < matrix.size(); ++i) {
+		out.put(matrix.data()[i]);
+	}
+}
+
+template <typename T>
+T get_value(Decoder &in) {
+	if constexpr (std::is_same_v<T, std::string>) {
+		return in.get_string();
+	}
+	else if constexpr (std::is_same_v<T, std::vector<entity_id_t>>) {
+		auto count = in.get<uint64_t>();
+		std::vector<entity_id_t> ids;
+		ids.reserve(std::min<uint64_t>(count, in.remaining()));
+		for (uint64_t i = 0; i < count; ++i) {
+			ids.push_back(in.get<entity_id_t>());
+		}
+		return ids;
+	}
+	else if constexpr (std::is_same_v<T, Eigen::Vector2f> or std::is_same_v<T, Eigen::Matrix4f>) {
+		T matrix;
+		for (int i = 0; i < matrix.size(); ++i) {
+			matrix.data()[i] = in.get<float>();
+		}
+		return matrix;
+	}
+	else {
+		return in.get<T>();
+	}
+}
+
+template <typename T>
+bool try_put_param(Encoder &out, param_t type, const std::any &value) {
+	if (value.type() != typeid(T)) {
+		return false;
+	}
+
+	out.put(type);
+	put_value(out, std::any_cast<const T &>(value));
+	return true;
+}
+
+/**
+ * Encode an event parameter.
+ *
+ * @return false if the parameter type can not be encoded.
+ */
+bool encode_param(Encoder &out, const std::any &value) {
+	return try_put_param<bool>(out, param_t::BOOL, value)
+	       or try_put_param<int32_t>(out, param_t::INT32, value)
+	       or try_put_param<uint32_t>(out, param_t::UINT32, value)
+	       or try_put_param<int64_t>(out, param_t::INT64, value)
+	       or try_put_param<uint64_t>(out, param_t::UINT64, value)
+	       or try_put_param<size_t>(out, param_t::SIZE, value)
+	       or try_put_param<float>(out, param_t::FLOAT, value)
+	       or try_put_param<double>(out, param_t::DOUBLE, value)
+	       or try_put_param<std::string>(out, param_t::STRING, value)
+	       or try_put_param<time::time_t>(out, param_t::TIME, value)
+	       or try_put_param<coord::phys3>(out, param_t::PHYS3, value)
+	       or try_put_param<component::command::command_t>(out, param_t::COMMAND_TYPE, value)
+	       or try_put_param<std::vector<entity_id_t>>(out, param_t::ENTITY_IDS, value)
+	       or try_put_param<Eigen::Vector2f>(out, param_t::VECTOR2F, value)
+	       or try_put_param<Eigen::Matrix4f>(out, param_t::MATRIX4F, value);
+}
+
+std::any decode_param(Decoder &in) {
+	auto type = in.get<param_t>();
+	switch (type) {
+	case param_t::BOOL:
+		return get_value<bool>(in);
+	case param_t::INT32:
+		return get_value<int32_t>(in);
+	case param_t::UINT32:
+		return get_value<uint32_t>(in);
+	case param_t::INT64:
+		return get_value<int64_t>(in);
+	case param_t::UINT64:
+		return get_value<uint64_t>(in);
+	case param_t::SIZE:
+		return get_value<size_t>(in);
+	case param_t::FLOAT:
+		return get_value<float>(in);
+	case param_t::DOUBLE:
+		return get_value<double>(in);
+	case param_t::STRING:
+		return get_value<std::string>(in);
+	case param_t::TIME:
+		return get_value<time::time_t>(in);
+	case param_t::PHYS3:
+		return get_value<coord::phys3>(in);
+	case param_t::COMMAND_TYPE:
+		return get_value<component::command::command_t>(in);
+	case param_t::ENTITY_IDS:
+		return get_value<std::vector<entity_id_t>>(in);
+	case param_t::VECTOR2F:
+		return get_value<Eigen::Vector2f>(in);
+	case param_t::MATRIX4F:
+		return get_value<Eigen::Matrix4f>(in);
+	default:
+		throw Error{MSG(err) << "Data contains unknown event parameter type "
+		                     << static_cast<int>(type)};
+	}
+}
+
+} // namespace
+
+
+void put_params(Encoder &out,
+                const event::EventHandler::param_map &params,
+                const std::string &eventhandler) {
+	std::vector<std::pair<std::string, const std::any *>> entries;
+	for (const auto &[key, value] : params.get_map()) {
+		entries.emplace_back(key, &value);
+	}
+	std::sort(std::begin(entries), std::end(entries));
+
+	size_t count_pos = out.buffer.size();
+	uint32_t count = 0;
+	out.put(count);
+	for (const auto &[key, value] : entries) {
+		size_t entry_pos = out.buffer.size();
+		out.put(key);
+		if (encode_param(out, *value)) {
+			count += 1;
+		}
+		else {
+			// e.g. callbacks, they only feed results back to the UI
+			log::log(DBG << "Not encoding parameter " << key
+			             << " of event " << eventhandler);
+			out.buffer.resize(entry_pos);
+		}
+	}
+	std::memcpy(out.buffer.data() + count_pos, &count, sizeof(count));
+}
+
+event::EventHandler::param_map::map_t get_params(Decoder &in) {
+	event::EventHandler::param_map::map_t params;
+	auto count = in.get<uint32_t>();
+	for (uint32_t i = 0; i < count; ++i) {
+		auto key = in.get_string();
+		params.emplace(std::move(key), decode_param(in));
+	}
+	return params;
+}
+
+} // namespace openage::gamestate::serialize
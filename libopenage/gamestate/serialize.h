@@ -0,0 +1,190 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <algorithm>
+#include <any>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "error/error.h"
+#include "log/message.h"
+
+#include "coord/phys.h"
+#include "curve/keyframe_container.h"
+#include "event/eventhandler.h"
+#include "time/time.h"
+#include "util/fixed_point.h"
+
+
+/**
+ * Binary encoding of gamestate values, used by snapshots and replays.
+ */
+namespace openage::gamestate::serialize {
+
+/**
+ * Check if a type is a fixed point number.
+ */
+template <typename T>
+constexpr bool is_fixed_point_v = false;
+
+template <typename I, unsigned int F>
+constexpr bool is_fixed_point_v<util::FixedPoint<I, F>> = true;
+
+
+/**
+ * Appends values to a byte buffer in native byte order.
+ */
+class Encoder {
+public:
+	template <typename T>
+	void put(const T &value) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		auto bytes = reinterpret_cast<const uint8_t *>(&value);
+		this->buffer.insert(std::end(this->buffer), bytes, bytes + sizeof(T));
+	}
+
+	template <typename I, unsigned int F>
+	void put(const util::FixedPoint<I, F> &value) {
+		this->put<I>(value.get_raw_value());
+	}
+
+	void put(const coord::phys3 &value) {
+		this->put(value.ne);
+		this->put(value.se);
+		this->put(value.up);
+	}
+
+	void put(const std::string &value) {
+		this->put<uint64_t>(value.size());
+		this->buffer.insert(std::end(this->buffer), std::begin(value), std::end(value));
+	}
+
+	template <typename T>
+	void put_keyframes(const curve::KeyframeContainer<T> &keyframes) {
+		this->put<uint64_t>(keyframes.size());
+		for (const auto &keyframe : keyframes) {
+			this->put(keyframe.time());
+			this->put(keyframe.val());
+		}
+	}
+
+	/**
+	 * Start a block that is prefixed with its size, so that
+	 * readers can skip it.
+	 *
+	 * @return Position of the block.
+	 */
+	size_t begin_block() {
+		size_t pos = this->buffer.size();
+		this->put<uint64_t>(0);
+		return pos;
+	}
+
+	void end_block(size_t pos) {
+		uint64_t size = this->buffer.size() - pos - sizeof(uint64_t);
+		std::memcpy(this->buffer.data() + pos, &size, sizeof(size));
+	}
+
+	std::vector<uint8_t> buffer;
+};
+
+
+/**
+ * Reads values from a byte buffer. Throws if the data is truncated.
+ */
+class Decoder {
+public:
+	Decoder(const uint8_t *data, size_t size) :
+		data{data},
+		size{size},
+		pos{0} {}
+
+	template <typename T>
+	T get() {
+		if constexpr (std::is_same_v<T, coord::phys3>) {
+			auto ne = this->get<coord::phys_t>();
+			auto se = this->get<coord::phys_t>();
+			auto up = this->get<coord::phys_t>();
+			return coord::phys3{ne, se, up};
+		}
+		else if constexpr (is_fixed_point_v<T>) {
+			return T::from_raw_value(this->get<typename T::raw_type>());
+		}
+		else {
+			static_assert(std::is_trivially_copyable_v<T>);
+			T value;
+			std::memcpy(&value, this->take(sizeof(T)), sizeof(T));
+			return value;
+		}
+	}
+
+	std::string get_string() {
+		auto length = this->get<uint64_t>();
+		auto chars = reinterpret_cast<const char *>(this->take(length));
+		return std::string{chars, length};
+	}
+
+	template <typename T>
+	typename curve::KeyframeContainer<T>::container_t get_keyframes() {
+		auto count = this->get<uint64_t>();
+		typename curve::KeyframeContainer<T>::container_t keyframes;
+		keyframes.reserve(std::min<uint64_t>(count, this->remaining()));
+		for (uint64_t i = 0; i < count; ++i) {
+			auto time = this->get<time::time_t>();
+			auto value = this->get<T>();
+			keyframes.emplace_back(time, value);
+		}
+		return keyframes;
+	}
+
+	const uint8_t *take(size_t count) {
+		if (count > this->remaining()) {
+			throw Error{MSG(err) << "Data is truncated at byte " << this->pos};
+		}
+		const uint8_t *result = this->data + this->pos;
+		this->pos += count;
+		return result;
+	}
+
+	size_t remaining() const {
+		return this->size - this->pos;
+	}
+
+private:
+	const uint8_t *data;
+	size_t size;
+	size_t pos;
+};
+
+
+/**
+ * Encode the parameters of an event.
+ *
+ * Parameters of types that can not be encoded, e.g. callbacks, are skipped.
+ * Parameters are sorted by their key, so that the same parameters always
+ * have the same encoding.
+ *
+ * @param out Encoder.
+ * @param params Event parameters.
+ * @param eventhandler Event handler ID, used for logging skipped parameters.
+ */
+void put_params(Encoder &out,
+                const event::EventHandler::param_map &params,
+                const std::string &eventhandler);
+
+/**
+ * Decode the parameters of an event.
+ *
+ * @param in Decoder.
+ *
+ * @return Event parameters.
+ */
+event::EventHandler::param_map::map_t get_params(Decoder &in);
+
+} // namespace openage::gamestate::serialize
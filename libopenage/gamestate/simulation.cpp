@@ -2,15 +2,25 @@
 
 #include "simulation.h"
 
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
 #include "assets/mod_manager.h"
+#include "coord/phys.h"
+#include "cvar/cvar.h"
 #include "event/event_loop.h"
+#include "gamestate/collision/separation.h"
 #include "gamestate/entity_factory.h"
 #include "gamestate/event/drag_select.h"
 #include "gamestate/event/process_command.h"
 #include "gamestate/event/send_command.h"
+#include "gamestate/event/separate.h"
 #include "gamestate/event/spawn_entity.h"
 #include "gamestate/event/wait.h"
+#include "gamestate/replay.h"
 #include "gamestate/terrain_factory.h"
+#include "job/job_manager.h"
 #include "time/clock.h"
 #include "time/time_loop.h"
 
@@ -20,6 +30,21 @@
 
 namespace openage::gamestate {
 
+namespace {
+
+/**
+ * Radius of game entities for separating them.
+ */
+constexpr coord::phys_t separation_radius = coord::phys_t::from_double(0.25);
+
+/**
+ * Time between two separation steps.
+ */
+constexpr time::time_t separation_interval = time::time_t::from_double(0.25);
+
+} // namespace
+
+
 GameSimulation::GameSimulation(const util::Path &root_dir,
                                const std::shared_ptr<cvar::CVarManager> &cvar_manager,
                                const std::shared_ptr<openage::time::TimeLoop> time_loop) :
@@ -32,21 +57,42 @@ GameSimulation::GameSimulation(const util::Path &root_dir,
 	terrain_factory{std::make_shared<gamestate::TerrainFactory>()},
 	mod_manager{std::make_shared<assets::ModManager>(this->root_dir / "assets" / "converted")},
 	spawner{std::make_shared<gamestate::event::Spawner>(this->event_loop)},
-	commander{std::make_shared<gamestate::event::Commander>(this->event_loop)} {
+	commander{std::make_shared<gamestate::event::Commander>(this->event_loop)},
+	job_mgr{std::make_shared<job::JobManager>(std::max<int>(std::thread::hardware_concurrency(), 1))},
+	separator{std::make_shared<gamestate::event::Separator>(this->event_loop)} {
 	auto mods = mod_manager->enumerate_modpacks(root_dir / "assets" / "converted");
 	for (const auto &mod : mods) {
 		this->mod_manager->register_modpack(mod);
 	}
 
+	// limits the update rate of the simulation loop, can be changed at runtime
+	this->tick_rate = this->cvar_manager->create<int>("sim_tick_rate", 0);
+
 	log::log(MSG(info) << "Created game simulation");
 }
 
 
 void GameSimulation::run() {
 	this->start();
+	auto next_tick = std::chrono::steady_clock::now();
 	while (this->running) {
 		time::time_t current_time = this->time_loop->get_clock()->get_time();
 		this->event_loop->reach_time(current_time, this->game->get_state());
+
+		{
+			std::shared_lock lock{this->mutex};
+			if (this->replay_recorder) {
+				this->replay_recorder->checkpoint(current_time, this->game->get_state());
+			}
+		}
+
+		int tick_rate = this->tick_rate.get();
+		if (tick_rate > 0) {
+			// don't catch up on ticks that were missed because the loop was too slow
+			next_tick = std::max(next_tick + std::chrono::nanoseconds{1'000'000'000 / tick_rate},
+			                     std::chrono::steady_clock::now());
+			std::this_thread::sleep_until(next_tick);
+		}
 	}
 	log::log(MSG(info) << "Game simulation loop exited");
 }
@@ -55,13 +101,17 @@ void GameSimulation::run() {
 void GameSimulation::start() {
 	std::unique_lock lock{this->mutex};
 
-	this->init_event_handlers();
+	this->init_game();
 
-	// TODO: wait for presenter to initialize before starting?
-	this->game = std::make_shared<gamestate::Game>(event_loop,
-	                                               this->mod_manager,
-	                                               this->entity_factory,
-	                                               this->terrain_factory);
+	// internal events are not posted, so the recorder has to be told about them
+	auto start_time = this->time_loop->get_clock()->get_time();
+	this->event_loop->create_event("game.separate",
+	                               this->separator,
+	                               this->game->get_state(),
+	                               start_time);
+	if (this->replay_recorder) {
+		this->replay_recorder->record(start_time, "game.separate", this->separator, start_time, {});
+	}
 
 	this->running = true;
 
@@ -69,6 +119,34 @@ void GameSimulation::start() {
 }
 
 
+ReplayResult GameSimulation::replay(const std::string &path) {
+	{
+		std::unique_lock lock{this->mutex};
+
+		// the internal events of start() are created from the replay
+		this->init_game();
+	}
+
+	log::log(MSG(info) << "Playing replay " << path);
+	auto result = play_replay(path,
+	                          this->game->get_state(),
+	                          this->event_loop,
+	                          {this->spawner, this->commander, this->separator});
+
+	if (result.diverged_at.has_value()) {
+		log::log(MSG(err) << "Replay diverged at t=" << *result.diverged_at
+		                  << " after " << result.events << " events");
+	}
+	else {
+		log::log(MSG(info) << "Replay finished at t=" << result.end_time
+		                   << ": " << result.events << " events, "
+		                   << result.checkpoints << " state hashes matched");
+	}
+
+	return result;
+}
+
+
 void GameSimulation::stop() {
 	std::unique_lock lock{this->mutex};
 
@@ -133,6 +211,33 @@ void GameSimulation::set_modpacks(const std::vector<std::string> &modpacks) {
 	// TODO: Prevent setting modpacks if a game is already running
 }
 
+void GameSimulation::set_replay_recorder(const std::shared_ptr<ReplayRecorder> &recorder) {
+	std::unique_lock lock{this->mutex};
+
+	if (this->replay_recorder) {
+		this->replay_recorder->detach(this->event_loop);
+	}
+
+	this->replay_recorder = recorder;
+	if (this->replay_recorder) {
+		this->replay_recorder->attach(this->event_loop);
+	}
+}
+
+void GameSimulation::init_game() {
+	// the workers are stopped when the simulation is destroyed,
+	// so that a running simulation step can still finish its jobs
+	this->job_mgr->start();
+
+	this->init_event_handlers();
+
+	// TODO: wait for presenter to initialize before starting?
+	this->game = std::make_shared<gamestate::Game>(event_loop,
+	                                               this->mod_manager,
+	                                               this->entity_factory,
+	                                               this->terrain_factory);
+}
+
 void GameSimulation::init_event_handlers() {
 	auto drag_select_handler = std::make_shared<gamestate::event::DragSelectHandler>();
 	auto spawn_handler = std::make_shared<gamestate::event::SpawnEntityHandler>(this->event_loop,
@@ -140,11 +245,16 @@ void GameSimulation::init_event_handlers() {
 	auto command_handler = std::make_shared<gamestate::event::SendCommandHandler>();
 	auto manager_handler = std::make_shared<gamestate::event::ProcessCommandHandler>();
 	auto wait_handler = std::make_shared<gamestate::event::WaitHandler>();
+	auto separate_handler = std::make_shared<gamestate::event::SeparateHandler>(
+		std::make_shared<collision::Separation>(separation_radius,
+		                                        separation_interval,
+		                                        this->job_mgr));
 	this->event_loop->add_event_handler(drag_select_handler);
 	this->event_loop->add_event_handler(spawn_handler);
 	this->event_loop->add_event_handler(command_handler);
 	this->event_loop->add_event_handler(manager_handler);
 	this->event_loop->add_event_handler(wait_handler);
+	this->event_loop->add_event_handler(separate_handler);
 }
 
 } // namespace openage::gamestate
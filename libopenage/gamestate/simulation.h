@@ -3,7 +3,10 @@
 #pragma once
 
 #include <shared_mutex>
+#include <string>
+#include <vector>
 
+#include "cvar/typed_cvar.h"
 #include "util/path.h"
 
 namespace openage {
@@ -20,6 +23,10 @@ namespace event {
 class EventLoop;
 } // namespace event
 
+namespace job {
+class JobManager;
+} // namespace job
+
 namespace renderer {
 class RenderFactory;
 }
@@ -31,10 +38,13 @@ class TimeLoop;
 namespace gamestate {
 class EntityFactory;
 class Game;
+class ReplayRecorder;
+struct ReplayResult;
 class TerrainFactory;
 
 namespace event {
 class Commander;
+class Separator;
 class Spawner;
 } // namespace event
 
@@ -73,6 +83,19 @@ public:
 	 */
 	void start();
 
+	/**
+	 * Play a recorded replay as fast as possible instead of running the
+	 * simulation loop. The game is set up like in \p start(), but the
+	 * internal events of \p start() are taken from the replay.
+	 *
+	 * The modpacks must be the same as in the recorded match.
+	 *
+	 * @param path Native path of the replay file.
+	 *
+	 * @return Playback statistics.
+	 */
+	ReplayResult replay(const std::string &path);
+
 	/**
 	 * Stop of the simulation loop.
 	 */
@@ -136,6 +159,16 @@ public:
 	 */
 	void set_modpacks(const std::vector<std::string> &modpacks);
 
+	/**
+	 * Record the events posted to the simulation to a replay.
+	 *
+	 * The recorder must be set before the simulation is started,
+	 * so that the events created by \p start() are recorded too.
+	 *
+	 * @param recorder Replay recorder. Pass \p nullptr to stop recording.
+	 */
+	void set_replay_recorder(const std::shared_ptr<ReplayRecorder> &recorder);
+
 	/**
 	 * current simulation state variable.
 	 * to be set to false to stop the simulation loop.
@@ -143,6 +176,11 @@ public:
 	bool running;
 
 private:
+	/**
+	 * Create the game and initialize the event handlers.
+	 */
+	void init_game();
+
 	/**
 	 * Initialize event handlers.
 	 */
@@ -164,6 +202,11 @@ private:
 	 */
 	std::shared_ptr<cvar::CVarManager> cvar_manager;
 
+	/**
+	 * Maximum number of simulation loop iterations per second. 0 means unlimited.
+	 */
+	cvar::CVar<int> tick_rate;
+
 	/**
 	 * Time loop for getting the current simulation time and changing speed.
 	 */
@@ -193,9 +236,24 @@ private:
 	std::shared_ptr<gamestate::event::Spawner> spawner;
 	std::shared_ptr<gamestate::event::Commander> commander;
 
+	/**
+	 * Worker threads for the parallel parts of the simulation steps.
+	 */
+	std::shared_ptr<job::JobManager> job_mgr;
+
+	/**
+	 * Target of the events that push overlapping game entities apart.
+	 */
+	std::shared_ptr<gamestate::event::Separator> separator;
+
 	// TODO: The game run by the engine
 	std::shared_ptr<gamestate::Game> game;
 
+	/**
+	 * Records posted events and state hashes, if set.
+	 */
+	std::shared_ptr<ReplayRecorder> replay_recorder;
+
 	/**
 	 * Mutex for thread-safe access to the simulation.
 	 */
@@ -0,0 +1,708 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "snapshot.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+
+#include "error/error.h"
+#include "log/log.h"
+#include "log/message.h"
+
+#include "coord/phys.h"
+#include "curve/discrete.h"
+#include "curve/keyframe_container.h"
+#include "event/event.h"
+#include "event/event_loop.h"
+#include "event/evententity.h"
+#include "event/eventhandler.h"
+#include "event/eventqueue.h"
+#include "event/eventstore.h"
+#include "gamestate/activity/wait_list.h"
+#include "gamestate/component/api/live.h"
+#include "gamestate/component/internal/activity.h"
+#include "gamestate/component/internal/command_queue.h"
+#include "gamestate/component/internal/commands/custom.h"
+#include "gamestate/component/internal/commands/idle.h"
+#include "gamestate/component/internal/commands/move.h"
+#include "gamestate/component/internal/ownership.h"
+#include "gamestate/component/internal/position.h"
+#include "gamestate/component/types.h"
+#include "gamestate/game_entity.h"
+#include "gamestate/game_state.h"
+#include "gamestate/manager.h"
+#include "gamestate/serialize.h"
+#include "job/job_manager.h"
+#include "util/mmap.h"
+
+
+namespace openage::gamestate {
+
+namespace {
+
+using serialize::Decoder;
+using serialize::Encoder;
+
+/**
+ * First bytes of a snapshot. The last byte is the format version,
+ * bump it when the format changes.
+ */
+constexpr std::string_view snapshot_magic{"OASNAP\0\2", 8};
+
+enum class snapshot_kind_t : uint8_t {
+	FULL,
+	INCREMENTAL,
+};
+
+/**
+ * Components that are stored in snapshots.
+ */
+constexpr component::component_t snapshot_components[] = {
+	component::component_t::POSITION,
+	component::component_t::OWNERSHIP,
+	component::component_t::ACTIVITY,
+	component::component_t::COMMANDQUEUE,
+	component::component_t::LIVE,
+};
+
+
+/**
+ * Event targets by their string ID and numeric ID.
+ */
+using targets_t = std::map<std::pair<std::string, size_t>, std::shared_ptr<event::EventEntity>>;
+
+
+/**
+ * Header of a snapshot.
+ */
+struct SnapshotHeader {
+	snapshot_kind_t kind;
+	uint64_t sequence;
+	time::time_t time;
+};
+
+
+size_t entity_change_count(const std::shared_ptr<GameEntity> &entity) {
+	size_t count = 0;
+	if (entity->has_component(component::component_t::POSITION)) {
+		auto position = std::dynamic_pointer_cast<component::Position>(
+			entity->get_component(component::component_t::POSITION));
+		count += position->get_positions().get_change_count();
+		count += position->get_angles().get_change_count();
+	}
+	if (entity->has_component(component::component_t::OWNERSHIP)) {
+		auto ownership = std::dynamic_pointer_cast<component::Ownership>(
+			entity->get_component(component::component_t::OWNERSHIP));
+		count += ownership->get_owners().get_change_count();
+	}
+	if (entity->has_component(component::component_t::ACTIVITY)) {
+		auto activity = std::dynamic_pointer_cast<component::Activity>(
+			entity->get_component(component::component_t::ACTIVITY));
+		count += activity->get_pcs().get_change_count();
+	}
+	if (entity->has_component(component::component_t::COMMANDQUEUE)) {
+		auto command_queue = std::dynamic_pointer_cast<component::CommandQueue>(
+			entity->get_component(component::component_t::COMMANDQUEUE));
+		count += command_queue->get_queue().get_change_count();
+	}
+	if (entity->has_component(component::component_t::LIVE)) {
+		auto live = std::dynamic_pointer_cast<component::Live>(
+			entity->get_component(component::component_t::LIVE));
+		count += live->get_attributes().get_change_count();
+		for (const auto &[attribute, element] : live->get_attributes().get_container()) {
+			count += element.value->get_change_count();
+		}
+	}
+	return count;
+}
+
+
+/**
+ * Check if an event is a pending event that is not stored with a game entity.
+ *
+ * Events of game entities target their manager and are stored
+ * with the activity component.
+ */
+bool is_global_event(const std::shared_ptr<event::Event> &event) {
+	auto target = event->get_entity().lock();
+	return target != nullptr
+	       and std::dynamic_pointer_cast<GameEntityManager>(target) == nullptr;
+}
+
+/**
+ * Get the pending events that are not stored with a game entity.
+ *
+ * Events are sorted, so that snapshots of the same state are identical.
+ */
+std::vector<std::shared_ptr<event::Event>> get_global_events(const std::shared_ptr<event::EventLoop> &loop) {
+	std::vector<std::shared_ptr<event::Event>> events;
+	for (const auto &[event, element] : loop->get_queue().get_event_queue().events) {
+		if (is_global_event(event)) {
+			events.push_back(event);
+		}
+	}
+
+	std::sort(std::begin(events), std::end(events), [](const auto &a, const auto &b) {
+		auto a_target = a->get_entity().lock();
+		auto b_target = b->get_entity().lock();
+		return std::make_tuple(a->get_time(), a->get_eventhandler()->id(), a_target->idstr(), a_target->id())
+		       < std::make_tuple(b->get_time(), b->get_eventhandler()->id(), b_target->idstr(), b_target->id());
+	});
+
+	return events;
+}
+
+
+void encode_command(Encoder &out, const std::shared_ptr<component::command::Command> &command) {
+	if (command == nullptr) {
+		out.put(component::command::command_t::NONE);
+		return;
+	}
+
+	out.put(command->get_type());
+	switch (command->get_type()) {
+	case component::command::command_t::CUSTOM:
+		out.put(std::dynamic_pointer_cast<component::command::CustomCommand>(command)->get_id());
+		break;
+	case component::command::command_t::MOVE:
+		out.put(std::dynamic_pointer_cast<component::command::MoveCommand>(command)->get_target());
+		break;
+	case component::command::command_t::IDLE:
+	case component::command::command_t::NONE:
+	default:
+		break;
+	}
+}
+
+
+std::shared_ptr<component::command::Command> decode_command(Decoder &in) {
+	auto type = in.get<component::command::command_t>();
+	switch (type) {
+	case component::command::command_t::NONE:
+		return nullptr;
+	case component::command::command_t::CUSTOM:
+		return std::make_shared<component::command::CustomCommand>(in.get_string());
+	case component::command::command_t::IDLE:
+		return std::make_shared<component::command::IdleCommand>();
+	case component::command::command_t::MOVE: {
+		return std::make_shared<component::command::MoveCommand>(in.get<coord::phys3>());
+	}
+	default:
+		throw Error{MSG(err) << "Snapshot contains unknown command type "
+		                     << static_cast<int>(type)};
+	}
+}
+
+
+void encode_component(Encoder &out,
+                      const std::shared_ptr<component::Component> &component,
+                      component::component_t type) {
+	switch (type) {
+	case component::component_t::POSITION: {
+		auto position = std::dynamic_pointer_cast<component::Position>(component);
+		out.put_keyframes(position->get_positions().get_container());
+		out.put_keyframes(position->get_angles().get_container());
+	} break;
+	case component::component_t::OWNERSHIP: {
+		auto ownership = std::dynamic_pointer_cast<component::Ownership>(component);
+		out.put_keyframes(ownership->get_owners().get_container());
+	} break;
+	case component::component_t::ACTIVITY: {
+		auto activity = std::dynamic_pointer_cast<component::Activity>(component);
+		out.put_keyframes(activity->get_pcs().get_container());
+
+		// events that were not cancelled yet
+		std::vector<std::shared_ptr<event::Event>> events;
+		for (const auto &event : activity->get_events()) {
+			if (not event->get_entity().expired()) {
+				events.push_back(event);
+			}
+		}
+
+		out.put<uint64_t>(events.size());
+		for (const auto &event : events) {
+			out.put(event->get_eventhandler()->id());
+			out.put(event->get_time());
+			serialize::put_params(out, event->get_params(), event->get_eventhandler()->id());
+		}
+	} break;
+	case component::component_t::COMMANDQUEUE: {
+		auto command_queue = std::dynamic_pointer_cast<component::CommandQueue>(component);
+		const auto &elements = command_queue->get_queue().get_container();
+		out.put<uint64_t>(elements.size());
+		for (const auto &element : elements) {
+			out.put(element.alive());
+			out.put(element.dead());
+			encode_command(out, element.value);
+		}
+	} break;
+	case component::component_t::LIVE: {
+		auto live = std::dynamic_pointer_cast<component::Live>(component);
+		const auto &elements = live->get_attributes().get_container();
+
+		std::vector<nyan::fqon_t> attributes;
+		for (const auto &[attribute, element] : elements) {
+			attributes.push_back(attribute);
+		}
+		std::sort(std::begin(attributes), std::end(attributes));
+
+		out.put<uint64_t>(attributes.size());
+		for (const auto &attribute : attributes) {
+			const auto &element = elements.at(attribute);
+			out.put(attribute);
+			out.put(element.alive);
+			out.put(element.dead);
+			out.put_keyframes(element.value->get_container());
+		}
+	} break;
+	default:
+		throw Error{MSG(err) << "Component type " << static_cast<int>(type)
+		                     << " can not be stored in snapshots"};
+	}
+}
+
+
+void decode_component(Decoder &in,
+                      const std::shared_ptr<GameEntity> &entity,
+                      component::component_t type,
+                      const time::time_t &time,
+                      const std::shared_ptr<GameState> &state,
+                      const std::shared_ptr<event::EventLoop> &loop) {
+	const auto &component = entity->get_component(type);
+	switch (type) {
+	case component::component_t::POSITION: {
+		auto positions = in.get_keyframes<coord::phys3>();
+		auto angles = in.get_keyframes<coord::phys_angle_t>();
+		std::dynamic_pointer_cast<component::Position>(component)->restore(std::move(positions),
+		                                                                   std::move(angles));
+	} break;
+	case component::component_t::OWNERSHIP: {
+		auto owners = in.get_keyframes<player_id_t>();
+		std::dynamic_pointer_cast<component::Ownership>(component)->restore(std::move(owners));
+	} break;
+	case component::component_t::ACTIVITY: {
+		auto activity = std::dynamic_pointer_cast<component::Activity>(component);
+		activity->restore(in.get_keyframes<activity::pc_t>());
+
+		// replace the events the entity is currently waiting for
+		activity->cancel_events(time);
+		auto count = in.get<uint64_t>();
+		for (uint64_t i = 0; i < count; ++i) {
+			auto handler = in.get_string();
+			auto event_time = in.get<time::time_t>();
+			auto params = serialize::get_params(in);
+			auto event = loop->restore_event(handler, entity->get_manager(), state, event_time, params);
+			activity->add_event(event);
+		}
+	} break;
+	case component::component_t::COMMANDQUEUE: {
+		auto count = in.get<uint64_t>();
+		std::vector<std::tuple<time::time_t, time::time_t, std::shared_ptr<component::command::Command>>> elements;
+		elements.reserve(std::min<uint64_t>(count, in.remaining()));
+		for (uint64_t i = 0; i < count; ++i) {
+			auto alive = in.get<time::time_t>();
+			auto dead = in.get<time::time_t>();
+			elements.emplace_back(alive, dead, decode_command(in));
+		}
+		std::dynamic_pointer_cast<component::CommandQueue>(component)->get_queue().restore(elements);
+	} break;
+	case component::component_t::LIVE: {
+		auto &attributes = std::dynamic_pointer_cast<component::Live>(component)->get_attributes();
+		const auto &current = attributes.get_container();
+
+		auto count = in.get<uint64_t>();
+		std::vector<std::tuple<nyan::fqon_t, time::time_t, time::time_t, std::shared_ptr<curve::Discrete<int64_t>>>> elements;
+		elements.reserve(std::min<uint64_t>(count, in.remaining()));
+		for (uint64_t i = 0; i < count; ++i) {
+			auto attribute = in.get_string();
+			auto alive = in.get<time::time_t>();
+			auto dead = in.get<time::time_t>();
+
+			// keep the curves of existing attributes, others may reference them
+			std::shared_ptr<curve::Discrete<int64_t>> values;
+			auto existing = current.find(attribute);
+			if (existing != std::end(current)) {
+				values = existing->second.value;
+			}
+			else {
+				values = std::make_shared<curve::Discrete<int64_t>>(loop, 0);
+			}
+			values->restore(in.get_keyframes<int64_t>());
+
+			elements.emplace_back(std::move(attribute), alive, dead, std::move(values));
+		}
+		attributes.restore(elements);
+	} break;
+	default:
+		throw Error{MSG(err) << "Component type " << static_cast<int>(type)
+		                     << " can not be restored from snapshots"};
+	}
+}
+
+
+SnapshotHeader decode_header(Decoder &in) {
+	auto magic = in.take(snapshot_magic.size());
+	if (std::memcmp(magic, snapshot_magic.data(), snapshot_magic.size()) != 0) {
+		throw Error{MSG(err) << "Data is not a snapshot or has an unsupported version"};
+	}
+
+	SnapshotHeader header;
+	header.kind = in.get<snapshot_kind_t>();
+	if (header.kind != snapshot_kind_t::FULL and header.kind != snapshot_kind_t::INCREMENTAL) {
+		throw Error{MSG(err) << "Snapshot has unknown kind " << static_cast<int>(header.kind)};
+	}
+	header.sequence = in.get<uint64_t>();
+	header.time = in.get<time::time_t>();
+
+	return header;
+}
+
+
+targets_t index_targets(const std::vector<std::shared_ptr<event::EventEntity>> &targets) {
+	targets_t targets_by_id;
+	for (const auto &target : targets) {
+		targets_by_id.emplace(std::make_pair(target->idstr(), target->id()), target);
+	}
+	return targets_by_id;
+}
+
+
+void decode_players(Decoder &in,
+                    const std::shared_ptr<GameState> &state) {
+	const auto &players = state->get_players();
+
+	auto player_count = in.get<uint64_t>();
+	if (player_count != players.size()) {
+		throw Error{MSG(err) << "Snapshot contains " << player_count
+		                     << " players, but the game has " << players.size()};
+	}
+
+	for (uint64_t i = 0; i < player_count; ++i) {
+		auto id = in.get<player_id_t>();
+		if (not players.contains(id)) {
+			throw Error{MSG(err) << "Snapshot contains unknown player " << id};
+		}
+	}
+}
+
+
+void decode_entity_ids(Decoder &in,
+                       const SnapshotHeader &header,
+                       const std::shared_ptr<GameState> &state) {
+	const auto &entities = state->get_game_entities();
+
+	std::unordered_set<entity_id_t> ids;
+	auto entity_count = in.get<uint64_t>();
+	for (uint64_t i = 0; i < entity_count; ++i) {
+		auto id = in.get<entity_id_t>();
+		if (not entities.contains(id)) {
+			throw Error{MSG(err) << "Snapshot contains unknown game entity " << id};
+		}
+		ids.insert(id);
+	}
+
+	// entities that were spawned after the snapshot was taken
+	std::vector<std::shared_ptr<GameEntity>> removed;
+	for (const auto &[id, entity] : entities) {
+		if (not ids.contains(id)) {
+			removed.push_back(entity);
+		}
+	}
+
+	for (const auto &entity : removed) {
+		if (entity->has_component(component::component_t::ACTIVITY)) {
+			auto activity = std::dynamic_pointer_cast<component::Activity>(
+				entity->get_component(component::component_t::ACTIVITY));
+			activity->cancel_events(header.time);
+		}
+		state->remove_game_entity(entity->get_id());
+	}
+}
+
+
+void decode_events(Decoder &in,
+                   const SnapshotHeader &header,
+                   const std::shared_ptr<GameState> &state,
+                   const std::shared_ptr<event::EventLoop> &loop,
+                   const targets_t &targets) {
+	for (const auto &event : get_global_events(loop)) {
+		event->cancel(header.time);
+	}
+
+	auto event_count = in.get<uint64_t>();
+	for (uint64_t i = 0; i < event_count; ++i) {
+		auto handler = in.get_string();
+		auto idstr = in.get_string();
+		auto id = in.get<uint64_t>();
+		auto event_time = in.get<time::time_t>();
+		auto params = serialize::get_params(in);
+
+		auto target = targets.find(std::make_pair(idstr, id));
+		if (target == std::end(targets)) {
+			throw Error{MSG(err) << "Snapshot references unknown event target "
+			                     << idstr << " (" << id << ")"};
+		}
+
+		loop->restore_event(handler, target->second, state, event_time, params);
+	}
+}
+
+
+void decode_entities(Decoder &in,
+                     const SnapshotHeader &header,
+                     const std::shared_ptr<GameState> &state,
+                     const std::shared_ptr<event::EventLoop> &loop) {
+	const auto &entities = state->get_game_entities();
+
+	auto entity_count = in.get<uint64_t>();
+	for (uint64_t i = 0; i < entity_count; ++i) {
+		auto id = in.get<entity_id_t>();
+		auto entity = entities.find(id);
+		if (entity == std::end(entities)) {
+			throw Error{MSG(err) << "Snapshot contains unknown game entity " << id};
+		}
+
+		auto &wait_list = state->get_command_wait_list();
+		wait_list.unpark(id);
+		auto waiting = in.get<uint8_t>();
+		auto next_id = in.get<uint64_t>();
+		if (waiting) {
+			wait_list.park(id, next_id);
+		}
+
+		auto component_count = in.get<uint32_t>();
+		for (uint32_t j = 0; j < component_count; ++j) {
+			auto type = in.get<component::component_t>();
+			auto block_size = in.get<uint64_t>();
+			Decoder block{in.take(block_size), block_size};
+
+			if (not entity->second->has_component(type)) {
+				throw Error{MSG(err) << "Snapshot contains a component of type "
+				                     << static_cast<int>(type) << " that game entity "
+				                     << id << " does not have"};
+			}
+			decode_component(block, entity->second, type, header.time, state, loop);
+		}
+	}
+}
+
+
+void decode_snapshot(Decoder &in,
+                     const SnapshotHeader &header,
+                     const std::shared_ptr<GameState> &state,
+                     const std::shared_ptr<event::EventLoop> &loop,
+                     const targets_t &targets) {
+	decode_players(in, state);
+	decode_entity_ids(in, header, state);
+	decode_events(in, header, state, loop, targets);
+	decode_entities(in, header, state, loop);
+}
+
+} // namespace
+
+
+SnapshotWriter::SnapshotWriter(const std::shared_ptr<job::JobManager> &job_mgr) :
+	job_mgr{job_mgr},
+	pending{},
+	sequence{0},
+	change_counts{} {
+}
+
+SnapshotWriter::~SnapshotWriter() {
+	try {
+		this->wait();
+	}
+	catch (const std::exception &err) {
+		log::log(WARN << "Writing snapshot failed: " << err.what());
+	}
+}
+
+std::vector<uint8_t> SnapshotWriter::capture(const std::shared_ptr<GameState> &state,
+                                             const std::shared_ptr<event::EventLoop> &loop,
+                                             const time::time_t &time) {
+	bool full = (this->sequence == 0);
+
+	Encoder out;
+	out.buffer.insert(std::end(out.buffer), std::begin(snapshot_magic), std::end(snapshot_magic));
+	out.put(full ? snapshot_kind_t::FULL : snapshot_kind_t::INCREMENTAL);
+	out.put<uint64_t>(this->sequence);
+	out.put(time);
+
+	// sort the players and entities so that snapshots of the same state are identical
+	std::vector<player_id_t> player_ids;
+	for (const auto &[id, player] : state->get_players()) {
+		player_ids.push_back(id);
+	}
+	std::sort(std::begin(player_ids), std::end(player_ids));
+
+	out.put<uint64_t>(player_ids.size());
+	for (auto id : player_ids) {
+		out.put(id);
+	}
+
+	const auto &entities = state->get_game_entities();
+	std::vector<entity_id_t> entity_ids;
+	std::vector<std::pair<entity_id_t, size_t>> changed;
+	for (const auto &[id, entity] : entities) {
+		entity_ids.push_back(id);
+
+		size_t count = entity_change_count(entity);
+		auto previous = this->change_counts.find(id);
+		if (full or previous == std::end(this->change_counts) or previous->second != count) {
+			changed.emplace_back(id, count);
+		}
+	}
+	std::sort(std::begin(entity_ids), std::end(entity_ids));
+	std::sort(std::begin(changed), std::end(changed));
+
+	// all entities are stored, so that restoring removes entities spawned later
+	out.put<uint64_t>(entity_ids.size());
+	for (auto id : entity_ids) {
+		out.put(id);
+	}
+
+	// forget removed entities, their IDs may be reused
+	std::erase_if(this->change_counts, [&entities](const auto &item) {
+		return not entities.contains(item.first);
+	});
+
+	auto events = get_global_events(loop);
+	out.put<uint64_t>(events.size());
+	for (const auto &event : events) {
+		auto target = event->get_entity().lock();
+		out.put(event->get_eventhandler()->id());
+		out.put(target->idstr());
+		out.put<uint64_t>(target->id());
+		out.put(event->get_time());
+		serialize::put_params(out, event->get_params(), event->get_eventhandler()->id());
+	}
+
+	auto &wait_list = state->get_command_wait_list();
+	out.put<uint64_t>(changed.size());
+	for (const auto &[id, count] : changed) {
+		const auto &entity = state->get_game_entity(id);
+		out.put(id);
+
+		auto next_id = wait_list.get(id);
+		out.put<uint8_t>(next_id.has_value());
+		out.put<uint64_t>(next_id.value_or(0));
+
+		std::vector<component::component_t> types;
+		for (auto type : snapshot_components) {
+			if (entity->has_component(type)) {
+				types.push_back(type);
+			}
+		}
+
+		out.put<uint32_t>(types.size());
+		for (auto type : types) {
+			out.put(type);
+			size_t block = out.begin_block();
+			encode_component(out, entity->get_component(type), type);
+			out.end_block(block);
+		}
+
+		this->change_counts.insert_or_assign(id, count);
+	}
+
+	this->sequence += 1;
+
+	return std::move(out.buffer);
+}
+
+void SnapshotWriter::save(const std::shared_ptr<GameState> &state,
+                          const std::shared_ptr<event::EventLoop> &loop,
+                          const time::time_t &time,
+                          const std::string &path) {
+	auto write_file = [path, data = this->capture(state, loop, time)]() {
+		std::ofstream file{path, std::ios::binary | std::ios::trunc};
+		file.write(reinterpret_cast<const char *>(data.data()), data.size());
+		file.close();
+		if (not file) {
+			throw Error{MSG(err) << "Could not write snapshot file " << path};
+		}
+		return true;
+	};
+
+	if (this->job_mgr == nullptr) {
+		write_file();
+		return;
+	}
+
+	// forget about finished writes
+	std::erase_if(this->pending, [](const job::Job<bool> &job) {
+		return job.is_finished();
+	});
+	this->pending.push_back(this->job_mgr->enqueue<bool>(std::move(write_file)));
+}
+
+void SnapshotWriter::wait() {
+	auto pending = std::move(this->pending);
+	this->pending.clear();
+
+	for (auto &job : pending) {
+		while (not job.is_finished()) {
+			std::this_thread::yield();
+		}
+		job.get_result();
+	}
+}
+
+void SnapshotWriter::reset() {
+	this->sequence = 0;
+	this->change_counts.clear();
+}
+
+
+time::time_t restore_snapshot(const uint8_t *data,
+                              size_t size,
+                              const std::shared_ptr<GameState> &state,
+                              const std::shared_ptr<event::EventLoop> &loop,
+                              const std::vector<std::shared_ptr<event::EventEntity>> &targets) {
+	Decoder in{data, size};
+	auto header = decode_header(in);
+	decode_snapshot(in, header, state, loop, index_targets(targets));
+
+	return header.time;
+}
+
+time::time_t load_snapshots(const std::vector<std::string> &paths,
+                            const std::shared_ptr<GameState> &state,
+                            const std::shared_ptr<event::EventLoop> &loop,
+                            const std::vector<std::shared_ptr<event::EventEntity>> &targets) {
+	auto targets_by_id = index_targets(targets);
+
+	time::time_t time = 0;
+	std::optional<uint64_t> sequence;
+	for (const auto &path : paths) {
+		util::MMap file{path};
+		Decoder in{file.data(), file.size()};
+		auto header = decode_header(in);
+
+		if (not sequence.has_value()) {
+			if (header.kind != snapshot_kind_t::FULL) {
+				throw Error{MSG(err) << "Snapshot chain does not start with a full snapshot: " << path};
+			}
+		}
+		else if (header.kind != snapshot_kind_t::INCREMENTAL or header.sequence != *sequence + 1) {
+			throw Error{MSG(err) << "Snapshot " << path << " does not continue the snapshot chain"};
+		}
+		sequence = header.sequence;
+
+		decode_snapshot(in, header, state, loop, targets_by_id);
+		time = header.time;
+	}
+
+	return time;
+}
+
+} // namespace openage::gamestate
@@ -0,0 +1,189 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gamestate/types.h"
+#include "job/job.h"
+#include "time/time.h"
+
+
+namespace openage {
+
+namespace event {
+class EventEntity;
+class EventLoop;
+} // namespace event
+
+namespace job {
+class JobManager;
+}
+
+namespace gamestate {
+class GameState;
+
+/**
+ * Writes binary snapshots of a game state.
+ *
+ * The first snapshot of a writer is a full snapshot. Every following
+ * snapshot is incremental and only contains the game entities that
+ * changed since the previous one. A chain of snapshots is restored by
+ * applying the full snapshot and then the incremental ones in order.
+ *
+ * Every snapshot stores
+ *   - the IDs of all players and game entities,
+ *   - the pending events of the event loop that do not target a game entity,
+ *     e.g. queued commands, spawns and the repeating separation event.
+ *
+ * For each stored game entity, snapshots contain the curves of the internal
+ * components (position, ownership, activity state and command queue),
+ * the attribute values of the Live component, the entity's place on the
+ * command wait list and its pending activity events.
+ *
+ * Not stored are
+ *   - the nyan views of players, API components other than Live and the
+ *     terrain, because they are defined by nyan objects or the game setup,
+ *   - event parameters that can not be encoded, e.g. callbacks,
+ *   - events requested with \p EventLoop::post_event() that were not
+ *     created yet. Snapshots should be taken between two loop steps.
+ *
+ * Encoding runs in the calling thread and only touches changed entities.
+ * Saving to a file is done on the job system if a job manager is given.
+ */
+class SnapshotWriter {
+public:
+	/**
+	 * Create a new snapshot writer.
+	 *
+	 * @param job_mgr Job manager for writing files in the background. If this
+	 *                is \p nullptr, files are written in the calling thread.
+	 */
+	SnapshotWriter(const std::shared_ptr<job::JobManager> &job_mgr = nullptr);
+
+	/**
+	 * Waits for pending file writes.
+	 */
+	~SnapshotWriter();
+
+	/**
+	 * Encode a snapshot of the game state.
+	 *
+	 * @param state Game state.
+	 * @param loop Event loop of the game state.
+	 * @param time Simulation time of the snapshot.
+	 *
+	 * @return Encoded snapshot.
+	 */
+	std::vector<uint8_t> capture(const std::shared_ptr<GameState> &state,
+	                             const std::shared_ptr<openage::event::EventLoop> &loop,
+	                             const time::time_t &time);
+
+	/**
+	 * Encode a snapshot of the game state and write it to a file.
+	 *
+	 * @param state Game state.
+	 * @param loop Event loop of the game state.
+	 * @param time Simulation time of the snapshot.
+	 * @param path Native path of the snapshot file.
+	 */
+	void save(const std::shared_ptr<GameState> &state,
+	          const std::shared_ptr<openage::event::EventLoop> &loop,
+	          const time::time_t &time,
+	          const std::string &path);
+
+	/**
+	 * Wait until all files passed to \p save() are written.
+	 *
+	 * Throws if writing a file failed.
+	 */
+	void wait();
+
+	/**
+	 * Make the next snapshot a full snapshot.
+	 */
+	void reset();
+
+private:
+	/**
+	 * Job manager for writing files.
+	 */
+	std::shared_ptr<job::JobManager> job_mgr;
+
+	/**
+	 * Jobs of pending file writes.
+	 */
+	std::vector<job::Job<bool>> pending;
+
+	/**
+	 * Number of snapshots encoded since the last full snapshot.
+	 */
+	uint64_t sequence;
+
+	/**
+	 * Sum of the change counts of the curves of each game entity
+	 * at the previous snapshot.
+	 */
+	std::unordered_map<entity_id_t, size_t> change_counts;
+};
+
+
+/**
+ * Restore a game state from an encoded snapshot.
+ *
+ * The snapshot can be restored into the game it was taken from or a game
+ * that was set up the same way:
+ *   - The game state must have the same players as the snapshot.
+ *   - All game entities in the snapshot must exist in the game state, because
+ *     they can not be created without their nyan objects. Game entities that
+ *     are not in the snapshot, e.g. because they were spawned after it was
+ *     taken, are removed from the game state and their events are cancelled.
+ *     Their render entities are not updated.
+ *   - Events that do not target a game entity must target one of \p targets.
+ *
+ * Pending events of the restored game entities and all pending events that
+ * do not target a game entity are replaced with the ones in the snapshot.
+ *
+ * Should only be called while the simulation is not running.
+ *
+ * @param data Start of the encoded snapshot.
+ * @param size Size of the encoded snapshot in bytes.
+ * @param state Game state.
+ * @param loop Event loop of the game state.
+ * @param targets Event targets that stored events may reference, e.g. the
+ *                entity spawner and the command handler of the simulation.
+ *
+ * @return Simulation time of the snapshot.
+ */
+time::time_t restore_snapshot(const uint8_t *data,
+                              size_t size,
+                              const std::shared_ptr<GameState> &state,
+                              const std::shared_ptr<openage::event::EventLoop> &loop,
+                              const std::vector<std::shared_ptr<openage::event::EventEntity>> &targets);
+
+/**
+ * Restore a game state from a chain of snapshot files.
+ *
+ * Files are memory-mapped and applied in order. The first file must contain
+ * a full snapshot, the others must be its incremental successors.
+ * See \p restore_snapshot() for the requirements on the game state.
+ *
+ * @param paths Native paths of the snapshot files.
+ * @param state Game state.
+ * @param loop Event loop of the game state.
+ * @param targets Event targets that stored events may reference.
+ *
+ * @return Simulation time of the last snapshot.
+ */
+time::time_t load_snapshots(const std::vector<std::string> &paths,
+                            const std::shared_ptr<GameState> &state,
+                            const std::shared_ptr<openage::event::EventLoop> &loop,
+                            const std::vector<std::shared_ptr<openage::event::EventEntity>> &targets);
+
+} // namespace gamestate
+} // namespace openage
@@ -0,0 +1,84 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "state_hasher.h"
+
+#include "error/error.h"
+#include "gamestate/game_entity.h"
+#include "time/time.h"
+
+
+namespace openage::gamestate {
+
+void StateHasher::add(const std::shared_ptr<GameEntity> &entity) {
+	auto id = entity->get_id();
+	auto existing = this->entities.find(id);
+	if (existing != this->entities.end()) {
+		this->hash -= existing->second.hash;
+		this->entities.erase(existing);
+	}
+
+	this->entities.emplace(id, entry{entity, 0, false});
+	this->mark_changed(id);
+
+	std::weak_ptr<StateHasher> hasher = this->weak_from_this();
+	entity->set_change_notifier([hasher, id](const time::time_t & /* time */) {
+		if (auto locked = hasher.lock()) {
+			locked->mark_changed(id);
+		}
+	});
+}
+
+void StateHasher::remove(entity_id_t id) {
+	auto it = this->entities.find(id);
+	if (it == this->entities.end()) {
+		return;
+	}
+
+	it->second.entity->set_change_notifier(nullptr);
+	this->hash -= it->second.hash;
+	if (it->second.dirty) {
+		std::erase(this->changed, id);
+	}
+	this->entities.erase(it);
+}
+
+void StateHasher::mark_changed(entity_id_t id) {
+	auto it = this->entities.find(id);
+	if (it == this->entities.end() or it->second.dirty) {
+		return;
+	}
+
+	it->second.dirty = true;
+	this->changed.push_back(id);
+}
+
+uint64_t StateHasher::get_hash() {
+	this->update();
+	return this->hash;
+}
+
+uint64_t StateHasher::get_entity_hash(entity_id_t id) {
+	auto it = this->entities.find(id);
+	if (it == this->entities.end()) [[unlikely]] {
+		throw Error{MSG(err) << "Game entity " << id << " is not hashed."};
+	}
+
+	this->update();
+	return it->second.hash;
+}
+
+void StateHasher::update() {
+	for (auto id : this->changed) {
+		auto &hashed = this->entities.at(id);
+
+		// entity hashes are summed up, so an entity can be replaced without
+		// touching the others
+		this->hash -= hashed.hash;
+		hashed.hash = hashed.entity->get_hash();
+		this->hash += hashed.hash;
+		hashed.dirty = false;
+	}
+	this->changed.clear();
+}
+
+} // namespace openage::gamestate
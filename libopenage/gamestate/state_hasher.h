@@ -0,0 +1,111 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "gamestate/types.h"
+
+
+namespace openage::gamestate {
+class GameEntity;
+
+/**
+ * Keeps a hash of all game entities in a game, e.g. to detect when two
+ * simulations of the same match diverge.
+ *
+ * The curves of the components update their hashes when keyframes are
+ * inserted or erased. Entities notify the hasher when one of their curves
+ * changes, so only the changed entities have to be hashed again when the
+ * global hash is requested.
+ *
+ * The hash covers the complete curves, i.e. the history and the predicted
+ * future of the entities. It is therefore the same for every simulation time.
+ */
+class StateHasher : public std::enable_shared_from_this<StateHasher> {
+public:
+	StateHasher() = default;
+	~StateHasher() = default;
+
+	/**
+	 * Add a game entity to the hash.
+	 *
+	 * Replaces the change notifier of the entity.
+	 *
+	 * @param entity Game entity.
+	 */
+	void add(const std::shared_ptr<GameEntity> &entity);
+
+	/**
+	 * Remove a game entity from the hash.
+	 *
+	 * Removes the change notifier of the entity.
+	 *
+	 * @param id ID of the game entity.
+	 */
+	void remove(entity_id_t id);
+
+	/**
+	 * Mark a game entity as changed. Its hash is updated on the next
+	 * call to \p get_hash().
+	 *
+	 * @param id ID of the game entity.
+	 */
+	void mark_changed(entity_id_t id);
+
+	/**
+	 * Get the hash of all game entities.
+	 *
+	 * Only the entities that changed since the last call are hashed again.
+	 *
+	 * @return Hash of the game entities.
+	 */
+	uint64_t get_hash();
+
+	/**
+	 * Get the hash of a single game entity.
+	 *
+	 * @param id ID of the game entity.
+	 *
+	 * @return Hash of the game entity.
+	 */
+	uint64_t get_entity_hash(entity_id_t id);
+
+private:
+	/**
+	 * Hashed game entity.
+	 */
+	struct entry {
+		/// game entity
+		std::shared_ptr<GameEntity> entity;
+		/// last computed hash of the entity
+		uint64_t hash;
+		/// whether the entity is in the list of changed entities
+		bool dirty;
+	};
+
+	/**
+	 * Update the hashes of the changed entities.
+	 */
+	void update();
+
+	/**
+	 * Hashed game entities by their ID.
+	 */
+	std::unordered_map<entity_id_t, entry> entities;
+
+	/**
+	 * IDs of the entities that changed since the last update.
+	 */
+	std::vector<entity_id_t> changed;
+
+	/**
+	 * Sum of the hashes of all entities.
+	 */
+	uint64_t hash = 0;
+};
+
+} // namespace openage::gamestate
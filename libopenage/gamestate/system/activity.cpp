@@ -1,24 +1,26 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2024 the openage authors. See copying.md for legal info.
 
 #include "activity.h"
 
 #include <functional>
+#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "error/error.h"
 #include "log/message.h"
 
+#include "gamestate/activity/compiled_activity.h"
+#include "gamestate/activity/condition/command_in_queue.h"
+#include "gamestate/activity/condition/next_command.h"
 #include "gamestate/activity/node.h"
-#include "gamestate/activity/start_node.h"
-#include "gamestate/activity/task_node.h"
-#include "gamestate/activity/task_system_node.h"
 #include "gamestate/activity/types.h"
-#include "gamestate/activity/xor_event_gate.h"
-#include "gamestate/activity/xor_gate.h"
+#include "gamestate/activity/wait_list.h"
 #include "gamestate/component/internal/activity.h"
 #include "gamestate/component/types.h"
 #include "gamestate/game_entity.h"
+#include "gamestate/game_state.h"
 #include "gamestate/system/idle.h"
 #include "gamestate/system/move.h"
 #include "util/fixed_point.h"
@@ -32,112 +34,210 @@ void Activity::advance(const time::time_t &start_time,
                        const std::shared_ptr<openage::event::EventLoop> &loop,
                        const std::shared_ptr<openage::gamestate::GameState> &state,
                        const std::optional<openage::event::EventHandler::param_map> &ev_params) {
-	auto activity_component = std::dynamic_pointer_cast<component::Activity>(
-		entity->get_component(component::component_t::ACTIVITY));
-	auto current_node = activity_component->get_node(start_time);
-
-	if (current_node == nullptr) [[unlikely]] {
-		throw Error{ERR << "No node defined in activity graph for entity "
-		                << std::to_string(entity->get_id()) << " (t=" << start_time << ")"};
+	ActivityTarget target{entity};
+	if (ev_params.has_value() and ev_params.value().contains("next")) {
+		target.next_id = ev_params.value().get<size_t>("next");
 	}
 
-	// TODO: this check should be moved to a more general pre-processing section
-	if (current_node->get_type() == activity::node_t::XOR_EVENT_GATE) {
-		// returning to a event gateway means that the event has been triggered
-		// move to the next node here
-		if (not ev_params.has_value()) {
-			throw Error{ERR << "XorEventGate: No event parameters given on continue"};
+	Activity::advance(start_time, std::vector<ActivityTarget>{target}, loop, state);
+}
+
+void Activity::advance(const time::time_t &start_time,
+                       const std::vector<ActivityTarget> &targets,
+                       const std::shared_ptr<openage::event::EventLoop> &loop,
+                       const std::shared_ptr<openage::gamestate::GameState> &state) {
+	// entities at the same instruction of the same program
+	struct Group {
+		const activity::CompiledActivity *program;
+		activity::pc_t pc;
+		std::vector<size_t> members;
+	};
+
+	std::vector<std::shared_ptr<component::Activity>> components;
+	std::vector<time::time_t> wait_times(targets.size(), 0);
+	components.reserve(targets.size());
+
+	// groups are processed in the order they are created, which keeps
+	// the order of side effects independent of memory addresses
+	std::vector<Group> groups;
+	size_t next_group = 0;
+	std::map<std::pair<const activity::CompiledActivity *, activity::pc_t>, size_t> open_groups;
+
+	auto enqueue = [&](const activity::CompiledActivity *program,
+	                   activity::pc_t pc,
+	                   size_t member) {
+		auto [it, inserted] = open_groups.try_emplace({program, pc}, groups.size());
+		if (inserted) {
+			groups.push_back(Group{program, pc, {}});
+		}
+		groups[it->second].members.push_back(member);
+	};
+
+	for (size_t i = 0; i < targets.size(); ++i) {
+		const auto &entity = targets[i].entity;
+		auto activity_component = std::dynamic_pointer_cast<component::Activity>(
+			entity->get_component(component::component_t::ACTIVITY));
+		const activity::CompiledActivity &program = activity_component->get_program();
+		activity::pc_t pc = activity_component->get_pc(start_time);
+
+		if (pc == activity::invalid_pc) [[unlikely]] {
+			throw Error{ERR << "No node defined in activity graph for entity "
+			                << std::to_string(entity->get_id()) << " (t=" << start_time << ")"};
 		}
 
-		auto next_id = ev_params.value().get<size_t>("next");
-		current_node = current_node->next(next_id);
+		// TODO: this check should be moved to a more general pre-processing section
+		if (program.at(pc).type == activity::node_t::XOR_EVENT_GATE) {
+			// returning to a event gateway means that the event has been triggered
+			// move to the next node here
+			if (not targets[i].next_id.has_value()) {
+				throw Error{ERR << "XorEventGate: No event parameters given on continue"};
+			}
+
+			pc = program.resume(pc, targets[i].next_id.value());
 
-		// cancel all other events that the manager may have been waiting for
-		activity_component->cancel_events(start_time);
+			// cancel all other events that the manager may have been waiting for
+			activity_component->cancel_events(start_time);
+			state->get_command_wait_list().unpark(entity->get_id());
+		}
+
+		components.push_back(std::move(activity_component));
+		enqueue(&program, pc, i);
 	}
 
-	time::time_t event_wait_time = 0;
-	auto stop = false;
-	while (not stop) {
-		switch (current_node->get_type()) {
+	std::vector<std::shared_ptr<gamestate::GameEntity>> batch;
+	while (next_group < groups.size()) {
+		// the group is closed now, entities arriving at the same instruction
+		// later (e.g. in a loop) form a new group
+		open_groups.erase({groups[next_group].program, groups[next_group].pc});
+		Group group = std::move(groups[next_group]);
+		next_group += 1;
+
+		const activity::CompiledActivity &program = *group.program;
+		const activity::Instruction &ins = program.at(group.pc);
+		switch (ins.type) {
 		case activity::node_t::START: {
-			auto node = std::static_pointer_cast<activity::StartNode>(current_node);
-			auto next_id = node->get_next();
-			current_node = node->next(next_id);
+			for (size_t member : group.members) {
+				enqueue(group.program, ins.next, member);
+			}
 		} break;
 		case activity::node_t::END: {
 			// TODO: if activities are nested, advance to parent activity
-			stop = true;
+			for (size_t member : group.members) {
+				components[member]->set_pc(start_time, group.pc);
+			}
 		} break;
 		case activity::node_t::TASK_CUSTOM: {
-			auto node = std::static_pointer_cast<activity::TaskCustom>(current_node);
-			auto task = node->get_task_func();
-			task(start_time, entity);
-			auto next_id = node->get_next();
-			current_node = node->next(next_id);
+			for (size_t member : group.members) {
+				program.get_task(ins.func)(start_time, targets[member].entity);
+				enqueue(group.program, ins.next, member);
+			}
 		} break;
 		case activity::node_t::TASK_SYSTEM: {
-			auto node = std::static_pointer_cast<activity::TaskSystemNode>(current_node);
-			auto task = node->get_system_id();
-			event_wait_time = Activity::handle_subsystem(entity, start_time, task);
-			auto next_id = node->get_next();
-			current_node = node->next(next_id);
+			batch.clear();
+			for (size_t member : group.members) {
+				batch.push_back(targets[member].entity);
+			}
+
+			auto runtimes = Activity::handle_subsystem(batch, start_time, ins.system_id);
+			for (size_t i = 0; i < group.members.size(); ++i) {
+				wait_times[group.members[i]] = runtimes[i];
+				enqueue(group.program, ins.next, group.members[i]);
+			}
 		} break;
 		case activity::node_t::XOR_GATE: {
-			auto node = std::static_pointer_cast<activity::XorGate>(current_node);
-			auto next_id = node->get_default()->get_id();
-			for (auto &condition : node->get_conditions()) {
-				auto condition_func = condition.second;
-				if (condition_func(start_time, entity)) {
-					next_id = condition.first;
-					break;
+			const activity::CompiledBranch *branches = program.branches(ins);
+			for (size_t member : group.members) {
+				activity::pc_t next = ins.next;
+				for (uint32_t i = 0; i < ins.count; ++i) {
+					if (Activity::check_condition(program, branches[i], start_time, targets[member].entity)) {
+						next = branches[i].target;
+						break;
+					}
 				}
+				enqueue(group.program, next, member);
 			}
-			current_node = node->next(next_id);
 		} break;
 		case activity::node_t::XOR_EVENT_GATE: {
-			auto node = std::static_pointer_cast<activity::XorEventGate>(current_node);
-			auto event_primers = node->get_primers();
-			for (auto &primer : event_primers) {
-				auto ev = primer.second(start_time + event_wait_time,
-				                        entity,
-				                        loop,
-				                        state,
-				                        primer.first);
-				activity_component->add_event(ev);
-			}
+			const activity::CompiledEventBranch *branches = program.event_branches(ins);
+			for (size_t member : group.members) {
+				const auto &entity = targets[member].entity;
+				for (uint32_t i = 0; i < ins.count; ++i) {
+					const activity::CompiledEventBranch &branch = branches[i];
+					switch (branch.op) {
+					case activity::primer_op_t::COMMAND_IN_QUEUE:
+						state->get_command_wait_list().park(entity->get_id(), branch.next_id);
+						break;
+					case activity::primer_op_t::CUSTOM:
+					default: {
+						auto ev = program.get_primer(branch.func)(start_time + wait_times[member],
+						                                          entity,
+						                                          loop,
+						                                          state,
+						                                          branch.next_id);
+						if (ev != nullptr) {
+							components[member]->add_event(ev);
+						}
+					} break;
+					}
+				}
 
-			// exit and wait for event
-			event_wait_time = 0;
-			stop = true;
+				// exit and wait for event
+				components[member]->set_pc(start_time, group.pc);
+			}
 		} break;
 		default:
-			throw Error{ERR << "Unhandled node type for node " << current_node->str()};
+			throw Error{ERR << "Unhandled node type for node " << program.get_node(group.pc)->str()};
 		}
 	}
+}
 
-	// save the current node in the component
-	activity_component->set_node(start_time, current_node);
+bool Activity::check_condition(const activity::CompiledActivity &program,
+                               const activity::CompiledBranch &branch,
+                               const time::time_t &time,
+                               const std::shared_ptr<gamestate::GameEntity> &entity) {
+	switch (branch.op) {
+	case activity::condition_op_t::COMMAND_IN_QUEUE:
+		return activity::command_in_queue(time, entity);
+	case activity::condition_op_t::NEXT_COMMAND_IDLE:
+		return activity::next_command_idle(time, entity);
+	case activity::condition_op_t::NEXT_COMMAND_MOVE:
+		return activity::next_command_move(time, entity);
+	case activity::condition_op_t::CUSTOM:
+	default:
+		return program.get_condition(branch.func)(time, entity);
+	}
 }
 
-const time::time_t Activity::handle_subsystem(const std::shared_ptr<gamestate::GameEntity> &entity,
-                                              const time::time_t &start_time,
-                                              system_id_t system_id) {
+const std::vector<time::time_t> Activity::handle_subsystem(const std::vector<std::shared_ptr<gamestate::GameEntity>> &entities,
+                                                           const time::time_t &start_time,
+                                                           system_id_t system_id) {
 	switch (system_id) {
-	case system_id_t::IDLE:
-		return Idle::idle(entity, start_time);
-		break;
 	case system_id_t::MOVE_COMMAND:
-		return Move::move_command(entity, start_time);
-		break;
+		return Move::move_command(entities, start_time);
+	case system_id_t::IDLE:
 	case system_id_t::MOVE_DEFAULT:
-		return Move::move_default(entity, {1, 1, 1}, start_time);
 		break;
 	default:
 		throw Error{ERR << "Unhandled subsystem " << static_cast<int>(system_id)};
 	}
 
-	return time::time_t::from_int(0);
+	// systems without a batch implementation run per entity
+	std::vector<time::time_t> runtimes;
+	runtimes.reserve(entities.size());
+	for (const auto &entity : entities) {
+		switch (system_id) {
+		case system_id_t::IDLE:
+			runtimes.push_back(Idle::idle(entity, start_time));
+			break;
+		case system_id_t::MOVE_DEFAULT:
+			runtimes.push_back(Move::move_default(entity, {1, 1, 1}, start_time));
+			break;
+		default:
+			break;
+		}
+	}
+
+	return runtimes;
 }
 
 
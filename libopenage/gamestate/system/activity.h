@@ -2,8 +2,10 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "event/eventhandler.h"
 #include "gamestate/system/types.h"
@@ -20,8 +22,25 @@ namespace gamestate {
 class GameEntity;
 class GameState;
 
+namespace activity {
+class CompiledActivity;
+struct CompiledBranch;
+} // namespace activity
+
 namespace system {
 
+/**
+ * Game entity whose activity is advanced by a batch.
+ */
+struct ActivityTarget {
+	std::shared_ptr<gamestate::GameEntity> entity;
+
+	/// ID of the output node that the entity continues with
+	/// if its activity waits at an event gateway
+	std::optional<size_t> next_id = std::nullopt;
+};
+
+
 class Activity {
 public:
 	/**
@@ -36,19 +55,50 @@ public:
 	                    const std::shared_ptr<openage::gamestate::GameState> &state,
 	                    const std::optional<openage::event::EventHandler::param_map> &ev_params = std::nullopt);
 
+	/**
+	 * Advance in the activity flow graphs of multiple game entities.
+	 *
+	 * Entities whose activities are at the same node of the same graph are
+	 * processed together, so that task systems run once for the whole group
+	 * instead of once per entity. Groups split up at gateways and merge again
+	 * when their members reach the same node.
+	 *
+	 * @param start_time Start time of change.
+	 * @param targets Game entities and the event gateway outputs they continue with.
+	 */
+	static void advance(const time::time_t &start_time,
+	                    const std::vector<ActivityTarget> &targets,
+	                    const std::shared_ptr<openage::event::EventLoop> &loop,
+	                    const std::shared_ptr<openage::gamestate::GameState> &state);
+
 private:
 	/**
-	 * Run a built-in engine subsystem.
+	 * Check the condition of an exclusive gateway output.
 	 *
+	 * @param program Compiled activity that the output belongs to.
+	 * @param branch Output of the gateway.
+	 * @param time Current simulation time.
 	 * @param entity Game entity.
+	 *
+	 * @return true if the output is chosen, false otherwise.
+	 */
+	static bool check_condition(const activity::CompiledActivity &program,
+	                            const activity::CompiledBranch &branch,
+	                            const time::time_t &time,
+	                            const std::shared_ptr<gamestate::GameEntity> &entity);
+
+	/**
+	 * Run a built-in engine subsystem for a group of game entities.
+	 *
+	 * @param entities Game entities.
 	 * @param start_time Start time of change.
 	 * @param system_id ID of the subsystem to run.
 	 *
-	 * @return Runtime of the change in simulation time.
+	 * @return Runtime of the change in simulation time for each entity.
 	 */
-	static const time::time_t handle_subsystem(const std::shared_ptr<gamestate::GameEntity> &entity,
-	                                           const time::time_t &start_time,
-	                                           system_id_t system_id);
+	static const std::vector<time::time_t> handle_subsystem(const std::vector<std::shared_ptr<gamestate::GameEntity>> &entities,
+	                                                        const time::time_t &start_time,
+	                                                        system_id_t system_id);
 };
 
 } // namespace system
@@ -1,8 +1,12 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2024 the openage authors. See copying.md for legal info.
 
 #include "move.h"
 
 #include <compare>
+#include <map>
+#include <optional>
+#include <string>
+#include <tuple>
 #include <vector>
 
 #include <nyan/nyan.h>
@@ -28,40 +32,54 @@
 
 
 namespace openage::gamestate::system {
-const time::time_t Move::move_command(const std::shared_ptr<gamestate::GameEntity> &entity,
-                                      const time::time_t &start_time) {
-	auto command_queue = std::dynamic_pointer_cast<component::CommandQueue>(
-		entity->get_component(component::component_t::COMMANDQUEUE));
-	auto command = std::dynamic_pointer_cast<component::command::MoveCommand>(
-		command_queue->pop_command(start_time));
-
-	if (not command) [[unlikely]] {
-		log::log(MSG(warn) << "Command is not a move command.");
-		return time::time_t::from_int(0);
-	}
-
-	return Move::move_default(entity, command->get_target(), start_time);
-}
 
+namespace {
+
+/**
+ * Values of the move and turn abilities of a game entity
+ * that are needed for moving it.
+ */
+struct MoveParams {
+	std::shared_ptr<nyan::Float> turn_speed;
+	std::shared_ptr<nyan::Float> move_speed;
+	std::optional<std::string> animation_path;
+};
+
+
+/**
+ * Look up the move parameters in the abilities of a game entity.
+ */
+MoveParams get_move_params(const nyan::Object &move_ability,
+                           const nyan::Object &turn_ability) {
+	MoveParams params{
+		turn_ability.get<nyan::Float>("Turn.turn_speed"),
+		move_ability.get<nyan::Float>("Move.speed"),
+		std::nullopt,
+	};
+
+	if (api::APIAbility::check_property(move_ability, api::ability_property_t::ANIMATED)) {
+		auto property = api::APIAbility::get_property(move_ability, api::ability_property_t::ANIMATED);
+		auto animations = api::APIAbilityProperty::get_animations(property);
+		auto animation_paths = api::APIAnimation::get_animation_paths(animations);
 
-const time::time_t Move::move_default(const std::shared_ptr<gamestate::GameEntity> &entity,
-                                      const coord::phys3 &destination,
-                                      const time::time_t &start_time) {
-	if (not entity->has_component(component::component_t::MOVE)) [[unlikely]] {
-		log::log(WARN << "Entity " << entity->get_id() << " has no move component.");
-		return time::time_t::from_int(0);
+		if (animation_paths.size() > 0) [[likely]] {
+			params.animation_path = animation_paths[0];
+		}
 	}
 
-	auto turn_component = std::dynamic_pointer_cast<component::Turn>(
-		entity->get_component(component::component_t::TURN));
-	auto turn_ability = turn_component->get_ability();
-	auto turn_speed = turn_ability.get<nyan::Float>("Turn.turn_speed");
+	return params;
+}
 
-	auto move_component = std::dynamic_pointer_cast<component::Move>(
-		entity->get_component(component::component_t::MOVE));
-	auto move_ability = move_component->get_ability();
-	auto move_speed = move_ability.get<nyan::Float>("Move.speed");
 
+/**
+ * Move a game entity to a destination with already looked up move parameters.
+ *
+ * @return Runtime of the change in simulation time.
+ */
+const time::time_t move_to(const std::shared_ptr<gamestate::GameEntity> &entity,
+                           const coord::phys3 &destination,
+                           const time::time_t &start_time,
+                           const MoveParams &params) {
 	auto pos_component = std::dynamic_pointer_cast<component::Position>(
 		entity->get_component(component::component_t::POSITION));
 
@@ -76,7 +94,7 @@ const time::time_t Move::move_default(const std::shared_ptr<gamestate::GameEntit
 
 	// rotation
 	double turn_time = 0;
-	if (not turn_speed->is_infinite_positive()) {
+	if (not params.turn_speed->is_infinite_positive()) {
 		auto angle_diff = new_angle - current_angle;
 		if (angle_diff < 0) {
 			// get the positive difference
@@ -88,32 +106,118 @@ const time::time_t Move::move_default(const std::shared_ptr<gamestate::GameEntit
 			angle_diff = angle_diff * -1;
 		}
 
-		turn_time = angle_diff.to_double() / turn_speed->get();
+		turn_time = angle_diff.to_double() / params.turn_speed->get();
 	}
 	pos_component->set_angle(start_time + turn_time, new_angle);
 
 	// movement
 	double move_time = 0;
-	if (not move_speed->is_infinite_positive()) {
+	if (not params.move_speed->is_infinite_positive()) {
 		auto distance = path.length();
-		move_time = distance / move_speed->get();
+		move_time = distance / params.move_speed->get();
 	}
 
 	pos_component->set_position(start_time, current_pos);
 	pos_component->set_position(start_time + turn_time + move_time, destination);
 
-	auto ability = move_component->get_ability();
-	if (api::APIAbility::check_property(ability, api::ability_property_t::ANIMATED)) {
-		auto property = api::APIAbility::get_property(ability, api::ability_property_t::ANIMATED);
-		auto animations = api::APIAbilityProperty::get_animations(property);
-		auto animation_paths = api::APIAnimation::get_animation_paths(animations);
+	if (params.animation_path.has_value()) {
+		entity->render_update(start_time, params.animation_path.value());
+	}
 
-		if (animation_paths.size() > 0) [[likely]] {
-			entity->render_update(start_time, animation_paths[0]);
+	return turn_time + move_time;
+}
+
+} // namespace
+
+
+const time::time_t Move::move_command(const std::shared_ptr<gamestate::GameEntity> &entity,
+                                      const time::time_t &start_time) {
+	auto command_queue = std::dynamic_pointer_cast<component::CommandQueue>(
+		entity->get_component(component::component_t::COMMANDQUEUE));
+	auto command = std::dynamic_pointer_cast<component::command::MoveCommand>(
+		command_queue->pop_command(start_time));
+
+	if (not command) [[unlikely]] {
+		log::log(MSG(warn) << "Command is not a move command.");
+		return time::time_t::from_int(0);
+	}
+
+	return Move::move_default(entity, command->get_target(), start_time);
+}
+
+
+const std::vector<time::time_t> Move::move_command(const std::vector<std::shared_ptr<gamestate::GameEntity>> &entities,
+                                                   const time::time_t &start_time) {
+	std::vector<time::time_t> runtimes;
+	runtimes.reserve(entities.size());
+
+	// entities of the same type and owner share their abilities, so the nyan lookups
+	// are only done once per ability combination. The abilities are fetched from the
+	// owner's database view, where their values may differ from other players,
+	// so the view is part of the key.
+	using params_key_t = std::tuple<const nyan::View *, nyan::fqon_t, const nyan::View *, nyan::fqon_t>;
+	std::map<params_key_t, MoveParams> params_cache;
+
+	for (const auto &entity : entities) {
+		auto command_queue = std::dynamic_pointer_cast<component::CommandQueue>(
+			entity->get_component(component::component_t::COMMANDQUEUE));
+		auto command = std::dynamic_pointer_cast<component::command::MoveCommand>(
+			command_queue->pop_command(start_time));
+
+		if (not command) [[unlikely]] {
+			log::log(MSG(warn) << "Command is not a move command.");
+			runtimes.push_back(time::time_t::from_int(0));
+			continue;
+		}
+
+		if (not entity->has_component(component::component_t::MOVE)) [[unlikely]] {
+			log::log(WARN << "Entity " << entity->get_id() << " has no move component.");
+			runtimes.push_back(time::time_t::from_int(0));
+			continue;
+		}
+
+		auto turn_component = std::dynamic_pointer_cast<component::Turn>(
+			entity->get_component(component::component_t::TURN));
+		auto move_component = std::dynamic_pointer_cast<component::Move>(
+			entity->get_component(component::component_t::MOVE));
+		const nyan::Object &turn_ability = turn_component->get_ability();
+		const nyan::Object &move_ability = move_component->get_ability();
+
+		params_key_t key{move_ability.get_view().get(),
+		                 move_ability.get_name(),
+		                 turn_ability.get_view().get(),
+		                 turn_ability.get_name()};
+		auto cached = params_cache.find(key);
+		if (cached == std::end(params_cache)) {
+			cached = params_cache.emplace(std::move(key),
+			                              get_move_params(move_ability, turn_ability))
+			             .first;
 		}
+
+		runtimes.push_back(move_to(entity, command->get_target(), start_time, cached->second));
 	}
 
-	return turn_time + move_time;
+	return runtimes;
+}
+
+
+const time::time_t Move::move_default(const std::shared_ptr<gamestate::GameEntity> &entity,
+                                      const coord::phys3 &destination,
+                                      const time::time_t &start_time) {
+	if (not entity->has_component(component::component_t::MOVE)) [[unlikely]] {
+		log::log(WARN << "Entity " << entity->get_id() << " has no move component.");
+		return time::time_t::from_int(0);
+	}
+
+	auto turn_component = std::dynamic_pointer_cast<component::Turn>(
+		entity->get_component(component::component_t::TURN));
+	auto move_component = std::dynamic_pointer_cast<component::Move>(
+		entity->get_component(component::component_t::MOVE));
+
+	return move_to(entity,
+	               destination,
+	               start_time,
+	               get_move_params(move_component->get_ability(), turn_component->get_ability()));
 }
 
 } // namespace openage::gamestate::system
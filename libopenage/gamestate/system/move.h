@@ -3,6 +3,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "coord/phys.h"
 #include "time/time.h"
@@ -26,6 +27,19 @@ public:
 	static const time::time_t move_command(const std::shared_ptr<gamestate::GameEntity> &entity,
 	                                       const time::time_t &start_time);
 
+	/**
+	 * Move multiple game entities to the destinations from their move commands.
+	 *
+	 * Ability lookups are shared between entities with the same abilities.
+	 *
+	 * @param entities Game entities.
+	 * @param start_time Start time of change.
+	 *
+	 * @return Runtime of the change in simulation time for each entity.
+	 */
+	static const std::vector<time::time_t> move_command(const std::vector<std::shared_ptr<gamestate::GameEntity>> &entities,
+	                                                    const time::time_t &start_time);
+
 	/**
 	 * Move a game entity to a destination.
 	 *
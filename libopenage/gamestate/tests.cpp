@@ -0,0 +1,365 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <nyan/nyan.h>
+
+#include "coord/phys.h"
+#include "error/error.h"
+#include "event/event_loop.h"
+#include "event/evententity.h"
+#include "event/eventhandler.h"
+#include "gamestate/component/internal/command_queue.h"
+#include "gamestate/component/internal/commands/move.h"
+#include "gamestate/component/internal/ownership.h"
+#include "gamestate/component/internal/position.h"
+#include "gamestate/game_entity.h"
+#include "gamestate/game_state.h"
+#include "gamestate/player.h"
+#include "gamestate/replay.h"
+#include "gamestate/snapshot.h"
+#include "gamestate/state_hasher.h"
+#include "testing/testing.h"
+
+
+namespace openage::gamestate::tests {
+
+/**
+ * Receives the events of the replay test.
+ */
+class ReplayTarget : public openage::event::EventEntity {
+public:
+	ReplayTarget(const std::shared_ptr<openage::event::EventLoop> &loop) :
+		EventEntity{loop} {}
+
+	size_t id() const override {
+		return 0;
+	}
+
+	std::string idstr() const override {
+		return "replay_target";
+	}
+};
+
+/**
+ * Moves game entities by the offset given in the event parameters.
+ */
+class ReplayMoveHandler : public openage::event::OnceEventHandler {
+public:
+	ReplayMoveHandler() :
+		OnceEventHandler{"test.replay_move"} {}
+
+	void setup_event(const std::shared_ptr<openage::event::Event> & /* event */,
+	                 const std::shared_ptr<openage::event::State> & /* state */) override {}
+
+	void invoke(openage::event::EventLoop & /* loop */,
+	            const std::shared_ptr<openage::event::EventEntity> & /* target */,
+	            const std::shared_ptr<openage::event::State> &state,
+	            const time::time_t &time,
+	            const param_map &params) override {
+		auto gstate = std::dynamic_pointer_cast<GameState>(state);
+		auto offset = params.get("offset", coord::phys3{0, 0, 0});
+		for (auto id : params.get("entity_ids", std::vector<entity_id_t>{})) {
+			auto position = std::dynamic_pointer_cast<component::Position>(
+				gstate->get_game_entity(id)->get_component(component::component_t::POSITION));
+			auto current = position->get_positions().get(time);
+			position->set_position(time, coord::phys3{current.ne + offset.ne, current.se + offset.se, 0});
+		}
+	}
+
+	time::time_t predict_invoke_time(const std::shared_ptr<openage::event::EventEntity> & /* target */,
+	                                 const std::shared_ptr<openage::event::State> & /* state */,
+	                                 const time::time_t &at) override {
+		return at;
+	}
+};
+
+/**
+ * Create a game with a few game entities for the replay test.
+ */
+std::shared_ptr<GameState> replay_game(const std::shared_ptr<openage::event::EventLoop> &loop,
+                                       const coord::phys3 &start) {
+	auto state = std::make_shared<GameState>(nyan::Database::create(), loop);
+	for (entity_id_t id = 1; id <= 3; ++id) {
+		auto entity = std::make_shared<GameEntity>(id);
+		entity->add_component(std::make_shared<component::Position>(loop, start, 0));
+		state->add_game_entity(entity);
+	}
+	return state;
+}
+
+
+void snapshot() {
+	auto loop = std::make_shared<event::EventLoop>();
+	loop->add_event_handler(std::make_shared<ReplayMoveHandler>());
+	auto target = std::make_shared<ReplayTarget>(loop);
+	auto state = std::make_shared<GameState>(nyan::Database::create(), loop);
+	state->add_player(std::make_shared<Player>(1, state->get_db_view()));
+
+	auto unit = std::make_shared<GameEntity>(1);
+	auto unit_pos = std::make_shared<component::Position>(loop, coord::phys3{1, 1, 0}, 0);
+	auto unit_owner = std::make_shared<component::Ownership>(loop, 1, 0);
+	auto unit_queue = std::make_shared<component::CommandQueue>(loop);
+	unit->add_component(unit_pos);
+	unit->add_component(unit_owner);
+	unit->add_component(unit_queue);
+	state->add_game_entity(unit);
+
+	auto tree = std::make_shared<GameEntity>(2);
+	auto tree_pos = std::make_shared<component::Position>(loop, coord::phys3{5, 5, 0}, 0);
+	tree->add_component(tree_pos);
+	state->add_game_entity(tree);
+
+	state->get_command_wait_list().park(1, 7);
+
+	// pending event that does not target a game entity
+	openage::event::EventHandler::param_map::map_t move_tree{
+		{"offset", coord::phys3{1, 0, 0}},
+		{"entity_ids", std::vector<entity_id_t>{2}},
+	};
+	loop->create_event("test.replay_move", target, state, 30, move_tree);
+
+	SnapshotWriter writer;
+	auto full = writer.capture(state, loop, 0);
+
+	// only the unit changes, so the tree is not in the incremental snapshot
+	unit_pos->set_position(10, coord::phys3{2, 2, 0});
+	unit_owner->set_owner(10, 2);
+	unit_queue->add_command(10, std::make_shared<component::command::MoveCommand>(coord::phys3{3, 3, 0}));
+	auto incremental = writer.capture(state, loop, 10);
+	TESTEQUALS(incremental.size() < full.size(), true);
+
+	// nothing changed
+	auto empty = writer.capture(state, loop, 10);
+	TESTEQUALS(empty.size() < incremental.size(), true);
+
+	// changes after the snapshots are reverted by restoring them
+	unit_pos->set_position(20, coord::phys3{4, 4, 0});
+	tree_pos->set_position(20, coord::phys3{6, 6, 0});
+	unit_owner->set_owner(20, 3);
+	unit_queue->get_queue().pop_front(20);
+	state->get_command_wait_list().unpark(1);
+
+	auto spawned = std::make_shared<GameEntity>(3);
+	spawned->add_component(std::make_shared<component::Position>(loop, coord::phys3{7, 7, 0}, 0));
+	state->add_game_entity(spawned);
+
+	openage::event::EventHandler::param_map::map_t move_unit{
+		{"offset", coord::phys3{1, 0, 0}},
+		{"entity_ids", std::vector<entity_id_t>{1}},
+	};
+	loop->create_event("test.replay_move", target, state, 25, move_unit);
+
+	restore_snapshot(full.data(), full.size(), state, loop, {target});
+	TESTEQUALS(unit_pos->get_positions().get(20) == coord::phys3(1, 1, 0), true);
+	TESTEQUALS(tree_pos->get_positions().get(20) == coord::phys3(5, 5, 0), true);
+	TESTEQUALS(unit_owner->get_owners().get(20), 1u);
+	TESTEQUALS(unit_queue->get_queue().empty(20), true);
+	TESTEQUALS(state->get_command_wait_list().get(1).value_or(0), 7u);
+
+	// entities spawned after the snapshot are removed
+	TESTEQUALS(state->get_game_entities().size(), 2u);
+	TESTEQUALS(state->get_game_entities().contains(3), false);
+
+	auto time = restore_snapshot(incremental.data(), incremental.size(), state, loop, {target});
+	TESTEQUALS(time == time::time_t{10}, true);
+	TESTEQUALS(unit_pos->get_positions().get(20) == coord::phys3(2, 2, 0), true);
+	TESTEQUALS(tree_pos->get_positions().get(20) == coord::phys3(5, 5, 0), true);
+	TESTEQUALS(unit_owner->get_owners().get(20), 2u);
+	TESTEQUALS(unit_queue->get_queue().empty(20), false);
+
+	auto command = std::dynamic_pointer_cast<component::command::MoveCommand>(
+		unit_queue->get_queue().front(20));
+	TESTEQUALS(command != nullptr, true);
+	TESTEQUALS(command->get_target() == coord::phys3(3, 3, 0), true);
+
+	// only the pending events of the snapshot are executed
+	loop->reach_time(30, state);
+	TESTEQUALS(unit_pos->get_positions().get(30) == coord::phys3(2, 2, 0), true);
+	TESTEQUALS(tree_pos->get_positions().get(30) == coord::phys3(6, 5, 0), true);
+
+	// a reset writer starts with a full snapshot again
+	writer.reset();
+	auto full_again = writer.capture(state, loop, 10);
+	TESTEQUALS(full_again.size() > incremental.size(), true);
+
+	// broken data
+	TESTTHROWS(restore_snapshot(full.data(), full.size() / 2, state, loop, {target}));
+	std::vector<uint8_t> garbage(full.size(), 0);
+	TESTTHROWS(restore_snapshot(garbage.data(), garbage.size(), state, loop, {target}));
+
+	// events reference targets that must be passed to the restore
+	TESTTHROWS(restore_snapshot(full.data(), full.size(), state, loop, {}));
+
+	// players and entities must exist in the game state
+	auto other_state = std::make_shared<GameState>(nyan::Database::create(), loop);
+	TESTTHROWS(restore_snapshot(full.data(), full.size(), other_state, loop, {target}));
+	other_state->add_player(std::make_shared<Player>(1, other_state->get_db_view()));
+	TESTTHROWS(restore_snapshot(full.data(), full.size(), other_state, loop, {target}));
+}
+
+void replay() {
+	auto path = (std::filesystem::temp_directory_path() / "openage_replay_test").string();
+
+	// record a match
+	uint64_t recorded_hash;
+	std::vector<coord::phys3> recorded_positions;
+	{
+		auto loop = std::make_shared<openage::event::EventLoop>();
+		loop->add_event_handler(std::make_shared<ReplayMoveHandler>());
+		auto target = std::make_shared<ReplayTarget>(loop);
+		auto state = replay_game(loop, coord::phys3{0, 0, 0});
+
+		auto recorder = std::make_shared<ReplayRecorder>(path, 5);
+		recorder->attach(loop);
+
+		for (int step = 1; step <= 20; ++step) {
+			if (step % 3 == 0) {
+				openage::event::EventHandler::param_map::map_t params{
+					{"offset", coord::phys3{1, 2, 0}},
+					{"entity_ids", std::vector<entity_id_t>{1, static_cast<entity_id_t>(step % 2 + 2)}},
+					// not recorded
+					{"callback", std::function<void()>{[]() {}}},
+				};
+				loop->post_event("test.replay_move", target, state, step - 1, params);
+			}
+			loop->reach_time(step, state);
+			recorder->checkpoint(step, state);
+		}
+
+		recorder->detach(loop);
+		recorded_hash = state->get_hash();
+		for (entity_id_t id = 1; id <= 3; ++id) {
+			auto position = std::dynamic_pointer_cast<component::Position>(
+				state->get_game_entity(id)->get_component(component::component_t::POSITION));
+			recorded_positions.push_back(position->get_positions().get(20));
+		}
+	}
+
+	// play it back
+	{
+		auto loop = std::make_shared<openage::event::EventLoop>();
+		loop->add_event_handler(std::make_shared<ReplayMoveHandler>());
+		auto target = std::make_shared<ReplayTarget>(loop);
+		auto state = replay_game(loop, coord::phys3{0, 0, 0});
+
+		auto result = play_replay(path, state, loop, {target});
+		TESTEQUALS(result.events, 6u);
+		TESTEQUALS(result.checkpoints, 4u);
+		TESTEQUALS(result.diverged_at.has_value(), false);
+		TESTEQUALS(result.end_time == time::time_t{18}, true);
+
+		loop->reach_time(20, state);
+		TESTEQUALS(state->get_hash(), recorded_hash);
+
+		for (entity_id_t id = 1; id <= 3; ++id) {
+			auto position = std::dynamic_pointer_cast<component::Position>(
+				state->get_game_entity(id)->get_component(component::component_t::POSITION));
+			TESTEQUALS(position->get_positions().get(20) == recorded_positions[id - 1], true);
+		}
+	}
+
+	// a different setup is detected at the first state hash
+	{
+		auto loop = std::make_shared<openage::event::EventLoop>();
+		loop->add_event_handler(std::make_shared<ReplayMoveHandler>());
+		auto target = std::make_shared<ReplayTarget>(loop);
+		auto state = replay_game(loop, coord::phys3{1, 0, 0});
+
+		auto result = play_replay(path, state, loop, {target});
+		TESTEQUALS(result.diverged_at.has_value(), true);
+		TESTEQUALS(*result.diverged_at == time::time_t{1}, true);
+	}
+
+	// events reference targets that must be passed to the playback
+	{
+		auto loop = std::make_shared<openage::event::EventLoop>();
+		loop->add_event_handler(std::make_shared<ReplayMoveHandler>());
+		auto state = replay_game(loop, coord::phys3{0, 0, 0});
+		TESTTHROWS(play_replay(path, state, loop, {}));
+	}
+
+	std::filesystem::remove(path);
+}
+
+void state_hash() {
+	auto loop = std::make_shared<event::EventLoop>();
+
+	// two games that are set up the same way
+	auto state = replay_game(loop, coord::phys3{0, 0, 0});
+	auto same_state = replay_game(loop, coord::phys3{0, 0, 0});
+	TESTEQUALS(state->get_hash(), same_state->get_hash());
+
+	auto position = std::dynamic_pointer_cast<component::Position>(
+		state->get_game_entity(2)->get_component(component::component_t::POSITION));
+	position->set_position(10, coord::phys3{1, 1, 0});
+	auto changed_hash = state->get_hash();
+	TESTEQUALS(changed_hash != same_state->get_hash(), true);
+
+	// the incremental hash equals the hash of all entities
+	uint64_t full_hash = 0;
+	for (const auto &[id, entity] : state->get_game_entities()) {
+		full_hash += entity->get_hash();
+	}
+	TESTEQUALS(full_hash, changed_hash);
+
+	// components added after the entity was registered are hashed too
+	auto owner = std::make_shared<component::Ownership>(loop, 1, 0);
+	state->get_game_entity(3)->add_component(owner);
+	owner->set_owner(5, 2);
+	TESTEQUALS(state->get_hash() != changed_hash, true);
+
+	// the same changes in the same order lead to the same hash
+	auto same_position = std::dynamic_pointer_cast<component::Position>(
+		same_state->get_game_entity(2)->get_component(component::component_t::POSITION));
+	same_position->set_position(10, coord::phys3{1, 1, 0});
+	auto same_owner = std::make_shared<component::Ownership>(loop, 1, 0);
+	same_state->get_game_entity(3)->add_component(same_owner);
+	same_owner->set_owner(5, 2);
+	TESTEQUALS(same_state->get_hash(), state->get_hash());
+
+	// overwritten keyframes do not leave traces in the hash
+	owner->set_owner(10, 3);
+	auto predicted_hash = state->get_hash();
+	TESTEQUALS(predicted_hash != same_state->get_hash(), true);
+	owner->set_owner(5, 2);
+	TESTEQUALS(state->get_hash(), same_state->get_hash());
+
+	// elements of queues are hashed
+	auto queue = std::make_shared<component::CommandQueue>(loop);
+	state->get_game_entity(1)->add_component(queue);
+	auto empty_queue_hash = state->get_hash();
+	queue->add_command(20, std::make_shared<component::command::MoveCommand>(coord::phys3{3, 3, 0}));
+	TESTEQUALS(state->get_hash() != empty_queue_hash, true);
+
+	// queued commands are hashed with their parameters
+	component::command::MoveCommand move(coord::phys3(3, 3, 0));
+	component::command::MoveCommand same_move(coord::phys3(3, 3, 0));
+	component::command::MoveCommand other_move(coord::phys3(3, 4, 0));
+	TESTEQUALS(move.hash(), same_move.hash());
+	TESTEQUALS(move.hash() != other_move.hash(), true);
+
+	auto same_queue = std::make_shared<component::CommandQueue>(loop);
+	same_state->get_game_entity(1)->add_component(same_queue);
+	same_queue->add_command(20, std::make_shared<component::command::MoveCommand>(coord::phys3{3, 4, 0}));
+	TESTEQUALS(state->get_hash() != same_state->get_hash(), true);
+
+	// restoring a snapshot updates the hash
+	SnapshotWriter writer;
+	auto snapshot = writer.capture(state, loop, 20);
+	auto snapshot_hash = state->get_hash();
+	position->set_position(30, coord::phys3{2, 2, 0});
+	TESTEQUALS(state->get_hash() != snapshot_hash, true);
+	restore_snapshot(snapshot.data(), snapshot.size(), state, loop, {});
+	TESTEQUALS(state->get_hash(), snapshot_hash);
+
+	StateHasher hasher;
+	TESTTHROWS(hasher.get_entity_hash(42));
+}
+
+} // namespace openage::gamestate::tests
@@ -1,8 +1,9 @@
-// Copyright 2015-2023 the openage authors. See copying.md for legal info.
+// Copyright 2015-2024 the openage authors. See copying.md for legal info.
 
 #pragma once
 
 #include <functional>
+#include <optional>
 #include <unordered_map>
 
 #include "input/event.h"
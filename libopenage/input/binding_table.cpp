@@ -0,0 +1,120 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "binding_table.h"
+
+#include "input/input_context.h"
+
+
+namespace openage::input {
+
+BindingTable::BindingTable() :
+	contexts{},
+	actions{},
+	by_class{},
+	class_has_events{},
+	by_event{} {}
+
+void BindingTable::build(const std::vector<std::shared_ptr<InputContext>> &contexts) {
+	this->contexts.clear();
+	this->actions.clear();
+	this->by_class.fill(std::nullopt);
+	this->class_has_events.fill(false);
+	this->by_event.clear();
+
+	for (auto &ctx : contexts) {
+		this->contexts.emplace_back(ctx, ctx->get_revision());
+	}
+
+	// event classes are resolved by the topmost context that binds them
+	for (size_t cl = 0; cl < event_class_count; ++cl) {
+		auto eclass = static_cast<event_class>(cl);
+		for (auto &ctx : contexts) {
+			if (ctx->is_bound(eclass)) {
+				this->by_class[cl] = this->add(ctx->lookup(eclass), ctx.get());
+				break;
+			}
+		}
+	}
+
+	// specific events only need an entry if no context above the one
+	// binding them binds their class
+	for (size_t i = 0; i < contexts.size(); ++i) {
+		for (auto &ev : contexts[i]->get_event_binds()) {
+			if (this->by_event.contains(ev)) {
+				// bound in a context with a higher priority
+				continue;
+			}
+
+			bool shadowed = false;
+			for (size_t j = 0; j < i; ++j) {
+				if (contexts[j]->is_bound(ev)) {
+					shadowed = true;
+					break;
+				}
+			}
+			if (shadowed) {
+				continue;
+			}
+
+			auto range = this->add(contexts[i]->lookup(ev), contexts[i].get());
+			this->by_event.emplace(ev, range);
+			this->class_has_events[static_cast<size_t>(ev.cc.cl)] = true;
+		}
+	}
+}
+
+bool BindingTable::is_current(const std::vector<std::shared_ptr<InputContext>> &contexts) const {
+	if (contexts.size() != this->contexts.size()) {
+		return false;
+	}
+
+	for (size_t i = 0; i < contexts.size(); ++i) {
+		if (contexts[i] != this->contexts[i].first
+		    or contexts[i]->get_revision() != this->contexts[i].second) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+std::optional<std::span<const table_action>> BindingTable::lookup(const Event &ev) const {
+	auto cl = static_cast<size_t>(ev.cc.cl);
+
+	std::optional<action_range> range = std::nullopt;
+	if (this->class_has_events[cl]) {
+		auto event_lookup = this->by_event.find(ev);
+		if (event_lookup != std::end(this->by_event)) {
+			range = event_lookup->second;
+		}
+	}
+	if (not range) {
+		range = this->by_class[cl];
+	}
+
+	if (not range) {
+		return std::nullopt;
+	}
+
+	return std::span<const table_action>{this->actions.data() + range->begin,
+	                                     this->actions.data() + range->end};
+}
+
+BindingTable::action_range BindingTable::add(const std::vector<input_action> &bound,
+                                             InputContext *context) {
+	action_range range{static_cast<uint32_t>(this->actions.size()), 0};
+	for (auto &action : bound) {
+		const std::string *context_id = nullptr;
+		auto id = action.flags.find("id");
+		if (id != std::end(action.flags)) {
+			context_id = &id->second;
+		}
+
+		this->actions.push_back(table_action{&action, context, context_id});
+	}
+	range.end = static_cast<uint32_t>(this->actions.size());
+
+	return range;
+}
+
+} // namespace openage::input
@@ -0,0 +1,131 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "input/action.h"
+#include "input/event.h"
+
+
+namespace openage::input {
+
+class InputContext;
+
+/**
+ * Number of values in \p event_class.
+ */
+constexpr size_t event_class_count = static_cast<size_t>(event_class::MOUSE_MOVE) + 1;
+
+
+/**
+ * Action in a binding table.
+ */
+struct table_action {
+	/// action bound to the event, owned by the input context
+	const input_action *action;
+	/// context that the action is bound in
+	InputContext *context;
+	/// ID of the context pushed or removed by the default action, if the action has one
+	const std::string *context_id;
+};
+
+
+/**
+ * Precompiled lookup table for the actions of a stack of input contexts.
+ *
+ * Resolves an input event to the actions of the topmost context that binds
+ * it, like walking the context stack with \p InputContext::is_bound() and
+ * \p InputContext::lookup() would. Event classes map directly to their
+ * actions, so only events of classes that have specific event bindings need
+ * a hash lookup.
+ *
+ * The table references the actions stored in the input contexts. It must
+ * be rebuilt when the context stack or the bindings of a context change.
+ */
+class BindingTable {
+public:
+	BindingTable();
+
+	~BindingTable() = default;
+
+	/**
+	 * Rebuild the table.
+	 *
+	 * @param contexts Input contexts, ordered from highest to lowest priority.
+	 */
+	void build(const std::vector<std::shared_ptr<InputContext>> &contexts);
+
+	/**
+	 * Check whether the table was built from the current bindings of the given contexts.
+	 *
+	 * @param contexts Input contexts, ordered from highest to lowest priority.
+	 *
+	 * @return true if the table is up to date, else false.
+	 */
+	bool is_current(const std::vector<std::shared_ptr<InputContext>> &contexts) const;
+
+	/**
+	 * Get the actions bound to an input event.
+	 *
+	 * @param ev Input event.
+	 *
+	 * @return Actions of the event, or \p std::nullopt if the event is not bound.
+	 */
+	std::optional<std::span<const table_action>> lookup(const Event &ev) const;
+
+private:
+	/**
+	 * Range of the actions of one binding in \p actions.
+	 */
+	struct action_range {
+		uint32_t begin;
+		uint32_t end;
+	};
+
+	/**
+	 * Append the actions of a binding to the table.
+	 *
+	 * @param bound Actions of the binding.
+	 * @param context Context of the binding.
+	 *
+	 * @return Range of the appended actions.
+	 */
+	action_range add(const std::vector<input_action> &bound, InputContext *context);
+
+	/**
+	 * Input contexts the table was built from, with the revision of their bindings.
+	 * Keeps the contexts alive while the table references their actions.
+	 */
+	std::vector<std::pair<std::shared_ptr<InputContext>, size_t>> contexts;
+
+	/**
+	 * Actions of all bindings.
+	 */
+	std::vector<table_action> actions;
+
+	/**
+	 * Actions of the event classes, indexed by event class.
+	 */
+	std::array<std::optional<action_range>, event_class_count> by_class;
+
+	/**
+	 * Whether there are specific events of the event class in \p by_event.
+	 */
+	std::array<bool, event_class_count> class_has_events;
+
+	/**
+	 * Actions of specific events that take priority over their event class.
+	 */
+	std::unordered_map<Event, action_range, event_hash> by_event;
+};
+
+} // namespace openage::input
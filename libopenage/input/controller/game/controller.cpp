@@ -1,4 +1,4 @@
-// Copyright 2021-2023 the openage authors. See copying.md for legal info.
+// Copyright 2021-2024 the openage authors. See copying.md for legal info.
 
 #include "controller.h"
 
@@ -65,7 +65,7 @@ bool Controller::process(const event_arguments &ev_args, const std::shared_ptr<B
 	}
 
 	// TODO: check if action is allowed
-	auto bind = ctx->lookup(ev_args.e);
+	auto &bind = ctx->lookup(ev_args.e);
 	auto controller = this->shared_from_this();
 	auto game_event = bind.transform(ev_args, controller);
 
@@ -128,13 +128,13 @@ void setup_defaults(const std::shared_ptr<BindingContext> &ctx,
 			{"owner", controller->get_controlled()},
 		};
 
-		auto event = simulation->get_event_loop()->create_event(
+		simulation->get_event_loop()->post_event(
 			"game.spawn_entity",
 			simulation->get_spawner(),
 			simulation->get_game()->get_state(),
 			time_loop->get_clock()->get_time(),
 			params);
-		return event;
+		return nullptr;
 	}};
 
 	binding_action create_entity_action{forward_action_t::SEND, create_entity_event};
@@ -155,13 +155,13 @@ void setup_defaults(const std::shared_ptr<BindingContext> &ctx,
 			{"entity_ids", controller->get_selected()},
 		};
 
-		auto event = simulation->get_event_loop()->create_event(
+		simulation->get_event_loop()->post_event(
 			"game.send_command",
 			simulation->get_commander(),
 			simulation->get_game()->get_state(),
 			time_loop->get_clock()->get_time(),
 			params);
-		return event;
+		return nullptr;
 	}};
 
 	binding_action move_entity_action{forward_action_t::SEND, move_entity};
@@ -205,7 +205,7 @@ void setup_defaults(const std::shared_ptr<BindingContext> &ctx,
 					 }}},
 			};
 
-			auto event = simulation->get_event_loop()->create_event(
+			simulation->get_event_loop()->post_event(
 				"game.drag_select",
 				simulation->get_commander(),
 				simulation->get_game()->get_state(),
@@ -215,7 +215,7 @@ void setup_defaults(const std::shared_ptr<BindingContext> &ctx,
 			// Reset drag selection start
 			controller->reset_drag_select();
 
-			return event;
+			return nullptr;
 		}};
 
 	binding_action drag_selection_action{forward_action_t::CLEAR, drag_selection};
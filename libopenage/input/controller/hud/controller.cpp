@@ -1,4 +1,4 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2024 the openage authors. See copying.md for legal info.
 
 #include "controller.h"
 
@@ -21,7 +21,7 @@ bool Controller::process(const event_arguments &ev_args,
 		return false;
 	}
 
-	auto bind = ctx->lookup(ev_args.e);
+	auto &bind = ctx->lookup(ev_args.e);
 	bind.action(ev_args, this->shared_from_this());
 
 	return true;
@@ -218,14 +218,14 @@ using event_flags_t = std::unordered_map<std::string, std::string>;
  */
 struct event_arguments {
 	// Triggering event
-	const Event e;
+	const Event &e;
 
 	// Mouse position
 	const coord::input mouse;
 	const coord::input_delta motion;
 
 	// additional settings
-	const event_flags_t flags = {};
+	const event_flags_t &flags;
 };
 
 
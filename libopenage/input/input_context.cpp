@@ -1,4 +1,4 @@
-// Copyright 2015-2023 the openage authors. See copying.md for legal info.
+// Copyright 2015-2024 the openage authors. See copying.md for legal info.
 
 #include "input_context.h"
 
@@ -8,7 +8,8 @@ namespace openage::input {
 InputContext::InputContext(const std::string id) :
 	id{id},
 	by_event{},
-	by_class{} {}
+	by_class{},
+	revision{0} {}
 
 
 const std::string &InputContext::get_id() {
@@ -42,25 +43,33 @@ const std::shared_ptr<hud::BindingContext> &InputContext::get_hud_bindings() {
 void InputContext::bind(const Event &ev, const input_action act) {
 	std::vector<input_action> actions{act};
 	this->by_event.emplace(std::make_pair(ev, actions));
+	this->revision += 1;
 }
 
 void InputContext::bind(const event_class &cl, const input_action act) {
 	std::vector<input_action> actions{act};
 	this->by_class.emplace(std::make_pair(cl, actions));
+	this->revision += 1;
 }
 
 void InputContext::bind(const Event &ev, const std::vector<input_action> &&acts) {
 	this->by_event.emplace(std::make_pair(ev, std::move(acts)));
+	this->revision += 1;
 }
 
 void InputContext::bind(const event_class &cl, const std::vector<input_action> &&acts) {
 	this->by_class.emplace(std::make_pair(cl, std::move(acts)));
+	this->revision += 1;
 }
 
 bool InputContext::is_bound(const Event &ev) const {
 	return this->by_event.contains(ev) || this->by_class.contains(ev.cc.cl);
 }
 
+bool InputContext::is_bound(const event_class &cl) const {
+	return this->by_class.contains(cl);
+}
+
 const std::vector<input_action> &InputContext::lookup(const Event &ev) const {
 	auto event_lookup = this->by_event.find(ev);
 	if (event_lookup != std::end(this->by_event)) {
@@ -77,6 +86,15 @@ const std::vector<input_action> &InputContext::lookup(const Event &ev) const {
 	throw Error{MSG(err) << "Event is not bound in context " << this->id};
 }
 
+const std::vector<input_action> &InputContext::lookup(const event_class &cl) const {
+	auto class_lookup = this->by_class.find(cl);
+	if (class_lookup == std::end(this->by_class)) [[unlikely]] {
+		throw Error{MSG(err) << "Event class is not bound in context " << this->id};
+	}
+
+	return class_lookup->second;
+}
+
 std::vector<Event> InputContext::get_event_binds() const {
 	std::vector<Event> result{};
 
@@ -97,4 +115,8 @@ std::vector<event_class> InputContext::get_class_binds() const {
 	return result;
 }
 
+size_t InputContext::get_revision() const {
+	return this->revision;
+}
+
 } // namespace openage::input
@@ -138,6 +138,15 @@ public:
 	 */
 	bool is_bound(const Event &ev) const;
 
+	/**
+	 * Check whether an event class is bound in this context.
+	 *
+	 * @param cl Event class.
+	 *
+	 * @return true if the class is bound, else false.
+	 */
+	bool is_bound(const event_class &cl) const;
+
 	/**
 	 * Get the action(s) bound to the given event.
 	 *
@@ -145,6 +154,13 @@ public:
 	 */
 	const std::vector<input_action> &lookup(const Event &ev) const;
 
+	/**
+	 * Get the action(s) bound to the given event class.
+	 *
+	 * @param cl Event class.
+	 */
+	const std::vector<input_action> &lookup(const event_class &cl) const;
+
 	/**
 	 * Get all event->action bindings in this context.
 	 *
@@ -159,6 +175,14 @@ public:
 	 */
 	std::vector<event_class> get_class_binds() const;
 
+	/**
+	 * Get the revision of the bindings. The revision changes whenever
+	 * a binding is added.
+	 *
+	 * @return Revision of the bindings.
+	 */
+	size_t get_revision() const;
+
 
 private:
 	/**
@@ -176,6 +200,11 @@ private:
 	 */
 	std::unordered_map<event_class, std::vector<input_action>, event_class_hash> by_class;
 
+	/**
+	 * Revision of the bindings.
+	 */
+	size_t revision;
+
 	/**
 	 * Additional context for game simulation events.
 	 */
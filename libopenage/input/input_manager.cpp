@@ -15,11 +15,15 @@ namespace openage::input {
 InputManager::InputManager() :
 	global_context{std::make_shared<InputContext>("main")},
 	active_contexts{},
+	lookup_order{},
+	bindings{},
 	available_contexts{},
 	game_controller{nullptr},
 	camera_controller{nullptr},
 	hud_controller{nullptr},
-	gui_input{nullptr} {
+	gui_input{nullptr},
+	pending_motion{nullptr} {
+	this->update_lookup_order();
 }
 
 void InputManager::set_gui(const std::shared_ptr<qtgui::GuiInput> &gui_input) {
@@ -83,6 +87,7 @@ std::vector<std::string> InputManager::active_binds() const {
 
 void InputManager::push_context(const std::shared_ptr<InputContext> &context) {
 	this->active_contexts.push_back(context);
+	this->update_lookup_order();
 }
 
 void InputManager::push_context(const std::string &id) {
@@ -93,6 +98,7 @@ void InputManager::push_context(const std::string &id) {
 void InputManager::pop_context() {
 	if (not this->active_contexts.empty()) {
 		this->active_contexts.pop_back();
+		this->update_lookup_order();
 	}
 }
 
@@ -104,6 +110,7 @@ void InputManager::pop_context(const std::string &id) {
 	for (auto it = this->active_contexts.begin(); it != this->active_contexts.end(); ++it) {
 		if ((*it)->get_id() == id) {
 			this->active_contexts.erase(it);
+			this->update_lookup_order();
 			return;
 		}
 	}
@@ -129,45 +136,86 @@ void InputManager::set_motion(int x, int y) {
 }
 
 bool InputManager::process(const QEvent &ev) {
-	input::Event input_ev{ev};
+	if (ev.type() == QEvent::MouseMove) {
+		auto &move = static_cast<const QMouseEvent &>(ev);
+
+		// only coalesce motion that would trigger the same bindings
+		if (this->pending_motion
+		    and (this->pending_motion->button() != move.button()
+		         or this->pending_motion->modifiers() != move.modifiers())) {
+			this->process_pending();
+		}
 
-	// Check context list on top of the stack (most recent bound first)
-	for (size_t i = this->active_contexts.size(); i > 0; --i) {
-		auto &ctx = this->active_contexts.at(i - 1);
-		if (ctx->is_bound(input_ev)) {
-			auto &actions = ctx->lookup(input_ev);
-			for (auto const &action : actions) {
-				this->process_action(input_ev, action, ctx);
-			}
-			return true;
+		if (not this->pending_motion) {
+			this->motion_origin = this->mouse_position - this->mouse_motion;
 		}
+		this->pending_motion = std::unique_ptr<QMouseEvent>(move.clone());
+		this->motion_target = this->mouse_position;
+
+		this->update_bindings();
+		Event motion_ev{event_class::MOUSE_MOVE, move.button(), move.modifiers(), QEvent::MouseMove};
+		return this->bindings.lookup(motion_ev).has_value();
 	}
 
-	// If no local keybinds were bound, check the global keybinds
-	if (this->global_context->is_bound(input_ev)) {
-		auto &actions = this->global_context->lookup(input_ev);
-		for (auto const &action : actions) {
-			this->process_action(input_ev, action, this->global_context);
-		}
-		return true;
+	// keep the order of the motion and the following event
+	this->process_pending();
+
+	input::Event input_ev{ev};
+	return this->dispatch(input_ev);
+}
+
+void InputManager::process_pending() {
+	if (not this->pending_motion) {
+		return;
 	}
 
-	return false;
+	input::Event motion_ev{*this->pending_motion};
+	this->pending_motion = nullptr;
+
+	// report the position and motion of all coalesced events. the mouse
+	// may already be at the position of the event that caused the flush.
+	auto position = this->mouse_position;
+	auto motion = this->mouse_motion;
+	this->mouse_position = this->motion_target;
+	this->mouse_motion = this->motion_target - this->motion_origin;
+
+	this->dispatch(motion_ev);
+
+	this->mouse_position = position;
+	this->mouse_motion = motion;
+}
+
+bool InputManager::dispatch(const input::Event &ev) {
+	this->update_bindings();
+
+	// the table is only rebuilt before the next event, so actions
+	// that change the context stack do not invalidate the lookup
+	auto actions = this->bindings.lookup(ev);
+	if (not actions) {
+		return false;
+	}
+
+	for (auto const &action : *actions) {
+		this->process_action(ev, action);
+	}
+	return true;
 }
 
 void InputManager::process_action(const input::Event &ev,
-                                  const input_action &action,
-                                  const std::shared_ptr<InputContext> &ctx) {
-	auto actions = action.action;
-	event_arguments args{ev, this->mouse_position, this->mouse_motion, action.flags};
-	if (actions) {
-		actions.value()(args);
+                                  const table_action &action) {
+	auto &bound = *action.action;
+	event_arguments args{ev, this->mouse_position, this->mouse_motion, bound.flags};
+	if (bound.action) {
+		bound.action.value()(args);
 	}
 	else {
 		// do default action if possible
-		switch (action.action_type) {
+		switch (bound.action_type) {
 		case input_action_t::PUSH_CONTEXT: {
-			auto ctx_id = action.flags.at("id");
+			if (action.context_id == nullptr) [[unlikely]] {
+				throw Error{MSG(err) << "PUSH_CONTEXT action has no context ID."};
+			}
+			auto &ctx_id = *action.context_id;
 			if (ctx_id != this->get_top_context()->get_id()) {
 				// prevent unnecessary stacking of the same context
 				this->push_context(ctx_id);
@@ -179,20 +227,22 @@ void InputManager::process_action(const input::Event &ev,
 			break;
 
 		case input_action_t::REMOVE_CONTEXT: {
-			auto ctx_id = action.flags.at("id");
-			this->pop_context(ctx_id);
+			if (action.context_id == nullptr) [[unlikely]] {
+				throw Error{MSG(err) << "REMOVE_CONTEXT action has no context ID."};
+			}
+			this->pop_context(*action.context_id);
 			break;
 		}
 		case input_action_t::GAME:
-			this->game_controller->process(args, ctx->get_game_bindings());
+			this->game_controller->process(args, action.context->get_game_bindings());
 			break;
 
 		case input_action_t::CAMERA:
-			this->camera_controller->process(args, ctx->get_camera_bindings());
+			this->camera_controller->process(args, action.context->get_camera_bindings());
 			break;
 
 		case input_action_t::HUD:
-			this->hud_controller->process(args, ctx->get_hud_bindings());
+			this->hud_controller->process(args, action.context->get_hud_bindings());
 			break;
 
 		case input_action_t::GUI:
@@ -208,6 +258,19 @@ void InputManager::process_action(const input::Event &ev,
 	}
 }
 
+void InputManager::update_lookup_order() {
+	this->lookup_order.clear();
+	this->lookup_order.insert(std::end(this->lookup_order),
+	                          this->active_contexts.rbegin(),
+	                          this->active_contexts.rend());
+	this->lookup_order.push_back(this->global_context);
+}
+
+void InputManager::update_bindings() {
+	if (not this->bindings.is_current(this->lookup_order)) {
+		this->bindings.build(this->lookup_order);
+	}
+}
 
 void setup_defaults(const std::shared_ptr<InputContext> &ctx) {
 	// hud
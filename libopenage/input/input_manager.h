@@ -11,6 +11,7 @@
 
 #include "coord/pixel.h"
 #include "input/action.h"
+#include "input/binding_table.h"
 
 namespace qtgui {
 class GuiInput;
@@ -143,24 +144,53 @@ public:
 	/**
 	 * Process an input event from the Qt window management.
 	 *
+	 * Mouse motion events are coalesced and their actions are only executed
+	 * by the next call to \p process_pending() or before the next event
+	 * that is not a mouse motion.
+	 *
 	 * @param ev Qt input event.
 	 *
 	 * @return true if the event is accepted, else false.
 	 */
 	bool process(const QEvent &ev);
 
+	/**
+	 * Execute the actions of the mouse motion coalesced since the last call.
+	 *
+	 * Should be called once per frame.
+	 */
+	void process_pending();
+
 
 private:
+	/**
+	 * Execute the actions bound to an input event.
+	 *
+	 * @param ev Input event.
+	 *
+	 * @return true if the event is bound, else false.
+	 */
+	bool dispatch(const input::Event &ev);
+
 	/**
 	 * Process the (default) action for an input event.
 	 *
 	 * @param ev Input event.
 	 * @param action Action bound to the event.
-	 * @param bind_ctx Context the action is bound in.
 	 */
 	void process_action(const input::Event &ev,
-	                    const input_action &action,
-	                    const std::shared_ptr<InputContext> &ctx);
+	                    const table_action &action);
+
+	/**
+	 * Update the order in which contexts are looked up after the
+	 * context stack changed.
+	 */
+	void update_lookup_order();
+
+	/**
+	 * Rebuild the binding table if the contexts changed.
+	 */
+	void update_bindings();
 
 	/**
 	 * The global context. Used as fallback.
@@ -173,6 +203,17 @@ private:
 	 */
 	std::vector<std::shared_ptr<InputContext>> active_contexts;
 
+	/**
+	 * Active contexts and the global context in the order they are looked up,
+	 * i.e. from top of the stack to the global context.
+	 */
+	std::vector<std::shared_ptr<InputContext>> lookup_order;
+
+	/**
+	 * Precompiled bindings of the contexts in \p lookup_order.
+	 */
+	BindingTable bindings;
+
 	/**
 	 * Map of all available contexts, referencable by an ID.
 	 *
@@ -209,6 +250,21 @@ private:
 	 * mouse position relative to the last frame position.
 	 */
 	coord::input_delta mouse_motion{0, 0};
+
+	/**
+	 * Latest mouse motion event whose actions were not executed yet.
+	 */
+	std::unique_ptr<QMouseEvent> pending_motion;
+
+	/**
+	 * Mouse position before the first coalesced mouse motion event.
+	 */
+	coord::input motion_origin{0, 0};
+
+	/**
+	 * Mouse position after the last coalesced mouse motion event.
+	 */
+	coord::input motion_target{0, 0};
 };
 
 /**
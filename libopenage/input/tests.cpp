@@ -1,15 +1,173 @@
 // Copyright 2023-2024 the openage authors. See copying.md for legal info.
 
+#include <vector>
+
+#include <QMouseEvent>
+
 #include "error/error.h"
 #include "log/log.h"
 
+#include "input/binding_table.h"
 #include "input/input_context.h"
 #include "input/input_manager.h"
 #include "renderer/gui/integration/public/gui_application_with_logger.h"
 #include "renderer/opengl/window.h"
+#include "testing/testing.h"
 
 namespace openage::input::tests {
 
+void binding_table() {
+	auto global = std::make_shared<InputContext>("main");
+	auto top = std::make_shared<InputContext>("top");
+
+	input_action global_action{input_action_t::CUSTOM};
+	input_action top_action{input_action_t::CUSTOM};
+	input_action push_top{input_action_t::PUSH_CONTEXT, std::nullopt, {{"id", "top"}}};
+
+	Event ev_a{event_class::KEYBOARD, Qt::Key::Key_A, Qt::KeyboardModifier::NoModifier, QEvent::KeyRelease};
+	Event ev_b{event_class::KEYBOARD, Qt::Key::Key_B, Qt::KeyboardModifier::NoModifier, QEvent::KeyRelease};
+	Event ev_c{event_class::KEYBOARD, Qt::Key::Key_C, Qt::KeyboardModifier::NoModifier, QEvent::KeyRelease};
+	Event ev_lmb{event_class::MOUSE_BUTTON,
+	             Qt::MouseButton::LeftButton,
+	             Qt::KeyboardModifier::NoModifier,
+	             QEvent::MouseButtonRelease};
+
+	global->bind(ev_a, push_top);
+	global->bind(event_class::KEYBOARD, global_action);
+	top->bind(ev_b, {top_action, top_action});
+
+	std::vector<std::shared_ptr<InputContext>> contexts{top, global};
+	BindingTable table;
+	TESTEQUALS(table.is_current(contexts), false);
+	table.build(contexts);
+	TESTEQUALS(table.is_current(contexts), true);
+
+	// specific event of the top context
+	auto b = table.lookup(ev_b);
+	TESTEQUALS(b.has_value(), true);
+	TESTEQUALS(b->size(), 2u);
+	TESTEQUALS(b->front().context == top.get(), true);
+
+	// specific event of a lower context, the context ID is resolved from the flags
+	auto a = table.lookup(ev_a);
+	TESTEQUALS(a.has_value(), true);
+	TESTEQUALS(a->front().action->action_type == input_action_t::PUSH_CONTEXT, true);
+	TESTEQUALS(*a->front().context_id, "top");
+
+	// event class
+	auto c = table.lookup(ev_c);
+	TESTEQUALS(c.has_value(), true);
+	TESTEQUALS(c->front().context == global.get(), true);
+	TESTEQUALS(c->front().context_id == nullptr, true);
+
+	TESTEQUALS(table.lookup(ev_lmb).has_value(), false);
+
+	// an event class bound in a higher context takes priority over
+	// specific events of lower contexts
+	top->bind(event_class::KEYBOARD, top_action);
+	TESTEQUALS(table.is_current(contexts), false);
+	table.build(contexts);
+	TESTEQUALS(table.lookup(ev_a)->front().context == top.get(), true);
+	TESTEQUALS(table.lookup(ev_b)->size(), 2u);
+
+	// changed context stack
+	std::vector<std::shared_ptr<InputContext>> only_global{global};
+	TESTEQUALS(table.is_current(only_global), false);
+	table.build(only_global);
+	TESTEQUALS(table.lookup(ev_b)->front().context == global.get(), true);
+	TESTEQUALS(table.lookup(ev_a)->front().action->action_type == input_action_t::PUSH_CONTEXT, true);
+}
+
+
+void motion_coalescing() {
+	InputManager mgr;
+
+	struct Dispatched {
+		QEvent::Type type;
+		int modifiers;
+		int button;
+		coord::pixel_t x;
+		coord::pixel_t y;
+		coord::pixel_t dx;
+		coord::pixel_t dy;
+	};
+	std::vector<Dispatched> dispatched;
+
+	action_func_t record{[&](const event_arguments &args) {
+		auto &ev = static_cast<const QMouseEvent &>(*args.e.get_event());
+		dispatched.push_back({ev.type(),
+		                      ev.modifiers().toInt(),
+		                      static_cast<int>(ev.button()),
+		                      args.mouse.x,
+		                      args.mouse.y,
+		                      args.motion.x,
+		                      args.motion.y});
+	}};
+	auto global = mgr.get_global_context();
+	global->bind(event_class::MOUSE_MOVE, input_action{input_action_t::CUSTOM, record});
+	global->bind(event_class::MOUSE_BUTTON, input_action{input_action_t::CUSTOM, record});
+
+	// forwarded like the window callbacks of the presenter do
+	auto move = [&](int x, int y, Qt::KeyboardModifiers mod = Qt::NoModifier, Qt::MouseButton button = Qt::NoButton) {
+		QMouseEvent ev{QEvent::MouseMove, QPointF(x, y), QPointF(x, y), button, button, mod};
+		mgr.set_mouse(x, y);
+		return mgr.process(ev);
+	};
+	auto check = [&](size_t idx, QEvent::Type type, int mod, int button, int x, int y, int dx, int dy) {
+		auto &ev = dispatched.at(idx);
+		TESTEQUALS(ev.type, type);
+		TESTEQUALS(ev.modifiers, mod);
+		TESTEQUALS(ev.button, button);
+		TESTEQUALS(ev.x, x);
+		TESTEQUALS(ev.y, y);
+		TESTEQUALS(ev.dx, dx);
+		TESTEQUALS(ev.dy, dy);
+	};
+
+	// motion is only dispatched on the next flush, with the combined motion
+	TESTEQUALS(move(10, 10), true);
+	TESTEQUALS(move(12, 15), true);
+	TESTEQUALS(move(20, 30), true);
+	TESTEQUALS(dispatched.size(), 0u);
+
+	mgr.process_pending();
+	TESTEQUALS(dispatched.size(), 1u);
+	check(0, QEvent::MouseMove, Qt::NoModifier, Qt::NoButton, 20, 30, 20, 30);
+
+	mgr.process_pending();
+	TESTEQUALS(dispatched.size(), 1u);
+
+	// changed modifiers flush the motion before the new event
+	move(21, 30);
+	move(25, 32, Qt::ShiftModifier);
+	TESTEQUALS(dispatched.size(), 2u);
+	check(1, QEvent::MouseMove, Qt::NoModifier, Qt::NoButton, 21, 30, 1, 0);
+
+	// changed button, the motion starts at the flushed position
+	move(27, 33, Qt::ShiftModifier);
+	move(28, 33, Qt::ShiftModifier, Qt::LeftButton);
+	TESTEQUALS(dispatched.size(), 3u);
+	check(2, QEvent::MouseMove, Qt::ShiftModifier, Qt::NoButton, 27, 33, 6, 3);
+
+	// other events are dispatched after the pending motion
+	move(30, 34, Qt::ShiftModifier, Qt::LeftButton);
+	QMouseEvent press{QEvent::MouseButtonPress, QPointF(30, 34), QPointF(30, 34), Qt::LeftButton, Qt::LeftButton, Qt::NoModifier};
+	TESTEQUALS(mgr.process(press), true);
+	TESTEQUALS(dispatched.size(), 5u);
+	check(3, QEvent::MouseMove, Qt::ShiftModifier, Qt::LeftButton, 30, 34, 3, 1);
+	check(4, QEvent::MouseButtonPress, Qt::NoModifier, Qt::LeftButton, 30, 34, 2, 1);
+
+	mgr.process_pending();
+	TESTEQUALS(dispatched.size(), 5u);
+
+	// motion after a flush starts at the last position
+	move(31, 30);
+	mgr.process_pending();
+	TESTEQUALS(dispatched.size(), 6u);
+	check(5, QEvent::MouseMove, Qt::NoModifier, Qt::NoButton, 31, 30, 1, -4);
+}
+
+
 void action_demo() {
 	auto qtapp = std::make_shared<renderer::gui::GuiApplicationWithLogger>();
 
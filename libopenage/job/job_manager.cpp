@@ -1,14 +1,27 @@
-// Copyright 2014-2019 the openage authors. See copying.md for legal info.
+// Copyright 2014-2024 the openage authors. See copying.md for legal info.
 
 #include "job_manager.h"
 
 #include "../log/log.h"
+#include "../metrics/registry.h"
 #include "../util/thread_id.h"
 #include "worker.h"
 
 
 namespace openage::job {
 
+namespace {
+
+metrics::Counter &jobs_enqueued_metric = metrics::registry().counter(
+	"job_manager_jobs_enqueued_total",
+	"Number of jobs enqueued into the job manager");
+
+metrics::Gauge &jobs_pending_metric = metrics::registry().gauge(
+	"job_manager_jobs_pending",
+	"Number of jobs waiting for a worker");
+
+} // namespace
+
 
 JobManager::JobManager(int number_of_workers)
 	:
@@ -89,6 +102,8 @@ JobGroup JobManager::create_job_group() {
 void JobManager::enqueue_state(const std::shared_ptr<JobStateBase> &state) {
 	std::lock_guard<std::mutex> lock{this->pending_jobs_mutex};
 	this->pending_jobs.push(state);
+	jobs_enqueued_metric.add();
+	jobs_pending_metric.set(this->pending_jobs.size());
 	for (auto &worker : this->workers) {
 		worker->notify();
 	}
@@ -103,6 +118,7 @@ std::shared_ptr<JobStateBase> JobManager::fetch_job() {
 
 	auto job = this->pending_jobs.front();
 	this->pending_jobs.pop();
+	jobs_pending_metric.set(this->pending_jobs.size());
 	return job;
 }
 
@@ -1,4 +1,4 @@
-// Copyright 2015-2019 the openage authors. See copying.md for legal info.
+// Copyright 2015-2024 the openage authors. See copying.md for legal info.
 
 #include "job_aborted_exception.h"
 #include "job_manager.h"
@@ -6,10 +6,22 @@
 
 #include <memory>
 
+#include "../metrics/registry.h"
+#include "../metrics/scoped_timer.h"
+#include "../metrics/trace.h"
+
 
 namespace openage {
 namespace job {
 
+namespace {
+
+metrics::Histogram &job_time_metric = metrics::registry().histogram(
+	"job_execution_time_ns",
+	"Time needed to execute a job on a worker thread");
+
+} // namespace
+
 
 Worker::Worker(JobManager *manager)
 	:
@@ -55,7 +67,13 @@ void Worker::execute_job(std::shared_ptr<JobStateBase> &job) {
 		return not this->is_running;
 	};
 
-	bool aborted = job->execute(should_abort);
+	bool aborted;
+	{
+		OA_TRACE_SCOPE("Worker::execute_job");
+		metrics::ScopedTimer timer{job_time_metric};
+		aborted = job->execute(should_abort);
+	}
+
 	// if the job was not aborted, tell the job manager, that the job has
 	// finished
 	if (not aborted) {
@@ -1,11 +1,14 @@
-// Copyright 2015-2023 the openage authors. See copying.md for legal info.
+// Copyright 2015-2024 the openage authors. See copying.md for legal info.
 
 #include "main.h"
 
+#include <chrono>
 #include <memory>
 
 #include "cvar/cvar.h"
 #include "engine/engine.h"
+#include "metrics/metrics.h"
+#include "metrics/reporter.h"
 #include "util/timer.h"
 
 namespace openage {
@@ -27,12 +30,30 @@ int run_game(const main_arguments &args) {
 
 	// set engine run_mode
 	openage::engine::Engine::mode run_mode = openage::engine::Engine::mode::FULL;
-	if (args.headless) {
+	if (args.headless or not args.replay_file.empty()) {
 		run_mode = openage::engine::Engine::mode::HEADLESS;
 	}
 
+	// performance metrics are dumped periodically while the engine runs
+	std::unique_ptr<metrics::Reporter> metrics_reporter;
+	if (args.metrics) {
+		metrics::set_enabled(true);
+		metrics_reporter = std::make_unique<metrics::Reporter>(std::chrono::seconds{10},
+		                                                       args.metrics_file);
+		metrics_reporter->start();
+	}
+
 	openage::engine::Engine engine{run_mode, args.root_path, args.mods, args.gl_debug};
 
+	// replays are played headless as fast as possible
+	if (not args.replay_file.empty()) {
+		return engine.replay(args.replay_file) ? 0 : 1;
+	}
+
+	if (not args.record_replay_file.empty()) {
+		engine.record_replay(args.record_replay_file);
+	}
+
 	engine.loop();
 
 	return 0;
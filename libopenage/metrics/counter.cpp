@@ -0,0 +1,23 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "counter.h"
+
+
+namespace openage::metrics {
+
+uint64_t Counter::get() const {
+	uint64_t sum = 0;
+	for (auto &shard : this->shards) {
+		sum += shard.value.load(std::memory_order_relaxed);
+	}
+	return sum;
+}
+
+
+void Counter::reset() {
+	for (auto &shard : this->shards) {
+		shard.value.store(0, std::memory_order_relaxed);
+	}
+}
+
+} // namespace openage::metrics
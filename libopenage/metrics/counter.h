@@ -0,0 +1,67 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "metrics/metrics.h"
+
+
+namespace openage::metrics {
+
+/**
+ * Monotonically increasing count of events, e.g. the number of executed jobs.
+ *
+ * Every thread increments one of several shards,
+ * the value of the counter is the sum of all shards.
+ */
+class Counter {
+public:
+	Counter() = default;
+	~Counter() = default;
+
+	Counter(const Counter &) = delete;
+	Counter &operator=(const Counter &) = delete;
+
+	/**
+	 * Increase the counter.
+	 *
+	 * @param amount Value added to the counter.
+	 */
+	void add(uint64_t amount = 1) {
+		if (not enabled()) {
+			return;
+		}
+
+		this->shards[thread_shard()].value.fetch_add(amount, std::memory_order_relaxed);
+	}
+
+	/**
+	 * Get the current value of the counter.
+	 *
+	 * @return Sum of all shards.
+	 */
+	uint64_t get() const;
+
+	/**
+	 * Set the counter back to zero.
+	 */
+	void reset();
+
+private:
+	/**
+	 * Counter shard, padded to its own cache line.
+	 */
+	struct alignas(64) Shard {
+		std::atomic<uint64_t> value{0};
+	};
+
+	/**
+	 * Partial sums of the counter.
+	 */
+	std::array<Shard, shard_count> shards;
+};
+
+} // namespace openage::metrics
@@ -0,0 +1,17 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "gauge.h"
+
+
+namespace openage::metrics {
+
+int64_t Gauge::get() const {
+	return this->value.load(std::memory_order_relaxed);
+}
+
+
+void Gauge::reset() {
+	this->value.store(0, std::memory_order_relaxed);
+}
+
+} // namespace openage::metrics
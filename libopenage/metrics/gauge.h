@@ -0,0 +1,64 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "metrics/metrics.h"
+
+
+namespace openage::metrics {
+
+/**
+ * Value that can go up and down, e.g. the length of a queue.
+ */
+class Gauge {
+public:
+	Gauge() = default;
+	~Gauge() = default;
+
+	Gauge(const Gauge &) = delete;
+	Gauge &operator=(const Gauge &) = delete;
+
+	/**
+	 * Replace the value of the gauge.
+	 *
+	 * @param value New value.
+	 */
+	void set(int64_t value) {
+		if (not enabled()) {
+			return;
+		}
+
+		this->value.store(value, std::memory_order_relaxed);
+	}
+
+	/**
+	 * Change the value of the gauge.
+	 *
+	 * @param amount Value added to the gauge, may be negative.
+	 */
+	void add(int64_t amount) {
+		if (not enabled()) {
+			return;
+		}
+
+		this->value.fetch_add(amount, std::memory_order_relaxed);
+	}
+
+	/**
+	 * Get the current value of the gauge.
+	 */
+	int64_t get() const;
+
+	/**
+	 * Set the gauge back to zero.
+	 */
+	void reset();
+
+private:
+	std::atomic<int64_t> value{0};
+};
+
+} // namespace openage::metrics
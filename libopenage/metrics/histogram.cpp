@@ -0,0 +1,72 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace openage::metrics {
+
+double HistogramSnapshot::mean() const {
+	if (this->count == 0) {
+		return 0.0;
+	}
+	return static_cast<double>(this->sum) / this->count;
+}
+
+
+uint64_t HistogramSnapshot::quantile(double q) const {
+	if (this->count == 0) {
+		return 0;
+	}
+
+	// rank of the requested value, starting at 1
+	auto rank = static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * this->count));
+	rank = std::max<uint64_t>(rank, 1);
+
+	uint64_t seen = 0;
+	for (auto &[upper, bucket_count] : this->buckets) {
+		seen += bucket_count;
+		if (seen >= rank) {
+			return std::min(upper, this->max);
+		}
+	}
+
+	return this->max;
+}
+
+
+HistogramSnapshot Histogram::snapshot() const {
+	HistogramSnapshot result;
+
+	for (size_t i = 0; i < bucket_count; i++) {
+		uint64_t bucket_values = this->buckets[i].load(std::memory_order_relaxed);
+		if (bucket_values > 0) {
+			result.buckets.emplace_back(bucket_bounds(i).second, bucket_values);
+			result.count += bucket_values;
+		}
+	}
+
+	// the buckets are not updated atomically with the sum,
+	// so concurrent records may be included in one but not the other.
+	result.sum = this->sum.load(std::memory_order_relaxed);
+	if (result.count > 0) {
+		result.min = this->min.load(std::memory_order_relaxed);
+		result.max = this->max.load(std::memory_order_relaxed);
+	}
+
+	return result;
+}
+
+
+void Histogram::reset() {
+	for (auto &bucket : this->buckets) {
+		bucket.store(0, std::memory_order_relaxed);
+	}
+	this->sum.store(0, std::memory_order_relaxed);
+	this->min.store(UINT64_MAX, std::memory_order_relaxed);
+	this->max.store(0, std::memory_order_relaxed);
+}
+
+} // namespace openage::metrics
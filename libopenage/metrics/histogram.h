@@ -0,0 +1,155 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "metrics/metrics.h"
+
+
+namespace openage::metrics {
+
+/**
+ * Copy of the state of a histogram at one point in time.
+ */
+struct HistogramSnapshot {
+	/// number of recorded values
+	uint64_t count = 0;
+
+	/// sum of all recorded values
+	uint64_t sum = 0;
+
+	/// smallest recorded value
+	uint64_t min = 0;
+
+	/// largest recorded value
+	uint64_t max = 0;
+
+	/**
+	 * Non-empty buckets in ascending order.
+	 * Stores the (inclusive) upper bound of a bucket and the number
+	 * of values in it.
+	 */
+	std::vector<std::pair<uint64_t, uint64_t>> buckets;
+
+	/**
+	 * Get the mean of the recorded values.
+	 */
+	double mean() const;
+
+	/**
+	 * Get the value below which the given fraction of values lies.
+	 *
+	 * The result is the upper bound of the bucket containing the
+	 * quantile, so it is at most 1 / sub_bucket_count too large.
+	 *
+	 * @param q Quantile in [0, 1], e.g. 0.99 for the 99th percentile.
+	 *
+	 * @return Value at the quantile, 0 if there are no values.
+	 */
+	uint64_t quantile(double q) const;
+};
+
+
+/**
+ * Distribution of values, e.g. latencies in nanoseconds.
+ *
+ * Buckets are arranged like in a HDR histogram: every power of two
+ * is split into sub_bucket_count linear buckets, so the relative
+ * error is bounded over the whole 64 bit range. Recording a value
+ * is a few bit operations and relaxed atomic increments.
+ */
+class Histogram {
+public:
+	/**
+	 * Number of bits used to select the linear sub bucket.
+	 */
+	static constexpr unsigned sub_bucket_bits = 5;
+
+	/**
+	 * Number of linear buckets per power of two.
+	 */
+	static constexpr uint64_t sub_bucket_count = uint64_t{1} << sub_bucket_bits;
+
+	/**
+	 * Total number of buckets needed to cover all uint64_t values.
+	 */
+	static constexpr size_t bucket_count = (64 - sub_bucket_bits + 1) * sub_bucket_count;
+
+	Histogram() = default;
+	~Histogram() = default;
+
+	Histogram(const Histogram &) = delete;
+	Histogram &operator=(const Histogram &) = delete;
+
+	/**
+	 * Record one value.
+	 *
+	 * @param value Value to add to the distribution.
+	 */
+	void record(uint64_t value) {
+		if (not enabled()) {
+			return;
+		}
+
+		this->buckets[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+		this->sum.fetch_add(value, std::memory_order_relaxed);
+
+		uint64_t prev_min = this->min.load(std::memory_order_relaxed);
+		while (value < prev_min
+		       and not this->min.compare_exchange_weak(prev_min, value, std::memory_order_relaxed)) {}
+
+		uint64_t prev_max = this->max.load(std::memory_order_relaxed);
+		while (value > prev_max
+		       and not this->max.compare_exchange_weak(prev_max, value, std::memory_order_relaxed)) {}
+	}
+
+	/**
+	 * Copy the current state of the histogram.
+	 */
+	HistogramSnapshot snapshot() const;
+
+	/**
+	 * Remove all recorded values.
+	 */
+	void reset();
+
+	/**
+	 * Get the index of the bucket that stores the given value.
+	 */
+	static constexpr size_t bucket_index(uint64_t value) {
+		if (value < sub_bucket_count) {
+			return value;
+		}
+
+		unsigned shift = std::bit_width(value) - 1 - sub_bucket_bits;
+		return (shift + 1) * sub_bucket_count + ((value >> shift) - sub_bucket_count);
+	}
+
+	/**
+	 * Get the smallest and the largest value stored in a bucket.
+	 */
+	static constexpr std::pair<uint64_t, uint64_t> bucket_bounds(size_t index) {
+		if (index < sub_bucket_count) {
+			return {index, index};
+		}
+
+		unsigned shift = index / sub_bucket_count - 1;
+		uint64_t lower = (sub_bucket_count + index % sub_bucket_count) << shift;
+		return {lower, lower + ((uint64_t{1} << shift) - 1)};
+	}
+
+private:
+	std::array<std::atomic<uint64_t>, bucket_count> buckets{};
+	std::atomic<uint64_t> sum{0};
+	std::atomic<uint64_t> min{UINT64_MAX};
+	std::atomic<uint64_t> max{0};
+};
+
+} // namespace openage::metrics
@@ -0,0 +1,23 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "metrics.h"
+
+
+namespace openage::metrics {
+
+std::atomic<bool> enabled_flag{false};
+
+
+void set_enabled(bool enabled) {
+	enabled_flag.store(enabled, std::memory_order_relaxed);
+}
+
+
+size_t thread_shard() {
+	static std::atomic<size_t> next_shard{0};
+	thread_local size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % shard_count;
+
+	return shard;
+}
+
+} // namespace openage::metrics
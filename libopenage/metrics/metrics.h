@@ -0,0 +1,45 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+
+namespace openage::metrics {
+
+/**
+ * Number of shards of a counter.
+ * Threads are distributed over the shards, so concurrent
+ * increments usually don't touch the same cache line.
+ */
+constexpr size_t shard_count = 16;
+
+/**
+ * Global switch for all metrics.
+ * Use enabled() and set_enabled() to access it.
+ */
+extern std::atomic<bool> enabled_flag;
+
+/**
+ * Check if metrics are recorded.
+ *
+ * All recording functions return immediately if this is false,
+ * so disabled metrics only cost this check.
+ */
+inline bool enabled() {
+	return enabled_flag.load(std::memory_order_relaxed);
+}
+
+/**
+ * Enable or disable the recording of all metrics.
+ * Metrics are disabled by default.
+ */
+void set_enabled(bool enabled);
+
+/**
+ * Get the counter shard used by the calling thread.
+ */
+size_t thread_shard();
+
+} // namespace openage::metrics
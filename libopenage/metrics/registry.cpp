@@ -0,0 +1,109 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "registry.h"
+
+#include "error/error.h"
+#include "log/message.h"
+
+
+namespace openage::metrics {
+
+template <typename T>
+T &Registry::get_or_create(std::unordered_map<std::string, std::unique_ptr<T>> &metrics,
+                           const std::string &name,
+                           const std::string &description) {
+	std::unique_lock lock{this->mutex};
+
+	auto it = metrics.find(name);
+	if (it != metrics.end()) {
+		return *it->second;
+	}
+
+	this->check_name(name);
+
+	if (not description.empty()) {
+		this->descriptions.emplace(name, description);
+	}
+
+	return *metrics.emplace(name, std::make_unique<T>()).first->second;
+}
+
+
+Counter &Registry::counter(const std::string &name, const std::string &description) {
+	return this->get_or_create(this->counters, name, description);
+}
+
+
+Gauge &Registry::gauge(const std::string &name, const std::string &description) {
+	return this->get_or_create(this->gauges, name, description);
+}
+
+
+Histogram &Registry::histogram(const std::string &name, const std::string &description) {
+	return this->get_or_create(this->histograms, name, description);
+}
+
+
+Snapshot Registry::snapshot() const {
+	Snapshot result;
+	result.timestamp = timing::get_real_time();
+
+	std::unique_lock lock{this->mutex};
+
+	for (auto &[name, counter] : this->counters) {
+		result.counters.emplace(name, counter->get());
+	}
+	for (auto &[name, gauge] : this->gauges) {
+		result.gauges.emplace(name, gauge->get());
+	}
+	for (auto &[name, histogram] : this->histograms) {
+		result.histograms.emplace(name, histogram->snapshot());
+	}
+	result.descriptions.insert(this->descriptions.begin(), this->descriptions.end());
+
+	return result;
+}
+
+
+void Registry::reset() {
+	std::unique_lock lock{this->mutex};
+
+	for (auto &[name, counter] : this->counters) {
+		counter->reset();
+	}
+	for (auto &[name, gauge] : this->gauges) {
+		gauge->reset();
+	}
+	for (auto &[name, histogram] : this->histograms) {
+		histogram->reset();
+	}
+}
+
+
+void Registry::check_name(const std::string &name) const {
+	auto valid_char = [](char c, bool first) {
+		return (c >= 'a' and c <= 'z') or (c >= 'A' and c <= 'Z') or c == '_' or c == ':'
+		       or (not first and c >= '0' and c <= '9');
+	};
+
+	bool valid = not name.empty();
+	for (size_t i = 0; i < name.size() and valid; i++) {
+		valid = valid_char(name[i], i == 0);
+	}
+
+	if (not valid) {
+		throw Error{MSG(err) << "invalid metric name: '" << name << "'"};
+	}
+
+	if (this->counters.contains(name) or this->gauges.contains(name) or this->histograms.contains(name)) {
+		throw Error{MSG(err) << "metric '" << name << "' is already registered with a different type"};
+	}
+}
+
+
+Registry &registry() {
+	static Registry instance;
+	return instance;
+}
+
+} // namespace openage::metrics
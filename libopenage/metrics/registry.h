@@ -0,0 +1,110 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "metrics/counter.h"
+#include "metrics/gauge.h"
+#include "metrics/histogram.h"
+#include "metrics/snapshot.h"
+
+
+namespace openage::metrics {
+
+/**
+ * Owns all metrics of the process, identified by their name.
+ *
+ * Registration takes a lock, so metrics should be looked up once
+ * and the returned reference kept, e.g. in a static variable:
+ *
+ *     static auto &jobs = metrics::registry().counter("jobs_total");
+ *     jobs.add();
+ *
+ * Recording values through the reference is lock-free.
+ * Metrics are never removed, so references stay valid.
+ */
+class Registry {
+public:
+	Registry() = default;
+	~Registry() = default;
+
+	Registry(const Registry &) = delete;
+	Registry &operator=(const Registry &) = delete;
+
+	/**
+	 * Get a counter, create it if it does not exist.
+	 *
+	 * @param name Name of the metric, must be a valid Prometheus metric name.
+	 * @param description Short explanation of the metric.
+	 *
+	 * @return Counter with the given name.
+	 */
+	Counter &counter(const std::string &name, const std::string &description = "");
+
+	/**
+	 * Get a gauge, create it if it does not exist.
+	 *
+	 * @param name Name of the metric, must be a valid Prometheus metric name.
+	 * @param description Short explanation of the metric.
+	 *
+	 * @return Gauge with the given name.
+	 */
+	Gauge &gauge(const std::string &name, const std::string &description = "");
+
+	/**
+	 * Get a histogram, create it if it does not exist.
+	 *
+	 * @param name Name of the metric, must be a valid Prometheus metric name.
+	 * @param description Short explanation of the metric.
+	 *
+	 * @return Histogram with the given name.
+	 */
+	Histogram &histogram(const std::string &name, const std::string &description = "");
+
+	/**
+	 * Copy the current values of all metrics.
+	 */
+	Snapshot snapshot() const;
+
+	/**
+	 * Reset the values of all metrics.
+	 */
+	void reset();
+
+private:
+	/**
+	 * Find or create a metric in one of the metric maps.
+	 */
+	template <typename T>
+	T &get_or_create(std::unordered_map<std::string, std::unique_ptr<T>> &metrics,
+	                 const std::string &name,
+	                 const std::string &description);
+
+	/**
+	 * Check that a new metric name is valid and not used by a metric of another type.
+	 * Must be called with the lock held.
+	 */
+	void check_name(const std::string &name) const;
+
+	/**
+	 * Protects the metric maps. Not used when recording values.
+	 */
+	mutable std::mutex mutex;
+
+	std::unordered_map<std::string, std::unique_ptr<Counter>> counters;
+	std::unordered_map<std::string, std::unique_ptr<Gauge>> gauges;
+	std::unordered_map<std::string, std::unique_ptr<Histogram>> histograms;
+	std::unordered_map<std::string, std::string> descriptions;
+};
+
+
+/**
+ * Get the process-wide metrics registry.
+ */
+Registry &registry();
+
+} // namespace openage::metrics
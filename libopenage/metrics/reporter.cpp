@@ -0,0 +1,94 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "reporter.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include "log/log.h"
+#include "log/message.h"
+#include "metrics/registry.h"
+
+
+namespace openage::metrics {
+
+Reporter::Reporter(std::chrono::milliseconds interval,
+                   const std::string &output_file) :
+	interval{interval},
+	output_file{output_file},
+	running{false} {}
+
+
+Reporter::~Reporter() {
+	this->stop();
+}
+
+
+void Reporter::start() {
+	std::unique_lock lock{this->mutex};
+	if (this->running) {
+		return;
+	}
+
+	this->running = true;
+	this->thread = std::thread{&Reporter::run, this};
+}
+
+
+void Reporter::stop() {
+	{
+		std::unique_lock lock{this->mutex};
+		this->running = false;
+	}
+	this->stopped.notify_all();
+
+	if (this->thread.joinable()) {
+		this->thread.join();
+	}
+}
+
+
+void Reporter::report() const {
+	auto snapshot = registry().snapshot();
+
+	log::log(MSG(info) << "Metrics:\n"
+	                   << format_summary(snapshot));
+
+	if (this->output_file.empty()) {
+		return;
+	}
+
+	// write to a temporary file first, then move it over the
+	// old one so readers never see an incomplete file.
+	std::string tmp_file = this->output_file + ".tmp";
+	{
+		std::ofstream out{tmp_file, std::ios_base::out | std::ios_base::trunc};
+		out << format_prometheus(snapshot);
+		if (not out) {
+			log::log(MSG(warn) << "Could not write metrics to " << tmp_file);
+			return;
+		}
+	}
+
+	if (std::rename(tmp_file.c_str(), this->output_file.c_str()) != 0) {
+		log::log(MSG(warn) << "Could not move metrics file to " << this->output_file);
+	}
+}
+
+
+void Reporter::run() {
+	std::unique_lock lock{this->mutex};
+
+	while (this->running) {
+		this->stopped.wait_for(lock, this->interval, [this] {
+			return not this->running;
+		});
+
+		// don't hold the lock while reporting, stop() would block
+		lock.unlock();
+		this->report();
+		lock.lock();
+	}
+}
+
+} // namespace openage::metrics
@@ -0,0 +1,92 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+namespace openage::metrics {
+
+/**
+ * Periodically dumps the metrics of the process-wide registry.
+ *
+ * Every interval, a summary is written to the log and, if an output file
+ * was given, the metrics are written to it in the Prometheus text format.
+ * The file is replaced atomically, so collectors never read partial data.
+ */
+class Reporter {
+public:
+	/**
+	 * Create a reporter. It does not report until start() is called.
+	 *
+	 * @param interval Time between two reports.
+	 * @param output_file Path of the metrics file. No file is written if empty.
+	 */
+	Reporter(std::chrono::milliseconds interval,
+	         const std::string &output_file = "");
+
+	/**
+	 * Stops the reporter thread.
+	 */
+	~Reporter();
+
+	Reporter(const Reporter &) = delete;
+	Reporter &operator=(const Reporter &) = delete;
+
+	/**
+	 * Start reporting in a background thread.
+	 */
+	void start();
+
+	/**
+	 * Stop the background thread. A final report is made before it exits.
+	 */
+	void stop();
+
+	/**
+	 * Report the current values immediately.
+	 */
+	void report() const;
+
+private:
+	/**
+	 * Loop of the background thread.
+	 */
+	void run();
+
+	/**
+	 * Time between two reports.
+	 */
+	std::chrono::milliseconds interval;
+
+	/**
+	 * Path of the metrics file.
+	 */
+	std::string output_file;
+
+	/**
+	 * Thread that makes the reports.
+	 */
+	std::thread thread;
+
+	/**
+	 * Protects running.
+	 */
+	std::mutex mutex;
+
+	/**
+	 * Wakes up the thread when the reporter is stopped.
+	 */
+	std::condition_variable stopped;
+
+	/**
+	 * Whether the reporter thread should continue.
+	 */
+	bool running;
+};
+
+} // namespace openage::metrics
@@ -0,0 +1,14 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "scoped_timer.h"
+
+
+namespace openage::metrics {
+
+ScopedTimer::~ScopedTimer() {
+	if (this->start != 0) {
+		this->histogram.record(timing::get_monotonic_time() - this->start);
+	}
+}
+
+} // namespace openage::metrics
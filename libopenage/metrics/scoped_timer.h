@@ -0,0 +1,41 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include "metrics/histogram.h"
+#include "metrics/metrics.h"
+#include "util/timing.h"
+
+
+namespace openage::metrics {
+
+/**
+ * Records the time between its construction and destruction
+ * in nanoseconds into a histogram.
+ *
+ * If metrics are disabled on construction, no time is measured.
+ */
+class ScopedTimer {
+public:
+	explicit ScopedTimer(Histogram &histogram) :
+		histogram{histogram},
+		start{enabled() ? timing::get_monotonic_time() : 0} {}
+
+	~ScopedTimer();
+
+	ScopedTimer(const ScopedTimer &) = delete;
+	ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+	/**
+	 * Histogram that receives the elapsed time.
+	 */
+	Histogram &histogram;
+
+	/**
+	 * Time of construction, 0 if metrics were disabled.
+	 */
+	time_nsec_t start;
+};
+
+} // namespace openage::metrics
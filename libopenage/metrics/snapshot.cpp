@@ -0,0 +1,86 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "snapshot.h"
+
+#include <sstream>
+
+
+namespace openage::metrics {
+
+namespace {
+
+/**
+ * Write the metadata lines that precede the samples of a metric.
+ */
+void prometheus_header(std::ostringstream &out,
+                       const Snapshot &snapshot,
+                       const std::string &name,
+                       const char *type) {
+	auto description = snapshot.descriptions.find(name);
+	if (description != snapshot.descriptions.end()) {
+		out << "# HELP " << name << " " << description->second << "\n";
+	}
+	out << "# TYPE " << name << " " << type << "\n";
+}
+
+} // namespace
+
+
+std::string format_prometheus(const Snapshot &snapshot) {
+	std::ostringstream out;
+	for (auto &[name, value] : snapshot.counters) {
+		prometheus_header(out, snapshot, name, "counter");
+		out << name << " " << value << "\n";
+	}
+
+	for (auto &[name, value] : snapshot.gauges) {
+		prometheus_header(out, snapshot, name, "gauge");
+		out << name << " " << value << "\n";
+	}
+
+	for (auto &[name, histogram] : snapshot.histograms) {
+		prometheus_header(out, snapshot, name, "histogram");
+
+		// bucket counts are cumulative in this format
+		uint64_t cumulative = 0;
+		for (auto &[upper, count] : histogram.buckets) {
+			cumulative += count;
+			out << name << "_bucket{le=\"" << upper << "\"} " << cumulative << "\n";
+		}
+		out << name << "_bucket{le=\"+Inf\"} " << histogram.count << "\n";
+		out << name << "_sum " << histogram.sum << "\n";
+		out << name << "_count " << histogram.count << "\n";
+	}
+
+	return out.str();
+}
+
+
+std::string format_summary(const Snapshot &snapshot) {
+	std::ostringstream out;
+
+	for (auto &[name, value] : snapshot.counters) {
+		out << name << ": " << value << "\n";
+	}
+
+	for (auto &[name, value] : snapshot.gauges) {
+		out << name << ": " << value << "\n";
+	}
+
+	for (auto &[name, histogram] : snapshot.histograms) {
+		out << name << ": n=" << histogram.count;
+		if (histogram.count > 0) {
+			out << " mean=" << static_cast<uint64_t>(histogram.mean())
+			    << " min=" << histogram.min
+			    << " p50=" << histogram.quantile(0.5)
+			    << " p90=" << histogram.quantile(0.9)
+			    << " p99=" << histogram.quantile(0.99)
+			    << " max=" << histogram.max;
+		}
+		out << "\n";
+	}
+
+	return out.str();
+}
+
+} // namespace openage::metrics
@@ -0,0 +1,58 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "metrics/histogram.h"
+#include "util/timing.h"
+
+
+namespace openage::metrics {
+
+/**
+ * Values of all registered metrics at one point in time.
+ */
+struct Snapshot {
+	/// real time of the snapshot in nanoseconds since the UNIX epoch
+	time_nsec_t timestamp = 0;
+
+	/// counter values by name
+	std::map<std::string, uint64_t> counters;
+
+	/// gauge values by name
+	std::map<std::string, int64_t> gauges;
+
+	/// histograms by name
+	std::map<std::string, HistogramSnapshot> histograms;
+
+	/// descriptions of the metrics by name, if they have one
+	std::map<std::string, std::string> descriptions;
+};
+
+
+/**
+ * Format a snapshot in the Prometheus text exposition format.
+ *
+ * The output can be scraped directly or written to a file that is
+ * picked up by a collector (e.g. the node exporter textfile collector).
+ *
+ * @param snapshot Metric values.
+ *
+ * @return Metrics in the text format, one sample per line.
+ */
+std::string format_prometheus(const Snapshot &snapshot);
+
+/**
+ * Format a snapshot as human readable summary for the log.
+ *
+ * @param snapshot Metric values.
+ *
+ * @return One line per metric, histograms are summarized with
+ *         their mean and percentiles.
+ */
+std::string format_summary(const Snapshot &snapshot);
+
+} // namespace openage::metrics
@@ -0,0 +1,141 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "metrics/counter.h"
+#include "metrics/histogram.h"
+#include "metrics/metrics.h"
+#include "metrics/registry.h"
+#include "metrics/scoped_timer.h"
+#include "metrics/snapshot.h"
+#include "metrics/trace.h"
+#include "testing/testing.h"
+
+
+namespace openage::metrics::tests {
+
+void metrics() {
+	bool was_enabled = enabled();
+	set_enabled(true);
+
+	// bucket layout
+	for (uint64_t value : std::vector<uint64_t>{0, 1, 31, 32, 33, 1000, 123456789, UINT64_MAX}) {
+		auto bounds = Histogram::bucket_bounds(Histogram::bucket_index(value));
+		TESTEQUALS(bounds.first <= value and value <= bounds.second, true);
+	}
+	TESTEQUALS(Histogram::bucket_index(UINT64_MAX), Histogram::bucket_count - 1);
+
+	// counters are summed over all threads
+	Counter counter;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; t++) {
+		threads.emplace_back([&counter] {
+			for (int i = 0; i < 1000; i++) {
+				counter.add();
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	TESTEQUALS(counter.get(), 4000u);
+
+	// nothing is recorded while disabled
+	set_enabled(false);
+	counter.add(5);
+	TESTEQUALS(counter.get(), 4000u);
+	set_enabled(true);
+
+	Histogram histogram;
+	for (uint64_t i = 1; i <= 1000; i++) {
+		histogram.record(i);
+	}
+	auto snapshot = histogram.snapshot();
+	TESTEQUALS(snapshot.count, 1000u);
+	TESTEQUALS(snapshot.sum, 500500u);
+	TESTEQUALS(snapshot.min, 1u);
+	TESTEQUALS(snapshot.max, 1000u);
+	TESTEQUALS(snapshot.quantile(0.0), 1u);
+	TESTEQUALS(snapshot.quantile(1.0), 1000u);
+
+	// the result may exceed the exact value by the bucket width
+	uint64_t p50 = snapshot.quantile(0.5);
+	TESTEQUALS(p50 >= 500 and p50 <= 500 + 500 / Histogram::sub_bucket_count, true);
+
+	histogram.reset();
+	TESTEQUALS(histogram.snapshot().count, 0u);
+	TESTEQUALS(histogram.snapshot().quantile(0.5), 0u);
+
+	// registration returns the same metric for the same name
+	auto &registered = registry().counter("metrics_test_total", "metrics test counter");
+	TESTEQUALS(&registered, &registry().counter("metrics_test_total"));
+	TESTTHROWS(registry().gauge("metrics_test_total"));
+	TESTTHROWS(registry().counter("metrics test"));
+	registered.add(3);
+
+	{
+		ScopedTimer timer{registry().histogram("metrics_test_time_ns")};
+	}
+
+	auto full = registry().snapshot();
+	TESTEQUALS(full.counters.at("metrics_test_total"), 3u);
+	TESTEQUALS(full.histograms.at("metrics_test_time_ns").count, 1u);
+
+	std::string text = format_prometheus(full);
+	TESTEQUALS(text.find("# HELP metrics_test_total metrics test counter\n") != std::string::npos, true);
+	TESTEQUALS(text.find("# TYPE metrics_test_time_ns histogram\n") != std::string::npos, true);
+	TESTEQUALS(text.find("metrics_test_time_ns_count 1\n") != std::string::npos, true);
+
+	registry().reset();
+	TESTEQUALS(registered.get(), 0u);
+
+	set_enabled(was_enabled);
+}
+
+
+void trace() {
+	bool was_enabled = tracing_enabled();
+	clear_trace();
+
+	{
+		OA_TRACE_SCOPE("untraced");
+	}
+
+	set_tracing(true);
+	{
+		OA_TRACE_SCOPE("outer");
+		std::thread{[] {
+			OA_TRACE_SCOPE("worker \"zone\"");
+		}}.join();
+	}
+	set_tracing(false);
+
+	std::ostringstream out;
+	write_trace(out);
+	std::string json = out.str();
+
+	TESTEQUALS(json.find("\"traceEvents\"") != std::string::npos, true);
+	TESTEQUALS(json.find("untraced"), std::string::npos);
+	TESTEQUALS(json.find("{\"name\":\"outer\",\"ph\":\"X\"") != std::string::npos, true);
+	TESTEQUALS(json.find("\"worker \\\"zone\\\"\"") != std::string::npos, true);
+
+	// the ring buffer only keeps the newest zones
+	set_tracing(true);
+	for (size_t i = 0; i < trace_buffer_size + 10; i++) {
+		OA_TRACE_SCOPE("overflow");
+	}
+	set_tracing(false);
+
+	std::ostringstream overflow_out;
+	write_trace(overflow_out);
+	json = overflow_out.str();
+	TESTEQUALS(json.find("outer"), std::string::npos);
+
+	clear_trace();
+	set_tracing(was_enabled);
+}
+
+} // namespace openage::metrics::tests
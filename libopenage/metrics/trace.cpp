@@ -0,0 +1,186 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "trace.h"
+
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include "error/error.h"
+#include "log/message.h"
+#include "util/thread_id.h"
+
+
+namespace openage::metrics {
+
+std::atomic<bool> tracing_flag{false};
+
+
+namespace {
+
+/**
+ * A finished trace zone.
+ */
+struct TraceEvent {
+	const char *name;
+	time_nsec_t start;
+	time_nsec_t duration;
+};
+
+
+/**
+ * Ring buffer of the zones recorded by one thread.
+ */
+struct ThreadTrace {
+	explicit ThreadTrace(size_t thread_id) :
+		thread_id{thread_id},
+		events(trace_buffer_size) {}
+
+	/**
+	 * Only contended while a trace is written.
+	 */
+	std::mutex mutex;
+
+	size_t thread_id;
+
+	std::vector<TraceEvent> events;
+
+	/**
+	 * Number of zones recorded since the last clear.
+	 * The next zone is stored at count % trace_buffer_size.
+	 */
+	size_t count = 0;
+};
+
+
+/**
+ * Buffers of all threads that have recorded zones.
+ * Buffers of exited threads are kept so that they show up in the trace.
+ */
+struct TraceRegistry {
+	std::mutex mutex;
+	std::vector<std::shared_ptr<ThreadTrace>> threads;
+};
+
+
+TraceRegistry &trace_registry() {
+	static TraceRegistry registry;
+	return registry;
+}
+
+
+ThreadTrace &thread_trace() {
+	thread_local std::shared_ptr<ThreadTrace> trace = [] {
+		auto trace = std::make_shared<ThreadTrace>(util::get_current_thread_id());
+
+		auto &registry = trace_registry();
+		std::unique_lock lock{registry.mutex};
+		registry.threads.push_back(trace);
+
+		return trace;
+	}();
+
+	return *trace;
+}
+
+
+/**
+ * Write a zone name as JSON string.
+ */
+void write_json_string(std::ostream &out, const char *str) {
+	out << '"';
+	for (const char *c = str; *c != '\0'; c++) {
+		switch (*c) {
+		case '"':
+			out << "\\\"";
+			break;
+		case '\\':
+			out << "\\\\";
+			break;
+		default:
+			if (static_cast<unsigned char>(*c) >= 0x20) {
+				out << *c;
+			}
+		}
+	}
+	out << '"';
+}
+
+} // namespace
+
+
+void set_tracing(bool enabled) {
+	tracing_flag.store(enabled, std::memory_order_relaxed);
+}
+
+
+void clear_trace() {
+	auto &registry = trace_registry();
+	std::unique_lock lock{registry.mutex};
+
+	for (auto &thread : registry.threads) {
+		std::unique_lock thread_lock{thread->mutex};
+		thread->count = 0;
+	}
+}
+
+
+void record_zone(const char *name, time_nsec_t start, time_nsec_t end) {
+	auto &trace = thread_trace();
+	std::unique_lock lock{trace.mutex};
+
+	trace.events[trace.count % trace_buffer_size] = TraceEvent{name, start, end - start};
+	trace.count += 1;
+}
+
+
+void write_trace(std::ostream &out) {
+	auto &registry = trace_registry();
+	std::unique_lock lock{registry.mutex};
+
+	// timestamps in the trace format are microseconds
+	auto write_usec = [&out](time_nsec_t nsec) {
+		out << nsec / 1000 << "." << (nsec % 1000) / 100 << (nsec % 100) / 10 << nsec % 10;
+	};
+
+	out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+	bool first = true;
+	for (auto &thread : registry.threads) {
+		std::unique_lock thread_lock{thread->mutex};
+
+		size_t begin = thread->count > trace_buffer_size ? thread->count - trace_buffer_size : 0;
+		for (size_t i = begin; i < thread->count; i++) {
+			auto &event = thread->events[i % trace_buffer_size];
+
+			if (not first) {
+				out << ",";
+			}
+			first = false;
+
+			out << "\n{\"name\":";
+			write_json_string(out, event.name);
+			out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->thread_id << ",\"ts\":";
+			write_usec(event.start);
+			out << ",\"dur\":";
+			write_usec(event.duration);
+			out << "}";
+		}
+	}
+
+	out << "\n]}\n";
+}
+
+
+void dump_trace(const std::string &filename) {
+	std::ofstream out{filename, std::ios_base::out | std::ios_base::trunc};
+	write_trace(out);
+
+	if (not out) {
+		throw Error{MSG(err) << "Could not write trace to " << filename};
+	}
+}
+
+} // namespace openage::metrics
@@ -0,0 +1,110 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <atomic>
+#include <iosfwd>
+#include <string>
+
+#include "util/timing.h"
+
+
+namespace openage::metrics {
+
+/**
+ * Number of zones that are kept per thread.
+ * When a thread records more zones, the oldest ones are overwritten.
+ */
+constexpr size_t trace_buffer_size = 16384;
+
+/**
+ * Global switch for trace zones.
+ * Use tracing_enabled() and set_tracing() to access it.
+ */
+extern std::atomic<bool> tracing_flag;
+
+/**
+ * Check if trace zones are recorded.
+ */
+inline bool tracing_enabled() {
+	return tracing_flag.load(std::memory_order_relaxed);
+}
+
+/**
+ * Start or stop recording trace zones.
+ * Zones recorded before are kept until clear_trace() is called.
+ */
+void set_tracing(bool enabled);
+
+/**
+ * Remove all recorded zones.
+ */
+void clear_trace();
+
+/**
+ * Store a finished zone in the trace buffer of the calling thread.
+ *
+ * @param name Name of the zone, must outlive the trace (e.g. a string literal).
+ * @param start Monotonic time when the zone was entered.
+ * @param end Monotonic time when the zone was left.
+ */
+void record_zone(const char *name, time_nsec_t start, time_nsec_t end);
+
+/**
+ * Write all recorded zones of all threads in the Chrome Trace Event
+ * JSON format, which can be opened in chrome://tracing or Perfetto.
+ *
+ * @param out Stream the JSON document is written to.
+ */
+void write_trace(std::ostream &out);
+
+/**
+ * Write the recorded zones to a file, see write_trace().
+ *
+ * @param filename Path of the trace file.
+ */
+void dump_trace(const std::string &filename);
+
+
+/**
+ * Records the time between its construction and destruction as trace zone.
+ * Use it through OA_TRACE_SCOPE.
+ */
+class TraceZone {
+public:
+	explicit TraceZone(const char *name) :
+		name{name},
+		start{tracing_enabled() ? timing::get_monotonic_time() : 0} {}
+
+	~TraceZone() {
+		if (this->start != 0) {
+			record_zone(this->name, this->start, timing::get_monotonic_time());
+		}
+	}
+
+	TraceZone(const TraceZone &) = delete;
+	TraceZone &operator=(const TraceZone &) = delete;
+
+private:
+	/**
+	 * Name of the zone.
+	 */
+	const char *name;
+
+	/**
+	 * Time of construction, 0 if tracing was disabled.
+	 */
+	time_nsec_t start;
+};
+
+} // namespace openage::metrics
+
+
+#define OA_TRACE_ZONE_NAME_IMPL(line) oa_trace_zone_##line
+#define OA_TRACE_ZONE_NAME(line) OA_TRACE_ZONE_NAME_IMPL(line)
+
+/**
+ * Record the current scope as trace zone with the given name.
+ * The name must be a string literal.
+ */
+#define OA_TRACE_SCOPE(name) ::openage::metrics::TraceZone OA_TRACE_ZONE_NAME(__LINE__){name}
@@ -3,6 +3,9 @@
 #include "pathfinder.h"
 
 #include "coord/phys.h"
+#include "metrics/registry.h"
+#include "metrics/scoped_timer.h"
+#include "metrics/trace.h"
 #include "pathfinding/flow_field.h"
 #include "pathfinding/grid.h"
 #include "pathfinding/integrator.h"
@@ -12,15 +15,31 @@
 
 namespace openage::path {
 
+namespace {
+
+metrics::Histogram &path_time_metric = metrics::registry().histogram(
+	"pathfinder_request_time_ns",
+	"Time needed to compute a path");
+
+metrics::Histogram &portal_path_metric = metrics::registry().histogram(
+	"pathfinder_portal_path_length",
+	"Number of portals on the high-level path of a request");
+
+} // namespace
+
 Pathfinder::Pathfinder() :
 	grids{},
 	integrator{std::make_shared<Integrator>()} {
 }
 
 const Path Pathfinder::get_path(const PathRequest &request) {
+	OA_TRACE_SCOPE("Pathfinder::get_path");
+	metrics::ScopedTimer timer{path_time_metric};
+
 	// High-level pathfinding
 	// Find the portals to use to get from the start to the target
 	auto portal_path = this->portal_a_star(request);
+	portal_path_metric.record(portal_path.size());
 
 	// Low-level pathfinding
 	// Find the path within the sectors
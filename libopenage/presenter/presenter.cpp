@@ -2,11 +2,13 @@
 
 #include "presenter.h"
 
+#include <algorithm>
 #include <eigen3/Eigen/Dense>
 #include <iostream>
 #include <string>
 #include <vector>
 
+#include "cvar/cvar.h"
 #include "gamestate/simulation.h"
 #include "input/controller/camera/binding_context.h"
 #include "input/controller/camera/controller.h"
@@ -17,6 +19,9 @@
 #include "input/input_context.h"
 #include "input/input_manager.h"
 #include "log/log.h"
+#include "metrics/registry.h"
+#include "metrics/scoped_timer.h"
+#include "metrics/trace.h"
 #include "renderer/camera/camera.h"
 #include "renderer/gui/gui.h"
 #include "renderer/gui/integration/public/gui_application_with_logger.h"
@@ -24,6 +29,7 @@
 #include "renderer/render_pass.h"
 #include "renderer/render_target.h"
 #include "renderer/resources/assets/asset_manager.h"
+#include "renderer/resources/assets/texture_manager.h"
 #include "renderer/resources/shader_source.h"
 #include "renderer/resources/texture_info.h"
 #include "renderer/stages/camera/manager.h"
@@ -39,13 +45,45 @@
 
 namespace openage::presenter {
 
+namespace {
+
+metrics::Histogram &frame_time_metric = metrics::registry().histogram(
+	"renderer_frame_time_ns",
+	"Time needed to update and render all stages of a frame");
+
+metrics::Histogram &terrain_update_metric = metrics::registry().histogram(
+	"renderer_terrain_update_time_ns",
+	"Time needed to update the terrain render stage");
+
+metrics::Histogram &world_update_metric = metrics::registry().histogram(
+	"renderer_world_update_time_ns",
+	"Time needed to update the world render stage");
+
+metrics::Histogram &hud_update_metric = metrics::registry().histogram(
+	"renderer_hud_update_time_ns",
+	"Time needed to update the HUD render stage");
+
+metrics::Histogram &gui_render_metric = metrics::registry().histogram(
+	"renderer_gui_render_time_ns",
+	"Time needed to render the GUI");
+
+metrics::Histogram &passes_render_metric = metrics::registry().histogram(
+	"renderer_passes_render_time_ns",
+	"Time needed to draw all render passes");
+
+} // namespace
+
 Presenter::Presenter(const util::Path &root_dir,
                      const std::shared_ptr<gamestate::GameSimulation> &simulation,
                      const std::shared_ptr<time::TimeLoop> &time_loop) :
 	root_dir{root_dir},
 	render_passes{},
 	simulation{simulation},
-	time_loop{time_loop} {}
+	time_loop{time_loop} {
+	if (this->simulation) {
+		this->init_settings();
+	}
+}
 
 
 void Presenter::run(bool debug_graphics) {
@@ -59,6 +97,9 @@ void Presenter::run(bool debug_graphics) {
 		this->gui_app->process_events();
 		// TODO: pass button presses and events from GUI to controller
 
+		// execute the actions of mouse motion coalesced during this frame
+		this->input_manager->process_pending();
+
 		this->render();
 
 		this->renderer->check_error();
@@ -81,6 +122,7 @@ void Presenter::run(bool debug_graphics) {
 
 void Presenter::set_simulation(const std::shared_ptr<gamestate::GameSimulation> &simulation) {
 	this->simulation = simulation;
+	this->init_settings();
 	auto render_factory = std::make_shared<renderer::RenderFactory>(this->terrain_renderer, this->world_renderer);
 	this->simulation->attach_renderer(render_factory);
 }
@@ -114,6 +156,10 @@ void Presenter::init_graphics(bool debug) {
 	auto missing_tex = this->root_dir / "assets" / "test" / "textures" / "test_missing.sprite";
 	this->asset_manager->set_placeholder_animation(missing_tex);
 
+	// shown while textures are loaded in the background
+	auto missing_img = this->root_dir / "assets" / "test" / "textures" / "missing.png";
+	this->asset_manager->get_texture_manager()->set_placeholder(missing_img);
+
 	// Camera
 	this->camera = std::make_shared<renderer::camera::Camera>(this->renderer, this->window->get_size());
 	this->window->add_resize_callback([this](size_t w, size_t h, double /*scale*/) {
@@ -301,14 +347,54 @@ void Presenter::init_final_render_pass() {
 	});
 }
 
+void Presenter::init_settings() {
+	// limits the GPU memory used by textures, can be changed at runtime
+	this->texture_budget = this->simulation->get_cvar_manager()->create<int>("texture_budget_mb", 0);
+
+	// limits the render distance, can be changed at runtime
+	this->camera_max_zoom_out = this->simulation->get_cvar_manager()->create<float>(
+		"camera_max_zoom_out",
+		renderer::camera::DEFAULT_MAX_ZOOM_OUT);
+}
+
 void Presenter::render() {
+	OA_TRACE_SCOPE("Presenter::render");
+	metrics::ScopedTimer frame_timer{frame_time_metric};
+
+	if (this->camera_max_zoom_out) {
+		this->camera->set_max_zoom_out(this->camera_max_zoom_out.get());
+	}
+
 	// TODO: Pass current time to update() instead of fetching it in renderer
 	this->camera_manager->update();
-	this->terrain_renderer->update();
-	this->world_renderer->update();
-	this->hud_renderer->update();
-	this->gui->render();
+	auto &texture_manager = this->asset_manager->get_texture_manager();
+	if (this->texture_budget) {
+		size_t budget_mb = std::max(this->texture_budget.get(), 0);
+		texture_manager->set_budget(budget_mb * 1024 * 1024);
+	}
+	texture_manager->update();
+	{
+		OA_TRACE_SCOPE("TerrainRenderer::update");
+		metrics::ScopedTimer timer{terrain_update_metric};
+		this->terrain_renderer->update();
+	}
+	{
+		OA_TRACE_SCOPE("WorldRenderer::update");
+		metrics::ScopedTimer timer{world_update_metric};
+		this->world_renderer->update();
+	}
+	{
+		OA_TRACE_SCOPE("HudRenderer::update");
+		metrics::ScopedTimer timer{hud_update_metric};
+		this->hud_renderer->update();
+	}
+	{
+		OA_TRACE_SCOPE("GUI::render");
+		metrics::ScopedTimer timer{gui_render_metric};
+		this->gui->render();
+	}
 
+	metrics::ScopedTimer timer{passes_render_metric};
 	for (auto &pass : this->render_passes) {
 		this->renderer->render(pass);
 	}
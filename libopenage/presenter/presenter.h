@@ -5,6 +5,7 @@
 #include <memory>
 #include <vector>
 
+#include "cvar/typed_cvar.h"
 #include "util/path.h"
 
 namespace qtgui {
@@ -138,6 +139,12 @@ protected:
 	 */
 	void init_final_render_pass();
 
+	/**
+	 * Create the configuration entries of the presenter in the
+	 * configuration manager of the simulation.
+	 */
+	void init_settings();
+
 	// void init_audio();
 
 	/**
@@ -209,6 +216,18 @@ protected:
 	 */
 	std::shared_ptr<renderer::resources::AssetManager> asset_manager;
 
+	/**
+	 * Memory budget for the loaded textures (in MiB). 0 means unlimited.
+	 * Unbound if there is no simulation.
+	 */
+	cvar::CVar<int> texture_budget;
+
+	/**
+	 * How far the camera can zoom out, i.e. how much of the world is rendered at once.
+	 * Unbound if there is no simulation.
+	 */
+	cvar::CVar<float> camera_max_zoom_out;
+
 	/**
 	 * Render passes in the openage renderer.
 	 */
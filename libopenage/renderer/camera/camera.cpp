@@ -135,6 +135,21 @@ void Camera::zoom_out(float zoom_delta) {
 	this->set_zoom(zoom);
 }
 
+void Camera::set_max_zoom_out(float max_zoom_out) {
+	if (max_zoom_out < Camera::MAX_ZOOM_IN) {
+		max_zoom_out = Camera::MAX_ZOOM_IN;
+	}
+
+	if (max_zoom_out == this->max_zoom_out) {
+		return;
+	}
+
+	this->max_zoom_out = max_zoom_out;
+	if (this->zoom > this->max_zoom_out) {
+		this->set_zoom(this->max_zoom_out);
+	}
+}
+
 void Camera::resize(size_t width, size_t height) {
 	this->viewport_size = util::Vector2s(width, height);
 	this->viewport_changed = true;
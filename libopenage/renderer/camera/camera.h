@@ -128,6 +128,14 @@ public:
 	 */
 	void zoom_out(float zoom_delta);
 
+	/**
+	 * Set how far the camera can zoom out. If the current zoom level
+	 * is further out, the camera zooms in to the new limit.
+	 *
+	 * @param max_zoom_out New maximum zoom out level.
+	 */
+	void set_max_zoom_out(float max_zoom_out);
+
 	/**
 	 * Resize the camera viewport.
 	 *
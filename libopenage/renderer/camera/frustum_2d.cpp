@@ -2,9 +2,40 @@
 
 #include "frustum_2d.h"
 
+#include <algorithm>
+
 
 namespace openage::renderer::camera {
 
+void CullingBatch::clear() {
+	this->x.clear();
+	this->y.clear();
+	this->z.clear();
+	this->scalefactor.clear();
+	this->left.clear();
+	this->right.clear();
+	this->top.clear();
+	this->bottom.clear();
+}
+
+void CullingBatch::add(const Eigen::Vector3f &scene_pos,
+                       const float scalefactor,
+                       const util::Vector4i &boundaries) {
+	this->x.push_back(scene_pos[0]);
+	this->y.push_back(scene_pos[1]);
+	this->z.push_back(scene_pos[2]);
+	this->scalefactor.push_back(scalefactor);
+	this->left.push_back(boundaries[0]);
+	this->right.push_back(boundaries[1]);
+	this->top.push_back(boundaries[2]);
+	this->bottom.push_back(boundaries[3]);
+}
+
+size_t CullingBatch::size() const {
+	return this->x.size();
+}
+
+
 Frustum2d::Frustum2d(const util::Vector2s &viewport_size,
                      const Eigen::Matrix4f &view_matrix,
                      const Eigen::Matrix4f &projection_matrix,
@@ -57,4 +88,51 @@ bool Frustum2d::in_frustum(const Eigen::Vector3f &scene_pos,
 	return true;
 }
 
+void Frustum2d::in_frustum(const CullingBatch &batch,
+                           const Eigen::Matrix4f &model_matrix,
+                           std::vector<uint64_t> &visible) const {
+	// only the x and y rows of the combined matrix are needed
+	Eigen::Matrix4f matrix = this->transform_matrix * model_matrix;
+	const float m00 = matrix(0, 0), m01 = matrix(0, 1), m02 = matrix(0, 2), m03 = matrix(0, 3);
+	const float m10 = matrix(1, 0), m11 = matrix(1, 1), m12 = matrix(1, 2), m13 = matrix(1, 3);
+	const float inv_zoom = this->inv_zoom_factor;
+	const float pixel_x = this->pixel_size_ndc[0];
+	const float pixel_y = this->pixel_size_ndc[1];
+
+	const size_t count = batch.size();
+	visible.assign((count + 63) / 64, 0);
+
+	// objects are checked in blocks of 64, one word of the bitmask
+	for (size_t base = 0; base < count; base += 64) {
+		const size_t block = std::min<size_t>(64, count - base);
+		const float *x = batch.x.data() + base;
+		const float *y = batch.y.data() + base;
+		const float *z = batch.z.data() + base;
+		const float *scalefactor = batch.scalefactor.data() + base;
+		const float *left = batch.left.data() + base;
+		const float *right = batch.right.data() + base;
+		const float *top = batch.top.data() + base;
+		const float *bottom = batch.bottom.data() + base;
+
+		// branchless, so that the loop is vectorized
+		uint32_t inside[64];
+		for (size_t i = 0; i < block; ++i) {
+			float x_ndc = m00 * x[i] + m01 * y[i] + m02 * z[i] + m03;
+			float y_ndc = m10 * x[i] + m11 * y[i] + m12 * z[i] + m13;
+			float zoom_scale = scalefactor[i] * inv_zoom;
+
+			inside[i] = (x_ndc - left[i] * zoom_scale * pixel_x < 1.0f)
+			            & (x_ndc + right[i] * zoom_scale * pixel_x > -1.0f)
+			            & (y_ndc + top[i] * zoom_scale * pixel_y > -1.0f)
+			            & (y_ndc - bottom[i] * zoom_scale * pixel_y < 1.0f);
+		}
+
+		uint64_t word = 0;
+		for (size_t i = 0; i < block; ++i) {
+			word |= static_cast<uint64_t>(inside[i]) << i;
+		}
+		visible[base / 64] = word;
+	}
+}
+
 } // namespace openage::renderer::camera
@@ -2,12 +2,78 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 #include <eigen3/Eigen/Dense>
 
 #include "util/vector.h"
 
 namespace openage::renderer::camera {
 
+/**
+ * Scene objects that are checked against a 2D frustum in one batch.
+ *
+ * Every attribute is stored in its own array, so that the checks
+ * for consecutive objects can be vectorized by the compiler.
+ */
+struct CullingBatch {
+	/// scene position x
+	std::vector<float> x;
+	/// scene position y
+	std::vector<float> y;
+	/// scene position z
+	std::vector<float> z;
+	/// scale factor of the animation
+	std::vector<float> scalefactor;
+	/// left boundary of the animation (in pixels)
+	std::vector<float> left;
+	/// right boundary of the animation (in pixels)
+	std::vector<float> right;
+	/// top boundary of the animation (in pixels)
+	std::vector<float> top;
+	/// bottom boundary of the animation (in pixels)
+	std::vector<float> bottom;
+
+	/**
+	 * Remove all objects. Keeps the allocated memory.
+	 */
+	void clear();
+
+	/**
+	 * Add an object.
+	 *
+	 * @param scene_pos 3D scene coordinates.
+	 * @param scalefactor Scale factor of the animation.
+	 * @param boundaries Boundaries of the animation (in pixels): left, right, top, bottom.
+	 */
+	void add(const Eigen::Vector3f &scene_pos,
+	         const float scalefactor,
+	         const util::Vector4i &boundaries);
+
+	/**
+	 * Get the number of objects.
+	 *
+	 * @return Number of objects.
+	 */
+	size_t size() const;
+};
+
+
+/**
+ * Check whether an object is set in a visibility bitmask.
+ *
+ * @param visible Bitmask with one bit per object, 64 objects per word.
+ * @param index Index of the object.
+ *
+ * @return true if the bit of the object is set, else false.
+ */
+inline bool is_visible(const std::vector<uint64_t> &visible, size_t index) {
+	return (visible[index / 64] >> (index % 64)) & 1;
+}
+
+
 /**
  * Frustum for culling objects outside of a camera view in 2D screen space.
  * This frustum object should be used for sprite culling as sprites do not exist in 3D world space.
@@ -59,6 +125,21 @@ public:
 	                const float scalefactor,
 	                const util::Vector4i &boundaries) const;
 
+	/**
+	 * Check which objects of a batch are inside the frustum.
+	 *
+	 * Gives the same results as calling \p in_frustum() for every object,
+	 * but combines the matrices only once per batch.
+	 *
+	 * @param batch Scene objects.
+	 * @param model_matrix Model matrix shared by the objects.
+	 * @param visible Set to a bitmask with one bit per object, 64 objects per word.
+	 *                A set bit means the object is inside the frustum.
+	 */
+	void in_frustum(const CullingBatch &batch,
+	                const Eigen::Matrix4f &model_matrix,
+	                std::vector<uint64_t> &visible) const;
+
 private:
 	/**
 	 * Camera transformation matrix.
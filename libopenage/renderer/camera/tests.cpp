@@ -0,0 +1,158 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <eigen3/Eigen/Dense>
+
+#include "error/error.h"
+#include "log/log.h"
+#include "renderer/camera/frustum_2d.h"
+#include "testing/testing.h"
+#include "util/vector.h"
+
+
+namespace openage::renderer::camera::tests {
+
+namespace {
+
+/**
+ * Frustum of a camera that looks at the scene from above,
+ * with the view rotated like the game camera.
+ */
+Frustum2d make_frustum() {
+	Eigen::Matrix4f view = Eigen::Matrix4f::Identity();
+	view.block<3, 3>(0, 0) = (Eigen::AngleAxisf(0.5f, Eigen::Vector3f::UnitX())
+	                          * Eigen::AngleAxisf(0.8f, Eigen::Vector3f::UnitY()))
+	                             .toRotationMatrix();
+	view(0, 3) = -3.0f;
+	view(1, 3) = 2.0f;
+
+	// orthographic projection of a 40x30 area
+	Eigen::Matrix4f projection = Eigen::Matrix4f::Identity();
+	projection(0, 0) = 2.0f / 40.0f;
+	projection(1, 1) = 2.0f / 30.0f;
+	projection(2, 2) = -0.01f;
+
+	return Frustum2d{util::Vector2s{1920, 1080}, view, projection, 1.5f};
+}
+
+/**
+ * Create objects that are spread around the camera view.
+ */
+CullingBatch make_batch(size_t count, unsigned int seed) {
+	std::mt19937 rng{seed};
+	std::uniform_real_distribution<float> pos{-60.0f, 60.0f};
+	std::uniform_real_distribution<float> scale{0.5f, 2.0f};
+	std::uniform_int_distribution<int> bound{0, 200};
+
+	CullingBatch batch;
+	for (size_t i = 0; i < count; ++i) {
+		batch.add(Eigen::Vector3f{pos(rng), pos(rng), pos(rng) / 10},
+		          scale(rng),
+		          util::Vector4i{bound(rng), bound(rng), bound(rng), bound(rng)});
+	}
+	return batch;
+}
+
+bool scalar_in_frustum(const Frustum2d &frustum,
+                       const CullingBatch &batch,
+                       const Eigen::Matrix4f &model_matrix,
+                       size_t i) {
+	return frustum.in_frustum(Eigen::Vector3f{batch.x[i], batch.y[i], batch.z[i]},
+	                          model_matrix,
+	                          batch.scalefactor[i],
+	                          util::Vector4i{static_cast<int>(batch.left[i]),
+	                                         static_cast<int>(batch.right[i]),
+	                                         static_cast<int>(batch.top[i]),
+	                                         static_cast<int>(batch.bottom[i])});
+}
+
+} // namespace
+
+
+void frustum() {
+	auto frustum = make_frustum();
+	Eigen::Matrix4f model_matrix = Eigen::Matrix4f::Identity();
+
+	// batches that do not fill the last word of the bitmask
+	for (size_t count : {0, 1, 63, 64, 65, 1000}) {
+		auto batch = make_batch(count, 42);
+		std::vector<uint64_t> visible;
+		frustum.in_frustum(batch, model_matrix, visible);
+		TESTEQUALS(visible.size(), (count + 63) / 64);
+
+		size_t visible_count = 0;
+		for (size_t i = 0; i < count; ++i) {
+			TESTEQUALS(is_visible(visible, i), scalar_in_frustum(frustum, batch, model_matrix, i));
+			visible_count += is_visible(visible, i);
+		}
+		if (count == 1000) {
+			// the batch covers objects inside and outside of the view
+			TESTEQUALS(visible_count > 0 and visible_count < count, true);
+		}
+
+		// bits after the last object are not set
+		if (count % 64 != 0) {
+			TESTEQUALS(visible.back() >> (count % 64), 0u);
+		}
+	}
+
+	// batches can be reused
+	auto batch = make_batch(100, 7);
+	batch.clear();
+	TESTEQUALS(batch.size(), 0u);
+	batch.add(Eigen::Vector3f{0, 0, 0}, 1.0f, util::Vector4i{10, 10, 10, 10});
+	std::vector<uint64_t> visible;
+	frustum.in_frustum(batch, model_matrix, visible);
+	TESTEQUALS(visible.size(), 1u);
+	TESTEQUALS(is_visible(visible, 0), scalar_in_frustum(frustum, batch, model_matrix, 0));
+}
+
+
+void frustum_benchmark() {
+	constexpr int rounds = 100;
+
+	auto frustum = make_frustum();
+	Eigen::Matrix4f model_matrix = Eigen::Matrix4f::Identity();
+
+	for (size_t count : {10000, 50000}) {
+		auto batch = make_batch(count, 1);
+
+		size_t scalar_visible = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int r = 0; r < rounds; ++r) {
+			for (size_t i = 0; i < count; ++i) {
+				scalar_visible += scalar_in_frustum(frustum, batch, model_matrix, i);
+			}
+		}
+		std::chrono::duration<double, std::micro> scalar = std::chrono::steady_clock::now() - start;
+
+		size_t batch_visible = 0;
+		std::vector<uint64_t> visible;
+		start = std::chrono::steady_clock::now();
+		for (int r = 0; r < rounds; ++r) {
+			frustum.in_frustum(batch, model_matrix, visible);
+			for (auto word : visible) {
+				batch_visible += std::popcount(word);
+			}
+		}
+		std::chrono::duration<double, std::micro> batched = std::chrono::steady_clock::now() - start;
+
+		if (scalar_visible != batch_visible) {
+			throw Error{ERR << "frustum benchmark: batch culling found " << batch_visible
+			                << " instead of " << scalar_visible << " visible objects"};
+		}
+
+		log::log(INFO << "frustum benchmark: " << count << " objects, "
+		              << scalar_visible / rounds << " visible, "
+		              << scalar.count() / rounds << " us with single checks, "
+		              << batched.count() / rounds << " us batched");
+	}
+}
+
+} // namespace openage::renderer::camera::tests
@@ -1,4 +1,4 @@
-// Copyright 2015-2023 the openage authors. See copying.md for legal info.
+// Copyright 2015-2024 the openage authors. See copying.md for legal info.
 
 #include "buffer.h"
 
@@ -13,7 +13,8 @@ GlBuffer::GlBuffer(const std::shared_ptr<GlContext> &context,
                    size_t size,
                    GLenum usage) :
 	GlSimpleObject(context, [](GLuint handle) { glDeleteBuffers(1, &handle); }),
-	size(size) {
+	size(size),
+	usage(usage) {
 	GLuint handle;
 	glGenBuffers(1, &handle);
 	this->handle = handle;
@@ -27,7 +28,8 @@ GlBuffer::GlBuffer(const std::shared_ptr<GlContext> &context,
                    size_t size,
                    GLenum usage) :
 	GlSimpleObject(context, [](GLuint handle) { glDeleteBuffers(1, &handle); }),
-	size(size) {
+	size(size),
+	usage(usage) {
 	GLuint handle;
 	glGenBuffers(1, &handle);
 	this->handle = handle;
@@ -46,6 +48,12 @@ void GlBuffer::upload_data(const uint8_t *data, size_t offset, size_t size) {
 	}
 
 	this->bind(GL_COPY_WRITE_BUFFER);
+	if (offset == 0 and size == this->size) {
+		// let the driver allocate new storage instead of synchronizing
+		glBufferData(GL_COPY_WRITE_BUFFER, size, data, this->usage);
+		return;
+	}
+
 	glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data);
 }
 
@@ -1,4 +1,4 @@
-// Copyright 2015-2023 the openage authors. See copying.md for legal info.
+// Copyright 2015-2024 the openage authors. See copying.md for legal info.
 
 #pragma once
 
@@ -31,6 +31,8 @@ public:
 
 	/// Uploads `size` bytes of new data starting at `offset`.
 	/// `offset + size` has to be less than or equal to `get_size()`.
+	/// When the whole buffer is replaced, its storage is orphaned first,
+	/// so the upload does not wait for draws still using the old data.
 	/// Binds the GL_COPY_WRITE_BUFFER target.
 	void upload_data(const uint8_t *data, size_t offset, size_t size);
 
@@ -40,6 +42,9 @@ public:
 private:
 	/// The size in bytes of this buffer.
 	size_t size;
+
+	/// The usage hint the buffer storage was created with.
+	GLenum usage;
 };
 
 } // namespace opengl
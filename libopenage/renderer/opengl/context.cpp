@@ -78,11 +78,23 @@ gl_context_spec GlContext::find_spec() {
 	caps.max_uniform_locations = temp;
 	glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &temp);
 	caps.max_uniform_buffer_bindings = temp;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &temp);
+	caps.uniform_buffer_offset_alignment = temp;
 
 	// OpenGL version
 	glGetIntegerv(GL_MAJOR_VERSION, &caps.major_version);
 	glGetIntegerv(GL_MINOR_VERSION, &caps.minor_version);
 
+	// Optional features
+	caps.persistent_buffers = epoxy_gl_version() >= 44
+	                          or epoxy_has_gl_extension("GL_ARB_buffer_storage");
+	if (epoxy_gl_version() >= 41 or epoxy_has_gl_extension("GL_ARB_get_program_binary")) {
+		// drivers may support the API without offering any binary formats
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &temp);
+		caps.program_binary = temp > 0;
+	}
+	caps.parallel_shader_compile = epoxy_has_gl_extension("GL_KHR_parallel_shader_compile");
+
 	return caps;
 }
 
@@ -123,6 +135,11 @@ GlContext::GlContext(const std::shared_ptr<QWindow> &window,
 
 	log::log(MSG(info) << "Created OpenGL context version " << specs.major_version << "." << specs.minor_version);
 
+	if (specs.parallel_shader_compile) {
+		// let the driver decide how many threads it uses for compiling shaders
+		glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+	}
+
 	// To quote the standard doc: 'The value gives a rough estimate of the
 	// largest texture that the GL can handle'
 	// -> wat?  anyways, we need at least 1024x1024.
@@ -29,6 +29,14 @@ struct gl_context_spec {
 	/// The maximum number of binding points for uniform blocks
 	/// in a single shader.
 	size_t max_uniform_buffer_bindings;
+	/// Required alignment of offsets when binding ranges of uniform buffers.
+	size_t uniform_buffer_offset_alignment;
+	/// Whether buffers can be mapped persistently (OpenGL 4.4 or ARB_buffer_storage).
+	bool persistent_buffers;
+	/// Whether linked programs can be stored as binaries (OpenGL 4.1 or ARB_get_program_binary).
+	bool program_binary;
+	/// Whether the driver can compile shaders in background threads (KHR_parallel_shader_compile).
+	bool parallel_shader_compile;
 
 	int major_version;
 	int minor_version;
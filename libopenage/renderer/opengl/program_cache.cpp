@@ -0,0 +1,175 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "program_cache.h"
+
+#include <array>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <system_error>
+
+#include "log/log.h"
+#include "util/hash.h"
+
+
+namespace openage::renderer::opengl {
+
+namespace {
+
+/**
+ * Identifies openage program cache files.
+ */
+constexpr uint32_t cache_magic = 0x4250414f; // "OAPB"
+
+/**
+ * Version of the cache file layout. Increase when the layout changes.
+ */
+constexpr uint32_t cache_version = 1;
+
+/**
+ * Header of a cache file. The program binary follows after it.
+ */
+struct cache_header {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t key;
+	GLenum format;
+};
+
+std::string gl_string(GLenum name) {
+	auto str = reinterpret_cast<const char *>(glGetString(name));
+	return str == nullptr ? "" : str;
+}
+
+} // namespace
+
+
+GlProgramCache::GlProgramCache(const std::filesystem::path &dir) :
+	dir{dir},
+	driver{gl_string(GL_VENDOR) + "\n" + gl_string(GL_RENDERER) + "\n" + gl_string(GL_VERSION)} {
+	log::log(MSG(dbg) << "Created OpenGL program cache in " << this->dir.string());
+}
+
+std::filesystem::path GlProgramCache::get_default_dir() {
+	// same locations as openage/default_dirs.py
+#ifdef _WIN32
+	const char *cache_home = std::getenv("LOCALAPPDATA");
+	if (cache_home != nullptr and cache_home[0] != '\0') {
+		return std::filesystem::path{cache_home} / "openage" / "shaders";
+	}
+#else
+	const char *cache_home = std::getenv("XDG_CACHE_HOME");
+	if (cache_home != nullptr and cache_home[0] != '\0') {
+		return std::filesystem::path{cache_home} / "openage" / "shaders";
+	}
+
+	const char *home = std::getenv("HOME");
+	if (home != nullptr and home[0] != '\0') {
+		return std::filesystem::path{home} / ".cache" / "openage" / "shaders";
+	}
+#endif
+
+	return {};
+}
+
+uint64_t GlProgramCache::get_key(const std::vector<resources::ShaderSource> &srcs) const {
+	std::string data = this->driver;
+	for (auto const &src : srcs) {
+		data += "\n";
+		data += std::to_string(static_cast<int>(src.get_lang()));
+		data += ":";
+		data += std::to_string(static_cast<int>(src.get_stage()));
+		data += ":";
+		data += std::to_string(src.get_source().size());
+		data += "\n";
+		data += src.get_source();
+	}
+
+	util::Siphash hasher{std::array<uint8_t, 16>{}};
+	return hasher.digest(reinterpret_cast<const uint8_t *>(data.data()), data.size());
+}
+
+bool GlProgramCache::load(GLuint program, uint64_t key) const {
+	std::ifstream file{this->get_path(key), std::ios::binary};
+	if (not file) {
+		return false;
+	}
+
+	cache_header header{};
+	file.read(reinterpret_cast<char *>(&header), sizeof(header));
+	if (not file
+	    or header.magic != cache_magic
+	    or header.version != cache_version
+	    or header.key != key) {
+		return false;
+	}
+
+	std::vector<char> binary{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+	if (binary.empty()) {
+		return false;
+	}
+
+	glProgramBinary(program, header.format, binary.data(), binary.size());
+
+	// drivers reject binaries of other driver versions or hardware
+	GLint status = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	if (status != GL_TRUE) {
+		log::log(MSG(dbg) << "Cached OpenGL program binary " << this->get_path(key).string()
+		                  << " was rejected by the driver");
+		return false;
+	}
+
+	return true;
+}
+
+void GlProgramCache::store(GLuint program, uint64_t key) const {
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) {
+		return;
+	}
+
+	cache_header header{cache_magic, cache_version, key, 0};
+	std::vector<char> binary(length);
+	GLsizei written = 0;
+	glGetProgramBinary(program, length, &written, &header.format, binary.data());
+	if (written <= 0) {
+		return;
+	}
+
+	auto path = this->get_path(key);
+	auto tmp_path = path;
+	tmp_path += ".tmp";
+
+	// write to a temporary file first so that no other process
+	// reads a partially written binary
+	std::error_code ec;
+	std::filesystem::create_directories(this->dir, ec);
+	{
+		std::ofstream file{tmp_path, std::ios::binary | std::ios::trunc};
+		file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		file.write(binary.data(), written);
+		if (not file) {
+			log::log(MSG(warn) << "Failed to write OpenGL program binary to " << tmp_path.string());
+			return;
+		}
+	}
+
+	std::filesystem::rename(tmp_path, path, ec);
+	if (ec) {
+		log::log(MSG(warn) << "Failed to store OpenGL program binary at " << path.string()
+		                   << ": " << ec.message());
+		std::filesystem::remove(tmp_path, ec);
+	}
+}
+
+std::filesystem::path GlProgramCache::get_path(uint64_t key) const {
+	std::ostringstream name;
+	name << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+	return this->dir / name.str();
+}
+
+} // namespace openage::renderer::opengl
@@ -0,0 +1,100 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <epoxy/gl.h>
+
+#include "renderer/resources/shader_source.h"
+
+
+namespace openage::renderer::opengl {
+
+/**
+ * Cache for linked shader program binaries.
+ *
+ * Programs are stored on disk with \p glGetProgramBinary and loaded with
+ * \p glProgramBinary on the next start, which skips compiling and linking
+ * the shader sources. The key of a program is a hash of its sources and
+ * of the driver vendor, renderer and version, so a driver update
+ * invalidates the cache.
+ *
+ * Loading fails if the binary is missing or rejected by the driver.
+ * Callers should then compile the program as usual and store it.
+ */
+class GlProgramCache {
+public:
+	/**
+	 * Create a new program cache for the driver of the current OpenGL context.
+	 * The context must support program binaries.
+	 *
+	 * @param dir Directory that the binaries are stored in. Created on the first store.
+	 */
+	GlProgramCache(const std::filesystem::path &dir);
+
+	~GlProgramCache() = default;
+
+	/**
+	 * Get the default cache directory of the user, e.g. \p ~/.cache/openage/shaders.
+	 *
+	 * @return Cache directory or an empty path if the platform has none.
+	 */
+	static std::filesystem::path get_default_dir();
+
+	/**
+	 * Get the key of a program.
+	 *
+	 * @param srcs Shader sources of the program.
+	 *
+	 * @return Key of the program.
+	 */
+	uint64_t get_key(const std::vector<resources::ShaderSource> &srcs) const;
+
+	/**
+	 * Load a program binary into a program object.
+	 *
+	 * @param program Handle of the program object.
+	 * @param key Key of the program.
+	 *
+	 * @return true if the program was loaded and linked, else false.
+	 */
+	bool load(GLuint program, uint64_t key) const;
+
+	/**
+	 * Store the binary of a linked program.
+	 *
+	 * Failing to store the binary is not an error, the program
+	 * is just compiled again on the next start.
+	 *
+	 * @param program Handle of the linked program object. It should have been linked
+	 *                with \p GL_PROGRAM_BINARY_RETRIEVABLE_HINT set.
+	 * @param key Key of the program.
+	 */
+	void store(GLuint program, uint64_t key) const;
+
+private:
+	/**
+	 * Get the path of the file for a program.
+	 *
+	 * @param key Key of the program.
+	 *
+	 * @return Path of the cache file.
+	 */
+	std::filesystem::path get_path(uint64_t key) const;
+
+	/**
+	 * Directory that the binaries are stored in.
+	 */
+	std::filesystem::path dir;
+
+	/**
+	 * Identifies the driver that created the binaries.
+	 */
+	std::string driver;
+};
+
+} // namespace openage::renderer::opengl
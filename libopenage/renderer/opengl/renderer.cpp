@@ -6,9 +6,11 @@
 
 #include "error/error.h"
 #include "log/log.h"
+#include "metrics/trace.h"
 #include "renderer/opengl/context.h"
 #include "renderer/opengl/geometry.h"
 #include "renderer/opengl/lookup.h"
+#include "renderer/opengl/program_cache.h"
 #include "renderer/opengl/render_pass.h"
 #include "renderer/opengl/render_target.h"
 #include "renderer/opengl/shader_program.h"
@@ -26,7 +28,13 @@ GlRenderer::GlRenderer(const std::shared_ptr<GlContext> &ctx,
 	gl_context{ctx},
 	display{std::make_shared<GlRenderTarget>(ctx,
                                              viewport_size[0],
-                                             viewport_size[1])} {
+                                             viewport_size[1])},
+	program_cache{nullptr} {
+	auto cache_dir = GlProgramCache::get_default_dir();
+	if (ctx->get_specs().program_binary and not cache_dir.empty()) {
+		this->program_cache = std::make_shared<GlProgramCache>(cache_dir);
+	}
+
 	// color used to clear the color buffers
 	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 
@@ -55,7 +63,7 @@ std::shared_ptr<Texture2d> GlRenderer::add_texture(const resources::Texture2dInf
 }
 
 std::shared_ptr<ShaderProgram> GlRenderer::add_shader(std::vector<resources::ShaderSource> const &srcs) {
-	return std::make_shared<GlShaderProgram>(this->gl_context, srcs);
+	return std::make_shared<GlShaderProgram>(this->gl_context, srcs, this->program_cache);
 }
 
 std::shared_ptr<Geometry> GlRenderer::add_mesh_geometry(resources::MeshData const &mesh) {
@@ -166,6 +174,8 @@ void GlRenderer::check_error() {
 }
 
 void GlRenderer::render(const std::shared_ptr<RenderPass> &pass) {
+	OA_TRACE_SCOPE("GlRenderer::render");
+
 	auto gl_target = std::dynamic_pointer_cast<GlRenderTarget>(pass->get_target());
 	gl_target->bind_write();
 
@@ -15,6 +15,7 @@ class ShaderProgram;
 
 namespace opengl {
 class GlContext;
+class GlProgramCache;
 class GlRenderPass;
 class GlRenderTarget;
 class GlWindow;
@@ -67,6 +68,10 @@ private:
 
 	/// The main screen surface as a render target.
 	std::shared_ptr<GlRenderTarget> display;
+
+	/// Cache for shader program binaries.
+	/// nullptr if the context does not support program binaries.
+	std::shared_ptr<GlProgramCache> program_cache;
 };
 
 } // namespace opengl
@@ -14,6 +14,7 @@
 #include "renderer/opengl/error.h"
 #include "renderer/opengl/geometry.h"
 #include "renderer/opengl/lookup.h"
+#include "renderer/opengl/program_cache.h"
 #include "renderer/opengl/shader.h"
 #include "renderer/opengl/texture.h"
 #include "renderer/opengl/uniform_buffer.h"
@@ -62,7 +63,8 @@ static void check_program_status(GLuint program, GLenum what_to_check) {
 }
 
 GlShaderProgram::GlShaderProgram(const std::shared_ptr<GlContext> &context,
-                                 const std::vector<resources::ShaderSource> &srcs) :
+                                 const std::vector<resources::ShaderSource> &srcs,
+                                 const std::shared_ptr<GlProgramCache> &cache) :
 	GlSimpleObject(context,
                    [](GLuint handle) { glDeleteProgram(handle); }),
 	validated(false) {
@@ -71,19 +73,36 @@ GlShaderProgram::GlShaderProgram(const std::shared_ptr<GlContext> &context,
 	GLuint handle = glCreateProgram();
 	this->handle = handle;
 
-	std::vector<GlShader> shaders;
-	for (auto const &src : srcs) {
-		GlShader shader{context, src};
-		glAttachShader(handle, shader.get_handle());
-		shaders.push_back(std::move(shader));
+	uint64_t cache_key = 0;
+	bool cached = false;
+	if (cache != nullptr) {
+		cache_key = cache->get_key(srcs);
+		cached = cache->load(handle, cache_key);
 	}
 
-	glLinkProgram(handle);
-	check_program_status(handle, GL_LINK_STATUS);
+	if (not cached) {
+		if (cache != nullptr) {
+			glProgramParameteri(handle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
+
+		std::vector<GlShader> shaders;
+		for (auto const &src : srcs) {
+			GlShader shader{context, src};
+			glAttachShader(handle, shader.get_handle());
+			shaders.push_back(std::move(shader));
+		}
+
+		glLinkProgram(handle);
+		check_program_status(handle, GL_LINK_STATUS);
 
-	// after linking we can delete the shaders
-	for (auto const &shdr : shaders) {
-		glDetachShader(handle, shdr.get_handle());
+		// after linking we can delete the shaders
+		for (auto const &shdr : shaders) {
+			glDetachShader(handle, shdr.get_handle());
+		}
+
+		if (cache != nullptr) {
+			cache->store(handle, cache_key);
+		}
 	}
 
 	// query program information
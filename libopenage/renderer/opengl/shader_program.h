@@ -20,6 +20,7 @@ class UniformInput;
 namespace opengl {
 
 class GlContext;
+class GlProgramCache;
 class GlUniformBuffer;
 class GlUniformInput;
 
@@ -32,9 +33,13 @@ public:
 	/**
 	 * Tries to create a shader program from the given sources.
 	 * Throws an exception on compile/link errors.
+	 *
+	 * If a program cache is given, the program is loaded from its binary
+	 * in the cache if possible. Otherwise, it is compiled and stored in the cache.
 	 */
 	explicit GlShaderProgram(const std::shared_ptr<GlContext> &,
-	                         const std::vector<resources::ShaderSource> &);
+	                         const std::vector<resources::ShaderSource> &,
+	                         const std::shared_ptr<GlProgramCache> &cache = nullptr);
 
 	/**
 	 * Bind this program as the currently used one in the OpenGL context.
@@ -0,0 +1,159 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "stream_buffer.h"
+
+#include "error/error.h"
+#include "log/log.h"
+
+#include "renderer/opengl/context.h"
+
+
+namespace openage::renderer::opengl {
+
+namespace {
+
+/**
+ * Time to wait for a fence before checking again (in nanoseconds).
+ */
+constexpr GLuint64 fence_timeout = 1000000000;
+
+size_t align_up(size_t offset, size_t alignment) {
+	return (offset + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+
+GlStreamBuffer::GlStreamBuffer(const std::shared_ptr<GlContext> &context,
+                               GLenum target,
+                               size_t size) :
+	GlSimpleObject(context,
+                   [](GLuint handle) {
+					   // deleting the buffer also unmaps it
+					   glDeleteBuffers(1, &handle);
+				   }),
+	target{target},
+	segment_size{size / segment_count},
+	head{0},
+	segment{0},
+	range_offset{0},
+	fences{},
+	persistent{nullptr} {
+	if (this->segment_size == 0) {
+		throw Error{MSG(err) << "Stream buffer size must be at least " << segment_count << " bytes"};
+	}
+
+	GLuint handle;
+	glGenBuffers(1, &handle);
+	this->handle = handle;
+
+	this->bind();
+	auto total_size = this->segment_size * segment_count;
+	if (context->get_specs().persistent_buffers) {
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(this->target, total_size, nullptr, flags);
+		this->persistent = static_cast<uint8_t *>(glMapBufferRange(this->target, 0, total_size, flags));
+		if (this->persistent == nullptr) {
+			throw Error{MSG(err) << "Could not map stream buffer persistently"};
+		}
+	}
+	else {
+		glBufferData(this->target, total_size, nullptr, GL_STREAM_DRAW);
+	}
+
+	log::log(MSG(dbg) << "Created OpenGL stream buffer (size: " << total_size
+	                  << ", persistent: " << this->is_persistent() << ")");
+}
+
+GlStreamBuffer::~GlStreamBuffer() {
+	for (auto fence : this->fences) {
+		if (fence != nullptr) {
+			glDeleteSync(fence);
+		}
+	}
+}
+
+uint8_t *GlStreamBuffer::map(size_t size, size_t alignment) {
+	if (size + alignment - 1 > this->segment_size) [[unlikely]] {
+		throw Error{MSG(err) << "Stream buffer write of " << size
+		                     << " bytes does not fit into a segment of "
+		                     << this->segment_size << " bytes"};
+	}
+
+	auto begin = align_up(this->head, alignment);
+
+	if (this->persistent != nullptr) {
+		if (begin + size > (this->segment + 1) * this->segment_size) {
+			this->next_segment();
+			begin = align_up(this->segment * this->segment_size, alignment);
+		}
+
+		this->head = begin + size;
+		this->range_offset = begin;
+		return this->persistent + begin;
+	}
+
+	this->bind();
+	if (begin + size > segment_count * this->segment_size) {
+		// the driver allocates new storage, so the GPU can
+		// keep reading the old one without stalling
+		glBufferData(this->target, segment_count * this->segment_size, nullptr, GL_STREAM_DRAW);
+		begin = 0;
+	}
+
+	// the range was not written since the last orphaning, so no synchronization is needed
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+	auto ptr = static_cast<uint8_t *>(glMapBufferRange(this->target, begin, size, flags));
+	if (ptr == nullptr) [[unlikely]] {
+		throw Error{MSG(err) << "Could not map stream buffer range (offset: "
+		                     << begin << ", size: " << size << ")"};
+	}
+
+	this->head = begin + size;
+	this->range_offset = begin;
+	return ptr;
+}
+
+size_t GlStreamBuffer::unmap() {
+	if (this->persistent == nullptr) {
+		this->bind();
+		glUnmapBuffer(this->target);
+	}
+
+	return this->range_offset;
+}
+
+bool GlStreamBuffer::is_persistent() const {
+	return this->persistent != nullptr;
+}
+
+void GlStreamBuffer::bind() const {
+	glBindBuffer(this->target, *this->handle);
+}
+
+void GlStreamBuffer::next_segment() {
+	// the GPU is done with the current segment when it has
+	// finished all commands issued so far
+	this->fences[this->segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	this->segment = (this->segment + 1) % segment_count;
+
+	auto &fence = this->fences[this->segment];
+	if (fence == nullptr) {
+		return;
+	}
+
+	while (true) {
+		auto result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, fence_timeout);
+		if (result == GL_ALREADY_SIGNALED or result == GL_CONDITION_SATISFIED) {
+			break;
+		}
+		if (result == GL_WAIT_FAILED) [[unlikely]] {
+			throw Error{MSG(err) << "Waiting for stream buffer segment failed"};
+		}
+	}
+
+	glDeleteSync(fence);
+	fence = nullptr;
+}
+
+} // namespace openage::renderer::opengl
@@ -0,0 +1,127 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <epoxy/gl.h>
+
+#include "renderer/opengl/simple_object.h"
+
+
+namespace openage::renderer::opengl {
+class GlContext;
+
+/**
+ * Ring buffer for data that is written by the CPU every frame, e.g. uniform
+ * blocks that change per frame.
+ *
+ * Writes go to a fresh range of the buffer, so the GPU can still read
+ * ranges written earlier while new data is written. The buffer is split
+ * into segments. When a segment is full, it is fenced and writing
+ * continues in the next segment once the GPU has finished reading it.
+ *
+ * If the context supports persistent mapping, the buffer is mapped once
+ * and written directly. Otherwise, every range is mapped unsynchronized
+ * and the whole buffer storage is orphaned when the ring wraps around.
+ *
+ * All draw calls using a range must be issued before the next call
+ * to \p map().
+ */
+class GlStreamBuffer final : public GlSimpleObject {
+public:
+	/**
+	 * Number of segments the buffer is split into. One is written by the CPU
+	 * while the GPU may still read the others.
+	 */
+	static constexpr size_t segment_count = 3;
+
+	/**
+	 * Create a new stream buffer.
+	 *
+	 * @param context OpenGL context.
+	 * @param target Buffer target that the buffer is bound to for writing, e.g. GL_UNIFORM_BUFFER.
+	 * @param size Size of the buffer (in bytes). Single writes must fit into one segment.
+	 */
+	GlStreamBuffer(const std::shared_ptr<GlContext> &context,
+	               GLenum target,
+	               size_t size);
+
+	~GlStreamBuffer();
+
+	/**
+	 * Reserve a range of the buffer for writing.
+	 *
+	 * @param size Size of the range (in bytes).
+	 * @param alignment Alignment of the range offset (in bytes).
+	 *
+	 * @return Pointer to the start of the range. It stays valid until \p unmap() is called.
+	 */
+	uint8_t *map(size_t size, size_t alignment = 1);
+
+	/**
+	 * Finish writing the range reserved by the last call to \p map().
+	 *
+	 * @return Offset of the range in the buffer (in bytes).
+	 */
+	size_t unmap();
+
+	/**
+	 * Check whether the buffer is mapped persistently.
+	 *
+	 * @return true if the buffer is persistently mapped, else false.
+	 */
+	bool is_persistent() const;
+
+	/**
+	 * Bind the buffer to its target.
+	 */
+	void bind() const;
+
+private:
+	/**
+	 * Move on to the next segment, waiting until the GPU has finished using it.
+	 */
+	void next_segment();
+
+	/**
+	 * Buffer target used for writing.
+	 */
+	GLenum target;
+
+	/**
+	 * Size of one segment (in bytes).
+	 */
+	size_t segment_size;
+
+	/**
+	 * Offset of the next free byte in the buffer.
+	 */
+	size_t head;
+
+	/**
+	 * Segment that is currently written.
+	 */
+	size_t segment;
+
+	/**
+	 * Offset of the range reserved by the last call to \p map().
+	 */
+	size_t range_offset;
+
+	/**
+	 * Fences signaled when the GPU has finished reading a segment.
+	 */
+	std::array<GLsync, segment_count> fences;
+
+	/**
+	 * Pointer to the persistently mapped buffer storage.
+	 * \p nullptr if persistent mapping is not available.
+	 */
+	uint8_t *persistent;
+};
+
+} // namespace openage::renderer::opengl
@@ -2,6 +2,9 @@
 
 #include "uniform_buffer.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "error/error.h"
 #include "log/log.h"
 
@@ -14,32 +17,43 @@
 
 namespace openage::renderer::opengl {
 
+namespace {
+
+/**
+ * Number of block updates that fit into one segment of the stream buffer.
+ * Most uniform buffers are updated at most a few times per frame.
+ */
+constexpr size_t updates_per_segment = 16;
+
+size_t stream_size(const std::shared_ptr<GlContext> &context, size_t size) {
+	size_t alignment = std::max<size_t>(1, context->get_specs().uniform_buffer_offset_alignment);
+	size_t aligned_size = (size + alignment - 1) / alignment * alignment;
+
+	// one extra block per segment to leave room for aligning the first range
+	return (updates_per_segment + 1) * aligned_size * GlStreamBuffer::segment_count;
+}
+
+} // namespace
+
+
 GlUniformBuffer::GlUniformBuffer(const std::shared_ptr<GlContext> &context,
                                  size_t size,
                                  std::vector<GlInBlockUniform> uniforms,
-                                 GLuint binding_point,
-                                 GLenum usage) :
-	GlSimpleObject(context,
-                   [&](GLuint handle) {
-					   glDeleteBuffers(1, &handle);
-				   }),
+                                 GLuint binding_point) :
 	uniforms{uniforms},
 	data_size{size},
-	binding_point{binding_point} {
-	GLuint handle;
-	glGenBuffers(1, &handle);
-	this->handle = handle;
-
-	this->bind();
-	glBufferData(GL_UNIFORM_BUFFER, this->data_size, NULL, usage);
-
+	binding_point{binding_point},
+	alignment{std::max<size_t>(1, context->get_specs().uniform_buffer_offset_alignment)},
+	block_data(size, 0),
+	block_offset{0},
+	stream{context, GL_UNIFORM_BUFFER, stream_size(context, size)} {
 	uniform_id_t unif_id = 0;
 	for (auto &uniform : uniforms) {
 		this->uniforms_by_name.insert(std::make_pair(uniform.name, unif_id));
 		unif_id += 1;
 	}
 
-	glBindBufferRange(GL_UNIFORM_BUFFER, this->binding_point, *this->handle, 0, this->data_size);
+	this->upload();
 
 	log::log(MSG(dbg) << "Created OpenGL uniform buffer (size: "
 	                  << this->data_size << ", binding point: "
@@ -52,15 +66,17 @@ GLuint GlUniformBuffer::get_binding_point() const {
 
 void GlUniformBuffer::set_binding_point(GLuint binding_point) {
 	this->binding_point = binding_point;
-	glBindBufferBase(GL_UNIFORM_BUFFER, this->binding_point, *this->handle);
+	glBindBufferRange(GL_UNIFORM_BUFFER,
+	                  this->binding_point,
+	                  this->stream.get_handle(),
+	                  this->block_offset,
+	                  this->data_size);
 }
 
 void GlUniformBuffer::update_uniforms(std::shared_ptr<UniformBufferInput> const &unif_in) {
 	auto glunif_in = std::dynamic_pointer_cast<GlUniformBufferInput>(unif_in);
 	ENSURE(glunif_in->get_buffer().get() == this, "Uniform input passed to different buffer than it was created with.");
 
-	this->bind();
-
 	const auto &update_offs = glunif_in->update_offs;
 	const auto &used_uniforms = glunif_in->used_uniforms;
 	const auto &uniforms = this->uniforms;
@@ -76,8 +92,11 @@ void GlUniformBuffer::update_uniforms(std::shared_ptr<UniformBufferInput> const
 		auto loc = unif.offset;
 		auto size = unif.size;
 
-		glBufferSubData(GL_UNIFORM_BUFFER, loc, size, ptr);
+		memcpy(this->block_data.data() + loc, ptr, size);
 	}
+
+	// upload the whole block at once instead of every uniform on its own
+	this->upload();
 }
 
 const std::vector<GlInBlockUniform> &GlUniformBuffer::get_uniforms() const {
@@ -89,7 +108,27 @@ bool GlUniformBuffer::has_uniform(const char *name) {
 }
 
 void GlUniformBuffer::bind() const {
-	glBindBuffer(GL_UNIFORM_BUFFER, *this->handle);
+	this->stream.bind();
+}
+
+GLuint GlUniformBuffer::get_handle() const {
+	return this->stream.get_handle();
+}
+
+void GlUniformBuffer::upload() {
+	if (this->data_size == 0) {
+		return;
+	}
+
+	uint8_t *ptr = this->stream.map(this->data_size, this->alignment);
+	memcpy(ptr, this->block_data.data(), this->data_size);
+	this->block_offset = this->stream.unmap();
+
+	glBindBufferRange(GL_UNIFORM_BUFFER,
+	                  this->binding_point,
+	                  this->stream.get_handle(),
+	                  this->block_offset,
+	                  this->data_size);
 }
 
 std::shared_ptr<UniformBufferInput> GlUniformBuffer::new_unif_in() {
@@ -2,10 +2,12 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "renderer/opengl/shader_data.h"
-#include "renderer/opengl/simple_object.h"
+#include "renderer/opengl/stream_buffer.h"
 #include "renderer/uniform_buffer.h"
 
 namespace openage::renderer {
@@ -17,14 +19,20 @@ class GlContext;
 class GlUniformInput;
 class GlUniformBufferInput;
 
-class GlUniformBuffer final : public UniformBuffer
-	, public GlSimpleObject {
+/**
+ * Uniform buffer that is updated by streaming.
+ *
+ * Every update writes the whole uniform block into a new range of a
+ * \p GlStreamBuffer and binds that range to the binding point. Draw calls
+ * issued before the update keep reading the old values, so updating
+ * does not wait for the GPU.
+ */
+class GlUniformBuffer final : public UniformBuffer {
 public:
 	GlUniformBuffer(const std::shared_ptr<GlContext> &context,
 	                size_t size,
 	                std::vector<GlInBlockUniform> uniforms,
-	                GLuint binding_point = 0,
-	                GLenum usage = GL_DYNAMIC_DRAW);
+	                GLuint binding_point = 0);
 
 	/**
 	 * Get the binding point of the buffer.
@@ -43,6 +51,8 @@ public:
 	/**
 	 * Set the binding point of the buffer.
 	 *
+	 * The range with the current uniform values is bound to it.
+	 *
 	 * @param binding_point Binding point ID.
 	 */
 	void set_binding_point(GLuint binding_point);
@@ -56,6 +66,13 @@ public:
 	 */
 	void bind() const;
 
+	/**
+	 * Get the OpenGL handle of the buffer.
+	 *
+	 * @return Buffer handle.
+	 */
+	GLuint get_handle() const;
+
 protected:
 	std::shared_ptr<UniformBufferInput> new_unif_in() override;
 	void set_i32(UniformBufferInput &in, const char *, int32_t) override;
@@ -92,6 +109,12 @@ private:
 	              void const *val,
 	              GLenum type);
 
+	/**
+	 * Write the current block data into a new range of the stream buffer
+	 * and bind it to the binding point.
+	 */
+	void upload();
+
 	/**
 	 * Uniform definitions inside the buffer.
 	 */
@@ -111,6 +134,26 @@ private:
 	 * Binding point of the buffer.
 	 */
 	GLuint binding_point;
+
+	/**
+	 * Alignment of the block ranges in the stream buffer.
+	 */
+	size_t alignment;
+
+	/**
+	 * Current values of the whole uniform block.
+	 */
+	std::vector<uint8_t> block_data;
+
+	/**
+	 * Offset of the range with the current values in the stream buffer.
+	 */
+	size_t block_offset;
+
+	/**
+	 * Buffer that the uniform blocks are streamed into.
+	 */
+	GlStreamBuffer stream;
 };
 
 } // namespace opengl
@@ -1,4 +1,4 @@
-// Copyright 2021-2023 the openage authors. See copying.md for legal info.
+// Copyright 2021-2024 the openage authors. See copying.md for legal info.
 
 #include "layer_info.h"
 
@@ -22,6 +22,7 @@ LayerInfo::LayerInfo(std::vector<std::shared_ptr<AngleInfo>> &angles,
 	time_per_frame{time_per_frame},
 	replay_delay{replay_delay},
 	angles{angles},
+	angle_lookup{},
 	frame_timing{nullptr} {
 	if (this->angles.size() > 0) {
 		// set frame timings by calculating when they appear in the animation sequence
@@ -35,6 +36,21 @@ LayerInfo::LayerInfo(std::vector<std::shared_ptr<AngleInfo>> &angles,
 		auto total_time = (frame_count - 1) * this->time_per_frame + this->replay_delay;
 		this->frame_timing = std::make_shared<FrameTiming>(total_time, std::move(keyframes));
 	}
+
+	// the angle only changes at the start of an angle, so ranges without
+	// an angle start have the same angle for all their directions
+	if (this->angles.size() > 1 and this->angles.size() < angle_lookup_search) {
+		constexpr float range_size = 360.0f / angle_lookup_size;
+		this->angle_lookup.resize(angle_lookup_size);
+		for (size_t i = 0; i < angle_lookup_size; ++i) {
+			float lower = i * range_size;
+			float upper = (i + 1) * range_size;
+			bool contains_start = std::any_of(std::begin(this->angles), std::end(this->angles), [&](const auto &angle) {
+				return angle->get_angle_start() >= lower and angle->get_angle_start() <= upper;
+			});
+			this->angle_lookup[i] = contains_start ? angle_lookup_search : this->search_angle(lower);
+		}
+	}
 }
 
 display_mode LayerInfo::get_display_mode() const {
@@ -62,9 +78,27 @@ const std::shared_ptr<AngleInfo> &LayerInfo::get_angle(size_t idx) const {
 }
 
 const std::shared_ptr<AngleInfo> &LayerInfo::get_direction_angle(float direction) const {
+	if (this->angle_lookup.empty()) {
+		return this->get_angle(this->search_angle(direction));
+	}
+
+	// clamp to possible degrees values
+	direction = std::clamp(direction, 0.0f, 360.0f);
+
+	auto range = std::min(static_cast<size_t>(direction * (angle_lookup_size / 360.0f)),
+	                      angle_lookup_size - 1);
+	auto idx = this->angle_lookup[range];
+	if (idx == angle_lookup_search) [[unlikely]] {
+		return this->get_angle(this->search_angle(direction));
+	}
+
+	return this->angles[idx];
+}
+
+size_t LayerInfo::search_angle(float direction) const {
 	if (this->angles.size() == 1) {
 		// angle covers all directions
-		return this->get_angle(0);
+		return 0;
 	}
 
 	// clamp to possible degrees values
@@ -74,7 +108,7 @@ const std::shared_ptr<AngleInfo> &LayerInfo::get_direction_angle(float direction
 	// around at 360 degrees, e.g. 337,5 to 22,5
 	if (direction > this->angles.at(0)->get_angle_start()
 	    or direction < this->angles.at(1)->get_angle_start()) {
-		return this->get_angle(0);
+		return 0;
 	}
 
 	// check if angles with index = angles.size() - 2 match
@@ -83,12 +117,12 @@ const std::shared_ptr<AngleInfo> &LayerInfo::get_direction_angle(float direction
 	// direction)
 	for (size_t i = 1; i < this->angles.size(); ++i) {
 		if (direction < this->angles.at(i)->get_angle_start()) {
-			return this->get_angle(i - 1);
+			return i - 1;
 		}
 	}
 
 	// last angle in the list is the only one remaining that could match
-	return this->get_angle(this->angles.size() - 1);
+	return this->angles.size() - 1;
 }
 
 const std::shared_ptr<FrameTiming> &LayerInfo::get_frame_timing() const {
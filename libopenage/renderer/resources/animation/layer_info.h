@@ -3,6 +3,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -88,6 +89,8 @@ public:
 	/**
 	 * Get the angle information of the angle matching the specified direction.
 	 *
+	 * Uses a precomputed lookup table, so the complexity is O(1).
+	 *
 	 * @param direction Direction in degrees.
 	 *
 	 * @return An angle information object.
@@ -102,6 +105,27 @@ public:
 	const std::shared_ptr<FrameTiming> &get_frame_timing() const;
 
 private:
+	/**
+	 * Search the index of the angle matching the specified direction.
+	 *
+	 * Complexity is linear in the number of angles.
+	 *
+	 * @param direction Direction in degrees.
+	 *
+	 * @return Index of the angle.
+	 */
+	size_t search_angle(float direction) const;
+
+	/**
+	 * Number of direction ranges in \p angle_lookup.
+	 */
+	static constexpr size_t angle_lookup_size = 1440;
+
+	/**
+	 * Marks direction ranges in \p angle_lookup that contain the start of an angle.
+	 */
+	static constexpr uint8_t angle_lookup_search = 0xff;
+
 	/**
 	 * Display mode of the contained frames.
 	 */
@@ -127,6 +151,13 @@ private:
 	 */
 	std::vector<std::shared_ptr<AngleInfo>> angles;
 
+	/**
+	 * Index of the angle for each direction range of 360 / \p angle_lookup_size degrees.
+	 * Ranges that contain the start of an angle are marked with \p angle_lookup_search
+	 * and searched instead.
+	 */
+	std::vector<uint8_t> angle_lookup;
+
 	/**
 	 * Frame timing in the animated sequence.
 	 */
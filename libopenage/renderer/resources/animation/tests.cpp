@@ -0,0 +1,129 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "renderer/resources/animation/angle_info.h"
+#include "renderer/resources/animation/frame_info.h"
+#include "renderer/resources/animation/layer_info.h"
+#include "renderer/resources/frame_timing.h"
+#include "testing/testing.h"
+#include "time/time.h"
+
+
+namespace openage::renderer::resources::tests {
+
+namespace {
+
+/**
+ * Create a layer with evenly spaced angles, starting with the
+ * front-facing angle that is centered around 0 degrees.
+ */
+LayerInfo make_layer(size_t angle_count, size_t frame_count) {
+	std::vector<std::shared_ptr<FrameInfo>> frames;
+	for (size_t i = 0; i < frame_count; ++i) {
+		frames.push_back(std::make_shared<FrameInfo>(0, i));
+	}
+
+	std::vector<std::shared_ptr<AngleInfo>> angles;
+	float angle_size = 360.0f / angle_count;
+	for (size_t i = 0; i < angle_count; ++i) {
+		float start = i == 0 ? 360.0f - angle_size / 2 : i * angle_size - angle_size / 2;
+		angles.push_back(std::make_shared<AngleInfo>(start, frames));
+	}
+
+	return LayerInfo{angles, display_mode::LOOP, 0, 0.1f, 0.0f};
+}
+
+/**
+ * Index of the angle containing a direction, found by comparing the direction
+ * with the angle centers.
+ */
+size_t expected_angle(size_t angle_count, float direction) {
+	float angle_size = 360.0f / angle_count;
+	auto idx = static_cast<size_t>((direction + angle_size / 2) / angle_size);
+	return idx % angle_count;
+}
+
+size_t angle_index(const LayerInfo &layer, float direction) {
+	auto &angle = layer.get_direction_angle(direction);
+	for (size_t i = 0; i < layer.get_angle_count(); ++i) {
+		if (layer.get_angle(i) == angle) {
+			return i;
+		}
+	}
+	return layer.get_angle_count();
+}
+
+} // namespace
+
+
+void animation() {
+	// angle lookup, including directions right at the angle borders
+	for (size_t angle_count : {1, 2, 8, 16, 32}) {
+		auto layer = make_layer(angle_count, 1);
+		for (int i = 0; i <= 3600; ++i) {
+			float direction = i * 0.1f;
+			float angle_size = 360.0f / angle_count;
+			float border = std::fmod(direction + angle_size / 2, angle_size);
+			if (border < 0.01f or border > angle_size - 0.01f) {
+				// rounding decides on which side of a border the direction is
+				continue;
+			}
+			TESTEQUALS(angle_index(layer, direction), expected_angle(angle_count, direction));
+		}
+
+		// directions outside of 0 to 360 degrees are clamped
+		TESTEQUALS(angle_index(layer, -10.0f), 0u);
+		TESTEQUALS(angle_index(layer, 400.0f), 0u);
+	}
+
+	// directions exactly at an angle start have the same angle as before the lookup table
+	auto layer = make_layer(8, 1);
+	TESTEQUALS(angle_index(layer, 22.5f), 1u);
+	TESTEQUALS(angle_index(layer, 337.5f), 7u);
+	TESTEQUALS(angle_index(layer, 0.0f), 0u);
+	TESTEQUALS(angle_index(layer, 360.0f), 0u);
+
+	// evenly spaced frames, the last frame is displayed longer
+	time::time_t frame_length = time::time_t::from_double(0.1);
+	std::vector<time::time_t> keyframes;
+	for (int i = 0; i < 10; ++i) {
+		keyframes.push_back(frame_length * i);
+	}
+	FrameTiming even{frame_length * 12, std::move(keyframes)};
+
+	TESTEQUALS(even.get_frame(0), 0u);
+	TESTEQUALS(even.get_frame(frame_length * 3), 3u);
+	TESTEQUALS(even.get_frame(frame_length * 3 - time::time_t::from_raw_value(1)), 2u);
+	TESTEQUALS(even.get_frame(frame_length * 9), 9u);
+	TESTEQUALS(even.get_frame(frame_length * 11), 9u);
+	TESTEQUALS(even.get_frame(frame_length * 12, 0), 0u);
+	TESTEQUALS(even.get_frame(frame_length * 15, frame_length * 2), 1u);
+
+	// uneven timings are searched
+	std::vector<time::time_t> skipped{0, frame_length, frame_length * 3};
+	FrameTiming gaps{frame_length * 4, std::move(skipped)};
+	TESTEQUALS(gaps.get_frame(frame_length * 2), 1u);
+	TESTEQUALS(gaps.get_frame(frame_length * 3), 2u);
+
+	// inserting a keyframe can make the frames evenly spaced
+	std::vector<time::time_t> gap{0, frame_length * 2};
+	FrameTiming filled{frame_length * 3, std::move(gap)};
+	TESTEQUALS(filled.get_frame(frame_length * 1), 0u);
+	filled.insert(frame_length);
+	TESTEQUALS(filled.get_frame(frame_length * 1), 1u);
+	TESTEQUALS(filled.get_frame(frame_length * 2), 2u);
+
+	// frames of animation layers are evenly spaced
+	auto animated = make_layer(8, 5);
+	auto &timing = animated.get_frame_timing();
+	TESTEQUALS(timing->size(), 5u);
+	TESTEQUALS(timing->get_frame(time::time_t::from_double(0.25)), 2u);
+	TESTEQUALS(timing->get_frame(time::time_t::from_double(0.45)), 4u);
+	TESTEQUALS(timing->get_frame(time::time_t::from_double(0.55), 0), 1u);
+}
+
+} // namespace openage::renderer::resources::tests
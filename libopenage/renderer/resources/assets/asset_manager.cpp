@@ -1,10 +1,13 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2024 the openage authors. See copying.md for legal info.
 
 #include "asset_manager.h"
 
 #include "error/error.h"
 #include "log/log.h"
 #include "log/message.h"
+#include "metrics/registry.h"
+#include "metrics/scoped_timer.h"
+#include "metrics/trace.h"
 
 #include "renderer/resources/animation/animation_info.h"
 #include "renderer/resources/assets/cache.h"
@@ -24,6 +27,18 @@
 
 namespace openage::renderer::resources {
 
+namespace {
+
+metrics::Histogram &asset_load_metric = metrics::registry().histogram(
+	"asset_manager_load_time_ns",
+	"Time needed to load an asset that was not cached");
+
+metrics::Counter &asset_failure_metric = metrics::registry().counter(
+	"asset_manager_load_failures_total",
+	"Number of assets that could not be loaded");
+
+} // namespace
+
 AssetManager::AssetManager(const std::shared_ptr<Renderer> &renderer,
                            const util::Path &asset_base_dir) :
 	renderer{renderer},
@@ -38,11 +53,14 @@ const std::shared_ptr<Animation2dInfo> &AssetManager::request_animation(const ut
 	try {
 		if (not this->cache->check_animation_cache(path)) {
 			// create if not loaded
+			OA_TRACE_SCOPE("AssetManager::load");
+			metrics::ScopedTimer timer{asset_load_metric};
 			info = std::make_shared<Animation2dInfo>(parser::parse_sprite_file(path, this->cache));
 			this->cache->add_animation(path, info);
 		}
 	}
 	catch (const Error &err) {
+		asset_failure_metric.add();
 		if (this->placeholder_animation) {
 			log::log(MSG(warn) << "Failed to load animation file from: " << path
 			                   << " - using placeholder instead.");
@@ -60,11 +78,14 @@ const std::shared_ptr<BlendPatternInfo> &AssetManager::request_blpattern(const u
 	try {
 		if (not this->cache->check_blpattern_cache(path)) {
 			// create if not loaded
+			OA_TRACE_SCOPE("AssetManager::load");
+			metrics::ScopedTimer timer{asset_load_metric};
 			info = std::make_shared<BlendPatternInfo>(parser::parse_blendmask_file(path, this->cache));
 			this->cache->add_blpattern(path, info);
 		}
 	}
 	catch (const Error &err) {
+		asset_failure_metric.add();
 		if (this->placeholder_blpattern) {
 			log::log(MSG(warn) << "Failed to load blend pattern file from: " << path
 			                   << " - using placeholder instead.");
@@ -82,11 +103,14 @@ const std::shared_ptr<BlendTableInfo> &AssetManager::request_bltable(const util:
 	try {
 		if (not this->cache->check_bltable_cache(path)) {
 			// create if not loaded
+			OA_TRACE_SCOPE("AssetManager::load");
+			metrics::ScopedTimer timer{asset_load_metric};
 			info = std::make_shared<BlendTableInfo>(parser::parse_blendtable_file(path, this->cache));
 			this->cache->add_bltable(path, info);
 		}
 	}
 	catch (const Error &err) {
+		asset_failure_metric.add();
 		if (this->placeholder_bltable) {
 			log::log(MSG(warn) << "Failed to load blend table file from: " << path
 			                   << " - using placeholder instead.");
@@ -104,11 +128,14 @@ const std::shared_ptr<PaletteInfo> &AssetManager::request_palette(const util::Pa
 	try {
 		if (not this->cache->check_palette_cache(path)) {
 			// create if not loaded
+			OA_TRACE_SCOPE("AssetManager::load");
+			metrics::ScopedTimer timer{asset_load_metric};
 			info = std::make_shared<PaletteInfo>(parser::parse_palette_file(path));
 			this->cache->add_palette(path, info);
 		}
 	}
 	catch (const Error &err) {
+		asset_failure_metric.add();
 		if (this->placeholder_palette) {
 			log::log(MSG(warn) << "Failed to load palette file from: " << path
 			                   << " - using placeholder instead.");
@@ -126,11 +153,14 @@ const std::shared_ptr<TerrainInfo> &AssetManager::request_terrain(const util::Pa
 	try {
 		if (not this->cache->check_terrain_cache(path)) {
 			// create if not loaded
+			OA_TRACE_SCOPE("AssetManager::load");
+			metrics::ScopedTimer timer{asset_load_metric};
 			info = std::make_shared<TerrainInfo>(parser::parse_terrain_file(path, this->cache));
 			this->cache->add_terrain(path, info);
 		}
 	}
 	catch (const Error &err) {
+		asset_failure_metric.add();
 		if (this->placeholder_terrain) {
 			log::log(MSG(warn) << "Failed to load terrain file from: " << path
 			                   << " - using placeholder instead.");
@@ -148,11 +178,14 @@ const std::shared_ptr<Texture2dInfo> &AssetManager::request_texture(const util::
 	try {
 		if (not this->cache->check_texture_cache(path)) {
 			// create if not loaded
+			OA_TRACE_SCOPE("AssetManager::load");
+			metrics::ScopedTimer timer{asset_load_metric};
 			info = std::make_shared<Texture2dInfo>(parser::parse_texture_file(path));
 			this->cache->add_texture(path, info);
 		}
 	}
 	catch (const Error &err) {
+		asset_failure_metric.add();
 		if (this->placeholder_texture) {
 			log::log(MSG(warn) << "Failed to load texture file from: " << path
 			                   << " - using placeholder instead.");
@@ -0,0 +1,205 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "error/error.h"
+#include "renderer/renderer.h"
+#include "renderer/resources/assets/texture_manager.h"
+#include "renderer/resources/texture_data.h"
+#include "renderer/resources/texture_info.h"
+#include "renderer/texture.h"
+#include "testing/testing.h"
+#include "util/fslike/directory.h"
+#include "util/path.h"
+
+
+namespace openage::renderer::resources::tests {
+
+namespace {
+
+/**
+ * Texture that only exists on the CPU.
+ */
+class StubTexture2d final : public Texture2d {
+public:
+	StubTexture2d(const Texture2dInfo &info) :
+		Texture2d{info} {}
+
+	Texture2dData into_data() override {
+		return Texture2dData{this->info, std::vector<uint8_t>(this->info.get_data_size())};
+	}
+
+	void upload(const Texture2dData &) override {}
+};
+
+
+/**
+ * Renderer that can only create textures. Counts the uploaded textures.
+ */
+class StubRenderer final : public Renderer {
+public:
+	std::shared_ptr<Texture2d> add_texture(const Texture2dData &data) override {
+		this->uploads += 1;
+		return std::make_shared<StubTexture2d>(data.get_info());
+	}
+
+	std::shared_ptr<Texture2d> add_texture(const Texture2dInfo &info) override {
+		return std::make_shared<StubTexture2d>(info);
+	}
+
+	std::shared_ptr<ShaderProgram> add_shader(const std::vector<ShaderSource> &) override {
+		throw Error{MSG(err) << "Not supported by the stub renderer"};
+	}
+
+	std::shared_ptr<Geometry> add_mesh_geometry(const MeshData &) override {
+		throw Error{MSG(err) << "Not supported by the stub renderer"};
+	}
+
+	std::shared_ptr<Geometry> add_bufferless_quad() override {
+		throw Error{MSG(err) << "Not supported by the stub renderer"};
+	}
+
+	std::shared_ptr<RenderPass> add_render_pass(std::vector<Renderable>,
+	                                            const std::shared_ptr<RenderTarget> &) override {
+		throw Error{MSG(err) << "Not supported by the stub renderer"};
+	}
+
+	std::shared_ptr<RenderTarget> create_texture_target(const std::vector<std::shared_ptr<Texture2d>> &) override {
+		throw Error{MSG(err) << "Not supported by the stub renderer"};
+	}
+
+	std::shared_ptr<RenderTarget> get_display_target() override {
+		throw Error{MSG(err) << "Not supported by the stub renderer"};
+	}
+
+	std::shared_ptr<UniformBuffer> add_uniform_buffer(const UniformBufferInfo &) override {
+		throw Error{MSG(err) << "Not supported by the stub renderer"};
+	}
+
+	std::shared_ptr<UniformBuffer> add_uniform_buffer(const std::shared_ptr<ShaderProgram> &,
+	                                                  const std::string &) override {
+		throw Error{MSG(err) << "Not supported by the stub renderer"};
+	}
+
+	Texture2dData display_into_data() override {
+		throw Error{MSG(err) << "Not supported by the stub renderer"};
+	}
+
+	void check_error() override {}
+
+	void render(const std::shared_ptr<RenderPass> &) override {}
+
+	/**
+	 * Number of textures created from texture data.
+	 */
+	size_t uploads = 0;
+};
+
+
+/**
+ * Write a fully opaque image.
+ */
+void write_image(const util::Path &path, size_t size) {
+	Texture2dInfo info{size, size, pixel_format::rgba8};
+	Texture2dData data{info, std::vector<uint8_t>(info.get_data_size(), 0xff)};
+	data.store(path);
+}
+
+} // namespace
+
+
+void texture_manager() {
+	auto dir = std::filesystem::temp_directory_path() / "openage_texture_manager_test";
+	std::filesystem::remove_all(dir);
+	std::filesystem::create_directories(dir);
+	util::Path root{std::make_shared<util::fslike::Directory>(dir.string()), {}};
+
+	auto renderer = std::make_shared<StubRenderer>();
+	Texture2dInfo info{16, 16, pixel_format::rgba8};
+	size_t size = info.get_data_size();
+
+	// textures are removed in the order of their last request
+	TextureManager manager{renderer};
+	manager.add(root / "a.png", renderer->add_texture(info));
+	manager.add(root / "b.png", renderer->add_texture(info));
+	manager.add(root / "c.png", renderer->add_texture(info));
+	std::weak_ptr<Texture2d> tex_b = manager.request(root / "b.png");
+	std::weak_ptr<Texture2d> tex_c = manager.request(root / "c.png");
+	TESTEQUALS(manager.get_resident_size(), 3 * size);
+
+	manager.set_budget(2 * size);
+	for (size_t i = 0; i < 100; ++i) {
+		manager.request(root / "a.png");
+		manager.update();
+	}
+	TESTEQUALS(manager.get_resident_size(), 2 * size);
+	TESTEQUALS(tex_b.expired(), true);
+	TESTEQUALS(tex_c.expired(), false);
+
+	// referenced textures are kept
+	auto pinned = tex_c.lock();
+	manager.set_budget(size);
+	for (size_t i = 0; i < 100; ++i) {
+		manager.request(root / "a.png");
+		manager.update();
+	}
+	TESTEQUALS(manager.get_resident_size(), 2 * size);
+
+	pinned.reset();
+	manager.update();
+	TESTEQUALS(manager.get_resident_size(), size);
+	TESTEQUALS(tex_c.expired(), true);
+
+	// recently requested textures are kept even if they exceed the budget
+	manager.set_budget(1);
+	manager.update();
+	TESTEQUALS(manager.get_resident_size(), size);
+
+	manager.remove(root / "a.png");
+	TESTEQUALS(manager.get_resident_size(), 0u);
+
+	// textures requested asynchronously show the placeholder until they are uploaded
+	write_image(root / "placeholder.png", 4);
+	write_image(root / "async.png", 8);
+	write_image(root / "sync.png", 16);
+	size_t uploads = renderer->uploads;
+
+	TextureManager async_manager{renderer};
+	async_manager.set_placeholder(root / "placeholder.png");
+	auto &placeholder = async_manager.get_placeholder()->second;
+	TESTEQUALS(async_manager.request_async(root / "sync.png"), placeholder);
+	TESTEQUALS(async_manager.request_async(root / "missing.png"), placeholder);
+
+	// a texture that was loaded synchronously in the meantime is not uploaded twice
+	TESTEQUALS(async_manager.request(root / "sync.png") == placeholder, false);
+
+	// the loading jobs are run in order, so the other jobs are done after this one
+	TESTEQUALS(async_manager.request_async(root / "async.png"), placeholder);
+	for (size_t i = 0; i < 10000; ++i) {
+		async_manager.update();
+		if (async_manager.request_async(root / "async.png") != placeholder) {
+			break;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds{1});
+	}
+
+	auto &loaded = async_manager.request_async(root / "async.png");
+	TESTEQUALS(loaded == placeholder, false);
+	TESTEQUALS(loaded->get_info().get_size().first, 8u);
+	TESTEQUALS(async_manager.request_async(root / "missing.png"), placeholder);
+	TESTEQUALS(async_manager.get_resident_size(),
+	           Texture2dInfo(8, 8, pixel_format::rgba8).get_data_size()
+	               + Texture2dInfo(16, 16, pixel_format::rgba8).get_data_size());
+
+	// placeholder, sync.png and async.png
+	TESTEQUALS(renderer->uploads - uploads, 3u);
+
+	std::filesystem::remove_all(dir);
+}
+
+} // namespace openage::renderer::resources::tests
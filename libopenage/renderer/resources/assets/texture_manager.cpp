@@ -1,43 +1,151 @@
-// Copyright 2022-2023 the openage authors. See copying.md for legal info.
+// Copyright 2022-2024 the openage authors. See copying.md for legal info.
 
 #include "texture_manager.h"
 
+#include <iterator>
+
+#include "error/error.h"
+#include "job/job_manager.h"
+#include "log/log.h"
+#include "metrics/registry.h"
 #include "renderer/renderer.h"
 #include "renderer/resources/texture_data.h"
+#include "renderer/texture.h"
 
 
 namespace openage::renderer::resources {
 
-TextureManager::TextureManager(const std::shared_ptr<Renderer> &renderer) :
+namespace {
+
+/**
+ * Number of frames after its last request in which a texture is not removed.
+ */
+constexpr size_t eviction_delay = 60;
+
+/**
+ * Default maximum size of the textures uploaded per frame (in bytes).
+ */
+constexpr size_t default_upload_budget = 16 * 1024 * 1024;
+
+metrics::Gauge &resident_size_metric = metrics::registry().gauge(
+	"texture_manager_resident_bytes",
+	"Size of the textures loaded by the texture manager");
+
+metrics::Counter &evicted_metric = metrics::registry().counter(
+	"texture_manager_evicted_total",
+	"Number of textures removed to stay within the memory budget");
+
+} // namespace
+
+
+TextureManager::TextureManager(const std::shared_ptr<Renderer> &renderer,
+                               size_t budget) :
 	renderer{renderer},
-	loaded{} {
+	loaded{},
+	lru{},
+	loading{},
+	loading_paths{},
+	failed{},
+	job_mgr{std::make_shared<job::JobManager>(1)},
+	budget{budget},
+	upload_budget{default_upload_budget},
+	resident_size{0},
+	frame{0} {
+	this->job_mgr->start();
+}
+
+TextureManager::~TextureManager() {
+	this->job_mgr->stop();
 }
 
 const std::shared_ptr<Texture2d> &TextureManager::request(const util::Path &path) {
-	if (not this->loaded.contains(path)) {
-		// create if not loaded
-		auto tex_data = resources::Texture2dData(path);
-		this->loaded.insert({path, this->renderer->add_texture(tex_data)});
+	auto it = this->loaded.find(path);
+	if (it != std::end(this->loaded)) {
+		this->touch(it->second);
+		return it->second.texture;
+	}
+
+	// create if not loaded
+	auto tex_data = resources::Texture2dData(path);
+	return this->insert(path, this->renderer->add_texture(tex_data));
+}
+
+const std::shared_ptr<Texture2d> &TextureManager::request_async(const util::Path &path) {
+	auto it = this->loaded.find(path);
+	if (it != std::end(this->loaded)) {
+		this->touch(it->second);
+		return it->second.texture;
+	}
+
+	if (not this->placeholder) {
+		return this->request(path);
+	}
+
+	if (not this->loading_paths.contains(path) and not this->failed.contains(path)) {
+		// the path may need the Python file system, so it is resolved in this thread
+		std::string native_path;
+		try {
+			native_path = path.resolve_native_path();
+		}
+		catch (Error &err) {
+			log::log(MSG(warn) << "Failed to load texture from: " << path
+			                   << ", using placeholder instead: " << err.what());
+			this->failed.insert(path);
+			return this->placeholder->second;
+		}
+
+		auto job = this->job_mgr->enqueue<std::shared_ptr<Texture2dData>>([path, native_path]() {
+			return std::make_shared<Texture2dData>(path, native_path);
+		});
+		this->loading.emplace_back(path, job);
+		this->loading_paths.insert(path);
 	}
-	return this->loaded.at(path);
+
+	return this->placeholder->second;
 }
 
 void TextureManager::add(const util::Path &path) {
 	if (not this->loaded.contains(path)) {
 		// create if not loaded
 		auto tex_data = resources::Texture2dData(path);
-		this->loaded.insert({path, this->renderer->add_texture(tex_data)});
+		this->insert(path, this->renderer->add_texture(tex_data));
 	}
 }
 
 void TextureManager::add(const util::Path &path,
                          const std::shared_ptr<Texture2d> &texture) {
-	auto flat_path = path.resolve_native_path();
-	this->loaded.insert({path, texture});
+	this->remove(path);
+	this->insert(path, texture);
 }
 
 void TextureManager::remove(const util::Path &path) {
-	this->loaded.erase(path);
+	auto it = this->loaded.find(path);
+	if (it == std::end(this->loaded)) {
+		return;
+	}
+
+	this->resident_size -= it->second.size;
+	this->lru.erase(it->second.lru_pos);
+	this->loaded.erase(it);
+	resident_size_metric.set(this->resident_size);
+}
+
+void TextureManager::update() {
+	this->frame += 1;
+	this->upload_loaded();
+	this->evict();
+}
+
+void TextureManager::set_budget(size_t budget) {
+	this->budget = budget;
+}
+
+void TextureManager::set_upload_budget(size_t upload_budget) {
+	this->upload_budget = upload_budget;
+}
+
+size_t TextureManager::get_resident_size() const {
+	return this->resident_size;
 }
 
 void TextureManager::set_placeholder(const util::Path &path) {
@@ -49,4 +157,86 @@ const TextureManager::placeholder_t &TextureManager::get_placeholder() const {
 	return this->placeholder;
 }
 
+const std::shared_ptr<Texture2d> &TextureManager::insert(const util::Path &path,
+                                                         const std::shared_ptr<Texture2d> &texture) {
+	size_t size = texture->get_info().get_data_size();
+	auto [it, inserted] = this->loaded.emplace(path, texture_entry{texture, size, this->frame, {}});
+	if (not inserted) {
+		// keep the texture that is already used
+		this->touch(it->second);
+		return it->second.texture;
+	}
+
+	this->lru.push_front(path);
+	it->second.lru_pos = std::begin(this->lru);
+	this->resident_size += size;
+	resident_size_metric.set(this->resident_size);
+
+	return it->second.texture;
+}
+
+void TextureManager::touch(texture_entry &entry) {
+	entry.last_used = this->frame;
+	this->lru.splice(std::begin(this->lru), this->lru, entry.lru_pos);
+}
+
+void TextureManager::upload_loaded() {
+	size_t uploaded = 0;
+	auto it = std::begin(this->loading);
+	while (it != std::end(this->loading) and uploaded < this->upload_budget) {
+		auto &[path, job] = *it;
+		if (not job.is_finished()) {
+			++it;
+			continue;
+		}
+
+		// textures requested with request() in the meantime are already loaded
+		if (not this->loaded.contains(path)) {
+			try {
+				auto tex_data = job.get_result();
+				auto &texture = this->insert(path, this->renderer->add_texture(*tex_data));
+				uploaded += texture->get_info().get_data_size();
+			}
+			catch (Error &err) {
+				log::log(MSG(warn) << "Failed to load texture from: " << path
+				                   << ", using placeholder instead: " << err.what());
+				this->failed.insert(path);
+			}
+		}
+
+		this->loading_paths.erase(path);
+		it = this->loading.erase(it);
+	}
+}
+
+void TextureManager::evict() {
+	if (this->budget == 0) {
+		return;
+	}
+
+	auto it = std::end(this->lru);
+	while (this->resident_size > this->budget and it != std::begin(this->lru)) {
+		--it;
+		auto entry = this->loaded.find(*it);
+
+		// the list is ordered by last use, so all other textures were used recently too
+		if (entry->second.last_used + eviction_delay > this->frame) {
+			break;
+		}
+
+		// textures that are referenced elsewhere stay on the GPU anyway
+		if (entry->second.texture.use_count() > 1) {
+			continue;
+		}
+
+		log::log(MSG(dbg) << "Removing texture " << *it << " to stay within the memory budget");
+		this->resident_size -= entry->second.size;
+		this->loaded.erase(entry);
+		it = this->lru.erase(it);
+		evicted_metric.add();
+	}
+
+	resident_size_metric.set(this->resident_size);
+}
+
 } // namespace openage::renderer::resources
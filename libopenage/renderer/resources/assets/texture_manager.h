@@ -2,26 +2,44 @@
 
 #pragma once
 
+#include <cstddef>
+#include <list>
 #include <memory>
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
+#include "job/job.h"
 #include "util/path.h"
 
 
+namespace openage::job {
+class JobManager;
+} // namespace openage::job
+
 namespace openage::renderer {
 class Renderer;
 class Texture2d;
 
 namespace resources {
+class Texture2dData;
 
 /**
  * Loads and stores references to shared texture assets.
  *
  * Using the texture manager to request texture assets allows quick access
  * to already loaded assets and avoid creating unnecessary duplicates.
+ *
+ * The textures that are kept on the GPU can be limited by a memory budget.
+ * When the loaded textures exceed the budget, \p update() removes the
+ * textures that were least recently requested. Textures that were requested
+ * in the last few frames or that are still referenced outside of the manager
+ * are never removed.
+ *
+ * Textures requested with \p request_async() are decoded in a worker thread
+ * and uploaded by \p update(), which limits the uploaded bytes per frame.
  */
 class TextureManager {
 public:
@@ -29,9 +47,11 @@ public:
 	 * Create a new texture manager.
 	 *
 	 * @param renderer The openage renderer instance.
+	 * @param budget Maximum size of the loaded textures (in bytes). 0 means unlimited.
 	 */
-	TextureManager(const std::shared_ptr<Renderer> &renderer);
-	~TextureManager() = default;
+	TextureManager(const std::shared_ptr<Renderer> &renderer,
+	               size_t budget = 0);
+	~TextureManager();
 
 	/**
 	 * Prevent accidental copy or assignment because it would defeat the
@@ -52,6 +72,23 @@ public:
 	 */
 	const std::shared_ptr<Texture2d> &request(const util::Path &path);
 
+	/**
+	 * Get the corresponding texture for the specified path without
+	 * waiting for it to load.
+	 *
+	 * If the texture does not exist in the cache yet, it is loaded in
+	 * the background and the placeholder texture is returned until
+	 * \p update() has uploaded it. Callers must request the texture again
+	 * in later frames to get the loaded texture.
+	 *
+	 * If there is no placeholder texture, the texture is loaded immediately.
+	 *
+	 * @param path Path to the texture resource.
+	 *
+	 * @return Texture resource at the given path or the placeholder texture.
+	 */
+	const std::shared_ptr<Texture2d> &request_async(const util::Path &path);
+
 	/**
 	 * Load the texture at the given path. Does nothing if the path
 	 * already exists in the cache.
@@ -77,6 +114,37 @@ public:
 	 */
 	void remove(const util::Path &path);
 
+	/**
+	 * Upload textures that were loaded in the background and remove
+	 * textures that exceed the memory budget.
+	 *
+	 * Must be called once per frame from the thread that owns the
+	 * renderer context.
+	 */
+	void update();
+
+	/**
+	 * Set the memory budget for the loaded textures.
+	 *
+	 * @param budget Maximum size of the loaded textures (in bytes). 0 means unlimited.
+	 */
+	void set_budget(size_t budget);
+
+	/**
+	 * Set the maximum size of the textures uploaded by one call to \p update().
+	 * At least one texture is uploaded per call.
+	 *
+	 * @param upload_budget Maximum uploaded size per frame (in bytes).
+	 */
+	void set_upload_budget(size_t upload_budget);
+
+	/**
+	 * Get the size of the loaded textures.
+	 *
+	 * @return Size of the loaded textures (in bytes).
+	 */
+	size_t get_resident_size() const;
+
 	/**
 	 * Set the placeholder texture.
 	 *
@@ -94,18 +162,117 @@ public:
 	const placeholder_t &get_placeholder() const;
 
 private:
+	/**
+	 * Texture in the cache.
+	 */
+	struct texture_entry {
+		/**
+		 * Texture on the GPU.
+		 */
+		std::shared_ptr<Texture2d> texture;
+
+		/**
+		 * Size of the texture (in bytes).
+		 */
+		size_t size;
+
+		/**
+		 * Frame in which the texture was last requested.
+		 */
+		size_t last_used;
+
+		/**
+		 * Position of the texture in the LRU list.
+		 */
+		std::list<util::Path>::iterator lru_pos;
+	};
+
+	/**
+	 * Add a texture to the cache.
+	 *
+	 * @param path Path to the texture resource.
+	 * @param texture Texture object.
+	 *
+	 * @return Cached texture.
+	 */
+	const std::shared_ptr<Texture2d> &insert(const util::Path &path,
+	                                         const std::shared_ptr<Texture2d> &texture);
+
+	/**
+	 * Mark a texture as used in the current frame.
+	 *
+	 * @param entry Cache entry of the texture.
+	 */
+	void touch(texture_entry &entry);
+
+	/**
+	 * Upload the textures that finished loading in the background.
+	 */
+	void upload_loaded();
+
+	/**
+	 * Remove least recently used textures until the loaded textures fit into the budget.
+	 */
+	void evict();
+
 	/**
 	 * openage renderer.
 	 */
 	std::shared_ptr<Renderer> renderer;
 
-	using texture_cache_t = std::unordered_map<util::Path, std::shared_ptr<Texture2d>>;
+	using texture_cache_t = std::unordered_map<util::Path, texture_entry>;
 
 	/**
 	 * Cache of already created textures.
 	 */
 	texture_cache_t loaded;
 
+	/**
+	 * Paths of the loaded textures, the most recently used first.
+	 */
+	std::list<util::Path> lru;
+
+	/**
+	 * Textures that are currently decoded in the background, in the order of their requests.
+	 */
+	std::list<std::pair<util::Path, job::Job<std::shared_ptr<Texture2dData>>>> loading;
+
+	/**
+	 * Paths in \p loading for fast lookup.
+	 */
+	std::unordered_set<util::Path> loading_paths;
+
+	/**
+	 * Textures that could not be loaded in the background.
+	 * The placeholder is used for them.
+	 */
+	std::unordered_set<util::Path> failed;
+
+	/**
+	 * Worker thread for decoding textures.
+	 */
+	std::shared_ptr<job::JobManager> job_mgr;
+
+	/**
+	 * Maximum size of the loaded textures (in bytes). 0 means unlimited.
+	 */
+	size_t budget;
+
+	/**
+	 * Maximum size of the textures uploaded per frame (in bytes).
+	 */
+	size_t upload_budget;
+
+	/**
+	 * Size of the loaded textures (in bytes).
+	 */
+	size_t resident_size;
+
+	/**
+	 * Number of the current frame. Increased by \p update().
+	 */
+	size_t frame;
+
 	/**
 	 * Placeholder texture to use if a texture could not be loaded.
 	 */
@@ -1,4 +1,4 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2024 the openage authors. See copying.md for legal info.
 
 #include "frame_timing.h"
 
@@ -16,10 +16,13 @@ namespace openage::renderer::resources {
 FrameTiming::FrameTiming(const time::time_t &total_length,
                          const std::vector<keyframe_t> &&keyframes) :
 	keyframes{keyframes},
+	frame_length{0},
 	total_length{total_length} {
 	if (this->keyframes.size() < 1) [[unlikely]] {
 		throw Error(ERR << "Frame timing sequence must have at least one keyframe.");
 	}
+
+	this->update_frame_length();
 }
 
 void FrameTiming::set_total_length(const time::time_t &total_length) {
@@ -30,12 +33,19 @@ void FrameTiming::insert(const time::time_t &time) {
 	for (auto it = this->keyframes.begin(); it != this->keyframes.end(); ++it) {
 		if (*it >= time) {
 			this->keyframes.insert(it, time);
+			this->update_frame_length();
 			return;
 		}
 	}
 }
 
 size_t FrameTiming::get_frame(const time::time_t &time) const {
+	if (this->frame_length > 0 and time >= 0) [[likely]] {
+		// the last frame is displayed until the sequence ends
+		auto idx = static_cast<size_t>(time.get_raw_value() / this->frame_length.get_raw_value());
+		return std::min(idx, this->keyframes.size() - 1);
+	}
+
 	return search_frame(time);
 }
 
@@ -74,5 +84,25 @@ size_t FrameTiming::search_frame(const time::time_t &time) const {
 	return right - 1;
 }
 
+void FrameTiming::update_frame_length() {
+	this->frame_length = 0;
+	if (this->keyframes.size() < 2 or this->keyframes[0] != 0) {
+		return;
+	}
+
+	auto length = this->keyframes[1];
+	if (length <= 0) {
+		return;
+	}
+
+	for (size_t i = 2; i < this->keyframes.size(); ++i) {
+		if (this->keyframes[i] - this->keyframes[i - 1] != length) {
+			return;
+		}
+	}
+
+	this->frame_length = length;
+}
+
 
 } // namespace openage::renderer::resources
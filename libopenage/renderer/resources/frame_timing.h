@@ -13,7 +13,8 @@ namespace openage::renderer::resources {
 /**
  * Storage for the timing of a sequence of frames.
  *
- * Optimized for fast read access.
+ * Optimized for fast read access. If all frames are displayed for the same
+ * time, frame indices are calculated directly instead of searching the keyframes.
  */
 class FrameTiming {
 public:
@@ -92,11 +93,22 @@ private:
 	 */
 	size_t search_frame(const time::time_t &time) const;
 
+	/**
+	 * Check whether the keyframes are evenly spaced and update \p frame_length.
+	 */
+	void update_frame_length();
+
 	/**
 	 * Time of each frame in the sequence relative to the sequence start (in seconds).
 	 */
 	std::vector<keyframe_t> keyframes;
 
+	/**
+	 * Time between two keyframes if the keyframes are evenly spaced, starting at 0.
+	 * 0 if the frames have different lengths.
+	 */
+	time::time_t frame_length;
+
 	/**
 	 * Total length of the sequence (in seconds).
 	 */
@@ -4,20 +4,22 @@
 
 #include <memory>
 
+#include "util/strings.h"
+
 
 namespace openage::renderer::resources::parser {
 
-size_t parse_version(const std::vector<std::string> &args) {
-	return std::stoul(args[1]);
+size_t parse_version(const std::vector<std::string_view> &args) {
+	return util::parse_number<size_t>(args[1]);
 }
 
-TextureData parse_texture(const std::vector<std::string> &args) {
+TextureData parse_texture(const std::vector<std::string_view> &args) {
 	// TODO: Splitting at the space char assumes that the path string contains no
 	// space. While the space char is not allowed because of nyan naming requirements,
 	// it should result in an error if wrongly used here.
 	TextureData texture;
 
-	texture.texture_id = std::stoul(args[1]);
+	texture.texture_id = util::parse_number<size_t>(args[1]);
 
 	// Call substr() to get rid of the quotes
 	texture.path = args[2].substr(1, args[2].size() - 2);
@@ -25,8 +27,8 @@ TextureData parse_texture(const std::vector<std::string> &args) {
 	return texture;
 }
 
-float parse_scalefactor(const std::vector<std::string> &args) {
-	return std::stof(args[1]);
+float parse_scalefactor(const std::vector<std::string_view> &args) {
+	return util::parse_number<float>(args[1]);
 }
 
 } // namespace openage::renderer::resources::parser
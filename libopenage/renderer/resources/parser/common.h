@@ -1,9 +1,10 @@
-// Copyright 2023-2023 the openage authors. See copying.md for legal info.
+// Copyright 2023-2024 the openage authors. See copying.md for legal info.
 
 #pragma once
 
 #include <cstddef>
 #include <string>
+#include <string_view>
 #include <vector>
 
 /**
@@ -41,7 +42,7 @@ struct TextureData {
  *
  * @return Version number.
  */
-size_t parse_version(const std::vector<std::string> &args);
+size_t parse_version(const std::vector<std::string_view> &args);
 
 /**
  * Parse the texture attribute.
@@ -51,7 +52,7 @@ size_t parse_version(const std::vector<std::string> &args);
  *
  * @return Struct containing the attribute data.
  */
-TextureData parse_texture(const std::vector<std::string> &args);
+TextureData parse_texture(const std::vector<std::string_view> &args);
 
 /**
  * Parse the scalefactor attribute.
@@ -61,6 +62,6 @@ TextureData parse_texture(const std::vector<std::string> &args);
  *
  * @return Scalefactor value.
  */
-float parse_scalefactor(const std::vector<std::string> &args);
+float parse_scalefactor(const std::vector<std::string_view> &args);
 
 } // namespace openage::renderer::resources::parser
@@ -6,6 +6,7 @@
 #include <cstddef>
 #include <functional>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -33,17 +34,16 @@ namespace openage::renderer::resources::parser {
  *
  * @return Struct containing the attribute data.
  */
-blending_mask parse_mask(const std::vector<std::string> &args) {
+blending_mask parse_mask(const std::vector<std::string_view> &args) {
 	blending_mask mask;
 
-	auto dir = 0;
-	if (args[0].starts_with("0b")) {
-		// discard prefix because std::stoul doesn't understand binary prefixes
-		std::string strip = args[0].substr(2, args[2].size() - 1);
-		dir = std::stoul(strip, nullptr, 2);
+	size_t dir = 0;
+	if (args[1].starts_with("0b")) {
+		// discard prefix because std::from_chars doesn't understand binary prefixes
+		dir = util::parse_number<size_t>(args[1].substr(2), 2);
 	}
 	else {
-		dir = std::stoul(args[0]);
+		dir = util::parse_number<size_t>(args[1]);
 	}
 
 	if (dir > 255) [[unlikely]] {
@@ -52,8 +52,8 @@ blending_mask parse_mask(const std::vector<std::string> &args) {
 	}
 
 	mask.directions = dir;
-	mask.texture_id = std::stoul(args[1]);
-	mask.subtex_id = std::stoul(args[2]);
+	mask.texture_id = util::parse_number<size_t>(args[2]);
+	mask.subtex_id = util::parse_number<size_t>(args[3]);
 
 	return mask;
 }
@@ -67,14 +67,14 @@ BlendPatternInfo parse_blendmask_file(const util::Path &path,
 	}
 
 	auto file = path.open();
-	auto lines = file.get_lines();
+	std::string content = file.read();
 
 	float scalefactor = 1.0;
 	std::vector<TextureData> textures;
 	std::vector<blending_mask> masks;
 
-	auto keywordfuncs = std::unordered_map<std::string, std::function<void(const std::vector<std::string> &)>>{
-		std::make_pair("version", [&](const std::vector<std::string> &args) {
+	auto keywordfuncs = std::unordered_map<std::string_view, std::function<void(const std::vector<std::string_view> &)>>{
+		std::make_pair("version", [&](const std::vector<std::string_view> &args) {
 			size_t version_no = parse_version(args);
 
 			if (version_no != 2) {
@@ -84,32 +84,33 @@ BlendPatternInfo parse_blendmask_file(const util::Path &path,
 			                         << version_no << " not supported");
 			}
 		}),
-		std::make_pair("texture", [&](const std::vector<std::string> &args) {
+		std::make_pair("texture", [&](const std::vector<std::string_view> &args) {
 			textures.push_back(parse_texture(args));
 		}),
-		std::make_pair("scalefactor", [&](const std::vector<std::string> &args) {
+		std::make_pair("scalefactor", [&](const std::vector<std::string_view> &args) {
 			scalefactor = parse_scalefactor(args);
 		}),
-		std::make_pair("mask", [&](const std::vector<std::string> &args) {
+		std::make_pair("mask", [&](const std::vector<std::string_view> &args) {
 			masks.push_back(parse_mask(args));
 		})};
 
-	for (auto line : lines) {
+	std::vector<std::string_view> args;
+	for (std::string_view line : util::split_newline_view(content)) {
 		// Skip empty lines and comments
-		if (line.empty() || line.substr(0, 1) == "#") {
+		if (line.empty() || line.starts_with('#')) {
 			continue;
 		}
-		std::vector<std::string> args{util::split(line, ' ')};
+		util::split_view(line, ' ', args);
 
-		// TODO: Avoid double lookup with keywordfuncs.find(args[0])
-		if (not keywordfuncs.contains(args[0])) [[unlikely]] {
+		auto keywordfunc = keywordfuncs.find(args[0]);
+		if (keywordfunc == keywordfuncs.end()) [[unlikely]] {
 			throw Error(MSG(err) << "Reading .blmask file '"
 			                     << path.get_name()
 			                     << "' failed. Reason: Keyword "
 			                     << args[0] << " is not defined");
 		}
 
-		keywordfuncs[args[0]](args);
+		keywordfunc->second(args);
 	}
 
 	// Order masks by directions value
@@ -3,6 +3,8 @@
 #include "parse_blendtable.h"
 
 #include <functional>
+#include <string>
+#include <string_view>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -32,13 +34,12 @@ namespace openage::renderer::resources::parser {
  *
  * @return Struct containing the attribute data.
  */
-std::vector<size_t> parse_table(const std::vector<std::string> &lines) {
+std::vector<size_t> parse_table(const std::vector<std::string_view> &lines) {
 	std::vector<size_t> entries{};
 
 	for (size_t i = 1; i < lines.size() - 1; ++i) {
-		std::vector<std::string> line_args{util::split(lines[i], ' ')};
-		for (auto arg : line_args) {
-			entries.push_back(std::stoul(arg));
+		for (std::string_view arg : util::split_view(lines[i], ' ')) {
+			entries.push_back(util::parse_number<size_t>(arg));
 		}
 	}
 
@@ -53,13 +54,13 @@ std::vector<size_t> parse_table(const std::vector<std::string> &lines) {
  *
  * @return Struct containing the attribute data.
  */
-PatternData parse_pattern(const std::vector<std::string> &args) {
+PatternData parse_pattern(const std::vector<std::string_view> &args) {
 	// TODO: Splitting at the space char assumes that the path string contains no
 	// space. While the space char is not allowed because of nyan naming requirements,
 	// it should result in an error if wrongly used here.
 	PatternData pattern;
 
-	pattern.pattern_id = std::stoul(args[1]);
+	pattern.pattern_id = util::parse_number<size_t>(args[1]);
 
 	// Call substr() to get rid of the quotes
 	pattern.path = args[2].substr(1, args[2].size() - 2);
@@ -76,13 +77,15 @@ BlendTableInfo parse_blendtable_file(const util::Path &path,
 	}
 
 	auto file = path.open();
-	auto lines = file.get_lines();
+	std::string content = file.read();
+	auto line_splitter = util::split_newline_view(content);
+	std::vector<std::string_view> lines{line_splitter.begin(), line_splitter.end()};
 
 	std::vector<size_t> blendtable;
 	std::vector<PatternData> patterns;
 
-	auto keywordfuncs = std::unordered_map<std::string, std::function<void(const std::vector<std::string> &)>>{
-		std::make_pair("version", [&](const std::vector<std::string> &args) {
+	auto keywordfuncs = std::unordered_map<std::string_view, std::function<void(const std::vector<std::string_view> &)>>{
+		std::make_pair("version", [&](const std::vector<std::string_view> &args) {
 			size_t version_no = parse_version(args);
 
 			if (version_no != 1) {
@@ -92,23 +95,24 @@ BlendTableInfo parse_blendtable_file(const util::Path &path,
 			                         << version_no << " not supported");
 			}
 		}),
-		std::make_pair("blendtable", [&](const std::vector<std::string> &args) {
+		std::make_pair("blendtable", [&](const std::vector<std::string_view> &args) {
 			blendtable = parse_table(args);
 		}),
-		std::make_pair("pattern", [&](const std::vector<std::string> &args) {
+		std::make_pair("pattern", [&](const std::vector<std::string_view> &args) {
 			patterns.push_back(parse_pattern(args));
 		})};
 
+	std::vector<std::string_view> args;
 	for (size_t i = 0; i < lines.size(); ++i) {
 		// Skip empty lines and comments
 		auto line = lines[i];
-		if (line.empty() || line.substr(0, 1) == "#") {
+		if (line.empty() || line.starts_with('#')) {
 			continue;
 		}
-		std::vector<std::string> args{util::split(line, ' ')};
+		util::split_view(line, ' ', args);
 
-		// TODO: Avoid double lookup with keywordfuncs.find(args[0])
-		if (not keywordfuncs.contains(args[0])) [[unlikely]] {
+		auto keywordfunc = keywordfuncs.find(args[0]);
+		if (keywordfunc == keywordfuncs.end()) [[unlikely]] {
 			throw Error(MSG(err) << "Reading .bltable file '"
 			                     << path.get_name()
 			                     << "' failed. Reason: Keyword "
@@ -118,7 +122,7 @@ BlendTableInfo parse_blendtable_file(const util::Path &path,
 		if (args[0] == "blendtable") {
 			// read all lines of the matrix
 			// TODO: better parsing for matrix values
-			std::vector<std::string> mat_lines{};
+			std::vector<std::string_view> mat_lines{};
 			mat_lines.push_back(line);
 
 			while (not line.starts_with("]")) {
@@ -133,10 +137,10 @@ BlendTableInfo parse_blendtable_file(const util::Path &path,
 				mat_lines.push_back(line);
 			}
 
-			keywordfuncs[args[0]](mat_lines);
+			keywordfunc->second(mat_lines);
 		}
 		else {
-			keywordfuncs[args[0]](args);
+			keywordfunc->second(args);
 		}
 	}
 
@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <functional>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -30,8 +31,8 @@ namespace openage::renderer::resources::parser {
  *
  * @return Version number.
  */
-size_t parse_entries(const std::vector<std::string> &args) {
-	return std::stoul(args[1]);
+size_t parse_entries(const std::vector<std::string_view> &args) {
+	return util::parse_number<size_t>(args[1]);
 }
 
 /**
@@ -43,13 +44,12 @@ size_t parse_entries(const std::vector<std::string> &args) {
  *
  * @return Struct containing the attribute data.
  */
-std::vector<uint8_t> parse_colours(const std::vector<std::string> &lines) {
+std::vector<uint8_t> parse_colours(const std::vector<std::string_view> &lines) {
 	std::vector<uint8_t> entries{};
 
 	for (size_t i = 1; i < lines.size() - 1; ++i) {
-		std::vector<std::string> line_args{util::split(lines[i], ' ')};
-		for (auto arg : line_args) {
-			auto channel = std::stoul(arg);
+		for (std::string_view arg : util::split_view(lines[i], ' ')) {
+			auto channel = util::parse_number<size_t>(arg);
 
 			if (channel > 255) [[unlikely]] {
 				throw Error(MSG(err) << "Reading .opal file failed. Reason: "
@@ -71,13 +71,15 @@ PaletteInfo parse_palette_file(const util::Path &path) {
 	}
 
 	auto file = path.open();
-	auto lines = file.get_lines();
+	std::string content = file.read();
+	auto line_splitter = util::split_newline_view(content);
+	std::vector<std::string_view> lines{line_splitter.begin(), line_splitter.end()};
 
 	size_t entries = 0;
 	std::vector<uint8_t> colours;
 
-	auto keywordfuncs = std::unordered_map<std::string, std::function<void(const std::vector<std::string> &)>>{
-		std::make_pair("version", [&](const std::vector<std::string> &args) {
+	auto keywordfuncs = std::unordered_map<std::string_view, std::function<void(const std::vector<std::string_view> &)>>{
+		std::make_pair("version", [&](const std::vector<std::string_view> &args) {
 			size_t version_no = parse_version(args);
 
 			if (version_no != 1) {
@@ -87,23 +89,24 @@ PaletteInfo parse_palette_file(const util::Path &path) {
 			                         << version_no << " not supported");
 			}
 		}),
-		std::make_pair("entries", [&](const std::vector<std::string> &args) {
+		std::make_pair("entries", [&](const std::vector<std::string_view> &args) {
 			entries = parse_entries(args);
 		}),
-		std::make_pair("colours", [&](const std::vector<std::string> &args) {
+		std::make_pair("colours", [&](const std::vector<std::string_view> &args) {
 			colours = parse_colours(args);
 		})};
 
+	std::vector<std::string_view> args;
 	for (size_t i = 0; i < lines.size(); ++i) {
 		// Skip empty lines and comments
 		auto line = lines[i];
-		if (line.empty() || line.substr(0, 1) == "#") {
+		if (line.empty() || line.starts_with('#')) {
 			continue;
 		}
-		std::vector<std::string> args{util::split(line, ' ')};
+		util::split_view(line, ' ', args);
 
-		// TODO: Avoid double lookup with keywordfuncs.find(args[0])
-		if (not keywordfuncs.contains(args[0])) [[unlikely]] {
+		auto keywordfunc = keywordfuncs.find(args[0]);
+		if (keywordfunc == keywordfuncs.end()) [[unlikely]] {
 			throw Error(MSG(err) << "Reading .opal file '"
 			                     << path.get_name()
 			                     << "' failed. Reason: Keyword "
@@ -113,7 +116,7 @@ PaletteInfo parse_palette_file(const util::Path &path) {
 		if (args[0] == "colours") {
 			// read all lines of the matrix
 			// TODO: better parsing for matrix values
-			std::vector<std::string> mat_lines{};
+			std::vector<std::string_view> mat_lines{};
 			mat_lines.push_back(line);
 
 			while (not line.starts_with("]")) {
@@ -128,10 +131,10 @@ PaletteInfo parse_palette_file(const util::Path &path) {
 				mat_lines.push_back(line);
 			}
 
-			keywordfuncs[args[0]](mat_lines);
+			keywordfunc->second(mat_lines);
 		}
 		else {
-			keywordfuncs[args[0]](args);
+			keywordfunc->second(args);
 		}
 	}
 
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <functional>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -35,14 +36,23 @@ namespace openage::renderer::resources::parser {
  *
  * @return Struct containing the attribute data.
  */
-LayerData parse_layer(const std::vector<std::string> &args) {
+LayerData parse_layer(const std::vector<std::string_view> &args) {
 	LayerData layer;
 
-	layer.layer_id = std::stoul(args[1]);
+	layer.layer_id = util::parse_number<size_t>(args[1]);
 
 	// Optional arguments
-	auto keywordfuncs = std::unordered_map<std::string, std::function<void(std::vector<std::string>)>>{
-		std::make_pair("mode", [&](const std::vector<std::string> &keywordargs) {
+	std::vector<std::string_view> keywordargs;
+	for (size_t i = 2; i < args.size(); ++i) {
+		util::split_view(args[i], '=', keywordargs);
+
+		if (keywordargs.size() != 2) [[unlikely]] {
+			throw Error(MSG(err) << "Keyword argument "
+			                     << args[i]
+			                     << " of 'layer' attribute is malformed");
+		}
+
+		if (keywordargs[0] == "mode") {
 			if (keywordargs[1] == "off") {
 				layer.mode = display_mode::OFF;
 			}
@@ -52,28 +62,21 @@ LayerData parse_layer(const std::vector<std::string> &args) {
 			else if (keywordargs[1] == "loop") {
 				layer.mode = display_mode::LOOP;
 			}
-		}),
-		std::make_pair("position", [&](const std::vector<std::string> &keywordargs) {
-			layer.position = std::stoul(keywordargs[1]);
-		}),
-		std::make_pair("time_per_frame", [&](const std::vector<std::string> &keywordargs) {
-			layer.time_per_frame = std::stof(keywordargs[1]);
-		}),
-		std::make_pair("replay_delay", [&](const std::vector<std::string> &keywordargs) {
-			layer.replay_delay = std::stof(keywordargs[1]);
-		})};
-
-	for (size_t i = 2; i < args.size(); ++i) {
-		std::vector<std::string> keywordargs{util::split(args[i], '=')};
-
-		// TODO: Avoid double lookup with keywordfuncs.find(args[0])
-		if (not keywordfuncs.contains(keywordargs[0])) [[unlikely]] {
+		}
+		else if (keywordargs[0] == "position") {
+			layer.position = util::parse_number<size_t>(keywordargs[1]);
+		}
+		else if (keywordargs[0] == "time_per_frame") {
+			layer.time_per_frame = util::parse_number<float>(keywordargs[1]);
+		}
+		else if (keywordargs[0] == "replay_delay") {
+			layer.replay_delay = util::parse_number<float>(keywordargs[1]);
+		}
+		else [[unlikely]] {
 			throw Error(MSG(err) << "Keyword argument "
 			                     << keywordargs[0]
 			                     << " of 'layer' attribute is not defined");
 		}
-
-		keywordfuncs[keywordargs[0]](keywordargs);
 	}
 
 	return layer;
@@ -87,28 +90,30 @@ LayerData parse_layer(const std::vector<std::string> &args) {
  *
  * @return Struct containing the attribute data.
  */
-AngleData parse_angle(const std::vector<std::string> &args) {
+AngleData parse_angle(const std::vector<std::string_view> &args) {
 	AngleData angle;
 
-	angle.degree = std::stoul(args[1]);
+	angle.degree = util::parse_number<size_t>(args[1]);
 
 	// Optional arguments
-	auto keywordfuncs = std::unordered_map<std::string, std::function<void(std::vector<std::string>)>>{
-		std::make_pair("mirror_from", [&](const std::vector<std::string> &keywordargs) {
-			angle.mirror_from = std::stoul(keywordargs[1]);
-		})};
-
+	std::vector<std::string_view> keywordargs;
 	for (size_t i = 2; i < args.size(); ++i) {
-		std::vector<std::string> keywordargs{util::split(args[i], '=')};
+		util::split_view(args[i], '=', keywordargs);
+
+		if (keywordargs.size() != 2) [[unlikely]] {
+			throw Error(MSG(err) << "Keyword argument "
+			                     << args[i]
+			                     << " of 'angle' attribute is malformed");
+		}
 
-		// TODO: Avoid double lookup with keywordfuncs.find(args[0])
-		if (not keywordfuncs.contains(keywordargs[0])) [[unlikely]] {
+		if (keywordargs[0] == "mirror_from") {
+			angle.mirror_from = util::parse_number<int>(keywordargs[1]);
+		}
+		else [[unlikely]] {
 			throw Error(MSG(err) << "Keyword argument "
 			                     << keywordargs[0]
 			                     << " of 'angle' attribute is not defined");
 		}
-
-		keywordfuncs[keywordargs[0]](keywordargs);
 	}
 
 	return angle;
@@ -122,14 +127,14 @@ AngleData parse_angle(const std::vector<std::string> &args) {
  *
  * @return Struct containing the attribute data.
  */
-FrameData parse_frame(const std::vector<std::string> &args) {
+FrameData parse_frame(const std::vector<std::string_view> &args) {
 	FrameData frame;
 
-	frame.index = std::stoul(args[1]);
-	frame.angle = std::stoul(args[2]);
-	frame.layer_id = std::stoul(args[3]);
-	frame.texture_id = std::stoul(args[4]);
-	frame.subtex_id = std::stoul(args[5]);
+	frame.index = util::parse_number<size_t>(args[1]);
+	frame.angle = util::parse_number<size_t>(args[2]);
+	frame.layer_id = util::parse_number<size_t>(args[3]);
+	frame.texture_id = util::parse_number<size_t>(args[4]);
+	frame.subtex_id = util::parse_number<size_t>(args[5]);
 
 	return frame;
 }
@@ -143,7 +148,7 @@ Animation2dInfo parse_sprite_file(const util::Path &path,
 	}
 
 	auto file = path.open();
-	auto lines = file.get_lines();
+	std::string content = file.read();
 
 	float scalefactor = 1.0;
 	std::vector<TextureData> textures;
@@ -156,8 +161,8 @@ Animation2dInfo parse_sprite_file(const util::Path &path,
 	// Map frame data to angle
 	std::unordered_map<size_t, std::vector<FrameData>> frames;
 
-	auto keywordfuncs = std::unordered_map<std::string, std::function<void(const std::vector<std::string> &)>>{
-		std::make_pair("version", [&](const std::vector<std::string> &args) {
+	auto keywordfuncs = std::unordered_map<std::string_view, std::function<void(const std::vector<std::string_view> &)>>{
+		std::make_pair("version", [&](const std::vector<std::string_view> &args) {
 			size_t version_no = parse_version(args);
 
 			if (version_no != 2) {
@@ -167,19 +172,19 @@ Animation2dInfo parse_sprite_file(const util::Path &path,
 			                         << version_no << " not supported");
 			}
 		}),
-		std::make_pair("texture", [&](const std::vector<std::string> &args) {
+		std::make_pair("texture", [&](const std::vector<std::string_view> &args) {
 			textures.push_back(parse_texture(args));
 		}),
-		std::make_pair("scalefactor", [&](const std::vector<std::string> &args) {
+		std::make_pair("scalefactor", [&](const std::vector<std::string_view> &args) {
 			scalefactor = parse_scalefactor(args);
 		}),
-		std::make_pair("layer", [&](const std::vector<std::string> &args) {
+		std::make_pair("layer", [&](const std::vector<std::string_view> &args) {
 			layers.push_back(parse_layer(args));
 		}),
-		std::make_pair("angle", [&](const std::vector<std::string> &args) {
+		std::make_pair("angle", [&](const std::vector<std::string_view> &args) {
 			angles.push_back(parse_angle(args));
 		}),
-		std::make_pair("frame", [&](const std::vector<std::string> &args) {
+		std::make_pair("frame", [&](const std::vector<std::string_view> &args) {
 			auto frame = parse_frame(args);
 			if (frames.count(frame.angle) == 0) {
 				std::vector<FrameData> angle_frames{};
@@ -194,22 +199,23 @@ Animation2dInfo parse_sprite_file(const util::Path &path,
 			}
 		})};
 
-	for (auto line : lines) {
+	std::vector<std::string_view> args;
+	for (std::string_view line : util::split_newline_view(content)) {
 		// Skip empty lines and comments
-		if (line.empty() || line.substr(0, 1) == "#") {
+		if (line.empty() || line.starts_with('#')) {
 			continue;
 		}
-		std::vector<std::string> args{util::split(line, ' ')};
+		util::split_view(line, ' ', args);
 
-		// TODO: Avoid double lookup with keywordfuncs.find(args[0])
-		if (not keywordfuncs.contains(args[0])) [[unlikely]] {
+		auto keywordfunc = keywordfuncs.find(args[0]);
+		if (keywordfunc == keywordfuncs.end()) [[unlikely]] {
 			throw Error(MSG(err) << "Reading .sprite file '"
 			                     << path.get_name()
 			                     << "' failed. Reason: Keyword "
 			                     << args[0] << " is not defined");
 		}
 
-		keywordfuncs[args[0]](args);
+		keywordfunc->second(args);
 	}
 
 	// Order frames by index
@@ -5,6 +5,8 @@
 #include <algorithm>
 #include <cstddef>
 #include <functional>
+#include <string>
+#include <string_view>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -36,13 +38,13 @@ namespace openage::renderer::resources::parser {
  *
  * @return Struct containing the attribute data.
  */
-BlendtableData parse_blendtable(const std::vector<std::string> &args) {
+BlendtableData parse_blendtable(const std::vector<std::string_view> &args) {
 	// TODO: Splitting at the space char assumes that the path string contains no
 	// space. While the space char is not allowed because of nyan naming requirements,
 	// it should result in an error if wrongly used here.
 	BlendtableData blendtable;
 
-	blendtable.table_id = std::stoul(args[1]);
+	blendtable.table_id = util::parse_number<size_t>(args[1]);
 
 	// Call substr() to get rid of the quotes
 	blendtable.path = args[2].substr(1, args[2].size() - 2);
@@ -58,42 +60,44 @@ BlendtableData parse_blendtable(const std::vector<std::string> &args) {
  *
  * @return Struct containing the attribute data.
  */
-TerrainLayerData parse_terrain_layer(const std::vector<std::string> &args) {
+TerrainLayerData parse_terrain_layer(const std::vector<std::string_view> &args) {
 	TerrainLayerData layer;
 
-	layer.layer_id = std::stoul(args[1]);
+	layer.layer_id = util::parse_number<size_t>(args[1]);
 
 	// Optional arguments
-	auto keywordfuncs = std::unordered_map<std::string, std::function<void(const std::vector<std::string> &)>>{
-		std::make_pair("mode", [&](const std::vector<std::string> &keywordargs) {
+	std::vector<std::string_view> keywordargs;
+	for (size_t i = 2; i < args.size(); ++i) {
+		util::split_view(args[i], '=', keywordargs);
+
+		if (keywordargs.size() != 2) [[unlikely]] {
+			throw Error(MSG(err) << "Keyword argument "
+			                     << args[i]
+			                     << " of 'layer' attribute is malformed");
+		}
+
+		if (keywordargs[0] == "mode") {
 			if (keywordargs[1] == "off") {
 				layer.mode = terrain_display_mode::OFF;
 			}
 			else if (keywordargs[1] == "loop") {
 				layer.mode = terrain_display_mode::LOOP;
 			}
-		}),
-		std::make_pair("position", [&](const std::vector<std::string> &keywordargs) {
-			layer.position = std::stoul(keywordargs[1]);
-		}),
-		std::make_pair("time_per_frame", [&](const std::vector<std::string> &keywordargs) {
-			layer.time_per_frame = std::stof(keywordargs[1]);
-		}),
-		std::make_pair("replay_delay", [&](const std::vector<std::string> &keywordargs) {
-			layer.replay_delay = std::stof(keywordargs[1]);
-		})};
-
-	for (size_t i = 2; i < args.size(); ++i) {
-		std::vector<std::string> keywordargs{util::split(args[i], '=')};
-
-		// TODO: Avoid double lookup with keywordfuncs.find(args[0])
-		if (not keywordfuncs.contains(keywordargs[0])) [[unlikely]] {
+		}
+		else if (keywordargs[0] == "position") {
+			layer.position = util::parse_number<size_t>(keywordargs[1]);
+		}
+		else if (keywordargs[0] == "time_per_frame") {
+			layer.time_per_frame = util::parse_number<float>(keywordargs[1]);
+		}
+		else if (keywordargs[0] == "replay_delay") {
+			layer.replay_delay = util::parse_number<float>(keywordargs[1]);
+		}
+		else [[unlikely]] {
 			throw Error(MSG(err) << "Keyword argument "
 			                     << keywordargs[0]
 			                     << " of 'layer' attribute is not defined");
 		}
-
-		keywordfuncs[keywordargs[0]](keywordargs);
 	}
 
 	return layer;
@@ -107,33 +111,36 @@ TerrainLayerData parse_terrain_layer(const std::vector<std::string> &args) {
  *
  * @return Struct containing the attribute data.
  */
-TerrainFrameData parse_terrain_frame(const std::vector<std::string> &args) {
+TerrainFrameData parse_terrain_frame(const std::vector<std::string_view> &args) {
 	TerrainFrameData frame;
 
-	frame.index = std::stoul(args[1]);
-	frame.layer_id = std::stoul(args[2]);
-	frame.texture_id = std::stoul(args[3]);
-	frame.subtex_id = std::stoul(args[4]);
+	frame.index = util::parse_number<size_t>(args[1]);
+	frame.layer_id = util::parse_number<size_t>(args[2]);
+	frame.texture_id = util::parse_number<size_t>(args[3]);
+	frame.subtex_id = util::parse_number<size_t>(args[4]);
 
-	auto keywordfuncs = std::unordered_map<std::string, std::function<void(const std::vector<std::string> &)>>{
-		std::make_pair("priority", [&](const std::vector<std::string> &keywordargs) {
-			frame.priority = std::stoul(keywordargs[1]);
-		}),
-		std::make_pair("blend_mode", [&](const std::vector<std::string> &keywordargs) {
-			frame.blend_mode = std::stoul(keywordargs[1]);
-		})};
+	// Optional arguments
+	std::vector<std::string_view> keywordargs;
+	for (size_t i = 5; i < args.size(); ++i) {
+		util::split_view(args[i], '=', keywordargs);
 
-	for (size_t i = 4; i < args.size() - 1; ++i) {
-		std::vector<std::string> keywordargs{util::split(args[i], '=')};
+		if (keywordargs.size() != 2) [[unlikely]] {
+			throw Error(MSG(err) << "Keyword argument "
+			                     << args[i]
+			                     << " of 'frame' attribute is malformed");
+		}
 
-		// TODO: Avoid double lookup with keywordfuncs.find(args[0])
-		if (not keywordfuncs.contains(keywordargs[0])) [[unlikely]] {
+		if (keywordargs[0] == "priority") {
+			frame.priority = util::parse_number<size_t>(keywordargs[1]);
+		}
+		else if (keywordargs[0] == "blend_mode") {
+			frame.blend_mode = util::parse_number<size_t>(keywordargs[1]);
+		}
+		else [[unlikely]] {
 			throw Error(MSG(err) << "Keyword argument "
 			                     << keywordargs[0]
 			                     << " of 'frame' attribute is not defined");
 		}
-
-		keywordfuncs[keywordargs[0]](keywordargs);
 	}
 
 	return frame;
@@ -148,7 +155,7 @@ TerrainInfo parse_terrain_file(const util::Path &path,
 	}
 
 	auto file = path.open();
-	auto lines = file.get_lines();
+	std::string content = file.read();
 
 	float scalefactor = 1.0;
 	std::vector<TextureData> textures;
@@ -161,8 +168,8 @@ TerrainInfo parse_terrain_file(const util::Path &path,
 	// Map frame data to layer
 	std::unordered_map<size_t, std::vector<TerrainFrameData>> frames;
 
-	auto keywordfuncs = std::unordered_map<std::string, std::function<void(const std::vector<std::string> &)>>{
-		std::make_pair("version", [&](const std::vector<std::string> &args) {
+	auto keywordfuncs = std::unordered_map<std::string_view, std::function<void(const std::vector<std::string_view> &)>>{
+		std::make_pair("version", [&](const std::vector<std::string_view> &args) {
 			size_t version_no = parse_version(args);
 
 			if (version_no != 2) {
@@ -172,19 +179,19 @@ TerrainInfo parse_terrain_file(const util::Path &path,
 			                         << version_no << " not supported");
 			}
 		}),
-		std::make_pair("texture", [&](const std::vector<std::string> &args) {
+		std::make_pair("texture", [&](const std::vector<std::string_view> &args) {
 			textures.push_back(parse_texture(args));
 		}),
-		std::make_pair("blendtable", [&](const std::vector<std::string> &args) {
+		std::make_pair("blendtable", [&](const std::vector<std::string_view> &args) {
 			blendtable = parse_blendtable(args);
 		}),
-		std::make_pair("scalefactor", [&](const std::vector<std::string> &args) {
+		std::make_pair("scalefactor", [&](const std::vector<std::string_view> &args) {
 			scalefactor = parse_scalefactor(args);
 		}),
-		std::make_pair("layer", [&](const std::vector<std::string> &args) {
+		std::make_pair("layer", [&](const std::vector<std::string_view> &args) {
 			layers.push_back(parse_terrain_layer(args));
 		}),
-		std::make_pair("frame", [&](const std::vector<std::string> &args) {
+		std::make_pair("frame", [&](const std::vector<std::string_view> &args) {
 			auto frame = parse_terrain_frame(args);
 			if (frames.count(frame.layer_id) == 0) {
 				std::vector<TerrainFrameData> layer_frames{};
@@ -199,22 +206,23 @@ TerrainInfo parse_terrain_file(const util::Path &path,
 			}
 		})};
 
-	for (auto line : lines) {
+	std::vector<std::string_view> args;
+	for (std::string_view line : util::split_newline_view(content)) {
 		// Skip empty lines and comments
-		if (line.empty() || line.substr(0, 1) == "#") {
+		if (line.empty() || line.starts_with('#')) {
 			continue;
 		}
-		std::vector<std::string> args{util::split(line, ' ')};
+		util::split_view(line, ' ', args);
 
-		// TODO: Avoid double lookup with keywordfuncs.find(args[0])
-		if (not keywordfuncs.contains(args[0])) [[unlikely]] {
+		auto keywordfunc = keywordfuncs.find(args[0]);
+		if (keywordfunc == keywordfuncs.end()) [[unlikely]] {
 			throw Error(MSG(err) << "Reading .terrain file '"
 			                     << path.get_name()
 			                     << "' failed. Reason: Keyword "
 			                     << args[0] << " is not defined");
 		}
 
-		keywordfuncs[args[0]](args);
+		keywordfunc->second(args);
 	}
 
 	// Order frames by index
@@ -6,6 +6,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -50,13 +51,13 @@ static constexpr size_t guess_row_alignment(size_t width) {
  *
  * @return Path to the image resource.
  */
-std::string parse_imagefile(const std::vector<std::string> &args) {
+std::string parse_imagefile(const std::vector<std::string_view> &args) {
 	// TODO: Splitting at the space char assumes that the path string contains no
 	// space. While the space char is not allowed because of nyan naming requirements,
 	// it should result in an error if wrongly used here.
 
 	// Call substr() to get rid of the quotes
-	return args[1].substr(1, args[1].size() - 2);
+	return std::string{args[1].substr(1, args[1].size() - 2)};
 }
 
 /**
@@ -67,11 +68,11 @@ std::string parse_imagefile(const std::vector<std::string> &args) {
  *
  * @return Struct containing the attribute data.
  */
-SizeData parse_size(const std::vector<std::string> &args) {
+SizeData parse_size(const std::vector<std::string_view> &args) {
 	SizeData size;
 
-	size.width = std::stoul(args[1]);
-	size.height = std::stoul(args[2]);
+	size.width = util::parse_number<size_t>(args[1]);
+	size.height = util::parse_number<size_t>(args[2]);
 
 	return size;
 }
@@ -84,35 +85,36 @@ SizeData parse_size(const std::vector<std::string> &args) {
  *
  * @return Struct containing the attribute data.
  */
-PixelFormatData parse_pxformat(const std::vector<std::string> &args) {
+PixelFormatData parse_pxformat(const std::vector<std::string_view> &args) {
 	PixelFormatData pxformat;
 
 	// Only accepted format
 	pxformat.format = pixel_format::rgba8;
 
 	// Optional arguments
-	auto keywordfuncs = std::unordered_map<std::string, std::function<void(std::vector<std::string>)>>{
-		std::make_pair("cbits", [&](std::vector<std::string> keywordargs) {
+	std::vector<std::string_view> keywordargs;
+	for (size_t i = 2; i < args.size(); ++i) {
+		util::split_view(args[i], '=', keywordargs);
+
+		if (keywordargs.size() != 2) [[unlikely]] {
+			throw Error(MSG(err) << "Keyword argument "
+			                     << args[i]
+			                     << " of 'pxformat' attribute is malformed");
+		}
+
+		if (keywordargs[0] == "cbits") {
 			if (keywordargs[1] == "True") {
 				pxformat.cbits = true;
 			}
 			else if (keywordargs[1] == "False") {
 				pxformat.cbits = false;
 			}
-		})};
-
-	// Optional arguments
-	for (size_t i = 2; i < args.size(); ++i) {
-		std::vector<std::string> keywordargs{util::split(args[i], '=')};
-
-		// TODO: Avoid double lookup with keywordfuncs.find(args[0])
-		if (not keywordfuncs.contains(keywordargs[0])) [[unlikely]] {
+		}
+		else [[unlikely]] {
 			throw Error(MSG(err) << "Keyword argument "
 			                     << keywordargs[0]
 			                     << " of 'pxformat' attribute is not defined");
 		}
-
-		keywordfuncs[keywordargs[0]](keywordargs);
 	}
 
 	return pxformat;
@@ -126,15 +128,15 @@ PixelFormatData parse_pxformat(const std::vector<std::string> &args) {
  *
  * @return Struct containing the attribute data.
  */
-SubtextureData parse_subtex(const std::vector<std::string> &args) {
+SubtextureData parse_subtex(const std::vector<std::string_view> &args) {
 	SubtextureData subtex;
 
-	subtex.xpos = std::stoi(args[1]);
-	subtex.ypos = std::stoi(args[2]);
-	subtex.xsize = std::stoul(args[3]);
-	subtex.ysize = std::stoul(args[4]);
-	subtex.xanchor = std::stoi(args[5]);
-	subtex.yanchor = std::stoi(args[6]);
+	subtex.xpos = util::parse_number<size_t>(args[1]);
+	subtex.ypos = util::parse_number<size_t>(args[2]);
+	subtex.xsize = util::parse_number<size_t>(args[3]);
+	subtex.ysize = util::parse_number<size_t>(args[4]);
+	subtex.xanchor = util::parse_number<int>(args[5]);
+	subtex.yanchor = util::parse_number<int>(args[6]);
 
 	return subtex;
 }
@@ -147,15 +149,15 @@ Texture2dInfo parse_texture_file(const util::Path &path) {
 	}
 
 	auto file = path.open();
-	auto lines = file.get_lines();
+	std::string content = file.read();
 
 	std::string imagefile;
 	SizeData size;
 	PixelFormatData pxformat;
 	std::vector<SubtextureData> subtexs;
 
-	auto keywordfuncs = std::unordered_map<std::string, std::function<void(const std::vector<std::string> &)>>{
-		std::make_pair("version", [&](const std::vector<std::string> &args) {
+	auto keywordfuncs = std::unordered_map<std::string_view, std::function<void(const std::vector<std::string_view> &)>>{
+		std::make_pair("version", [&](const std::vector<std::string_view> &args) {
 			size_t version_no = parse_version(args);
 
 			if (version_no != 1) {
@@ -165,34 +167,35 @@ Texture2dInfo parse_texture_file(const util::Path &path) {
 			                         << version_no << " not supported");
 			}
 		}),
-		std::make_pair("imagefile", [&](const std::vector<std::string> &args) {
+		std::make_pair("imagefile", [&](const std::vector<std::string_view> &args) {
 			imagefile = parse_imagefile(args);
 		}),
-		std::make_pair("size", [&](const std::vector<std::string> &args) {
+		std::make_pair("size", [&](const std::vector<std::string_view> &args) {
 			size = parse_size(args);
 		}),
-		std::make_pair("pxformat", [&](const std::vector<std::string> &args) {
+		std::make_pair("pxformat", [&](const std::vector<std::string_view> &args) {
 			pxformat = parse_pxformat(args);
 		}),
-		std::make_pair("subtex", [&](const std::vector<std::string> &args) {
+		std::make_pair("subtex", [&](const std::vector<std::string_view> &args) {
 			subtexs.push_back(parse_subtex(args));
 		})};
 
-	for (auto line : lines) {
+	std::vector<std::string_view> args;
+	for (std::string_view line : util::split_newline_view(content)) {
 		// Skip empty lines and comments
-		if (line.empty() || line.substr(0, 1) == "#") {
+		if (line.empty() || line.starts_with('#')) {
 			continue;
 		}
-		std::vector<std::string> args{util::split(line, ' ')};
+		util::split_view(line, ' ', args);
 
-		// TODO: Avoid double lookup with keywordfuncs.find(args[0])
-		if (not keywordfuncs.contains(args[0])) [[unlikely]] {
+		auto keywordfunc = keywordfuncs.find(args[0]);
+		if (keywordfunc == keywordfuncs.end()) [[unlikely]] {
 			throw Error(MSG(err) << "Reading .texture file '"
 			                     << path.get_name()
 			                     << "' failed. Reason: Keyword "
 			                     << args[0] << " is not defined");
 		}
-		keywordfuncs[args[0]](args);
+		keywordfunc->second(args);
 	}
 
 	std::vector<Texture2dSubInfo> subinfos;
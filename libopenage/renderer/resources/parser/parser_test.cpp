@@ -0,0 +1,204 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "error/error.h"
+#include "log/log.h"
+#include "renderer/resources/animation/angle_info.h"
+#include "renderer/resources/animation/animation_info.h"
+#include "renderer/resources/animation/layer_info.h"
+#include "renderer/resources/assets/cache.h"
+#include "renderer/resources/parser/parse_blendmask.h"
+#include "renderer/resources/parser/parse_sprite.h"
+#include "renderer/resources/parser/parse_terrain.h"
+#include "renderer/resources/terrain/blendpattern_info.h"
+#include "renderer/resources/terrain/layer_info.h"
+#include "renderer/resources/terrain/terrain_info.h"
+#include "renderer/resources/texture_info.h"
+#include "testing/testing.h"
+#include "util/fslike/directory.h"
+#include "util/path.h"
+
+
+namespace openage::renderer::resources::parser::tests {
+
+namespace {
+
+/**
+ * Temporary directory with generated resource files.
+ */
+class Corpus {
+public:
+	explicit Corpus(const std::string &name) :
+		dir{std::filesystem::temp_directory_path() / name} {
+		std::filesystem::remove_all(this->dir);
+		std::filesystem::create_directories(this->dir);
+
+		this->root = util::Path{std::make_shared<util::fslike::Directory>(this->dir.string()), {}};
+	}
+
+	~Corpus() {
+		std::error_code ec;
+		std::filesystem::remove_all(this->dir, ec);
+	}
+
+	util::Path write(const std::string &filename, const std::string &content) {
+		std::ofstream out{this->dir / filename, std::ios::binary};
+		out << content;
+		this->bytes += content.size();
+		return this->root[filename];
+	}
+
+	/// total size of all written files
+	size_t bytes = 0;
+
+private:
+	std::filesystem::path dir;
+	util::Path root;
+};
+
+
+std::string make_texture(size_t subtex_count) {
+	std::string txt = "# generated texture\n"
+	                  "version 1\n"
+	                  "imagefile \"corpus.png\"\n"
+	                  "size 2048 2048\n"
+	                  "pxformat rgba8 cbits=True\n";
+	for (size_t i = 0; i < subtex_count; ++i) {
+		txt += "subtex " + std::to_string((i % 32) * 64) + " " + std::to_string((i / 32) * 64)
+		       + " 64 64 32 48\n";
+	}
+	return txt;
+}
+
+
+/**
+ * Sprite with 5 angles that have frames and 3 mirrored angles.
+ */
+std::string make_sprite(size_t frame_count) {
+	std::string txt = "# generated sprite\n"
+	                  "version 2\n"
+	                  "texture 0 \"corpus.texture\"\n"
+	                  "scalefactor 1.0\n"
+	                  "layer 0 mode=loop position=0 time_per_frame=0.125 replay_delay=0.5\n";
+	for (size_t degree = 0; degree <= 180; degree += 45) {
+		txt += "angle " + std::to_string(degree) + "\n";
+	}
+	txt += "angle 225 mirror_from=135\r\n"
+	       "angle 270 mirror_from=90\r\n"
+	       "angle 315 mirror_from=45\r\n";
+	for (size_t degree = 0; degree <= 180; degree += 45) {
+		for (size_t i = 0; i < frame_count; ++i) {
+			txt += "frame " + std::to_string(i) + " " + std::to_string(degree) + " 0 0 "
+			       + std::to_string(i) + "\n";
+		}
+	}
+	return txt;
+}
+
+
+std::string make_terrain(size_t frame_count) {
+	std::string txt = "# generated terrain\n"
+	                  "version 2\n"
+	                  "texture 0 \"corpus.texture\"\n"
+	                  "scalefactor 1.0\n"
+	                  "layer 0 mode=loop position=0 time_per_frame=0.125\n";
+	for (size_t i = 0; i < frame_count; ++i) {
+		txt += "frame " + std::to_string(i) + " 0 0 " + std::to_string(i)
+		       + " priority=10 blend_mode=2\n";
+	}
+	return txt;
+}
+
+} // namespace
+
+
+void parser() {
+	Corpus corpus{"openage_parser_test"};
+	corpus.write("corpus.texture", make_texture(64));
+
+	auto sprite_path = corpus.write("test.sprite", make_sprite(20));
+	auto sprite = parse_sprite_file(sprite_path);
+	TESTEQUALS(sprite.get_scalefactor(), 1.0f);
+	TESTEQUALS(sprite.get_texture_count(), 1u);
+	TESTEQUALS(sprite.get_layer_count(), 1u);
+	TESTEQUALS(sprite.get_layer(0).get_angle_count(), 8u);
+	TESTEQUALS(sprite.get_layer(0).get_angle(0)->get_frame_count(), 20u);
+	TESTEQUALS(sprite.get_texture(0)->get_subtex_count(), 64u);
+
+	auto terrain_path = corpus.write("test.terrain", make_terrain(20));
+	auto terrain = parse_terrain_file(terrain_path);
+	TESTEQUALS(terrain.get_layer_count(), 1u);
+	TESTEQUALS(terrain.get_layer(0).get_frame_count(), 20u);
+
+	auto mask_path = corpus.write("test.blmask",
+	                              "version 2\n"
+	                              "texture 0 \"corpus.texture\"\n"
+	                              "scalefactor 1.0\n"
+	                              "mask 0b00001111 0 1\n"
+	                              "mask 255 0 2\n");
+	auto mask = parse_blendmask_file(mask_path);
+	TESTEQUALS(mask.get_mask_count(), 2u);
+
+	// malformed values
+	auto bad_number = corpus.write("bad_number.sprite", "version 2x\n");
+	TESTTHROWS(parse_sprite_file(bad_number));
+	auto bad_keyword = corpus.write("bad_keyword.terrain",
+	                                "version 2\n"
+	                                "layer 0 speed=2\n");
+	TESTTHROWS(parse_terrain_file(bad_keyword));
+	auto bad_mask = corpus.write("bad_mask.blmask",
+	                             "version 2\n"
+	                             "mask 256 0 1\n");
+	TESTTHROWS(parse_blendmask_file(bad_mask));
+}
+
+
+void parser_benchmark() {
+	constexpr size_t file_count = 200;
+	constexpr size_t frame_count = 30;
+	constexpr int rounds = 10;
+
+	Corpus corpus{"openage_parser_benchmark"};
+	corpus.write("corpus.texture", make_texture(frame_count));
+
+	std::vector<util::Path> sprites;
+	std::vector<util::Path> terrains;
+	for (size_t i = 0; i < file_count; ++i) {
+		sprites.push_back(corpus.write("unit" + std::to_string(i) + ".sprite", make_sprite(frame_count)));
+		terrains.push_back(corpus.write("terrain" + std::to_string(i) + ".terrain", make_terrain(frame_count)));
+	}
+
+	log::log(INFO << "parser benchmark: " << 2 * file_count << " files, "
+	              << corpus.bytes << " bytes");
+
+	// the texture is shared by all files, so it is only parsed once
+	auto cache = std::make_shared<AssetCache>();
+
+	size_t layers = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < rounds; ++r) {
+		for (size_t i = 0; i < file_count; ++i) {
+			layers += parse_sprite_file(sprites[i], cache).get_layer_count();
+			layers += parse_terrain_file(terrains[i], cache).get_layer_count();
+		}
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	if (layers != 2 * file_count * rounds) {
+		throw Error{ERR << "parser benchmark: parsed " << layers << " layers"};
+	}
+
+	double files = 2.0 * file_count * rounds;
+	double mbytes = static_cast<double>(corpus.bytes) * rounds / (1024 * 1024);
+	log::log(INFO << "parser benchmark: " << files / elapsed.count() << " files/s, "
+	              << mbytes / elapsed.count() << " MB/s");
+}
+
+} // namespace openage::renderer::resources::parser::tests
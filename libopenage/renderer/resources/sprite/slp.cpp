@@ -0,0 +1,455 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "slp.h"
+
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "error/error.h"
+#include "log/message.h"
+
+
+namespace openage::renderer::resources::sprite {
+
+namespace {
+
+/// size of the version string
+constexpr size_t slp_version_size = 4;
+
+/// size of the file header after the version string (same for all versions)
+constexpr size_t slp_header_size = 28;
+
+/// size of one slp_frame_info struct
+constexpr size_t slp_frame_info_size = 32;
+
+/// row edge value of completely transparent rows
+constexpr uint16_t slp_transparent_row = 0x8000;
+
+
+/**
+ * The draw amount may be encoded into the upper bits of the command.
+ * If they are zero, the amount is stored in the next byte.
+ */
+inline size_t cmd_or_next(SpriteReader &reader, uint8_t cmd, unsigned int n) {
+	uint8_t packed = cmd >> n;
+	if (packed != 0) {
+		return packed;
+	}
+	return reader.u8();
+}
+
+
+inline SpritePixel make_pixel(sprite_pixel_type type, uint8_t value = 0) {
+	return SpritePixel{type, {value, 0, 0, 0}};
+}
+
+
+/**
+ * Read a true color pixel stored as BGRA.
+ */
+inline SpritePixel read_bgra(SpriteReader &reader, bool premultiplied = false) {
+	uint8_t b = reader.u8();
+	uint8_t g = reader.u8();
+	uint8_t r = reader.u8();
+	uint8_t a = reader.u8();
+	return SpritePixel{sprite_pixel_type::rgba, {r, g, b, premultiplied ? static_cast<uint8_t>(255 - a) : uint8_t{255}}};
+}
+
+
+/**
+ * Handle the extended (0x0E) commands shared by all main graphics encodings.
+ *
+ * @return false if the command is not an outline command.
+ */
+inline bool draw_outline_cmd(SpriteReader &reader, RowWriter &row, uint8_t cmd) {
+	switch (cmd & 0xF0) {
+	case 0x00: // render hint: only draw the next command if not flipped
+	case 0x10: // render hint: only draw the next command if flipped
+	case 0x20: // use the normal transform color table
+	case 0x30: // use the alternate transform color table
+		return true;
+	case 0x40: // draw one player color outline pixel
+		row.put(make_pixel(sprite_pixel_type::outline));
+		return true;
+	case 0x60: // draw one black outline pixel
+		row.put(make_pixel(sprite_pixel_type::outline_black));
+		return true;
+	case 0x50: // draw a span of player color outline pixels
+		row.fill(make_pixel(sprite_pixel_type::outline), reader.u8());
+		return true;
+	case 0x70: // draw a span of black outline pixels
+		row.fill(make_pixel(sprite_pixel_type::outline_black), reader.u8());
+		return true;
+	case 0x80:
+		throw Error(MSG(err) << "SLP dither command is not implemented");
+	default:
+		return false;
+	}
+}
+
+
+/**
+ * Draw one row of a palette color frame.
+ *
+ * @param stride Number of bytes per color (2 when decay data is included).
+ */
+void draw_palette_row(SpriteReader &reader, RowWriter &row, size_t stride) {
+	auto read_color = [&]() {
+		reader.skip(stride - 1);
+		return reader.u8();
+	};
+
+	while (true) {
+		uint8_t cmd = reader.u8();
+		uint8_t lower_nibble = cmd & 0x0F;
+
+		if (lower_nibble == 0x0F) {
+			// end of row
+			return;
+		}
+
+		switch (cmd & 0x03) {
+		case 0x00: {
+			// color list: draw the following (cmd >> 2) colors
+			size_t count = cmd >> 2;
+			for (size_t i = 0; i < count; i++) {
+				row.put(make_pixel(sprite_pixel_type::standard, read_color()));
+			}
+			continue;
+		}
+		case 0x01:
+			// skip: leave (cmd >> 2) or next byte pixels transparent
+			row.skip(cmd_or_next(reader, cmd, 2));
+			continue;
+		default:
+			break;
+		}
+
+		switch (lower_nibble) {
+		case 0x02: {
+			// big color list
+			size_t count = ((cmd & 0xF0) << 4) + reader.u8();
+			for (size_t i = 0; i < count; i++) {
+				row.put(make_pixel(sprite_pixel_type::standard, read_color()));
+			}
+			break;
+		}
+		case 0x03:
+			// big skip
+			row.skip(((cmd & 0xF0) << 4) + reader.u8());
+			break;
+		case 0x06: {
+			// player color list
+			size_t count = cmd_or_next(reader, cmd, 4);
+			for (size_t i = 0; i < count; i++) {
+				row.put(make_pixel(sprite_pixel_type::player, read_color()));
+			}
+			break;
+		}
+		case 0x07: {
+			// fill with the color of the next byte
+			size_t count = cmd_or_next(reader, cmd, 4);
+			row.fill(make_pixel(sprite_pixel_type::standard, reader.u8()), count);
+			break;
+		}
+		case 0x0A: {
+			// fill with player color
+			size_t count = cmd_or_next(reader, cmd, 4);
+			row.fill(make_pixel(sprite_pixel_type::player, reader.u8()), count);
+			break;
+		}
+		case 0x0B:
+			// shadow pixels
+			row.fill(make_pixel(sprite_pixel_type::shadow), cmd_or_next(reader, cmd, 4));
+			break;
+		case 0x0E:
+			if (not draw_outline_cmd(reader, row, cmd) and (cmd & 0xF0) <= 0xA0) {
+				throw Error(MSG(err) << "SLP extended alpha command " << std::hex << +cmd << " is not implemented");
+			}
+			break;
+		default:
+			throw Error(MSG(err) << "unknown SLP drawing command " << std::hex << +cmd);
+		}
+	}
+}
+
+
+/**
+ * Draw one row of a 32-bit frame.
+ */
+void draw_rgba_row(SpriteReader &reader, RowWriter &row) {
+	while (true) {
+		uint8_t cmd = reader.u8();
+		uint8_t lower_nibble = cmd & 0x0F;
+
+		if (lower_nibble == 0x0F) {
+			return;
+		}
+
+		switch (cmd & 0x03) {
+		case 0x00: {
+			size_t count = cmd >> 2;
+			for (size_t i = 0; i < count; i++) {
+				row.put(read_bgra(reader));
+			}
+			continue;
+		}
+		case 0x01:
+			row.skip(cmd_or_next(reader, cmd, 2));
+			continue;
+		default:
+			break;
+		}
+
+		switch (lower_nibble) {
+		case 0x02: {
+			size_t count = ((cmd & 0xF0) << 4) + reader.u8();
+			for (size_t i = 0; i < count; i++) {
+				row.put(read_bgra(reader));
+			}
+			break;
+		}
+		case 0x03:
+			row.skip(((cmd & 0xF0) << 4) + reader.u8());
+			break;
+		case 0x06: {
+			size_t count = cmd_or_next(reader, cmd, 4);
+			for (size_t i = 0; i < count; i++) {
+				row.put(make_pixel(sprite_pixel_type::player, reader.u8()));
+			}
+			break;
+		}
+		case 0x07: {
+			// the fill command of 32-bit frames stores every pixel
+			size_t count = cmd_or_next(reader, cmd, 4);
+			for (size_t i = 0; i < count; i++) {
+				row.put(read_bgra(reader));
+			}
+			break;
+		}
+		case 0x0A: {
+			size_t count = cmd_or_next(reader, cmd, 4);
+			row.fill(make_pixel(sprite_pixel_type::player, reader.u8()), count);
+			break;
+		}
+		case 0x0B:
+			row.fill(make_pixel(sprite_pixel_type::shadow), cmd_or_next(reader, cmd, 4));
+			break;
+		case 0x0E:
+			if ((cmd & 0xF0) == 0x90) {
+				// premultiplied alpha
+				size_t count = reader.u8();
+				for (size_t i = 0; i < count; i++) {
+					row.put(read_bgra(reader, true));
+				}
+			}
+			else if (not draw_outline_cmd(reader, row, cmd) and (cmd & 0xF0) == 0xA0) {
+				throw Error(MSG(err) << "SLP original alpha command is not implemented");
+			}
+			break;
+		default:
+			throw Error(MSG(err) << "unknown SLP drawing command " << std::hex << +cmd);
+		}
+	}
+}
+
+
+/**
+ * Draw one row of a 4.0X/4.1X shadow frame.
+ */
+void draw_shadow_row(SpriteReader &reader, RowWriter &row) {
+	// shadow values are converted to alpha values
+	auto shadow = [](uint8_t value) {
+		return make_pixel(sprite_pixel_type::shadow_alpha, static_cast<uint8_t>(255 - (value << 2)));
+	};
+
+	while (true) {
+		uint8_t cmd = reader.u8();
+		uint8_t lower_nibble = cmd & 0x0F;
+
+		if (lower_nibble == 0x0F) {
+			return;
+		}
+
+		switch (cmd & 0x03) {
+		case 0x00: {
+			size_t count = cmd >> 2;
+			for (size_t i = 0; i < count; i++) {
+				row.put(shadow(reader.u8()));
+			}
+			continue;
+		}
+		case 0x01:
+			row.skip(cmd_or_next(reader, cmd, 2));
+			continue;
+		default:
+			break;
+		}
+
+		switch (lower_nibble) {
+		case 0x02: {
+			size_t count = ((cmd & 0xF0) << 4) + reader.u8();
+			for (size_t i = 0; i < count; i++) {
+				row.put(shadow(reader.u8()));
+			}
+			break;
+		}
+		case 0x03:
+			row.skip(((cmd & 0xF0) << 4) + reader.u8());
+			break;
+		case 0x06: {
+			size_t count = cmd_or_next(reader, cmd, 4);
+			for (size_t i = 0; i < count; i++) {
+				row.put(make_pixel(sprite_pixel_type::player, reader.u8()));
+			}
+			break;
+		}
+		case 0x07: {
+			size_t count = cmd_or_next(reader, cmd, 4);
+			row.fill(shadow(reader.u8()), count);
+			break;
+		}
+		default:
+			throw Error(MSG(err) << "unknown SLP shadow drawing command " << std::hex << +cmd);
+		}
+	}
+}
+
+} // namespace
+
+
+SLPFile::SLPFile(std::vector<uint8_t> &&data) :
+	SpriteFile{std::move(data)} {
+	if (this->data.size() < slp_version_size + slp_header_size) {
+		throw Error(MSG(err) << "SLP file is too small: " << this->data.size() << " bytes");
+	}
+
+	std::string version(reinterpret_cast<const char *>(this->data.data()), slp_version_size);
+	if (version == "4.2P") {
+		throw Error(MSG(err) << "LZ4-compressed SLP version 4.2P is not supported");
+	}
+
+	bool v4 = (version == "4.0X" or version == "4.1X");
+	bool de = (v4 or version == std::string{"3.0\0", 4});
+
+	SpriteReader header{this->data, slp_version_size};
+	size_t frame_count;
+	size_t shadow_offset = 0;
+	if (v4) {
+		frame_count = header.u16();
+		header.skip(2 + 2 + 2 + 4 + 4); // angles, unknown, frame count, checksum, main offset
+		shadow_offset = header.u32();
+	}
+	else {
+		frame_count = header.u32();
+	}
+
+	auto read_frames = [&](size_t table_offset, bool shadow) {
+		SpriteReader reader{this->data, table_offset};
+		for (size_t i = 0; i < frame_count; i++) {
+			LayerEntry entry;
+			entry.cmd_offset = reader.u32();
+			entry.outline_offset = reader.u32();
+			uint32_t palette_offset = reader.u32();
+			uint32_t properties = reader.u32();
+			entry.info.width = reader.u32();
+			entry.info.height = reader.u32();
+			entry.info.hotspot_x = static_cast<int32_t>(reader.u32());
+			entry.info.hotspot_y = static_cast<int32_t>(reader.u32());
+
+			if (entry.info.width > 0xFFFF or entry.info.height > 0xFFFF) [[unlikely]] {
+				throw Error(MSG(err) << "SLP frame " << i << " has invalid size "
+				                     << entry.info.width << "x" << entry.info.height);
+			}
+
+			if (de) {
+				// DE1 effects palette, otherwise the palette number is stored in the properties
+				entry.info.palette_number = (properties > 0xFFFFFF) ? 54 : (properties >> 16);
+			}
+			else {
+				entry.info.palette_number = palette_offset + 50500;
+			}
+
+			if (shadow) {
+				entry.encoding = encoding::shadow_v4;
+			}
+			else if ((properties & 0x07) == 0x07) {
+				entry.encoding = encoding::rgba32;
+				entry.info.palette_number = -1;
+			}
+			else if (version == "4.1X") {
+				entry.encoding = encoding::de41;
+			}
+			else if (de) {
+				entry.encoding = encoding::de;
+			}
+			else {
+				entry.encoding = encoding::aoc;
+			}
+
+			this->add_layer_entry(shadow ? sprite_layer::shadow : sprite_layer::main, entry);
+		}
+	};
+
+	read_frames(slp_version_size + slp_header_size, false);
+
+	if (shadow_offset != 0) {
+		// 4.0X SLPs contain a shadow SLP inside them
+		read_frames(shadow_offset, true);
+	}
+}
+
+
+void SLPFile::decode(const LayerEntry &entry, SpriteFrame &frame) const {
+	size_t width = entry.info.width;
+
+	SpriteReader edges{this->data, entry.outline_offset};
+	SpriteReader cmd_offsets{this->data, entry.cmd_offset};
+
+	for (size_t y = 0; y < entry.info.height; y++) {
+		uint16_t left = edges.u16();
+		uint16_t right = edges.u16();
+		uint32_t cmd_offset = cmd_offsets.u32();
+
+		if (left == slp_transparent_row or right == slp_transparent_row) {
+			continue;
+		}
+
+		if (static_cast<size_t>(left) + right > width) [[unlikely]] {
+			throw Error(MSG(err) << "SLP row " << y << " has edges wider than the frame");
+		}
+
+		RowWriter row{frame.row(y), left, width - right};
+		SpriteReader reader{this->data, cmd_offset};
+
+		try {
+			switch (entry.encoding) {
+			case encoding::aoc:
+			case encoding::de:
+				draw_palette_row(reader, row, 1);
+				break;
+			case encoding::de41:
+				draw_palette_row(reader, row, 2);
+				break;
+			case encoding::rgba32:
+				draw_rgba_row(reader, row);
+				break;
+			case encoding::shadow_v4:
+				draw_shadow_row(reader, row);
+				break;
+			default:
+				throw Error(MSG(err) << "unknown SLP frame encoding " << entry.encoding);
+			}
+		}
+		catch (Error &) {
+			throw Error(MSG(err) << "Could not decode SLP row " << y << " at offset " << cmd_offset);
+		}
+
+		if (row.remaining() != 0) [[unlikely]] {
+			throw Error(MSG(err) << "SLP row " << y << " is missing " << row.remaining() << " pixels");
+		}
+	}
+}
+
+} // namespace openage::renderer::resources::sprite
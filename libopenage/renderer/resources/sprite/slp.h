@@ -0,0 +1,52 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "renderer/resources/sprite/sprite_file.h"
+
+
+namespace openage::renderer::resources::sprite {
+
+/**
+ * SLP sprite file, the sprite format of AoE1, AoE2 and their HD editions.
+ *
+ * Supported versions are 2.0N (palette colors), 3.0 and 4.0X (DE1, with
+ * separate player color palettes), 4.1X (with decay data) and 32-bit frames.
+ * The shadow frames of 4.0X/4.1X are available in the shadow layer.
+ * LZ4-compressed 4.2P files are not supported.
+ */
+class SLPFile : public SpriteFile {
+public:
+	/**
+	 * Parse the frame table of an SLP file.
+	 *
+	 * @param data Contents of the SLP file.
+	 */
+	explicit SLPFile(std::vector<uint8_t> &&data);
+
+	~SLPFile() = default;
+
+	/**
+	 * Encodings of SLP frames.
+	 */
+	enum encoding : int {
+		/// palette colors up to version 2.0
+		aoc,
+		/// palette colors in version 3.0 and 4.0X
+		de,
+		/// palette colors with decay data in version 4.1X
+		de41,
+		/// true color (32-bit) frames
+		rgba32,
+		/// shadow frames in version 4.0X and 4.1X
+		shadow_v4,
+	};
+
+protected:
+	void decode(const LayerEntry &entry, SpriteFrame &frame) const override;
+};
+
+} // namespace openage::renderer::resources::sprite
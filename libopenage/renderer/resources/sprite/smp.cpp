@@ -0,0 +1,230 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "smp.h"
+
+#include <utility>
+
+#include "error/error.h"
+#include "log/message.h"
+
+
+namespace openage::renderer::resources::sprite {
+
+namespace {
+
+/// size of the file header
+constexpr size_t smp_header_size = 64;
+
+/// size of one layer header, the frame header has the same size
+constexpr size_t smp_layer_header_size = 32;
+
+/// row edge value of completely transparent rows
+constexpr uint16_t smp_transparent_row = 0xFFFF;
+
+/**
+ * SMP layer types.
+ */
+enum smp_layer_type : uint32_t {
+	smp_main = 0x02,
+	smp_shadow = 0x04,
+	smp_outline = 0x08,
+	smp_outline_alt = 0x10,
+};
+
+
+/**
+ * Draw one row of a main graphics layer.
+ */
+void draw_main_row(SpriteReader &reader, RowWriter &row) {
+	while (true) {
+		uint8_t cmd = reader.u8();
+		size_t count = (cmd >> 2) + 1;
+
+		switch (cmd & 0x03) {
+		case 0x00:
+			// skip
+			row.skip(count);
+			break;
+		case 0x01:
+		case 0x02: {
+			// color list or player color list, 4 bytes per pixel:
+			// palette index, palette number and section, 2x damage modifier
+			auto type = (cmd & 0x03) == 0x01 ? sprite_pixel_type::standard : sprite_pixel_type::player;
+			for (size_t i = 0; i < count; i++) {
+				uint8_t index = reader.u8();
+				uint8_t palette = reader.u8();
+				reader.skip(2);
+				row.put(SpritePixel{type, {index, static_cast<uint8_t>(palette & 0x03), 0, 0}});
+			}
+			break;
+		}
+		default:
+			// end of row
+			return;
+		}
+	}
+}
+
+
+/**
+ * Draw one row of a shadow layer.
+ */
+void draw_shadow_row(SpriteReader &reader, RowWriter &row) {
+	uint8_t alpha = 0;
+
+	while (true) {
+		uint8_t cmd = reader.u8();
+		size_t count = (cmd >> 2) + 1;
+
+		switch (cmd & 0x03) {
+		case 0x00:
+			row.skip(count);
+			break;
+		case 0x01:
+			// color list of 1 byte alpha values
+			for (size_t i = 0; i < count; i++) {
+				alpha = reader.u8();
+				row.put(SpritePixel{sprite_pixel_type::shadow_alpha, {alpha, 0, 0, 0}});
+			}
+			break;
+		case 0x03:
+			// end of row. Shadows sometimes need an extra pixel
+			// at the end, which repeats the last one.
+			if (row.remaining() > 0) {
+				row.put(SpritePixel{sprite_pixel_type::shadow_alpha, {alpha, 0, 0, 0}});
+			}
+			return;
+		default:
+			throw Error(MSG(err) << "unknown SMP shadow drawing command " << std::hex << +cmd);
+		}
+	}
+}
+
+
+/**
+ * Draw one row of an outline layer.
+ */
+void draw_outline_row(SpriteReader &reader, RowWriter &row) {
+	while (true) {
+		uint8_t cmd = reader.u8();
+		size_t count = (cmd >> 2) + 1;
+
+		switch (cmd & 0x03) {
+		case 0x00:
+			row.skip(count);
+			break;
+		case 0x01:
+			// the outline color is chosen by the game
+			row.fill(SpritePixel{sprite_pixel_type::outline, {}}, count);
+			break;
+		case 0x03:
+			return;
+		default:
+			throw Error(MSG(err) << "unknown SMP outline drawing command " << std::hex << +cmd);
+		}
+	}
+}
+
+} // namespace
+
+
+SMPFile::SMPFile(std::vector<uint8_t> &&data) :
+	SpriteFile{std::move(data)} {
+	SpriteReader header{this->data, 8};
+	size_t frame_count = header.u32();
+
+	SpriteReader frame_offsets{this->data, smp_header_size};
+	for (size_t i = 0; i < frame_count; i++) {
+		size_t frame_offset = frame_offsets.u32();
+
+		// number of layers in the frame
+		SpriteReader frame_header{this->data, frame_offset + 28};
+		size_t layer_count = frame_header.u32();
+
+		for (size_t l = 1; l <= layer_count; l++) {
+			SpriteReader reader{this->data, frame_offset + l * smp_layer_header_size};
+
+			LayerEntry entry;
+			entry.info.width = reader.u32();
+			entry.info.height = reader.u32();
+			entry.info.hotspot_x = static_cast<int32_t>(reader.u32());
+			entry.info.hotspot_y = static_cast<int32_t>(reader.u32());
+			uint32_t layer_type = reader.u32();
+
+			// table offsets are relative to the frame
+			entry.outline_offset = frame_offset + reader.u32();
+			entry.cmd_offset = frame_offset + reader.u32();
+			entry.data_offset = frame_offset;
+			entry.encoding = layer_type;
+
+			if (entry.info.width > 0xFFFF or entry.info.height > 0xFFFF) [[unlikely]] {
+				throw Error(MSG(err) << "SMP layer at offset " << reader.tell() << " has invalid size "
+				                     << entry.info.width << "x" << entry.info.height);
+			}
+
+			switch (layer_type) {
+			case smp_main:
+				this->add_layer_entry(sprite_layer::main, entry);
+				break;
+			case smp_shadow:
+				this->add_layer_entry(sprite_layer::shadow, entry);
+				break;
+			case smp_outline:
+			case smp_outline_alt:
+				this->add_layer_entry(sprite_layer::outline, entry);
+				break;
+			default:
+				throw Error(MSG(err) << "unknown SMP layer type " << std::hex << layer_type
+				                     << " in frame " << std::dec << i);
+			}
+		}
+	}
+}
+
+
+void SMPFile::decode(const LayerEntry &entry, SpriteFrame &frame) const {
+	size_t width = entry.info.width;
+
+	SpriteReader edges{this->data, entry.outline_offset};
+	SpriteReader cmd_offsets{this->data, entry.cmd_offset};
+
+	for (size_t y = 0; y < entry.info.height; y++) {
+		uint16_t left = edges.u16();
+		uint16_t right = edges.u16();
+		size_t cmd_offset = entry.data_offset + cmd_offsets.u32();
+
+		if (left == smp_transparent_row or right == smp_transparent_row) {
+			continue;
+		}
+
+		if (static_cast<size_t>(left) + right > width) [[unlikely]] {
+			throw Error(MSG(err) << "SMP row " << y << " has edges wider than the layer");
+		}
+
+		RowWriter row{frame.row(y), left, width - right};
+		SpriteReader reader{this->data, cmd_offset};
+
+		try {
+			switch (entry.encoding) {
+			case smp_main:
+				draw_main_row(reader, row);
+				break;
+			case smp_shadow:
+				draw_shadow_row(reader, row);
+				break;
+			default:
+				draw_outline_row(reader, row);
+				break;
+			}
+		}
+		catch (Error &) {
+			throw Error(MSG(err) << "Could not decode SMP row " << y << " at offset " << cmd_offset);
+		}
+
+		if (row.remaining() != 0) [[unlikely]] {
+			throw Error(MSG(err) << "SMP row " << y << " is missing " << row.remaining() << " pixels");
+		}
+	}
+}
+
+} // namespace openage::renderer::resources::sprite
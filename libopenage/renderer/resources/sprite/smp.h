@@ -0,0 +1,37 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "renderer/resources/sprite/sprite_file.h"
+
+
+namespace openage::renderer::resources::sprite {
+
+/**
+ * SMP sprite file, the uncompressed predecessor of SMX used
+ * by the AoE2: Definitive Edition beta.
+ *
+ * Every frame consists of a main graphics layer and optional shadow and
+ * outline layers. Main graphics pixels select one of the 4 sections of
+ * a 1024 color palette. The palette number is stored in each pixel,
+ * so it is not part of the frame metadata.
+ */
+class SMPFile : public SpriteFile {
+public:
+	/**
+	 * Parse the frame table of an SMP file.
+	 *
+	 * @param data Contents of the SMP file.
+	 */
+	explicit SMPFile(std::vector<uint8_t> &&data);
+
+	~SMPFile() = default;
+
+protected:
+	void decode(const LayerEntry &entry, SpriteFrame &frame) const override;
+};
+
+} // namespace openage::renderer::resources::sprite
@@ -0,0 +1,285 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "smx.h"
+
+#include <utility>
+
+#include "error/error.h"
+#include "log/message.h"
+
+
+namespace openage::renderer::resources::sprite {
+
+namespace {
+
+/// size of the file header
+constexpr size_t smx_header_size = 32;
+
+/// row edge value of completely transparent rows
+constexpr uint16_t smx_transparent_row = 0xFFFF;
+
+
+/**
+ * Position in the packed pixel data of a main graphics layer.
+ * The position continues from one row to the next.
+ */
+struct ColorCursor {
+	const std::vector<uint8_t> &data;
+
+	/// offset of the current chunk
+	size_t pos;
+
+	/// index of the next pixel in the current chunk
+	size_t chunk_pos = 0;
+
+	uint8_t at(size_t offset) const {
+		if (offset >= this->data.size()) [[unlikely]] {
+			throw Error(MSG(err) << "SMX pixel data ends unexpectedly at offset " << offset);
+		}
+		return this->data[offset];
+	}
+
+	/**
+	 * 4plus1: 4 palette indices, followed by a byte that contains
+	 * the 2 bit palette section of each of them.
+	 */
+	SpritePixel next_4plus1(sprite_pixel_type type) {
+		uint8_t index = this->at(this->pos);
+		uint8_t sections = this->at(this->pos - this->chunk_pos + 4);
+		uint8_t section = (sections >> (2 * this->chunk_pos)) & 0x03;
+
+		this->pos += 1;
+		this->chunk_pos += 1;
+		if (this->chunk_pos > 3) {
+			// skip the palette section byte
+			this->chunk_pos = 0;
+			this->pos += 1;
+		}
+
+		return SpritePixel{type, {index, section, 0, 0}};
+	}
+
+	/**
+	 * 8to5: 2 pixels of 4 values (palette index, palette section and 2 damage
+	 * modifiers) are packed into 5 bytes. The first pixel occupies byte 0-3,
+	 * the second one byte 1-4, shifted by 2 bits.
+	 */
+	SpritePixel next_8to5(sprite_pixel_type type) {
+		uint8_t index;
+		uint8_t section;
+
+		if (this->chunk_pos == 0) {
+			index = this->at(this->pos);
+			section = this->at(this->pos + 1) & 0x03;
+			this->chunk_pos = 1;
+		}
+		else {
+			uint8_t b1 = this->at(this->pos + 1);
+			uint8_t b2 = this->at(this->pos + 2);
+			index = (b1 >> 2) | (b2 << 6);
+			section = (b2 >> 2) & 0x03;
+			this->chunk_pos = 0;
+			this->pos += 5;
+		}
+
+		return SpritePixel{type, {index, section, 0, 0}};
+	}
+};
+
+
+/**
+ * Draw one row of a main graphics layer.
+ */
+template <bool packed_8to5>
+void draw_main_row(SpriteReader &cmds, ColorCursor &colors, RowWriter &row) {
+	while (true) {
+		uint8_t cmd = cmds.u8();
+		size_t count = (cmd >> 2) + 1;
+
+		switch (cmd & 0x03) {
+		case 0x00:
+			row.skip(count);
+			break;
+		case 0x01:
+		case 0x02: {
+			// color list or player color list
+			auto type = (cmd & 0x03) == 0x01 ? sprite_pixel_type::standard : sprite_pixel_type::player;
+			for (size_t i = 0; i < count; i++) {
+				if constexpr (packed_8to5) {
+					row.put(colors.next_8to5(type));
+				}
+				else {
+					row.put(colors.next_4plus1(type));
+				}
+			}
+			break;
+		}
+		default:
+			return;
+		}
+	}
+}
+
+
+/**
+ * Draw one row of a shadow layer.
+ */
+void draw_shadow_row(SpriteReader &cmds, RowWriter &row) {
+	uint8_t alpha = 0;
+
+	while (true) {
+		uint8_t cmd = cmds.u8();
+		size_t count = (cmd >> 2) + 1;
+
+		switch (cmd & 0x03) {
+		case 0x00:
+			row.skip(count);
+			break;
+		case 0x01:
+			for (size_t i = 0; i < count; i++) {
+				alpha = cmds.u8();
+				row.put(SpritePixel{sprite_pixel_type::shadow_alpha, {alpha, 0, 0, 0}});
+			}
+			break;
+		case 0x03:
+			// shadows sometimes need an extra pixel at the end
+			if (row.remaining() > 0) {
+				row.put(SpritePixel{sprite_pixel_type::shadow_alpha, {alpha, 0, 0, 0}});
+			}
+			return;
+		default:
+			throw Error(MSG(err) << "unknown SMX shadow drawing command " << std::hex << +cmd);
+		}
+	}
+}
+
+
+/**
+ * Draw one row of an outline layer.
+ */
+void draw_outline_row(SpriteReader &cmds, RowWriter &row) {
+	while (true) {
+		uint8_t cmd = cmds.u8();
+		size_t count = (cmd >> 2) + 1;
+
+		switch (cmd & 0x03) {
+		case 0x00:
+			row.skip(count);
+			break;
+		case 0x01:
+			row.fill(SpritePixel{sprite_pixel_type::outline, {}}, count);
+			break;
+		case 0x03:
+			return;
+		default:
+			throw Error(MSG(err) << "unknown SMX outline drawing command " << std::hex << +cmd);
+		}
+	}
+}
+
+} // namespace
+
+
+SMXFile::SMXFile(std::vector<uint8_t> &&data) :
+	SpriteFile{std::move(data)} {
+	SpriteReader reader{this->data, 6};
+	size_t frame_count = reader.u16();
+
+	// SMX files have no offset tables, the layers follow each other
+	reader.seek(smx_header_size);
+	for (size_t i = 0; i < frame_count; i++) {
+		uint8_t frame_type = reader.u8();
+		uint8_t palette_number = reader.u8();
+		reader.skip(4); // uncompressed size
+
+		for (auto layer : {sprite_layer::main, sprite_layer::shadow, sprite_layer::outline}) {
+			if (not(frame_type & (1 << static_cast<int>(layer)))) {
+				continue;
+			}
+
+			LayerEntry entry;
+			entry.info.width = reader.u16();
+			entry.info.height = reader.u16();
+			entry.info.hotspot_x = static_cast<int16_t>(reader.u16());
+			entry.info.hotspot_y = static_cast<int16_t>(reader.u16());
+			reader.skip(8); // distance to next frame, unknown
+
+			entry.outline_offset = reader.tell();
+			reader.skip(4 * entry.info.height);
+
+			size_t cmd_size = reader.u32();
+			size_t color_size = 0;
+
+			if (layer == sprite_layer::main) {
+				color_size = reader.u32();
+				entry.info.palette_number = palette_number;
+				entry.encoding = (frame_type & 0x08) ? encoding::main_8to5 : encoding::main_4plus1;
+			}
+			else {
+				entry.encoding = (layer == sprite_layer::shadow) ? encoding::shadow : encoding::outline;
+			}
+
+			entry.cmd_offset = reader.tell();
+			entry.data_offset = entry.cmd_offset + cmd_size;
+			reader.skip(cmd_size + color_size);
+
+			if (reader.tell() > this->data.size()) [[unlikely]] {
+				throw Error(MSG(err) << "SMX frame " << i << " exceeds the file size");
+			}
+
+			this->add_layer_entry(layer, entry);
+		}
+	}
+}
+
+
+void SMXFile::decode(const LayerEntry &entry, SpriteFrame &frame) const {
+	size_t width = entry.info.width;
+
+	SpriteReader edges{this->data, entry.outline_offset};
+	SpriteReader cmds{this->data, entry.cmd_offset};
+	ColorCursor colors{this->data, entry.data_offset};
+
+	for (size_t y = 0; y < entry.info.height; y++) {
+		uint16_t left = edges.u16();
+		uint16_t right = edges.u16();
+
+		if (left == smx_transparent_row or right == smx_transparent_row) {
+			continue;
+		}
+
+		if (static_cast<size_t>(left) + right > width) [[unlikely]] {
+			throw Error(MSG(err) << "SMX row " << y << " has edges wider than the layer");
+		}
+
+		RowWriter row{frame.row(y), left, width - right};
+
+		try {
+			switch (entry.encoding) {
+			case encoding::main_4plus1:
+				draw_main_row<false>(cmds, colors, row);
+				break;
+			case encoding::main_8to5:
+				draw_main_row<true>(cmds, colors, row);
+				break;
+			case encoding::shadow:
+				draw_shadow_row(cmds, row);
+				break;
+			case encoding::outline:
+				draw_outline_row(cmds, row);
+				break;
+			default:
+				throw Error(MSG(err) << "unknown SMX layer encoding " << entry.encoding);
+			}
+		}
+		catch (Error &) {
+			throw Error(MSG(err) << "Could not decode SMX row " << y << " at offset " << cmds.tell());
+		}
+
+		if (row.remaining() != 0) [[unlikely]] {
+			throw Error(MSG(err) << "SMX row " << y << " is missing " << row.remaining() << " pixels");
+		}
+	}
+}
+
+} // namespace openage::renderer::resources::sprite
@@ -0,0 +1,49 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "renderer/resources/sprite/sprite_file.h"
+
+
+namespace openage::renderer::resources::sprite {
+
+/**
+ * SMX sprite file, the compressed sprite format of AoE2: Definitive Edition.
+ *
+ * Like SMP, every frame has a main graphics layer and optional shadow
+ * and outline layers. The pixel data of the main layer is packed with
+ * either the "4plus1" or the "8to5" compression.
+ */
+class SMXFile : public SpriteFile {
+public:
+	/**
+	 * Parse the frame headers of an SMX file.
+	 *
+	 * @param data Contents of the SMX file.
+	 */
+	explicit SMXFile(std::vector<uint8_t> &&data);
+
+	~SMXFile() = default;
+
+	/**
+	 * Encodings of SMX layers.
+	 */
+	enum encoding : int {
+		/// main graphics, 4 palette indices followed by 1 byte of palette sections
+		main_4plus1,
+		/// main graphics, 2 pixels with damage modifiers in 5 bytes
+		main_8to5,
+		/// shadow alpha values
+		shadow,
+		/// outline
+		outline,
+	};
+
+protected:
+	void decode(const LayerEntry &entry, SpriteFrame &frame) const override;
+};
+
+} // namespace openage::renderer::resources::sprite
@@ -0,0 +1,254 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "sprite_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "error/error.h"
+#include "job/job_manager.h"
+#include "log/message.h"
+
+#include "renderer/resources/palette_info.h"
+#include "renderer/resources/sprite/slp.h"
+#include "renderer/resources/sprite/smp.h"
+#include "renderer/resources/sprite/smx.h"
+#include "renderer/resources/texture_info.h"
+#include "renderer/resources/texture_subinfo.h"
+#include "util/file.h"
+#include "util/path.h"
+
+
+namespace openage::renderer::resources::sprite {
+
+SpriteFrame::SpriteFrame(const SpriteFrameInfo &info) :
+	info{info},
+	pixels(static_cast<size_t>(info.width) * info.height) {}
+
+
+const SpriteFrameInfo &SpriteFrame::get_info() const {
+	return this->info;
+}
+
+
+const SpritePixel &SpriteFrame::get_pixel(size_t x, size_t y) const {
+	if (x >= this->info.width or y >= this->info.height) [[unlikely]] {
+		throw Error(MSG(err) << "Pixel position (" << x << ", " << y << ") is outside the sprite frame.");
+	}
+
+	return this->pixels[y * this->info.width + x];
+}
+
+
+SpritePixel *SpriteFrame::row(size_t y) {
+	return this->pixels.data() + y * this->info.width;
+}
+
+
+template <typename F>
+Texture2dData SpriteFrame::make_texture(pixel_format fmt, F &&color) const {
+	std::vector<uint8_t> rgba(this->pixels.size() * 4);
+
+	uint8_t *out = rgba.data();
+	for (auto &px : this->pixels) {
+		color(px, out);
+		out += 4;
+	}
+
+	uint32_t w = this->info.width;
+	uint32_t h = this->info.height;
+	std::vector<Texture2dSubInfo> subtextures{
+		Texture2dSubInfo(0, 0, w, h, this->info.hotspot_x, this->info.hotspot_y, w, h),
+	};
+
+	return Texture2dData{
+		Texture2dInfo(w, h, fmt, std::nullopt, 4, std::move(subtextures)),
+		std::move(rgba),
+	};
+}
+
+
+namespace {
+
+/**
+ * Write the RGBA value of a pixel that doesn't need a palette lookup.
+ */
+inline void special_color(const SpritePixel &px, uint8_t *out) {
+	// odd alpha values: regular pixels, displayed as-is with transparency
+	// even alpha values: special pixels with the player color index in green
+	switch (px.type) {
+	case sprite_pixel_type::transparent:
+		std::memset(out, 0, 4);
+		break;
+	case sprite_pixel_type::rgba:
+		out[0] = px.value[0];
+		out[1] = px.value[1];
+		out[2] = px.value[2];
+		out[3] = px.value[3] | 0x01;
+		break;
+	case sprite_pixel_type::shadow:
+		out[0] = out[1] = out[2] = 0;
+		out[3] = 100;
+		break;
+	case sprite_pixel_type::shadow_alpha:
+		out[0] = out[1] = out[2] = 0;
+		out[3] = px.value[0] | 0x01;
+		break;
+	case sprite_pixel_type::player:
+		out[0] = out[2] = 0;
+		out[1] = px.value[0];
+		out[3] = 254;
+		break;
+	case sprite_pixel_type::outline:
+		out[0] = out[2] = 0;
+		out[1] = px.value[0];
+		out[3] = 252;
+		break;
+	case sprite_pixel_type::outline_black:
+		out[0] = out[2] = 0;
+		out[1] = px.value[0];
+		out[3] = 250;
+		break;
+	default:
+		throw Error(MSG(err) << "unexpected sprite pixel type " << static_cast<int>(px.type));
+	}
+}
+
+} // namespace
+
+
+Texture2dData SpriteFrame::to_rgba(const PaletteInfo &palette) const {
+	// convert the palette once instead of for every pixel
+	auto colors = palette.get_colors();
+	std::vector<uint8_t> lookup(colors.size() * 4);
+	for (size_t i = 0; i < colors.size(); i++) {
+		for (size_t c = 0; c < 3; c++) {
+			lookup[i * 4 + c] = static_cast<uint8_t>(std::min(colors[i][c] * 256.0f, 255.0f));
+		}
+	}
+
+	return this->make_texture(pixel_format::rgba8, [&](const SpritePixel &px, uint8_t *out) {
+		if (px.type == sprite_pixel_type::standard) [[likely]] {
+			// palettes are divided into sections of 256 colors
+			size_t idx = px.value[0] + px.value[1] * 256;
+			if (idx >= colors.size()) [[unlikely]] {
+				throw Error(MSG(err) << "sprite color " << idx << " is not in the palette "
+				                     << "with " << colors.size() << " entries");
+			}
+
+			std::memcpy(out, &lookup[idx * 4], 3);
+			out[3] = 255;
+		}
+		else {
+			special_color(px, out);
+		}
+	});
+}
+
+
+Texture2dData SpriteFrame::to_indexed() const {
+	return this->make_texture(pixel_format::rgba8ui, [](const SpritePixel &px, uint8_t *out) {
+		if (px.type == sprite_pixel_type::standard) [[likely]] {
+			out[0] = px.value[0];
+			out[1] = px.value[1];
+			out[2] = 0;
+			out[3] = 255;
+		}
+		else if (px.type == sprite_pixel_type::rgba) [[unlikely]] {
+			throw Error(MSG(err) << "true color sprite frames can't be palette-indexed");
+		}
+		else {
+			special_color(px, out);
+		}
+	});
+}
+
+
+SpriteFile::SpriteFile(std::vector<uint8_t> &&data) :
+	data{std::move(data)} {}
+
+
+std::shared_ptr<SpriteFile> SpriteFile::open(const util::Path &path) {
+	std::string content = path.open_r().read();
+
+	try {
+		return SpriteFile::open(std::vector<uint8_t>(content.begin(), content.end()));
+	}
+	catch (Error &) {
+		// the decoding error is stored as the cause
+		throw Error(MSG(err) << "Could not read sprite file " << path);
+	}
+}
+
+
+std::shared_ptr<SpriteFile> SpriteFile::open(std::vector<uint8_t> &&data) {
+	if (data.size() >= 4) {
+		if (std::memcmp(data.data(), "SMPX", 4) == 0) {
+			return std::make_shared<SMXFile>(std::move(data));
+		}
+		if (std::memcmp(data.data(), "SMP$", 4) == 0) {
+			return std::make_shared<SMPFile>(std::move(data));
+		}
+	}
+
+	// SLPs start with their version string
+	return std::make_shared<SLPFile>(std::move(data));
+}
+
+
+size_t SpriteFile::get_frame_count(sprite_layer layer) const {
+	return this->layers[static_cast<size_t>(layer)].size();
+}
+
+
+const SpriteFrameInfo &SpriteFile::get_frame_info(size_t idx, sprite_layer layer) const {
+	return this->get_slot(idx, layer).entry.info;
+}
+
+
+std::shared_ptr<const SpriteFrame> SpriteFile::get_frame(size_t idx, sprite_layer layer) {
+	Slot &slot = this->get_slot(idx, layer);
+
+	std::call_once(slot.decoded, [&]() {
+		auto frame = std::make_shared<SpriteFrame>(slot.entry.info);
+		this->decode(slot.entry, *frame);
+		slot.frame = std::move(frame);
+	});
+
+	return slot.frame;
+}
+
+
+job::Job<std::shared_ptr<const SpriteFrame>> SpriteFile::decode_async(const std::shared_ptr<job::JobManager> &job_mgr,
+                                                                      size_t idx,
+                                                                      sprite_layer layer) {
+	// check the index now instead of in the worker thread
+	this->get_slot(idx, layer);
+
+	auto self = this->shared_from_this();
+	return job_mgr->enqueue<std::shared_ptr<const SpriteFrame>>([self, idx, layer]() {
+		return self->get_frame(idx, layer);
+	});
+}
+
+
+void SpriteFile::add_layer_entry(sprite_layer layer, const LayerEntry &entry) {
+	auto slot = std::make_unique<Slot>();
+	slot->entry = entry;
+	this->layers[static_cast<size_t>(layer)].push_back(std::move(slot));
+}
+
+
+SpriteFile::Slot &SpriteFile::get_slot(size_t idx, sprite_layer layer) const {
+	auto &slots = this->layers[static_cast<size_t>(layer)];
+	if (idx >= slots.size()) [[unlikely]] {
+		throw Error(MSG(err) << "sprite frame " << idx << " does not exist in layer "
+		                     << static_cast<int>(layer) << " with " << slots.size() << " frames");
+	}
+
+	return *slots[idx];
+}
+
+} // namespace openage::renderer::resources::sprite
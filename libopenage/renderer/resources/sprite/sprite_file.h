@@ -0,0 +1,410 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "job/job.h"
+#include "renderer/resources/texture_data.h"
+
+
+namespace openage {
+namespace job {
+class JobManager;
+} // namespace job
+
+namespace util {
+class Path;
+} // namespace util
+
+namespace renderer::resources {
+class PaletteInfo;
+
+namespace sprite {
+
+/**
+ * Layers that a frame of an original game sprite can consist of.
+ */
+enum class sprite_layer {
+	/// main graphics
+	main,
+	/// shadow drawn below the main graphics
+	shadow,
+	/// outline shown when the unit is obstructed
+	outline,
+};
+
+/**
+ * How a decoded sprite pixel is drawn.
+ */
+enum class sprite_pixel_type : uint8_t {
+	/// not drawn at all
+	transparent = 0,
+	/// palette color
+	standard,
+	/// true color from 32-bit SLPs
+	rgba,
+	/// shadow with a fixed alpha value (SLP up to version 3.0)
+	shadow,
+	/// shadow with its own alpha value
+	shadow_alpha,
+	/// color that is replaced by the player color
+	player,
+	/// player color outline
+	outline,
+	/// black outline
+	outline_black,
+};
+
+/**
+ * One decoded sprite pixel.
+ */
+struct SpritePixel {
+	sprite_pixel_type type = sprite_pixel_type::transparent;
+
+	/**
+	 * Type-dependent pixel values:
+	 *
+	 * - standard: palette index, palette section
+	 * - rgba: red, green, blue, alpha
+	 * - shadow_alpha: alpha
+	 * - player, outline, outline_black: player color index
+	 */
+	std::array<uint8_t, 4> value{};
+};
+
+/**
+ * Metadata of one layer of a sprite frame.
+ */
+struct SpriteFrameInfo {
+	/// width of the frame in pixels
+	uint32_t width = 0;
+
+	/// height of the frame in pixels
+	uint32_t height = 0;
+
+	/// x coordinate of the anchor point
+	int32_t hotspot_x = 0;
+
+	/// y coordinate of the anchor point
+	int32_t hotspot_y = 0;
+
+	/// number of the palette the colors refer to, -1 if the frame has none
+	int palette_number = -1;
+};
+
+
+/**
+ * Decoded pixels of one frame layer.
+ *
+ * Pixels are stored in row-major order, starting with the top row.
+ */
+class SpriteFrame {
+public:
+	explicit SpriteFrame(const SpriteFrameInfo &info);
+
+	/**
+	 * Get the frame metadata.
+	 */
+	const SpriteFrameInfo &get_info() const;
+
+	/**
+	 * Get the pixel at the given position.
+	 */
+	const SpritePixel &get_pixel(size_t x, size_t y) const;
+
+	/**
+	 * Get a pointer to the first pixel of a row. Used by the decoders.
+	 */
+	SpritePixel *row(size_t y);
+
+	/**
+	 * Create an RGBA texture from the frame.
+	 *
+	 * Uses the same alpha conventions as the converter so that the result
+	 * matches converted sprite sheets: Odd alpha values are regular pixels,
+	 * even values mark special pixels whose player color index is stored
+	 * in the green channel (254 = player color, 252 = outline, 250 = black outline).
+	 *
+	 * @param palette Palette for resolving standard pixels. Sections of 256 colors
+	 *                are selected by the palette section of the pixel.
+	 *
+	 * @return Texture with \p pixel_format::rgba8 pixels.
+	 */
+	Texture2dData to_rgba(const PaletteInfo &palette) const;
+
+	/**
+	 * Create a palette-indexed texture from the frame, so that colors can be
+	 * resolved on the GPU.
+	 *
+	 * Standard pixels store the palette index in the red channel and the
+	 * palette section in the green channel. All other pixels are encoded
+	 * like in to_rgba(). Frames with true color pixels can't be indexed.
+	 *
+	 * @return Texture with \p pixel_format::rgba8ui pixels.
+	 */
+	Texture2dData to_indexed() const;
+
+private:
+	/**
+	 * Create the texture data from per-pixel RGBA values.
+	 */
+	template <typename F>
+	Texture2dData make_texture(pixel_format fmt, F &&color) const;
+
+	/**
+	 * Metadata of the frame.
+	 */
+	SpriteFrameInfo info;
+
+	/**
+	 * Decoded pixels.
+	 */
+	std::vector<SpritePixel> pixels;
+};
+
+
+/**
+ * Original game sprite file (SLP, SMP or SMX).
+ *
+ * The frame tables are parsed on construction, while the frames themselves
+ * are decoded lazily on first access and then cached. Decoding is thread-safe,
+ * so frames can be decoded in the background with decode_async().
+ */
+class SpriteFile : public std::enable_shared_from_this<SpriteFile> {
+public:
+	virtual ~SpriteFile() = default;
+
+	/**
+	 * Open a sprite file, detecting the format by its signature.
+	 *
+	 * @param path Path to the sprite file.
+	 */
+	static std::shared_ptr<SpriteFile> open(const util::Path &path);
+
+	/**
+	 * Open a sprite file from memory, detecting the format by its signature.
+	 *
+	 * @param data Contents of the sprite file.
+	 */
+	static std::shared_ptr<SpriteFile> open(std::vector<uint8_t> &&data);
+
+	/**
+	 * Get the number of frames in a layer.
+	 */
+	size_t get_frame_count(sprite_layer layer = sprite_layer::main) const;
+
+	/**
+	 * Get the metadata of a frame without decoding it.
+	 */
+	const SpriteFrameInfo &get_frame_info(size_t idx,
+	                                      sprite_layer layer = sprite_layer::main) const;
+
+	/**
+	 * Get a decoded frame. The frame is decoded on first access.
+	 * Concurrent callers for the same frame wait for the one doing the work.
+	 */
+	std::shared_ptr<const SpriteFrame> get_frame(size_t idx,
+	                                             sprite_layer layer = sprite_layer::main);
+
+	/**
+	 * Decode a frame on a worker thread of the job manager.
+	 *
+	 * @return Job that results in the decoded frame.
+	 */
+	job::Job<std::shared_ptr<const SpriteFrame>> decode_async(const std::shared_ptr<job::JobManager> &job_mgr,
+	                                                          size_t idx,
+	                                                          sprite_layer layer = sprite_layer::main);
+
+protected:
+	explicit SpriteFile(std::vector<uint8_t> &&data);
+
+	/**
+	 * Location and encoding of one frame layer inside the file.
+	 */
+	struct LayerEntry {
+		/// frame metadata
+		SpriteFrameInfo info;
+
+		/// format-specific encoding of the pixel data
+		int encoding = 0;
+
+		/// absolute offset of the row edge table
+		size_t outline_offset = 0;
+
+		/// absolute offset of the command table or array
+		size_t cmd_offset = 0;
+
+		/// format-specific base offset (pixel data or frame start)
+		size_t data_offset = 0;
+	};
+
+	/**
+	 * Register a frame layer found while parsing the file.
+	 */
+	void add_layer_entry(sprite_layer layer, const LayerEntry &entry);
+
+	/**
+	 * Decode the pixels of a frame layer.
+	 *
+	 * @param entry Location of the layer in the file.
+	 * @param frame Frame to draw into, initialized to transparent pixels.
+	 */
+	virtual void decode(const LayerEntry &entry, SpriteFrame &frame) const = 0;
+
+	/**
+	 * Contents of the sprite file.
+	 */
+	std::vector<uint8_t> data;
+
+private:
+	/**
+	 * Lazily decoded frame layer.
+	 */
+	struct Slot {
+		LayerEntry entry;
+
+		/// guards the one-time decoding of the frame
+		std::once_flag decoded;
+
+		/// decoded frame
+		std::shared_ptr<const SpriteFrame> frame;
+	};
+
+	/**
+	 * Get the slot of a frame layer.
+	 */
+	Slot &get_slot(size_t idx, sprite_layer layer) const;
+
+	/**
+	 * Frame layers, indexed by layer and frame index.
+	 * Stored by pointer because of the once_flag.
+	 */
+	std::array<std::vector<std::unique_ptr<Slot>>, 3> layers;
+};
+
+
+/**
+ * Bounds-checked little endian reader for sprite file contents.
+ */
+class SpriteReader {
+public:
+	SpriteReader(const std::vector<uint8_t> &data, size_t pos = 0) :
+		data{data.data()}, size{data.size()}, pos{pos} {}
+
+	/**
+	 * Read the next byte.
+	 */
+	uint8_t u8() {
+		if (this->pos >= this->size) [[unlikely]] {
+			throw Error(MSG(err) << "sprite data ends unexpectedly at offset " << this->pos);
+		}
+		return this->data[this->pos++];
+	}
+
+	uint16_t u16() {
+		uint16_t low = this->u8();
+		return low | (this->u8() << 8);
+	}
+
+	uint32_t u32() {
+		uint32_t low = this->u16();
+		return low | (static_cast<uint32_t>(this->u16()) << 16);
+	}
+
+	/**
+	 * Skip the given number of bytes.
+	 */
+	void skip(size_t count) {
+		this->pos += count;
+	}
+
+	/**
+	 * Move to an absolute offset.
+	 */
+	void seek(size_t offset) {
+		this->pos = offset;
+	}
+
+	/**
+	 * Current absolute offset.
+	 */
+	size_t tell() const {
+		return this->pos;
+	}
+
+private:
+	const uint8_t *data;
+	size_t size;
+	size_t pos;
+};
+
+
+/**
+ * Writes the pixels of one frame row, making sure the drawing
+ * commands stay inside the row.
+ */
+class RowWriter {
+public:
+	/**
+	 * @param row First pixel of the row.
+	 * @param begin Index of the first pixel drawn by commands.
+	 * @param end Index after the last pixel drawn by commands.
+	 */
+	RowWriter(SpritePixel *row, size_t begin, size_t end) :
+		row{row}, pos{begin}, end{end} {}
+
+	/**
+	 * Draw a pixel.
+	 */
+	void put(const SpritePixel &pixel) {
+		this->reserve(1);
+		this->row[this->pos++] = pixel;
+	}
+
+	/**
+	 * Draw the same pixel count times.
+	 */
+	void fill(const SpritePixel &pixel, size_t count) {
+		this->reserve(count);
+		for (size_t i = 0; i < count; i++) {
+			this->row[this->pos++] = pixel;
+		}
+	}
+
+	/**
+	 * Leave count pixels transparent.
+	 */
+	void skip(size_t count) {
+		this->reserve(count);
+		this->pos += count;
+	}
+
+	/**
+	 * Number of pixels that can still be drawn.
+	 */
+	size_t remaining() const {
+		return this->end - this->pos;
+	}
+
+private:
+	void reserve(size_t count) const {
+		if (count > this->end - this->pos) [[unlikely]] {
+			throw Error(MSG(err) << "sprite drawing commands exceed the row by "
+			                     << count - (this->end - this->pos) << " pixels");
+		}
+	}
+
+	SpritePixel *row;
+	size_t pos;
+	size_t end;
+};
+
+} // namespace sprite
+} // namespace renderer::resources
+} // namespace openage
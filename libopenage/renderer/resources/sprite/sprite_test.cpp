@@ -0,0 +1,188 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "job/job_manager.h"
+#include "renderer/resources/palette_info.h"
+#include "renderer/resources/sprite/sprite_file.h"
+#include "testing/testing.h"
+
+
+namespace openage::renderer::resources::sprite::tests {
+
+namespace {
+
+void put16(std::vector<uint8_t> &buf, uint16_t val) {
+	buf.push_back(val & 0xff);
+	buf.push_back(val >> 8);
+}
+
+
+void put32(std::vector<uint8_t> &buf, uint32_t val) {
+	put16(buf, val & 0xffff);
+	put16(buf, val >> 16);
+}
+
+
+/**
+ * SLP 2.0N with one 4x3 frame:
+ *
+ *   row 0: 2 palette colors, 2 player colors
+ *   row 1: transparent
+ *   row 2: 1 transparent edge pixel, 2 shadow pixels, 1 transparent pixel
+ */
+std::vector<uint8_t> make_slp() {
+	std::vector<uint8_t> slp{'2', '.', '0', 'N'};
+	put32(slp, 1);
+	slp.resize(32);
+
+	// slp_frame_info
+	put32(slp, 76); // command table
+	put32(slp, 64); // outline table
+	put32(slp, 0);
+	put32(slp, 0);
+	put32(slp, 4);
+	put32(slp, 3);
+	put32(slp, 1);
+	put32(slp, 2);
+
+	// outline table
+	put16(slp, 0);
+	put16(slp, 0);
+	put16(slp, 0x8000);
+	put16(slp, 0x8000);
+	put16(slp, 1);
+	put16(slp, 0);
+
+	// command table
+	put32(slp, 88);
+	put32(slp, 0);
+	put32(slp, 94);
+
+	// row 0: color list, player color fill, end of row
+	slp.insert(slp.end(), {0x08, 5, 6, 0x2A, 3, 0x0F});
+
+	// row 2: shadow, skip, end of row
+	slp.insert(slp.end(), {0x2B, 0x05, 0x0F});
+
+	return slp;
+}
+
+
+/**
+ * SMX with one frame consisting of a 3x1 main graphics layer
+ * packed with 4plus1 compression.
+ */
+std::vector<uint8_t> make_smx() {
+	std::vector<uint8_t> smx{'S', 'M', 'P', 'X'};
+	put16(smx, 2);
+	put16(smx, 1);
+	smx.resize(32);
+
+	// frame header: main layer only, palette 21
+	smx.insert(smx.end(), {0x01, 21});
+	put32(smx, 0);
+
+	// layer header
+	put16(smx, 3);
+	put16(smx, 1);
+	put16(smx, 1);
+	put16(smx, 0);
+	put32(smx, 0);
+	put32(smx, 0);
+
+	// outline table
+	put16(smx, 0);
+	put16(smx, 0);
+
+	// command array size, color table size
+	put32(smx, 2);
+	put32(smx, 5);
+
+	// color list of 3 pixels, end of row
+	smx.insert(smx.end(), {0x09, 0x03});
+
+	// palette indices and sections 1, 2, 3
+	smx.insert(smx.end(), {10, 11, 12, 0, 0x39});
+
+	return smx;
+}
+
+} // namespace
+
+
+void sprite() {
+	auto slp = SpriteFile::open(make_slp());
+	TESTEQUALS(slp->get_frame_count(), 1u);
+	TESTEQUALS(slp->get_frame_count(sprite_layer::shadow), 0u);
+	TESTEQUALS(slp->get_frame_info(0).width, 4u);
+	TESTEQUALS(slp->get_frame_info(0).hotspot_y, 2);
+	TESTEQUALS(slp->get_frame_info(0).palette_number, 50500);
+	TESTTHROWS(slp->get_frame_info(1));
+
+	auto frame = slp->get_frame(0);
+	TESTEQUALS(frame.get(), slp->get_frame(0).get());
+	TESTEQUALS(static_cast<int>(frame->get_pixel(1, 0).type), static_cast<int>(sprite_pixel_type::standard));
+	TESTEQUALS(+frame->get_pixel(1, 0).value[0], 6);
+	TESTEQUALS(static_cast<int>(frame->get_pixel(3, 0).type), static_cast<int>(sprite_pixel_type::player));
+	TESTEQUALS(+frame->get_pixel(3, 0).value[0], 3);
+	TESTEQUALS(static_cast<int>(frame->get_pixel(2, 1).type), static_cast<int>(sprite_pixel_type::transparent));
+	TESTEQUALS(static_cast<int>(frame->get_pixel(0, 2).type), static_cast<int>(sprite_pixel_type::transparent));
+	TESTEQUALS(static_cast<int>(frame->get_pixel(2, 2).type), static_cast<int>(sprite_pixel_type::shadow));
+
+	std::vector<uint8_t> colors;
+	for (size_t i = 0; i < 1024; i++) {
+		colors.insert(colors.end(), {uint8_t(i & 0xff), uint8_t(i >> 8), 7, 255});
+	}
+	PaletteInfo palette{colors};
+
+	auto texture = frame->to_rgba(palette);
+	const uint8_t *rgba = texture.get_data();
+	TESTEQUALS(texture.get_info().get_size().first, 4);
+	TESTEQUALS(+rgba[4 * 1 + 0], 6);
+	TESTEQUALS(+rgba[4 * 1 + 1], 0);
+	TESTEQUALS(+rgba[4 * 1 + 2], 7);
+	TESTEQUALS(+rgba[4 * 1 + 3], 255);
+	TESTEQUALS(+rgba[4 * 3 + 1], 3);
+	TESTEQUALS(+rgba[4 * 3 + 3], 254);
+	TESTEQUALS(+rgba[4 * 10 + 3], 100);
+
+	auto indexed = frame->to_indexed();
+	TESTEQUALS(+indexed.get_data()[4 * 1 + 0], 6);
+
+	// truncated command data
+	auto broken_data = make_slp();
+	broken_data.resize(broken_data.size() - 1);
+	auto broken = SpriteFile::open(std::move(broken_data));
+	TESTTHROWS(broken->get_frame(0));
+
+	auto smx = SpriteFile::open(make_smx());
+	TESTEQUALS(smx->get_frame_count(), 1u);
+	TESTEQUALS(smx->get_frame_info(0).palette_number, 21);
+
+	// decode on a worker thread
+	auto job_mgr = std::make_shared<job::JobManager>(1);
+	job_mgr->start();
+	auto job = smx->decode_async(job_mgr, 0);
+	while (not job.is_finished()) {
+		std::this_thread::yield();
+	}
+	auto smx_frame = job.get_result();
+	job_mgr->stop();
+
+	TESTEQUALS(+smx_frame->get_pixel(0, 0).value[0], 10);
+	TESTEQUALS(+smx_frame->get_pixel(0, 0).value[1], 1);
+	TESTEQUALS(+smx_frame->get_pixel(2, 0).value[0], 12);
+	TESTEQUALS(+smx_frame->get_pixel(2, 0).value[1], 3);
+
+	// palette section 1 selects colors 256-511
+	auto smx_texture = smx_frame->to_rgba(palette);
+	TESTEQUALS(+smx_texture.get_data()[0], 10);
+	TESTEQUALS(+smx_texture.get_data()[1], 1);
+}
+
+} // namespace openage::renderer::resources::sprite::tests
@@ -1,4 +1,4 @@
-// Copyright 2015-2023 the openage authors. See copying.md for legal info.
+// Copyright 2015-2024 the openage authors. See copying.md for legal info.
 
 #include "texture_data.h"
 
@@ -57,9 +57,10 @@ static constexpr size_t guess_row_alignment(size_t width, pixel_format fmt, size
 	return 4;
 }
 
-Texture2dData::Texture2dData(const util::Path &path) {
-	std::string native_path = path.resolve_native_path();
+Texture2dData::Texture2dData(const util::Path &path) :
+	Texture2dData{path, path.resolve_native_path()} {}
 
+Texture2dData::Texture2dData(const util::Path &path, const std::string &native_path) {
 	// TODO: use QImageIOHandler to directly create the correct surface format.
 	QImage image{native_path.c_str()};
 	image.convertTo(QImage::Format_RGBA8888);
@@ -1,9 +1,10 @@
-// Copyright 2017-2023 the openage authors. See copying.md for legal info.
+// Copyright 2017-2024 the openage authors. See copying.md for legal info.
 
 #pragma once
 
 #include <cstddef>
 #include <cstdint>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -29,6 +30,12 @@ public:
 	/// Uses QImage internally.
 	Texture2dData(const util::Path &path);
 
+	/// Create a texture from an image file whose native path is already resolved.
+	/// Does not access the file system of `path`, so it can be used in worker threads.
+	/// @param path Path to the image file.
+	/// @param native_path Native path of the image file.
+	Texture2dData(const util::Path &path, const std::string &native_path);
+
 	/// Create a texture from info.
 	///
 	/// Uses QImage internally. For supported image file types,
@@ -21,6 +21,7 @@ TerrainRenderMesh::TerrainRenderMesh(const std::shared_ptr<renderer::resources::
 	changed{false},
 	asset_manager{asset_manager},
 	terrain_info{nullptr},
+	texture{nullptr},
 	uniforms{nullptr},
 	mesh{renderer::resources::MeshData::make_quad()} {
 }
@@ -32,6 +33,7 @@ TerrainRenderMesh::TerrainRenderMesh(const std::shared_ptr<renderer::resources::
 	changed{true},
 	asset_manager{asset_manager},
 	terrain_info{nullptr},
+	texture{nullptr},
 	uniforms{nullptr},
 	mesh{std::move(mesh)} {
 	this->set_terrain_info(info);
@@ -67,9 +69,9 @@ void TerrainRenderMesh::update_uniforms(const time::time_t & /* time */) {
 
 	auto tex_info = this->terrain_info->get_texture(0);
 	auto tex_manager = this->asset_manager->get_texture_manager();
-	auto texture = tex_manager->request(tex_info->get_image_path().value());
+	this->texture = tex_manager->request(tex_info->get_image_path().value());
 
-	this->uniforms->update("tex", texture);
+	this->uniforms->update("tex", this->texture);
 
 	this->changed = false;
 }
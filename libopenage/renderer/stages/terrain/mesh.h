@@ -14,6 +14,7 @@
 
 
 namespace openage::renderer {
+class Texture2d;
 class UniformInput;
 
 namespace resources {
@@ -151,6 +152,12 @@ private:
 	 */
 	std::shared_ptr<renderer::resources::TerrainInfo> terrain_info;
 
+	/**
+	 * Texture used by the uniforms. Holding it keeps the texture manager
+	 * from removing it while the terrain is drawn.
+	 */
+	std::shared_ptr<renderer::Texture2d> texture;
+
 	/**
 	 * Shader uniforms for the renderable in the terrain render pass.
 	 */
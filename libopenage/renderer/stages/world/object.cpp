@@ -40,6 +40,7 @@ WorldObject::WorldObject(const std::shared_ptr<renderer::resources::AssetManager
 	angle{nullptr, 0, "", nullptr, 0},
 	animation_info{nullptr, 0},
 	layer_uniforms{},
+	layer_frames{},
 	last_update{0.0} {
 }
 
@@ -86,7 +87,6 @@ void WorldObject::fetch_updates(const time::time_t &time) {
 }
 
 void WorldObject::update_uniforms(const time::time_t &time) {
-	// TODO: Only update uniforms that changed since last update
 	if (this->layer_uniforms.empty()) [[unlikely]] {
 		return;
 	}
@@ -108,14 +108,6 @@ void WorldObject::update_uniforms(const time::time_t &time) {
 		auto &layer = animation_info->get_layer(layer_idx);
 		auto &angle = layer.get_direction_angle(angle_degrees);
 
-		// Flip subtexture horizontally if angle is mirrored
-		if (angle->is_mirrored()) {
-			layer_unifs->update(this->flip_x, true);
-		}
-		else {
-			layer_unifs->update(this->flip_x, false);
-		}
-
 		// Current frame index considering current time
 		size_t frame_idx;
 		switch (layer.get_display_mode()) {
@@ -139,7 +131,22 @@ void WorldObject::update_uniforms(const time::time_t &time) {
 
 		auto &tex_info = animation_info->get_texture(tex_idx);
 		auto &tex_manager = this->asset_manager->get_texture_manager();
-		auto &texture = tex_manager->request(tex_info->get_image_path().value());
+		// visible objects request their textures every frame, so the
+		// placeholder is only shown until the texture is loaded
+		auto &texture = tex_manager->request_async(tex_info->get_image_path().value());
+
+		// the remaining uniforms only change with the displayed frame
+		auto &cached = this->layer_frames.at(layer_idx);
+		if (cached.frame == frame_info.get()
+		    and cached.texture == texture
+		    and cached.mirrored == angle->is_mirrored()) {
+			continue;
+		}
+		cached = layer_frame{frame_info.get(), texture, angle->is_mirrored()};
+
+		// Flip subtexture horizontally if angle is mirrored
+		layer_unifs->update(this->flip_x, angle->is_mirrored());
+
 		layer_unifs->update(this->tex, texture);
 
 		// Subtexture coordinates.inside texture
@@ -222,17 +229,18 @@ void WorldObject::clear_changed_flag() {
 
 void WorldObject::set_uniforms(std::vector<std::shared_ptr<renderer::UniformInput>> &&uniforms) {
 	this->layer_uniforms = std::move(uniforms);
+
+	// new uniform inputs have none of the frame uniforms set
+	this->layer_frames.assign(this->layer_uniforms.size(), layer_frame{});
 }
 
-bool WorldObject::is_visible(const camera::Frustum2d &frustum,
-                             const time::time_t &time) {
-	static const Eigen::Matrix4f model_matrix = this->get_model_matrix();
+void WorldObject::add_to_culling_batch(camera::CullingBatch &batch,
+                                       const time::time_t &time) {
 	Eigen::Vector3f current_pos = this->position.get(time).to_world_space();
 	auto animation_info = this->animation_info.get(time);
-	return frustum.in_frustum(current_pos,
-	                          model_matrix,
-	                          animation_info->get_scalefactor(),
-	                          animation_info->get_max_bounds());
+	batch.add(current_pos,
+	          animation_info->get_scalefactor(),
+	          animation_info->get_max_bounds());
 }
 
 } // namespace openage::renderer::world
@@ -17,15 +17,17 @@
 
 
 namespace openage::renderer {
+class Texture2d;
 class UniformInput;
 
 namespace camera {
-class Frustum2d;
+struct CullingBatch;
 }
 
 namespace resources {
 class AssetManager;
 class Animation2dInfo;
+class FrameInfo;
 } // namespace resources
 
 namespace world {
@@ -127,22 +129,22 @@ public:
 
 	/**
 	 * Set the uniform inputs for the layers of this object.
-	 * Layer uniforms are updated on every update call.
+	 * Layer uniforms are updated on every update call. Uniforms that depend
+	 * on the displayed frame are only updated when the frame changes.
 	 *
 	 * @param uniforms Uniform inputs of this object's layers.
 	 */
 	void set_uniforms(std::vector<std::shared_ptr<renderer::UniformInput>> &&uniforms);
 
 	/**
-	 * Check whether the object is visible in the camera view.
+	 * Add the object to a batch of objects that are checked for
+	 * visibility in the camera view.
 	 *
-	 * @param frustum Camera frustum for culling.
+	 * @param batch Culling batch.
 	 * @param time Current simulation time.
-	 *
-	 * @return true if the object is visible, else false.
 	 */
-	bool is_visible(const camera::Frustum2d &frustum,
-	                const time::time_t &time);
+	void add_to_culling_batch(camera::CullingBatch &batch,
+	                          const time::time_t &time);
 
 	/**
 	 * Shader uniform IDs for setting uniform values.
@@ -157,6 +159,28 @@ public:
 	inline static uniform_id_t anchor_offset;
 
 private:
+	/**
+	 * Frame whose parameters were last written to the uniforms of a layer.
+	 */
+	struct layer_frame {
+		/**
+		 * Displayed frame.
+		 */
+		const renderer::resources::FrameInfo *frame = nullptr;
+
+		/**
+		 * Texture containing the frame. The uniforms only store the texture
+		 * handle, so this keeps the texture manager from removing the texture
+		 * while the renderable may still be drawn with it.
+		 */
+		std::shared_ptr<renderer::Texture2d> texture;
+
+		/**
+		 * Whether the frame is flipped horizontally.
+		 */
+		bool mirrored = false;
+	};
+
 	/**
 	 * Stores whether a new renderable for this object needs to be created
 	 * for the render pass.
@@ -206,6 +230,11 @@ private:
 	 */
 	std::vector<std::shared_ptr<renderer::UniformInput>> layer_uniforms;
 
+	/**
+	 * Frames last written to the layer uniforms.
+	 */
+	std::vector<layer_frame> layer_frames;
+
 	/**
 	 * Time of the last update call.
 	 */
@@ -3,6 +3,7 @@
 #include "render_stage.h"
 
 #include "renderer/camera/camera.h"
+#include "renderer/camera/frustum_2d.h"
 #include "renderer/camera/frustum_3d.h"
 #include "renderer/opengl/context.h"
 #include "renderer/render_pass.h"
@@ -61,12 +62,27 @@ void WorldRenderStage::add_render_entity(const std::shared_ptr<WorldRenderEntity
 void WorldRenderStage::update() {
 	std::unique_lock lock{this->mutex};
 	auto current_time = this->clock->get_real_time();
-	auto &camera_frustum = this->camera->get_frustum_2d();
 	for (auto &obj : this->render_objects) {
 		obj->fetch_updates(current_time);
+	}
+
+	// cull all objects at once, so that the camera matrices are only combined once
+	if (WorldRenderStage::ENABLE_FRUSTUM_CULLING) {
+		this->culling_batch.clear();
+		for (auto &obj : this->render_objects) {
+			obj->add_to_culling_batch(this->culling_batch, current_time);
+		}
+
+		auto &camera_frustum = this->camera->get_frustum_2d();
+		camera_frustum.in_frustum(this->culling_batch,
+		                          WorldObject::get_model_matrix(),
+		                          this->visible);
+	}
 
+	for (size_t i = 0; i < this->render_objects.size(); ++i) {
+		auto &obj = this->render_objects[i];
 		if (WorldRenderStage::ENABLE_FRUSTUM_CULLING
-		    and not obj->is_visible(camera_frustum, current_time)) {
+		    and not camera::is_visible(this->visible, i)) {
 			continue;
 		}
 
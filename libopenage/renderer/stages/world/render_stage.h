@@ -2,10 +2,12 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <shared_mutex>
 #include <vector>
 
+#include "renderer/camera/frustum_2d.h"
 #include "util/path.h"
 
 namespace openage {
@@ -136,6 +138,16 @@ private:
 	 */
 	std::vector<std::shared_ptr<WorldObject>> render_objects;
 
+	/**
+	 * Positions and animation bounds of the render objects for frustum culling.
+	 */
+	camera::CullingBatch culling_batch;
+
+	/**
+	 * Visibility bitmask of the render objects from the last culling pass.
+	 */
+	std::vector<uint64_t> visible;
+
 	/**
 	 * Shader for rendering the world objects.
 	 */
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <cstring>
 
 #include <functional>
@@ -64,6 +65,15 @@ using read_callback_t = std::function<size_t(unsigned char *buf, size_t size)>;
  * the appropriate amount of nullbits/nullbytes.
  * Calling the modeswitch methods while already in the respective mode does
  * nothing.
+ *
+ * Input
+ * -----
+ *
+ * The input is either pulled through a read callback into an internal buffer,
+ * or read directly from a contiguous span of memory.
+ * In bitstream mode, whole 16-bit words are refilled into a 64-bit bit buffer
+ * while the input has data at hand; bits that were loaded ahead of a switch to
+ * bytestream mode are handed out by read_bytes() first.
  */
 template <unsigned int inbuf_size>
 class BitStream {
@@ -81,27 +91,28 @@ private:
 
 	/**
 	 * Input byte buffer.
-	 * Used by both modes (via ensure_bits and read_bytes).
+	 * Used by both modes (via ensure_bits and read_bytes),
+	 * unless the input is a contiguous span.
 	 */
 	unsigned char inbuf[inbuf_size];
 
 	/**
-	 * Pointer to current position in inbuf.
+	 * Pointer to current position in the input (inbuf or the input span).
 	 */
-	unsigned char *i_ptr;
+	const unsigned char *i_ptr;
 
 	/**
-	 * Pointer to end of valid data in inbuf.
+	 * Pointer to end of valid data in the input.
 	 */
-	unsigned char *i_end;
+	const unsigned char *i_end;
 
 	/**
 	 * Bit buffer; used in bitstream mode.
-	 * Filled by via get_next_byte() via ensure_bits(),
+	 * Filled by ensure_bits(),
 	 * read by peak_bits(),
 	 * cleared by remove_bits().
 	 */
-	unsigned int bit_buffer;
+	uint64_t bit_buffer;
 
 	/**
 	 * The number of valid bits in bit_buffer.
@@ -110,6 +121,22 @@ private:
 	 */
 	unsigned int bits_left;
 
+	/**
+	 * Bytes that were loaded into the bit buffer before switching to
+	 * bytestream mode. They are consumed before any further input.
+	 */
+	unsigned char pending[2 * sizeof(uint64_t)];
+
+	/**
+	 * Position of the next pending byte.
+	 */
+	unsigned int pending_pos;
+
+	/**
+	 * End of the valid pending bytes.
+	 */
+	unsigned int pending_end;
+
 	/**
 	 * counts the number of bits (in bitstream mode) or bytes (in bytestream mode),
 	 * for determining the correct number of bits/bytes to discard.
@@ -141,7 +168,11 @@ private:
 		// check if we need to actually read some bytes.
 		if (this->input_bytes_available() == 0) {
 			// fill the entire input buffer.
-			size_t read_bytes = this->read_callback(this->inbuf, inbuf_size);
+			// without callback, the input span is all there is.
+			size_t read_bytes = 0;
+			if (this->read_callback) {
+				read_bytes = this->read_callback(this->inbuf, inbuf_size);
+			}
 
 			// we might overrun the input stream by asking for bits we don't use,
 			// so fake 2 more bytes at the end of input
@@ -178,6 +209,18 @@ private:
 	template <unsigned maxsymbols_p, unsigned tablebits_p, bool allow_empty>
 	friend class HuffmanTable;
 
+	/**
+	 * returns the next input byte, which is a pending byte if there is one.
+	 */
+	unsigned char next_input_byte() {
+		if (this->pending_pos < this->pending_end) [[unlikely]] {
+			return this->pending[this->pending_pos++];
+		}
+
+		this->ensure_input_bytes();
+		return *this->i_ptr++;
+	}
+
 	/**
 	 * for use in bitstream mode.
 	 *
@@ -187,23 +230,30 @@ private:
 		// example: input stream contains bytes A, B. previous byte was J.
 		//
 		// 5 bits are left
-		// bit buffer is:                     jjjjj000 00000000 00000000 00000000
+		// bit buffer is:                     jjjjj000 00000000 00000000 00000000 ...
 		//
 		// ensure_bits(9) is called.
 		// b0 = aaaaaaaa
 		// b1 = bbbbbbbb
-		// bit_buffer |= bbbbbbbb aaaaaaaa << (32 - 16 - 5) == 11
+		// bit_buffer |= bbbbbbbb aaaaaaaa << (64 - 16 - 5) == 43
 		//
-		// new bit buffer:                    jjjjjbbb bbbbbaaa aaaaa000 00000000
+		// new bit buffer:                    jjjjjbbb bbbbbaaa aaaaa000 00000000 ...
 
 		// read two bytes to b0, b1
-		this->ensure_input_bytes();
-		unsigned char b0 = *i_ptr++;
-		this->ensure_input_bytes();
-		unsigned char b1 = *i_ptr++;
+		unsigned char b0 = this->next_input_byte();
+		unsigned char b1 = this->next_input_byte();
 
 		// inject bits into bit_buffer
-		bit_buffer |= ((b1 << 8) | b0) << (sizeof(bit_buffer) * 8 - 16 - bits_left);
+		this->inject_16_bits((b1 << 8) | b0);
+	}
+
+	/**
+	 * for use in bitstream mode.
+	 *
+	 * appends a 16-bit value to the bits in the bit buffer.
+	 */
+	void inject_16_bits(uint64_t value) {
+		bit_buffer |= value << (sizeof(bit_buffer) * 8 - 16 - bits_left);
 		bits_left += 16;
 	}
 
@@ -217,6 +267,19 @@ private:
 			throw Error(MSG(err) << "instream: attempted to ensure bits while in bytestream mode");
 		}
 
+		if (bits_left >= nbits) [[likely]] {
+			return;
+		}
+
+		// fast path: fill the bit buffer with whole words directly from the input.
+		if (this->pending_pos == this->pending_end) [[likely]] {
+			while (bits_left <= sizeof(bit_buffer) * 8 - 16 and this->i_end - this->i_ptr >= 2) {
+				this->inject_16_bits((this->i_ptr[1] << 8) | this->i_ptr[0]);
+				this->i_ptr += 2;
+			}
+		}
+
+		// slow path: input buffer boundaries, pending bytes, EOF
 		while (bits_left < nbits) {
 			this->load_next_16_bits();
 		}
@@ -228,11 +291,11 @@ private:
 	 * returns nbits bits from the bit buffer, without removing them.
 	 */
 	unsigned peek_bits(unsigned int nbits) {
-		// example: bit buffer is:   abcdefgh ijkl0000 00000000 00000000
+		// example: bit buffer is:   abcdefgh ijkl0000 00000000 00000000 ...
 		//
 		// peek_bits(3) is called.
 		//
-		// return (bit_buffer >> (32 - 3) == 29
+		// return (bit_buffer >> (64 - 3) == 61
 		//
 		// returned value is:        abc
 		this->ensure_bits(nbits);
@@ -246,13 +309,13 @@ private:
 	 * removes nbits bits from the bit buffer.
 	 */
 	void remove_bits(unsigned int nbits) {
-		// example: bit buffer is:  abcdefgh ijkl0000 00000000 00000000
+		// example: bit buffer is:  abcdefgh ijkl0000 00000000 00000000 ...
 		//
 		// remove_bits(3) is called.
 		//
 		// bit_buffer <<= 3
 		//
-		// resulting bit buffer is: defghijk l0000000 00000000 00000000
+		// resulting bit buffer is: defghijk l0000000 00000000 00000000 ...
 		this->ensure_bits(nbits);
 
 		bit_buffer <<= nbits;
@@ -260,6 +323,24 @@ private:
 		this->stream_position += nbits;
 	}
 
+	/**
+	 * peek_bits() without the refill;
+	 * the caller must have ensured nbits bits before.
+	 */
+	unsigned peek_bits_ensured(unsigned int nbits) const {
+		return (bit_buffer >> (sizeof(bit_buffer) * 8 - nbits));
+	}
+
+	/**
+	 * remove_bits() without the refill;
+	 * the caller must have ensured nbits bits before.
+	 */
+	void remove_bits_ensured(unsigned int nbits) {
+		bit_buffer <<= nbits;
+		bits_left -= nbits;
+		this->stream_position += nbits;
+	}
+
 	/**
 	 * for use in bitstream mode.
 	 *
@@ -300,6 +381,27 @@ public:
 		i_end{inbuf},
 		bit_buffer{0},
 		bits_left{0},
+		pending_pos{0},
+		pending_end{0},
+		stream_position{0},
+		bitstream_mode{true} {
+		static_assert(inbuf_size >= 2, "inbuf size must be at least 2");
+		static_assert(inbuf_size % 2 == 0, "inbuf size must be even");
+	}
+
+	/**
+	 * Reads the input directly from a contiguous span of memory,
+	 * which must stay valid for the lifetime of the bitstream.
+	 */
+	BitStream(const unsigned char *data, size_t size) :
+		eof{false},
+		read_callback{},
+		i_ptr{data},
+		i_end{data + size},
+		bit_buffer{0},
+		bits_left{0},
+		pending_pos{0},
+		pending_end{0},
 		stream_position{0},
 		bitstream_mode{true} {
 		static_assert(inbuf_size >= 2, "inbuf size must be at least 2");
@@ -330,6 +432,20 @@ public:
 			throw Error(MSG(err) << "attempt to read_bytes while in bitstream mode");
 		}
 
+		// bytes that were loaded into the bit buffer ahead of time come first.
+		if (this->pending_pos < this->pending_end) [[unlikely]] {
+			unsigned int available = this->pending_end - this->pending_pos;
+			if (available < count) {
+				count = available;
+			}
+
+			memcpy(buf, &this->pending[this->pending_pos], count);
+			this->pending_pos += count;
+			this->stream_position += count;
+
+			return count;
+		}
+
 		this->ensure_input_bytes();
 
 		unsigned int available = this->input_bytes_available();
@@ -414,9 +530,31 @@ public:
 		this->bitstream_mode = false;
 		this->stream_position = 0;
 
-		if (this->bits_left) {
+		if (this->bits_left % 16 != 0) {
 			throw Error(MSG(err) << "bits left after switching to bytestream mode: " << this->bits_left);
 		}
+
+		// the remaining words in the bit buffer were read ahead; they are
+		// the next bytes of the bytestream, followed by older pending bytes.
+		unsigned char ahead[sizeof(bit_buffer)];
+		unsigned int ahead_count = 0;
+		while (this->bits_left > 0) {
+			unsigned int word = this->bit_buffer >> (sizeof(bit_buffer) * 8 - 16);
+			ahead[ahead_count++] = word & 0xff;
+			ahead[ahead_count++] = word >> 8;
+			this->bit_buffer <<= 16;
+			this->bits_left -= 16;
+		}
+
+		unsigned int remaining = this->pending_end - this->pending_pos;
+		if (ahead_count + remaining > sizeof(this->pending)) [[unlikely]] {
+			throw Error(MSG(err) << "too many read-ahead bytes when switching to bytestream mode");
+		}
+
+		memmove(&this->pending[ahead_count], &this->pending[this->pending_pos], remaining);
+		memcpy(this->pending, ahead, ahead_count);
+		this->pending_pos = 0;
+		this->pending_end = ahead_count + remaining;
 	}
 
 	/**
@@ -1,7 +1,7 @@
 // This file was adapted from cabextract/libmspack <http://www.cabextract.org.uk/>,
 // Copyright 2003-2013 the cabextract contributors.
 // It's licensed under the terms of the GNU Library General Public License version 2.
-// Modifications Copyright 2014-2023 the openage authors.
+// Modifications Copyright 2014-2024 the openage authors.
 // See copying.md for further legal info.
 
 /*
@@ -46,7 +46,7 @@ constexpr unsigned LZX_NUM_SECONDARY_LENGTHS = 249; // length tree #elements
 
 // LZX huffman constants: tweak tablebits as desired
 constexpr unsigned LZX_PRETREE_MAXSYMBOLS = LZX_PRETREE_NUM_ELEMENTS;
-constexpr unsigned LZX_PRETREE_TABLEBITS = 6;
+constexpr unsigned LZX_PRETREE_TABLEBITS = 8;
 constexpr unsigned LZX_MAINTREE_MAXSYMBOLS = LZX_NUM_CHARS + 50 * 8;
 constexpr unsigned LZX_MAINTREE_TABLEBITS = 12;
 constexpr unsigned LZX_LENGTH_MAXSYMBOLS = LZX_NUM_SECONDARY_LENGTHS + 1;
@@ -91,19 +91,33 @@ public:
 	static constexpr unsigned int maxsymbols = maxsymbols_p;
 	static constexpr unsigned int tablebits = tablebits_p;
 
+	/**
+	 * number of index bits of the second-level tables
+	 */
+	static constexpr unsigned int subtablebits = HUFF_MAXBITS - tablebits_p;
+
+	/**
+	 * decode table entry layout:
+	 * bits 0-15: symbol, or offset of the second-level table
+	 * bits 16-23: code length in bits
+	 * bit 31: entry links to a second-level table
+	 */
+	static constexpr uint32_t ENTRY_SUBTABLE = 1u << 31;
+
 	/**
 	 * table of code lengths (in bits) for each symbol
 	 */
 	unsigned char len[maxsymbols_p + LZX_LENTABLE_SAFETY];
 
 	/**
-	 * table to fill up with decoded values for symbols, and pointers.
-	 * symbols shorter than tablebits_p are decoded by direct lookup
+	 * two-level decode table.
+	 * symbols with codes of up to tablebits_p bits are decoded by direct lookup
 	 * (that's the first (1<<tablebits_p) entries).
-	 * longer symbols are decoded by following pointers to the appropriate
-	 * leaf in the upper nsyms*2 fields.
+	 * longer codes share their first tablebits_p bits with at most maxsymbols_p
+	 * other codes; each such prefix links to a second-level table, which is
+	 * indexed by the remaining (HUFF_MAXBITS - tablebits_p) bits.
 	 */
-	uint16_t table[(1 << tablebits_p) + (maxsymbols_p * 2)];
+	uint32_t table[(1 << tablebits_p) + (maxsymbols_p << subtablebits)];
 
 	/**
 	 * the table could not be constructed and is empty (try_make_decode_table failed).
@@ -136,9 +150,9 @@ public:
 
 private:
 	/**
-	 * This function was originally coded by David Tritscher.
-	 * It builds a fast huffman decoding table from
+	 * Builds the two-level huffman decoding table from
 	 * a canonical huffman code lengths table.
+	 * Fails if the code is not complete.
 	 */
 	bool try_make_decode_table();
 };
@@ -178,6 +192,7 @@ public:
 
 	/** See the doc for LZXDecompressor::LZXDecompressor in lzxd.h */
 	LZXDStream(read_callback_t callback, unsigned int window_bits, unsigned int reset_interval);
+	LZXDStream(const unsigned char *data, size_t size, unsigned int window_bits, unsigned int reset_interval);
 	~LZXDStream();
 
 	LZXDStream(const LZXDStream &other) = delete;
@@ -189,6 +204,11 @@ public:
 	unsigned decompress_next_frame(unsigned char *output_buf);
 
 private:
+	/**
+	 * Allocates the window; shared by the constructors.
+	 */
+	void init_window(unsigned int window_bits);
+
 	/**
 	 * Initializes the next block.
 	 */
@@ -208,6 +228,13 @@ private:
 	 */
 	int decode_symbol_from_aligned_block();
 
+	/**
+	 * Copies a match of match_length bytes from match_offset bytes back
+	 * in the window to the current window position.
+	 * The window position is not advanced.
+	 */
+	void copy_match(unsigned int match_offset, unsigned int match_length);
+
 	/**
 	 * Reads the given amount of bytes from the current uncompressed block.
 	 * Returns its argument (the number of bytes that were read).
@@ -232,20 +259,17 @@ public:
 
 template <unsigned int maxsymbols_p, unsigned int tablebits_p, bool allow_empty>
 int HuffmanTable<maxsymbols_p, tablebits_p, allow_empty>::read_sym() {
-	lzx->bits.ensure_bits(HUFF_MAXBITS);
-	uint16_t sym = table[lzx->bits.peek_bits(tablebits)];
-
-	unsigned i = 1 << (sizeof(lzx->bits.bit_buffer) * 8 - tablebits);
-	while (sym >= maxsymbols) {
-		// huff_traverse
-		if ((i >>= 1) == 0) [[unlikely]] {
-			throw Error(MSG(err) << "huff_error in huff_traverse");
-		}
-		sym = table[(sym << 1) | ((lzx->bits.bit_buffer & i) ? 1 : 0)];
+	auto &bits = lzx->bits;
+	bits.ensure_bits(HUFF_MAXBITS);
+	uint32_t entry = table[bits.peek_bits_ensured(tablebits)];
+
+	if (entry & ENTRY_SUBTABLE) [[unlikely]] {
+		unsigned int index = bits.peek_bits_ensured(HUFF_MAXBITS) & ((1 << subtablebits) - 1);
+		entry = table[(entry & 0xFFFF) + index];
 	}
 
-	lzx->bits.remove_bits(len[sym]);
-	return sym;
+	bits.remove_bits_ensured((entry >> 16) & 0xFF);
+	return entry & 0xFFFF;
 }
 
 
@@ -275,84 +299,73 @@ void HuffmanTable<maxsymbols_p, tablebits_p, allow_empty>::make_decode_table() {
 
 template <unsigned int maxsymbols_p, unsigned int tablebits_p, bool allow_empty>
 bool HuffmanTable<maxsymbols_p, tablebits_p, allow_empty>::try_make_decode_table() {
-	uint16_t sym, next_symbol;
-	unsigned int leaf, fill;
-	unsigned char bit_num;
-	unsigned int pos = 0; // the current position in the decode table
-	unsigned int table_mask = 1 << tablebits;
-	unsigned int bit_mask = table_mask >> 1; // don't do 0 length codes
-
-	// fill entries for codes short enough for a direct mapping
-	for (bit_num = 1; bit_num <= tablebits; bit_num++) {
-		for (sym = 0; sym < maxsymbols; sym++) {
-			if (len[sym] != bit_num) {
-				continue;
-			}
-			leaf = pos;
-			if ((pos += bit_mask) > table_mask) {
-				return false; // table overrun
-			}
-
-			// fill all possible lookups of this symbol with the symbol itself
-			for (fill = bit_mask; fill-- > 0;) {
-				table[leaf++] = sym;
-			}
+	// number of codes per code length
+	unsigned int count[HUFF_MAXBITS + 1] = {};
+	for (unsigned int sym = 0; sym < maxsymbols; sym++) {
+		if (len[sym] > HUFF_MAXBITS) {
+			return false;
 		}
-		bit_mask >>= 1;
+		count[len[sym]]++;
 	}
+	count[0] = 0;
 
-	// exit with success if table is now complete
-	if (pos == table_mask) {
-		return true;
+	// the code must be complete: every bit sequence decodes to a symbol.
+	uint32_t coverage = 0;
+	for (unsigned int bit_num = 1; bit_num <= HUFF_MAXBITS; bit_num++) {
+		coverage += count[bit_num] << (HUFF_MAXBITS - bit_num);
 	}
-
-	// mark all remaining table entries as unused
-	for (sym = pos; sym < table_mask; sym++) {
-		table[sym] = 0xFFFF;
+	if (coverage != (1u << HUFF_MAXBITS)) {
+		return false;
 	}
 
-	// next_symbol = base of allocation for long codes
-	next_symbol = ((table_mask >> 1) < maxsymbols) ? maxsymbols : (table_mask >> 1);
+	// first canonical code for each code length
+	uint32_t next_code[HUFF_MAXBITS + 1] = {};
+	uint32_t code = 0;
+	for (unsigned int bit_num = 1; bit_num <= HUFF_MAXBITS; bit_num++) {
+		code = (code + count[bit_num - 1]) << 1;
+		next_code[bit_num] = code;
+	}
 
-	// give ourselves room for codes to grow by up to 16 more bits.
-	// codes now start at bit (tablebits + 16) and end at (tablebits + 16 - codelength)
-	pos <<= 16;
-	table_mask <<= 16;
-	bit_mask = 1 << 15;
+	// no first-level entry links to a second-level table yet
+	for (unsigned int i = 0; i < (1u << tablebits); i++) {
+		table[i] = 0;
+	}
+	uint32_t next_subtable = 1 << tablebits;
 
-	for (bit_num = tablebits + 1; bit_num <= HUFF_MAXBITS; bit_num++) {
-		for (sym = 0; sym < maxsymbols; sym++) {
-			if (len[sym] != bit_num) {
-				continue;
-			}
+	// codes are assigned in symbol order for each length
+	for (unsigned int sym = 0; sym < maxsymbols; sym++) {
+		unsigned int bit_num = len[sym];
+		if (bit_num == 0) {
+			continue;
+		}
 
-			leaf = pos >> 16;
-			for (fill = 0; fill < (bit_num - tablebits); fill++) {
-				// if this path hasn't been taken yet, 'allocate' two entries
-				if (table[leaf] == 0xFFFF) {
-					table[(next_symbol << 1) + 0] = 0xFFFF;
-					table[(next_symbol << 1) + 1] = 0xFFFF;
-					table[leaf] = next_symbol++;
-				}
+		uint32_t sym_code = next_code[bit_num]++;
+		uint32_t entry = (bit_num << 16) | sym;
 
-				// follow the path and select either left or right for next bit
-				leaf = table[leaf] << 1;
-				if ((pos >> (15 - fill)) & 1)
-					leaf++;
+		if (bit_num <= tablebits) {
+			// fill all possible lookups of this symbol with the symbol itself
+			uint32_t first = sym_code << (tablebits - bit_num);
+			for (uint32_t fill = 0; fill < (1u << (tablebits - bit_num)); fill++) {
+				table[first + fill] = entry;
 			}
-			table[leaf] = sym;
+			continue;
+		}
 
-			if ((pos += bit_mask) > table_mask) {
-				// table overflow
-				return false;
-			}
+		// long code: allocate the second-level table for its prefix
+		uint32_t prefix = sym_code >> (bit_num - tablebits);
+		if (not (table[prefix] & ENTRY_SUBTABLE)) {
+			table[prefix] = ENTRY_SUBTABLE | next_subtable;
+			next_subtable += 1 << subtablebits;
 		}
 
-		bit_mask >>= 1;
+		uint32_t subtable = table[prefix] & 0xFFFF;
+		uint32_t first = (sym_code << (HUFF_MAXBITS - bit_num)) & ((1 << subtablebits) - 1);
+		for (uint32_t fill = 0; fill < (1u << (HUFF_MAXBITS - bit_num)); fill++) {
+			table[subtable + first + fill] = entry;
+		}
 	}
 
-	// full table?
-	return pos == table_mask;
+	return true;
 }
 
 
@@ -426,6 +439,30 @@ LZXDStream::LZXDStream(read_callback_t read_callback,
 	htmain{this},
 	htlength{this},
 	htaligned{this} {
+	this->init_window(window_bits);
+}
+
+
+LZXDStream::LZXDStream(const unsigned char *data,
+                       size_t size,
+                       unsigned int window_bits,
+                       unsigned int reset_interval) :
+	output_pos{0},
+	window_size{static_cast<unsigned int>(1) << window_bits},
+	window_posn{0},
+	frame_posn{0},
+	frame{0},
+	reset_interval{reset_interval},
+	bits{data, size},
+	htpre{this},
+	htmain{this},
+	htlength{this},
+	htaligned{this} {
+	this->init_window(window_bits);
+}
+
+
+void LZXDStream::init_window(unsigned int window_bits) {
 	// LZX supports window sizes of 2^15 (32 KiB) through 2^21 (2 MiB)
 	if (window_bits < 15 || window_bits > 21) {
 		throw Error(MSG(err) << "Bad requested window size: 2^" << window_bits << " bytes");
@@ -574,39 +611,7 @@ int LZXDStream::decode_symbol_from_verbatim_block() {
 		this->R0 = match_offset;
 	}
 
-	if ((this->window_posn + match_length) > this->window_size) [[unlikely]] {
-		throw Error(MSG(err) << "decrunch: match ran over window wrap");
-	}
-
-	// copy match
-	unsigned char *rundest = &window[this->window_posn];
-	int i = match_length;
-	// does match offset wrap the window?
-	if (match_offset > this->window_posn) {
-		// j = length from match offset to end of window
-		int j = match_offset - this->window_posn;
-		if (j > (int)this->window_size) [[unlikely]] {
-			throw Error(MSG(err) << "decrunch: match offset beyond window boundaries");
-		}
-		unsigned char *runsrc = &window[this->window_size - j];
-		if (j < i) {
-			// if match goes over the window edge, do two copy runs
-			i -= j;
-			while (j-- > 0) {
-				*rundest++ = *runsrc++;
-			}
-			runsrc = window;
-		}
-		while (i-- > 0) {
-			*rundest++ = *runsrc++;
-		}
-	}
-	else {
-		unsigned char *runsrc = rundest - match_offset;
-		while (i-- > 0) {
-			*rundest++ = *runsrc++;
-		}
-	}
+	this->copy_match(match_offset, match_length);
 
 	this->window_posn += match_length;
 	return match_length;
@@ -685,42 +690,69 @@ int LZXDStream::decode_symbol_from_aligned_block() {
 		this->R0 = match_offset;
 	}
 
+	this->copy_match(match_offset, match_length);
+
+	this->window_posn += match_length;
+	return match_length;
+}
+
+
+namespace {
+
+/**
+ * Copies length bytes from src to dest, where src may overlap dest from below.
+ * Overlapping matches repeat the pattern between src and dest, which is copied
+ * in chunks that double in size.
+ */
+inline void lz_copy(unsigned char *dest, const unsigned char *src, size_t length) {
+	size_t distance = dest - src;
+
+	if (distance >= length) [[likely]] {
+		memcpy(dest, src, length);
+	}
+	else if (distance == 1) {
+		memset(dest, *src, length);
+	}
+	else {
+		while (length > 0) {
+			size_t chunk = std::min<size_t>(length, dest - src);
+			memcpy(dest, src, chunk);
+			dest += chunk;
+			length -= chunk;
+		}
+	}
+}
+
+} // namespace
+
+
+void LZXDStream::copy_match(unsigned int match_offset, unsigned int match_length) {
 	if ((this->window_posn + match_length) > this->window_size) [[unlikely]] {
 		throw Error(MSG(err) << "decrunch: match ran over window wrap");
 	}
 
-	// copy match
 	unsigned char *rundest = &window[this->window_posn];
-	int i = match_length;
+
 	// does match offset wrap the window?
-	if (match_offset > this->window_posn) {
+	if (match_offset > this->window_posn) [[unlikely]] {
 		// j = length from match offset to end of window
-		int j = match_offset - this->window_posn;
-		if (j > (int)this->window_size) [[unlikely]] {
+		unsigned int j = match_offset - this->window_posn;
+		if (j > this->window_size) [[unlikely]] {
 			throw Error(MSG(err) << "decrunch: match offset beyond window boundaries");
 		}
 		unsigned char *runsrc = &window[this->window_size - j];
-		if (j < i) {
+		if (j < match_length) {
 			// if match goes over the window edge, do two copy runs
-			i -= j;
-			while (j-- > 0) {
-				*rundest++ = *runsrc++;
-			}
-			runsrc = window;
+			memmove(rundest, runsrc, j);
+			lz_copy(rundest + j, window, match_length - j);
 		}
-		while (i-- > 0) {
-			*rundest++ = *runsrc++;
+		else {
+			memmove(rundest, runsrc, match_length);
 		}
 	}
 	else {
-		unsigned char *runsrc = rundest - match_offset;
-		while (i-- > 0) {
-			*rundest++ = *runsrc++;
-		}
+		lz_copy(rundest, rundest - match_offset, match_length);
 	}
-
-	this->window_posn += match_length;
-	return match_length;
 }
 
 
@@ -925,6 +957,13 @@ LZXDecompressor::LZXDecompressor(read_callback_t read_callback,
 	stream{new LZXDStream{std::move(read_callback), window_bits, reset_interval}} {}
 
 
+LZXDecompressor::LZXDecompressor(const unsigned char *data,
+                                 size_t size,
+                                 unsigned int window_bits,
+                                 unsigned int reset_interval) :
+	stream{new LZXDStream{data, size, window_bits, reset_interval}} {}
+
+
 LZXDecompressor::~LZXDecompressor() {
 	delete stream;
 }
@@ -57,6 +57,22 @@ public:
 	                unsigned int window_bits = 21,
 	                unsigned int reset_interval = 0);
 
+	/*
+	 * Initialises LZX decompression state for decoding an LZX stream
+	 * that is available as a whole in memory. This avoids the read callback
+	 * and lets the bitstream refill straight from the input.
+	 *
+	 * @param data               the compressed stream; must stay valid until
+	 *                           the decompressor is destroyed.
+	 * @param size               size of the compressed stream in bytes.
+	 * @param window_bits        see above.
+	 * @param reset_interval     see above.
+	 */
+	LZXDecompressor(const unsigned char *data,
+	                size_t size,
+	                unsigned int window_bits = 21,
+	                unsigned int reset_interval = 0);
+
 	/**
 	 * Frees the internally-allocated LZXDStream object.
 	 */
@@ -0,0 +1,588 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "lzxd.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../log/log.h"
+#include "../../testing/testing.h"
+
+
+namespace openage::util::compress::tests {
+
+namespace {
+
+/*
+ * A minimal LZX encoder, used to produce test and benchmark corpora.
+ *
+ * It emits verbatim, aligned and uncompressed blocks of any size, but
+ * never uses the repeated-offset slots, so it's simple but still exercises
+ * the huffman tables, the position slots, the match copying and the
+ * switches between bitstream and bytestream mode.
+ */
+
+constexpr unsigned window_bits = 21;
+constexpr unsigned num_chars = 256;
+constexpr unsigned posn_slots = 50;
+constexpr unsigned main_symbols = num_chars + posn_slots * 8;
+constexpr unsigned length_symbols = 249;
+constexpr unsigned max_bits = 16;
+constexpr unsigned min_match = 3;
+constexpr unsigned max_match = 257;
+
+constexpr unsigned block_verbatim = 1;
+constexpr unsigned block_aligned = 2;
+constexpr unsigned block_uncompressed = 3;
+
+
+/**
+ * 16-bit little-endian word bit writer.
+ */
+class BitWriter {
+public:
+	void write(uint32_t value, unsigned nbits) {
+		for (unsigned i = nbits; i-- > 0;) {
+			this->word = (this->word << 1) | ((value >> i) & 1);
+			if (++this->word_bits == 16) {
+				this->flush_word();
+			}
+		}
+	}
+
+	/** pad to the next 16-bit boundary */
+	void align() {
+		if (this->word_bits > 0) {
+			this->write(0, 16 - this->word_bits);
+		}
+	}
+
+	/** pad with 1 to 16 bits to the next 16-bit boundary, as before a bytestream */
+	void pad() {
+		this->write(0, 16 - this->word_bits);
+	}
+
+	std::vector<uint8_t> out;
+
+private:
+	void flush_word() {
+		this->out.push_back(this->word & 0xff);
+		this->out.push_back(this->word >> 8);
+		this->word = 0;
+		this->word_bits = 0;
+	}
+
+	uint32_t word = 0;
+	unsigned word_bits = 0;
+};
+
+
+/**
+ * Huffman code lengths for the given frequencies, limited to max_bits.
+ * At least two symbols are always assigned, so the code is complete.
+ */
+std::vector<uint8_t> code_lengths(std::vector<uint32_t> freq) {
+	std::vector<uint8_t> lengths(freq.size(), 0);
+
+	freq[0] = std::max<uint32_t>(freq[0], 1);
+	freq[1] = std::max<uint32_t>(freq[1], 1);
+
+	while (true) {
+		struct Node {
+			uint64_t weight;
+			int left;
+			int right;
+		};
+		std::vector<Node> nodes;
+		using item_t = std::pair<uint64_t, int>;
+		std::priority_queue<item_t, std::vector<item_t>, std::greater<item_t>> heap;
+
+		for (size_t sym = 0; sym < freq.size(); sym++) {
+			if (freq[sym] > 0) {
+				nodes.push_back({freq[sym], -1, static_cast<int>(sym)});
+				heap.emplace(freq[sym], nodes.size() - 1);
+			}
+		}
+
+		while (heap.size() > 1) {
+			auto a = heap.top();
+			heap.pop();
+			auto b = heap.top();
+			heap.pop();
+			nodes.push_back({a.first + b.first, a.second, b.second});
+			heap.emplace(a.first + b.first, nodes.size() - 1);
+		}
+
+		// assign depths
+		bool too_long = false;
+		std::vector<std::pair<int, uint8_t>> stack{{heap.top().second, 0}};
+		while (not stack.empty()) {
+			auto [idx, depth] = stack.back();
+			stack.pop_back();
+			if (nodes[idx].left < 0) {
+				lengths[nodes[idx].right] = depth;
+				too_long = too_long or depth > max_bits;
+			}
+			else {
+				stack.emplace_back(nodes[idx].left, depth + 1);
+				stack.emplace_back(nodes[idx].right, depth + 1);
+			}
+		}
+
+		if (not too_long) {
+			return lengths;
+		}
+
+		// flatten the distribution and try again
+		for (auto &f : freq) {
+			if (f > 0) {
+				f = (f + 1) / 2;
+			}
+		}
+	}
+}
+
+
+/**
+ * Canonical huffman codes for the given lengths.
+ */
+std::vector<uint32_t> canonical_codes(const std::vector<uint8_t> &lengths) {
+	std::vector<uint32_t> codes(lengths.size(), 0);
+	uint32_t code = 0;
+	for (unsigned bits = 1; bits <= max_bits; bits++) {
+		for (size_t sym = 0; sym < lengths.size(); sym++) {
+			if (lengths[sym] == bits) {
+				codes[sym] = code++;
+			}
+		}
+		code <<= 1;
+	}
+	return codes;
+}
+
+
+/**
+ * Write code lengths [first, last) as deltas to the previous lengths,
+ * using a fixed, complete pretree.
+ */
+void write_lengths(BitWriter &bits,
+                   const std::vector<uint8_t> &lengths,
+                   std::vector<uint8_t> &prev,
+                   unsigned first,
+                   unsigned last) {
+	// pretree: symbols 0..11 get 4 bits, 12..19 get 5 bits.
+	std::vector<uint8_t> pre_lengths(20);
+	for (unsigned i = 0; i < 20; i++) {
+		pre_lengths[i] = (i < 12) ? 4 : 5;
+		bits.write(pre_lengths[i], 4);
+	}
+	auto pre_codes = canonical_codes(pre_lengths);
+
+	for (unsigned i = first; i < last; i++) {
+		unsigned delta = (prev[i] + 17 - lengths[i]) % 17;
+		bits.write(pre_codes[delta], pre_lengths[delta]);
+		prev[i] = lengths[i];
+	}
+}
+
+
+struct Symbol {
+	/// literal byte or match length
+	uint16_t value;
+	/// 0 for literals
+	uint32_t offset;
+	/// the symbol ends a frame
+	bool frame_end;
+};
+
+
+struct Block {
+	/// block type, verbatim, aligned or uncompressed
+	unsigned type;
+	/// number of uncompressed bytes
+	size_t size;
+};
+
+
+/**
+ * Encode data as LZX stream, split into the given blocks.
+ */
+std::vector<uint8_t> lzx_encode(const std::vector<uint8_t> &data,
+                                const std::vector<Block> &blocks) {
+	static_assert(window_bits == 21, "posn_slots is set up for a 2 MiB window");
+
+	BitWriter bits;
+	// no intel e8 translation
+	bits.write(0, 1);
+
+	std::vector<uint8_t> prev_main(main_symbols, 0);
+	std::vector<uint8_t> prev_length(length_symbols, 0);
+
+	// position_base for the position slots
+	std::array<uint32_t, posn_slots + 1> position_base;
+	std::array<uint8_t, posn_slots> slot_bits;
+	for (unsigned i = 0, base = 0; i < posn_slots; i++) {
+		slot_bits[i] = (i < 4) ? 0 : std::min<unsigned>((i - 2) / 2, 17);
+		position_base[i] = base;
+		base += 1 << slot_bits[i];
+		position_base[i + 1] = base;
+	}
+
+	std::vector<int64_t> last_seen(1 << 16, -1);
+	auto hash = [&](size_t pos) {
+		return ((data[pos] << 8) ^ (data[pos + 1] << 4) ^ data[pos + 2]) & 0xffff;
+	};
+
+	size_t block_start = 0;
+	for (auto &block : blocks) {
+		size_t block_end = block_start + block.size;
+
+		bits.write(block.type, 3);
+		bits.write(block.size >> 8, 16);
+		bits.write(block.size & 0xff, 8);
+
+		if (block.type == block_uncompressed) {
+			bits.pad();
+
+			// R0, R1, R2
+			for (int i = 0; i < 3; i++) {
+				bits.out.insert(bits.out.end(), {1, 0, 0, 0});
+			}
+
+			bits.out.insert(bits.out.end(), data.begin() + block_start, data.begin() + block_end);
+			if (block.size & 1) {
+				bits.out.push_back(0);
+			}
+
+			block_start = block_end;
+			continue;
+		}
+
+		// find matches greedily, matches must not cross the block or frame end
+		std::vector<Symbol> symbols;
+		for (size_t pos = block_start; pos < block_end;) {
+			size_t segment_end = std::min<size_t>(block_end, (pos / LZX_FRAME_SIZE + 1) * LZX_FRAME_SIZE);
+
+			size_t best_len = 0;
+			size_t best_offset = 0;
+
+			if (pos + min_match <= segment_end) {
+				uint32_t h = hash(pos);
+				int64_t candidate = last_seen[h];
+				last_seen[h] = pos;
+
+				if (candidate >= 0) {
+					size_t limit = std::min<size_t>(max_match, segment_end - pos);
+					size_t len = 0;
+					while (len < limit and data[candidate + len] == data[pos + len]) {
+						len++;
+					}
+					if (len >= min_match) {
+						best_len = len;
+						best_offset = pos - candidate;
+					}
+				}
+			}
+
+			if (best_len > 0) {
+				for (size_t i = 1; i < best_len and pos + i + min_match <= segment_end; i++) {
+					last_seen[hash(pos + i)] = pos + i;
+				}
+				pos += best_len;
+				symbols.push_back({static_cast<uint16_t>(best_len), static_cast<uint32_t>(best_offset), pos % LZX_FRAME_SIZE == 0});
+			}
+			else {
+				symbols.push_back({data[pos], 0, (pos + 1) % LZX_FRAME_SIZE == 0});
+				pos += 1;
+			}
+		}
+
+		// translate to huffman symbols and gather frequencies
+		struct Coded {
+			unsigned main;
+			int length_footer;
+			unsigned extra_nbits;
+			uint32_t extra;
+			bool frame_end;
+		};
+		std::vector<Coded> coded;
+		std::vector<uint32_t> main_freq(main_symbols, 0);
+		std::vector<uint32_t> length_freq(length_symbols, 0);
+		std::vector<uint32_t> aligned_freq(8, 0);
+
+		for (auto &sym : symbols) {
+			if (sym.offset == 0) {
+				coded.push_back({sym.value, -1, 0, 0, sym.frame_end});
+				main_freq[sym.value]++;
+				continue;
+			}
+
+			uint32_t formatted = sym.offset + 2;
+			unsigned slot = 3;
+			while (position_base[slot + 1] <= formatted) {
+				slot++;
+			}
+
+			unsigned len_header = std::min<unsigned>(sym.value - 2, 7);
+			int footer = (len_header == 7) ? (sym.value - 2 - 7) : -1;
+
+			unsigned main = num_chars + ((slot << 3) | len_header);
+			uint32_t extra = formatted - position_base[slot];
+			coded.push_back({main, footer, slot_bits[slot], extra, sym.frame_end});
+			main_freq[main]++;
+			if (footer >= 0) {
+				length_freq[footer]++;
+			}
+			if (slot_bits[slot] >= 3) {
+				aligned_freq[extra & 7]++;
+			}
+		}
+
+		auto main_len = code_lengths(main_freq);
+		auto length_len = code_lengths(length_freq);
+		auto aligned_len = code_lengths(aligned_freq);
+		auto main_code = canonical_codes(main_len);
+		auto length_code = canonical_codes(length_len);
+		auto aligned_code = canonical_codes(aligned_len);
+
+		if (block.type == block_aligned) {
+			for (auto len : aligned_len) {
+				bits.write(len, 3);
+			}
+		}
+
+		write_lengths(bits, main_len, prev_main, 0, num_chars);
+		write_lengths(bits, main_len, prev_main, num_chars, main_symbols);
+		write_lengths(bits, length_len, prev_length, 0, length_symbols);
+
+		for (auto &c : coded) {
+			bits.write(main_code[c.main], main_len[c.main]);
+			if (c.length_footer >= 0) {
+				bits.write(length_code[c.length_footer], length_len[c.length_footer]);
+			}
+			if (c.main >= num_chars) {
+				if (block.type == block_aligned and c.extra_nbits >= 3) {
+					// the lowest 3 bits are huffman-coded
+					bits.write(c.extra >> 3, c.extra_nbits - 3);
+					bits.write(aligned_code[c.extra & 7], aligned_len[c.extra & 7]);
+				}
+				else {
+					bits.write(c.extra, c.extra_nbits);
+				}
+			}
+
+			// the decoder realigns at each frame boundary
+			if (c.frame_end) {
+				bits.align();
+			}
+		}
+
+		block_start = block_end;
+	}
+
+	bits.align();
+	return std::move(bits.out);
+}
+
+
+/**
+ * Encode data as LZX stream with one block of the given type per frame.
+ */
+std::vector<uint8_t> lzx_encode(const std::vector<uint8_t> &data,
+                                unsigned block_type = block_verbatim) {
+	std::vector<Block> blocks;
+	for (size_t pos = 0; pos < data.size(); pos += LZX_FRAME_SIZE) {
+		blocks.push_back({block_type, std::min<size_t>(LZX_FRAME_SIZE, data.size() - pos)});
+	}
+	return lzx_encode(data, blocks);
+}
+
+
+/**
+ * Generate a compressible corpus: words from a small vocabulary,
+ * interleaved with runs of binary-ish noise.
+ */
+std::vector<uint8_t> make_corpus(size_t size, uint32_t seed) {
+	static const char *words[] = {
+		"openage", "villager", "castle", "trebuchet", "wololo", "monk",
+		"gold", "stone", "wood", "food", "relic", "wonder", "the", "and",
+		"of", "a", "to", "archer", "knight", "pikeman", "\n", ", ", ". "
+	};
+
+	std::mt19937 rng{seed};
+	std::vector<uint8_t> corpus;
+	corpus.reserve(size);
+
+	while (corpus.size() < size) {
+		if (rng() % 16 == 0) {
+			unsigned count = rng() % 64;
+			for (unsigned i = 0; i < count; i++) {
+				corpus.push_back(rng() & 0xff);
+			}
+		}
+		else {
+			const char *word = words[rng() % std::size(words)];
+			corpus.insert(corpus.end(), word, word + std::strlen(word));
+			corpus.push_back(' ');
+		}
+	}
+
+	corpus.resize(size);
+	return corpus;
+}
+
+
+/**
+ * Decode a whole LZX stream from memory.
+ */
+std::vector<uint8_t> lzx_decode(const std::vector<uint8_t> &compressed, size_t size) {
+	LZXDecompressor decompressor{compressed.data(), compressed.size(), window_bits};
+
+	std::vector<uint8_t> result(size + LZX_FRAME_SIZE);
+	size_t pos = 0;
+	while (pos < size) {
+		unsigned frame_size = decompressor.decompress_next_frame(result.data() + pos);
+		if (frame_size == 0) {
+			break;
+		}
+		pos += frame_size;
+	}
+
+	result.resize(pos);
+	return result;
+}
+
+
+/**
+ * Decode a whole LZX stream through a read callback that hands out
+ * chunks of at most chunk_size bytes.
+ */
+std::vector<uint8_t> lzx_decode_chunked(const std::vector<uint8_t> &compressed,
+                                        size_t size,
+                                        size_t chunk_size) {
+	size_t read_pos = 0;
+	LZXDecompressor decompressor{
+		[&](unsigned char *buf, size_t count) -> size_t {
+			count = std::min<size_t>({count, chunk_size, compressed.size() - read_pos});
+			std::memcpy(buf, compressed.data() + read_pos, count);
+			read_pos += count;
+			return count;
+		},
+		window_bits};
+
+	std::vector<uint8_t> result(size + LZX_FRAME_SIZE);
+	size_t pos = 0;
+	while (pos < size) {
+		unsigned frame_size = decompressor.decompress_next_frame(result.data() + pos);
+		if (frame_size == 0) {
+			break;
+		}
+		pos += frame_size;
+	}
+
+	result.resize(pos);
+	return result;
+}
+
+} // namespace
+
+
+void lzxd() {
+	auto corpus = make_corpus(5 * LZX_FRAME_SIZE + 1234, 42);
+	auto compressed = lzx_encode(corpus);
+
+	(compressed.size() < corpus.size()) or TESTFAIL;
+
+	// decode from a contiguous span
+	TESTEQUALS(lzx_decode(compressed, corpus.size()) == corpus, true);
+
+	// decode through a read callback that hands out odd chunk sizes
+	TESTEQUALS(lzx_decode_chunked(compressed, corpus.size(), 333) == corpus, true);
+
+	// aligned blocks
+	auto aligned = lzx_encode(corpus, block_aligned);
+	(aligned != compressed) or TESTFAIL;
+	TESTEQUALS(lzx_decode(aligned, corpus.size()) == corpus, true);
+	TESTEQUALS(lzx_decode_chunked(aligned, corpus.size(), 333) == corpus, true);
+
+	// uncompressed blocks store the data verbatim
+	auto uncompressed = lzx_encode(corpus, block_uncompressed);
+	TESTEQUALS(uncompressed.size(), 6 * (4 + 12) + corpus.size());
+	TESTEQUALS(lzx_decode(uncompressed, corpus.size()) == corpus, true);
+
+	// blocks that don't match the frames. uncompressed blocks start at odd
+	// bytes, cross frame boundaries and end with a padding byte.
+	std::vector<Block> mixed_blocks{
+		{block_verbatim, 1001},
+		{block_uncompressed, 40001},
+		{block_uncompressed, 7},
+		{block_aligned, 30000},
+		{block_uncompressed, 1},
+		{block_verbatim, LZX_FRAME_SIZE},
+	};
+	size_t mixed_size = 0;
+	for (auto &block : mixed_blocks) {
+		mixed_size += block.size;
+	}
+	mixed_blocks.push_back({block_aligned, corpus.size() - mixed_size});
+
+	auto mixed = lzx_encode(corpus, mixed_blocks);
+	TESTEQUALS(lzx_decode(mixed, corpus.size()) == corpus, true);
+	TESTEQUALS(lzx_decode_chunked(mixed, corpus.size(), 333) == corpus, true);
+	TESTEQUALS(lzx_decode_chunked(mixed, corpus.size(), 1) == corpus, true);
+
+	// odd-sized uncompressed blocks are followed by a padding byte
+	std::vector<uint8_t> pad_data{'o', 'p', 'e', 'n', 'a', 'g', 'e', '!'};
+	auto padded = lzx_encode(pad_data, {{block_uncompressed, 7}, {block_uncompressed, 1}});
+	std::vector<uint8_t> expected{
+		// e8 bit, block type and size, padding
+		0x00, 0x30, 0x70, 0x00,
+		1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0,
+		'o', 'p', 'e', 'n', 'a', 'g', 'e', 0x00,
+		// block type and size, padding
+		0x00, 0x60, 0x20, 0x00,
+		1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0,
+		'!', 0x00};
+	TESTEQUALS(padded == expected, true);
+	TESTEQUALS(lzx_decode(padded, pad_data.size()) == pad_data, true);
+}
+
+
+void lzxd_benchmark() {
+	constexpr size_t corpus_size = 2 * 1024 * 1024;
+	constexpr int rounds = 20;
+
+	auto corpus = make_corpus(corpus_size, 1337);
+	auto compressed = lzx_encode(corpus);
+
+	log::log(INFO << "lzxd benchmark: " << corpus.size() << " bytes in "
+	              << corpus.size() / LZX_FRAME_SIZE << " frames, compressed to "
+	              << compressed.size() << " bytes");
+
+	if (lzx_decode(compressed, corpus.size()) != corpus) {
+		throw Error{ERR << "lzxd benchmark: decoded data differs from the input"};
+	}
+
+	size_t decoded = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < rounds; i++) {
+		decoded += lzx_decode(compressed, corpus.size()).size();
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	if (decoded != corpus.size() * rounds) {
+		throw Error{ERR << "lzxd benchmark: decoded " << decoded << " bytes"};
+	}
+
+	double mbytes = static_cast<double>(corpus.size()) * rounds / (1024 * 1024);
+	log::log(INFO << "lzxd benchmark: " << mbytes / elapsed.count() << " MB/s");
+}
+
+
+} // namespace openage::util::compress::tests
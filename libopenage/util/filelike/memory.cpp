@@ -0,0 +1,120 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "memory.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "../../error/error.h"
+
+
+namespace openage::util::filelike {
+
+Memory::Memory(std::shared_ptr<const void> owner,
+               const uint8_t *data,
+               size_t size,
+               const std::string &name) :
+	owner{std::move(owner)},
+	data{data},
+	size{size},
+	pos{0},
+	name{name} {}
+
+
+size_t Memory::readable_count(ssize_t max) const {
+	size_t remaining = this->size - std::min(this->pos, this->size);
+	if (max < 0) {
+		return remaining;
+	}
+	return std::min(remaining, static_cast<size_t>(max));
+}
+
+
+std::string Memory::read(ssize_t max) {
+	size_t count = this->readable_count(max);
+	std::string ret{reinterpret_cast<const char *>(this->data + this->pos), count};
+	this->pos += count;
+	return ret;
+}
+
+
+size_t Memory::read_to(void *buf, ssize_t max) {
+	size_t count = this->readable_count(max);
+	std::memcpy(buf, this->data + this->pos, count);
+	this->pos += count;
+	return count;
+}
+
+
+bool Memory::readable() {
+	return true;
+}
+
+
+void Memory::write(const std::string & /* data */) {
+	throw Error{ERR << "memory file is read-only"};
+}
+
+
+bool Memory::writable() {
+	return false;
+}
+
+
+void Memory::seek(ssize_t offset, seek_t how) {
+	ssize_t target;
+
+	switch (how) {
+	case seek_t::SET:
+		target = offset;
+		break;
+	case seek_t::CUR:
+		target = static_cast<ssize_t>(this->pos) + offset;
+		break;
+	case seek_t::END:
+		target = static_cast<ssize_t>(this->size) + offset;
+		break;
+	default:
+		throw Error{ERR << "invalid seek mode"};
+	}
+
+	if (target < 0) {
+		throw Error{ERR << "seek to negative position: " << target};
+	}
+
+	this->pos = static_cast<size_t>(target);
+}
+
+
+bool Memory::seekable() {
+	return true;
+}
+
+
+size_t Memory::tell() {
+	return this->pos;
+}
+
+
+void Memory::close() {
+	this->owner.reset();
+	this->data = nullptr;
+	this->size = 0;
+	this->pos = 0;
+}
+
+
+void Memory::flush() {}
+
+
+ssize_t Memory::get_size() {
+	return this->size;
+}
+
+
+std::ostream &Memory::repr(std::ostream &stream) {
+	stream << "Memory(" << this->name << ", " << this->size << " bytes)";
+	return stream;
+}
+
+} // namespace openage::util::filelike
@@ -0,0 +1,72 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "filelike.h"
+
+
+namespace openage {
+namespace util {
+namespace filelike {
+
+/**
+ * Read-only file-like view on a region of memory.
+ *
+ * The memory is kept alive by a shared owner object,
+ * which is usually the buffer the data lives in.
+ */
+class Memory : public FileLike {
+public:
+	/**
+	 * @param owner Object that keeps the memory region alive.
+	 * @param data Pointer to the first byte of the region.
+	 * @param size Size of the region in bytes.
+	 * @param name Name used for the string representation.
+	 */
+	Memory(std::shared_ptr<const void> owner,
+	       const uint8_t *data,
+	       size_t size,
+	       const std::string &name = "");
+	virtual ~Memory() = default;
+
+	std::string read(ssize_t max) override;
+	size_t read_to(void *buf, ssize_t max) override;
+
+	bool readable() override;
+
+	void write(const std::string &data) override;
+
+	bool writable() override;
+
+	void seek(ssize_t offset, seek_t how = seek_t::SET) override;
+	bool seekable() override;
+	size_t tell() override;
+	void close() override;
+	void flush() override;
+	ssize_t get_size() override;
+
+	std::ostream &repr(std::ostream &) override;
+
+protected:
+	/**
+	 * Number of bytes that can be read with the given limit.
+	 */
+	size_t readable_count(ssize_t max) const;
+
+	std::shared_ptr<const void> owner;
+
+	const uint8_t *data;
+	size_t size;
+	size_t pos;
+
+	std::string name;
+};
+
+} // namespace filelike
+} // namespace util
+} // namespace openage
@@ -0,0 +1,659 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "cab.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "../../error/error.h"
+#include "../../job/job_manager.h"
+#include "../../log/log.h"
+#include "../compress/lzxd.h"
+#include "../file.h"
+#include "../filelike/memory.h"
+#include "../mmap.h"
+#include "../path.h"
+#include "../strings.h"
+
+
+namespace openage::util::fslike {
+
+namespace {
+
+/** size of the fixed part of CFHEADER */
+constexpr size_t cfheader_size = 36;
+
+/** size of the fixed part of CFFOLDER */
+constexpr size_t cffolder_size = 8;
+
+/** size of the fixed part of CFFILE */
+constexpr size_t cffile_size = 16;
+
+/** size of the fixed part of CFDATA */
+constexpr size_t cfdata_size = 8;
+
+/** CFHEADER flags */
+constexpr uint16_t flag_prev_cabinet = 0x0001;
+constexpr uint16_t flag_next_cabinet = 0x0002;
+constexpr uint16_t flag_reserve_present = 0x0004;
+
+/** CFFILE attribute: name is UTF-8, not ISO-8859-1 */
+constexpr uint16_t attrib_name_is_utf = 0x0080;
+
+/** compression types (lower nibble of typeCompress) */
+constexpr uint16_t compress_none = 0;
+constexpr uint16_t compress_mszip = 1;
+constexpr uint16_t compress_quantum = 2;
+constexpr uint16_t compress_lzx = 3;
+
+
+/**
+ * Bounds-checked little-endian reader over the mapped cabinet.
+ */
+class Reader {
+public:
+	Reader(const uint8_t *data, size_t size, size_t pos) :
+		data{data},
+		size{size},
+		pos{pos} {}
+
+	void require(size_t count) const {
+		if (this->pos > this->size or count > this->size - this->pos) [[unlikely]] {
+			throw Error{ERR << "unexpected end of CAB file at offset " << this->pos};
+		}
+	}
+
+	uint8_t u8() {
+		this->require(1);
+		return this->data[this->pos++];
+	}
+
+	uint16_t u16() {
+		this->require(2);
+		uint16_t ret = this->data[this->pos] | (this->data[this->pos + 1] << 8);
+		this->pos += 2;
+		return ret;
+	}
+
+	uint32_t u32() {
+		this->require(4);
+		uint32_t ret = (static_cast<uint32_t>(this->data[this->pos + 0]) << 0)
+		               | (static_cast<uint32_t>(this->data[this->pos + 1]) << 8)
+		               | (static_cast<uint32_t>(this->data[this->pos + 2]) << 16)
+		               | (static_cast<uint32_t>(this->data[this->pos + 3]) << 24);
+		this->pos += 4;
+		return ret;
+	}
+
+	const uint8_t *bytes(size_t count) {
+		this->require(count);
+		const uint8_t *ret = &this->data[this->pos];
+		this->pos += count;
+		return ret;
+	}
+
+	std::string nullterminated_string() {
+		size_t start = this->pos;
+		while (this->u8() != 0) {}
+		return std::string{reinterpret_cast<const char *>(&this->data[start]),
+		                   this->pos - start - 1};
+	}
+
+	const uint8_t *data;
+	size_t size;
+	size_t pos;
+};
+
+
+/**
+ * Convert an ISO-8859-1 string to UTF-8.
+ */
+std::string latin1_to_utf8(const std::string &str) {
+	std::string ret;
+	ret.reserve(str.size());
+	for (unsigned char c : str) {
+		if (c < 0x80) {
+			ret.push_back(c);
+		}
+		else {
+			ret.push_back(0xc0 | (c >> 6));
+			ret.push_back(0x80 | (c & 0x3f));
+		}
+	}
+	return ret;
+}
+
+
+/**
+ * Join path parts with '/', as used for the entry lookup.
+ */
+std::string join_parts(const Path::parts_t &parts) {
+	std::string ret;
+	for (auto &part : parts) {
+		if (not ret.empty()) {
+			ret += PATHSEP;
+		}
+		ret += part;
+	}
+	return ret;
+}
+
+
+/**
+ * Decode the DOS date and time stamp of a CFFILE to a UNIX timestamp.
+ * CAB files have no timezone info; UTC is assumed.
+ */
+int decode_timestamp(uint16_t date, uint16_t time) {
+	struct tm stamp {};
+	stamp.tm_year = (date >> 9) + 1980 - 1900;
+	stamp.tm_mon = ((date >> 5) & 0x000f) - 1;
+	stamp.tm_mday = (date >> 0) & 0x001f;
+	stamp.tm_hour = time >> 11;
+	stamp.tm_min = (time >> 5) & 0x003f;
+	stamp.tm_sec = (time << 1) & 0x003f;
+
+#ifdef _WIN32
+	return static_cast<int>(_mkgmtime(&stamp));
+#else
+	return static_cast<int>(timegm(&stamp));
+#endif
+}
+
+} // namespace
+
+
+uint32_t cab_checksum(const uint8_t *data, size_t size, uint32_t seed) {
+	uint32_t result = seed;
+
+	size_t count = size / 4;
+	for (size_t i = 0; i < count; i++) {
+		result ^= (static_cast<uint32_t>(data[0]) << 0)
+		          | (static_cast<uint32_t>(data[1]) << 8)
+		          | (static_cast<uint32_t>(data[2]) << 16)
+		          | (static_cast<uint32_t>(data[3]) << 24);
+		data += 4;
+	}
+
+	// the remaining bytes are interpreted as big-endian value
+	uint32_t remainder = 0;
+	for (size_t i = 0; i < size % 4; i++) {
+		remainder = (remainder << 8) | data[i];
+	}
+
+	return result ^ remainder;
+}
+
+
+CAB::CAB(const std::string &path,
+         size_t offset,
+         const std::shared_ptr<job::JobManager> &job_mgr) :
+	file{std::make_unique<MMap>(path)},
+	data_reserved{0},
+	job_manager{job_mgr} {
+	this->dirs[""];
+	this->read_headers(offset);
+}
+
+
+CAB::~CAB() = default;
+
+
+void CAB::read_headers(size_t offset) {
+	Reader header{this->file->data(), this->file->size(), offset};
+	header.require(cfheader_size);
+
+	if (std::memcmp(header.bytes(4), "MSCF", 4) != 0) {
+		throw Error{ERR << "invalid CAB file signature in " << this->file->get_path()};
+	}
+
+	header.u32(); // reserved1
+	header.u32(); // cbCabinet
+	header.u32(); // reserved2
+	uint32_t files_offset = header.u32();
+	header.u32(); // reserved3
+	header.u8();  // versionMinor
+	header.u8();  // versionMajor
+	uint16_t folder_count = header.u16();
+	uint16_t file_count = header.u16();
+	uint16_t flags = header.u16();
+	header.u16(); // setID
+	header.u16(); // iCabinet
+
+	uint16_t header_reserved = 0;
+	uint8_t folder_reserved = 0;
+	if (flags & flag_reserve_present) {
+		header_reserved = header.u16();
+		folder_reserved = header.u8();
+		this->data_reserved = header.u8();
+	}
+	header.bytes(header_reserved);
+
+	// names of the previous and next cabinets of a set.
+	// multi-cabinet sets are not supported, but the fields must be skipped.
+	if (flags & flag_prev_cabinet) {
+		header.nullterminated_string();
+		header.nullterminated_string();
+	}
+	if (flags & flag_next_cabinet) {
+		header.nullterminated_string();
+		header.nullterminated_string();
+	}
+
+	// CFFOLDER entries
+	for (size_t i = 0; i < folder_count; i++) {
+		header.require(cffolder_size);
+
+		auto folder = std::make_unique<Folder>();
+		folder->data_offset = header.u32() + offset;
+		folder->block_count = header.u16();
+		folder->compression = header.u16();
+		header.bytes(folder_reserved);
+
+		switch (folder->compression & 0x000f) {
+		case compress_none:
+		case compress_lzx:
+			break;
+		case compress_mszip:
+			throw Error{ERR << "MSZIP compression is unsupported"};
+		case compress_quantum:
+			throw Error{ERR << "Quantum compression is unsupported"};
+		default:
+			throw Error{ERR << "unknown CAB compression type " << (folder->compression & 0x000f)};
+		}
+
+		this->folders.push_back(std::move(folder));
+	}
+
+	// CFFILE entries
+	if (header.pos != files_offset + offset) {
+		log::log(DBG << "CAB file has nonstandard format: seek to header.coffFiles was required");
+		header.pos = files_offset + offset;
+	}
+
+	for (size_t i = 0; i < file_count; i++) {
+		header.require(cffile_size);
+
+		Entry entry;
+		entry.size = header.u32();
+		entry.pos = header.u32();
+		uint16_t folder_id = header.u16();
+		uint16_t date = header.u16();
+		uint16_t time = header.u16();
+		uint16_t attribs = header.u16();
+
+		std::string name = header.nullterminated_string();
+		if (not (attribs & attrib_name_is_utf)) {
+			name = latin1_to_utf8(name);
+		}
+
+		// interpret the special values of folderid:
+		// 0xFFFD and 0xFFFF continue from the previous cabinet (actual id: 0),
+		// 0xFFFE continues in the next cabinet (actual id: last).
+		if (folder_id == 0xFFFD or folder_id == 0xFFFF) {
+			folder_id = 0;
+		}
+		else if (folder_id == 0xFFFE) {
+			folder_id = this->folders.size() - 1;
+		}
+
+		if (folder_id >= this->folders.size()) {
+			throw Error{ERR << "CAB file entry '" << name << "' has invalid folder id " << folder_id};
+		}
+
+		entry.folder = folder_id;
+		entry.mtime = decode_timestamp(date, time);
+
+		// normalize the path: forward slashes, lowercase.
+		std::replace(name.begin(), name.end(), '\\', PATHSEP);
+		std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) {
+			return (c < 0x80) ? std::tolower(c) : c;
+		});
+
+		Path::parts_t parts = util::split(name, PATHSEP);
+		std::string key = join_parts(parts);
+
+		if (this->entries.contains(key) or this->dirs.contains(key)) {
+			throw Error{ERR << "CAB file has multiple entries with the same path: " << key};
+		}
+
+		// register the file in all its parent directories
+		std::string dir;
+		for (size_t j = 0; j < parts.size(); j++) {
+			this->dirs[dir].insert(parts[j]);
+			if (j + 1 < parts.size()) {
+				dir = dir.empty() ? parts[j] : dir + PATHSEP + parts[j];
+			}
+		}
+		this->dirs[dir];
+
+		this->entries.emplace(std::move(key), entry);
+	}
+}
+
+
+const CAB::Entry *CAB::find_entry(const Path::parts_t &parts) const {
+	auto it = this->entries.find(join_parts(parts));
+	if (it == std::end(this->entries)) {
+		return nullptr;
+	}
+	return &it->second;
+}
+
+
+const std::shared_ptr<const std::vector<uint8_t>> &CAB::get_folder_data(size_t folder_id) {
+	Folder &folder = *this->folders.at(folder_id);
+
+	// if the folder is currently decompressed by another thread,
+	// this waits for it to finish.
+	std::call_once(folder.decompressed, [this, &folder]() {
+		folder.data = this->decompress_folder(folder);
+	});
+
+	return folder.data;
+}
+
+
+std::shared_ptr<const std::vector<uint8_t>> CAB::decompress_folder(const Folder &folder) const {
+	struct Block {
+		const uint8_t *payload;
+		size_t size;
+	};
+
+	// locate and verify all data blocks
+	std::vector<Block> blocks;
+	blocks.reserve(folder.block_count);
+	size_t uncompressed_size = 0;
+
+	Reader reader{this->file->data(), this->file->size(), folder.data_offset};
+	for (size_t i = 0; i < folder.block_count; i++) {
+		reader.require(cfdata_size);
+
+		uint32_t csum = reader.u32();
+		const uint8_t *sizes = &reader.data[reader.pos];
+		uint16_t data_size = reader.u16();
+		uint16_t uncompressed = reader.u16();
+		const uint8_t *reserved = reader.bytes(this->data_reserved);
+		const uint8_t *payload = reader.bytes(data_size);
+
+		// a checksum of zero means it was not computed.
+		if (csum != 0) {
+			uint32_t checksum = cab_checksum(payload, data_size);
+			checksum = cab_checksum(reserved, this->data_reserved, checksum);
+			checksum = cab_checksum(sizes, 4, checksum);
+
+			if (checksum != csum) [[unlikely]] {
+				throw Error{ERR << "checksum error in MSCAB data block " << i
+				                << " at offset " << (payload - reader.data)};
+			}
+		}
+
+		blocks.push_back({payload, data_size});
+		uncompressed_size += uncompressed;
+	}
+
+	auto output = std::make_shared<std::vector<uint8_t>>(uncompressed_size);
+
+	if ((folder.compression & 0x000f) == compress_none) {
+		size_t pos = 0;
+		for (auto &block : blocks) {
+			if (block.size > uncompressed_size - pos) [[unlikely]] {
+				throw Error{ERR << "uncompressed CAB block is larger than announced"};
+			}
+			std::memcpy(output->data() + pos, block.payload, block.size);
+			pos += block.size;
+		}
+		return output;
+	}
+
+	// LZX: the blocks form one continuous bitstream. A single block is
+	// decoded straight from the mapping, otherwise the payloads are gathered
+	// so the decompressor can read from one contiguous span.
+	unsigned int window_bits = (folder.compression >> 8) & 0x1f;
+
+	std::vector<uint8_t> joined;
+	const uint8_t *input = nullptr;
+	size_t input_size = 0;
+
+	if (blocks.size() == 1) {
+		input = blocks[0].payload;
+		input_size = blocks[0].size;
+	}
+	else {
+		for (auto &block : blocks) {
+			input_size += block.size;
+		}
+		joined.reserve(input_size);
+		for (auto &block : blocks) {
+			joined.insert(joined.end(), block.payload, block.payload + block.size);
+		}
+		input = joined.data();
+	}
+
+	compress::LZXDecompressor decompressor{input, input_size, window_bits, 0};
+
+	unsigned char frame[compress::LZX_FRAME_SIZE];
+	size_t pos = 0;
+	while (pos < uncompressed_size) {
+		size_t remaining = uncompressed_size - pos;
+
+		// decode directly to the output buffer, unless the frame
+		// could overrun it.
+		unsigned char *target = (remaining >= compress::LZX_FRAME_SIZE) ? output->data() + pos : frame;
+		unsigned int frame_size = decompressor.decompress_next_frame(target);
+
+		if (frame_size == 0) {
+			throw Error{ERR << "unexpected end of LZX stream: got " << pos
+			                << " of " << uncompressed_size << " bytes"};
+		}
+
+		if (target == frame) {
+			std::memcpy(output->data() + pos, frame, std::min<size_t>(frame_size, remaining));
+		}
+
+		pos += frame_size;
+	}
+
+	return output;
+}
+
+
+void CAB::decompress_all() {
+	if (this->job_manager) {
+		// jobs that are still queued when the archive is dropped must not keep it alive
+		std::weak_ptr<CAB> self = std::static_pointer_cast<CAB>(this->shared_from_this());
+
+		for (size_t i = 0; i < this->folders.size(); i++) {
+			this->job_manager->enqueue<bool>([self, i]() {
+				if (auto cab = self.lock()) {
+					cab->get_folder_data(i);
+				}
+				return true;
+			});
+		}
+	}
+
+	// work on the folders in reverse order, so the calling thread
+	// most likely picks the ones that were not started by a worker yet.
+	for (size_t i = this->folders.size(); i-- > 0;) {
+		this->get_folder_data(i);
+	}
+}
+
+
+void CAB::extract(const std::string &target_dir) {
+	this->decompress_all();
+
+	std::filesystem::path target{target_dir};
+	std::filesystem::create_directories(target);
+
+	for (auto &[key, entry] : this->entries) {
+		Path::parts_t parts = util::split(key, PATHSEP);
+
+		// entry names come from the archive, so they must not leave the target
+		std::filesystem::path file_path = target;
+		for (auto &part : parts) {
+			if (part.empty() or part == "." or part == "..") {
+				throw Error{ERR << "CAB file entry has an invalid path: " << key};
+			}
+			file_path /= part;
+		}
+
+		auto &data = this->get_folder_data(entry.folder);
+		if (static_cast<size_t>(entry.pos) + entry.size > data->size()) {
+			throw Error{ERR << "CAB file entry exceeds its folder: " << key};
+		}
+
+		std::filesystem::create_directories(file_path.parent_path());
+		std::ofstream out{file_path, std::ios::binary | std::ios::trunc};
+		out.write(reinterpret_cast<const char *>(data->data() + entry.pos), entry.size);
+		if (not out) {
+			throw Error{ERR << "could not write extracted file " << file_path.string()};
+		}
+	}
+}
+
+
+size_t CAB::get_folder_count() const {
+	return this->folders.size();
+}
+
+
+bool CAB::is_file(const Path::parts_t &parts) {
+	return this->find_entry(parts) != nullptr;
+}
+
+
+bool CAB::is_dir(const Path::parts_t &parts) {
+	return this->dirs.contains(join_parts(parts));
+}
+
+
+bool CAB::writable(const Path::parts_t & /* parts */) {
+	return false;
+}
+
+
+std::vector<Path::part_t> CAB::list(const Path::parts_t &parts) {
+	auto it = this->dirs.find(join_parts(parts));
+	if (it == std::end(this->dirs)) {
+		throw Error{ERR << "not a directory in CAB file: " << join_parts(parts)};
+	}
+
+	return {std::begin(it->second), std::end(it->second)};
+}
+
+
+bool CAB::mkdirs(const Path::parts_t & /* parts */) {
+	return false;
+}
+
+
+File CAB::open_r(const Path::parts_t &parts) {
+	const Entry *entry = this->find_entry(parts);
+	if (entry == nullptr) {
+		throw Error{ERR << "file not found in CAB file: " << join_parts(parts)};
+	}
+
+	auto &data = this->get_folder_data(entry->folder);
+	if (static_cast<size_t>(entry->pos) + entry->size > data->size()) {
+		throw Error{ERR << "CAB file entry exceeds its folder: " << join_parts(parts)};
+	}
+
+	return File{
+		std::make_shared<filelike::Memory>(data,
+		                                   data->data() + entry->pos,
+		                                   entry->size,
+		                                   join_parts(parts))};
+}
+
+
+File CAB::open_w(const Path::parts_t & /* parts */) {
+	throw Error{ERR << "CAB files are read-only"};
+}
+
+
+File CAB::open_rw(const Path::parts_t & /* parts */) {
+	throw Error{ERR << "CAB files are read-only"};
+}
+
+
+File CAB::open_a(const Path::parts_t & /* parts */) {
+	throw Error{ERR << "CAB files are read-only"};
+}
+
+
+File CAB::open_ar(const Path::parts_t & /* parts */) {
+	throw Error{ERR << "CAB files are read-only"};
+}
+
+
+std::string CAB::get_native_path(const Path::parts_t & /* parts */) {
+	// archive members have no native path.
+	return "";
+}
+
+
+bool CAB::rename(const Path::parts_t & /* parts */,
+                 const Path::parts_t & /* target_parts */) {
+	return false;
+}
+
+
+bool CAB::rmdir(const Path::parts_t & /* parts */) {
+	return false;
+}
+
+
+bool CAB::touch(const Path::parts_t & /* parts */) {
+	return false;
+}
+
+
+bool CAB::unlink(const Path::parts_t & /* parts */) {
+	return false;
+}
+
+
+int CAB::get_mtime(const Path::parts_t &parts) {
+	const Entry *entry = this->find_entry(parts);
+	if (entry == nullptr) {
+		throw Error{ERR << "can't get mtime"};
+	}
+	return entry->mtime;
+}
+
+
+uint64_t CAB::get_filesize(const Path::parts_t &parts) {
+	const Entry *entry = this->find_entry(parts);
+	if (entry == nullptr) {
+		throw Error{ERR << "can't get filesize"};
+	}
+	return entry->size;
+}
+
+
+std::ostream &CAB::repr(std::ostream &stream) {
+	stream << "CAB(" << this->file->get_path() << ")";
+	return stream;
+}
+
+
+void extract_cab(const std::string &path,
+                 size_t offset,
+                 const std::string &target_dir) {
+	int worker_count = std::max<int>(std::thread::hardware_concurrency(), 1);
+	auto job_mgr = std::make_shared<job::JobManager>(worker_count);
+	job_mgr->start();
+
+	auto cab = std::make_shared<CAB>(path, offset, job_mgr);
+	cab->extract(target_dir);
+
+	job_mgr->stop();
+}
+
+} // namespace openage::util::fslike
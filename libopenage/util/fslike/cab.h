@@ -0,0 +1,227 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+// pxd: from libcpp.string cimport string
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "fslike.h"
+
+
+namespace openage {
+namespace job {
+class JobManager;
+} // namespace job
+
+namespace util {
+class MMap;
+
+namespace fslike {
+
+
+/**
+ * MSCAB checksum of a data block.
+ *
+ * Given e.g. 11 bytes of data, ABCDEFGHIJK, three four-byte integers are
+ * created and XORed: DCBA, HGFE (little endian) and 0IJK (big endian).
+ *
+ * @param data Data to checksum.
+ * @param size Number of bytes in data.
+ * @param seed Initial checksum value (for chaining).
+ */
+uint32_t cab_checksum(const uint8_t *data, size_t size, uint32_t seed = 0);
+
+
+/**
+ * Read-only filesystem-like object for MSCAB archives.
+ *
+ * The cabinet file is memory-mapped, and its CFHEADER, CFFOLDER and
+ * CFFILE structures are parsed on construction.
+ * Struct definitions are according to the documentation at
+ * https://msdn.microsoft.com/en-us/library/bb417343.aspx.
+ *
+ * CAB folders (compressed streams of concatenated file contents) are
+ * decompressed lazily when a file inside them is opened, or all at once
+ * via decompress_all(), which distributes the folders over the job system.
+ * Data block checksums are verified during decompression.
+ *
+ * Supported compression types are "none" and LZX.
+ */
+class CAB : public FSLike {
+public:
+	/**
+	 * Open a CAB archive.
+	 *
+	 * @param path Native filesystem path of the cabinet file.
+	 * @param offset Offset of the cabinet inside the file.
+	 * @param job_mgr Job manager used for parallel folder decompression.
+	 *                May be nullptr to decompress in the calling thread.
+	 */
+	CAB(const std::string &path,
+	    size_t offset = 0,
+	    const std::shared_ptr<job::JobManager> &job_mgr = nullptr);
+
+	~CAB();
+
+	bool is_file(const Path::parts_t &parts) override;
+	bool is_dir(const Path::parts_t &parts) override;
+	bool writable(const Path::parts_t &parts) override;
+	std::vector<Path::part_t> list(const Path::parts_t &parts) override;
+	bool mkdirs(const Path::parts_t &parts) override;
+	File open_r(const Path::parts_t &parts) override;
+	File open_w(const Path::parts_t &parts) override;
+	File open_rw(const Path::parts_t &parts) override;
+	File open_a(const Path::parts_t &parts) override;
+	File open_ar(const Path::parts_t &parts) override;
+	std::string get_native_path(const Path::parts_t &parts) override;
+	bool rename(const Path::parts_t &parts,
+	            const Path::parts_t &target_parts) override;
+	bool rmdir(const Path::parts_t &parts) override;
+	bool touch(const Path::parts_t &parts) override;
+	bool unlink(const Path::parts_t &parts) override;
+
+	int get_mtime(const Path::parts_t &parts) override;
+	uint64_t get_filesize(const Path::parts_t &parts) override;
+
+	std::ostream &repr(std::ostream &) override;
+
+	/**
+	 * Decompress all folders of the archive.
+	 *
+	 * If a job manager was given, the folders are decompressed in parallel
+	 * on the worker threads. The calling thread takes part in the work and
+	 * returns once every folder is available.
+	 */
+	void decompress_all();
+
+	/**
+	 * Write all files of the archive into a native directory.
+	 *
+	 * The folders are decompressed with \p decompress_all() first.
+	 * Paths are written in their normalized (lowercase) form.
+	 *
+	 * @param target_dir Native path of the directory. Created if it does not exist.
+	 */
+	void extract(const std::string &target_dir);
+
+	/**
+	 * Number of CAB folders (compressed streams) in the archive.
+	 */
+	size_t get_folder_count() const;
+
+private:
+	/**
+	 * CFFOLDER: One compressed data stream.
+	 */
+	struct Folder {
+		/// absolute offset of the first CFDATA block
+		size_t data_offset;
+
+		/// number of CFDATA blocks
+		uint16_t block_count;
+
+		/// compression type and parameters
+		uint16_t compression;
+
+		/// guards the one-time decompression of the folder
+		std::once_flag decompressed;
+
+		/// decompressed folder contents
+		std::shared_ptr<const std::vector<uint8_t>> data;
+	};
+
+	/**
+	 * CFFILE: One file inside a folder.
+	 */
+	struct Entry {
+		/// index of the folder that contains the file
+		size_t folder;
+
+		/// offset of the file in the decompressed folder
+		uint32_t pos;
+
+		/// uncompressed file size
+		uint32_t size;
+
+		/// UNIX timestamp
+		int mtime;
+	};
+
+	/**
+	 * Parse the header, folder and file tables.
+	 */
+	void read_headers(size_t offset);
+
+	/**
+	 * Return the contents of a folder, decompressing it if necessary.
+	 * Thread-safe; concurrent callers for the same folder wait for
+	 * the one doing the work.
+	 */
+	const std::shared_ptr<const std::vector<uint8_t>> &get_folder_data(size_t folder_id);
+
+	/**
+	 * Verify and decompress all data blocks of a folder.
+	 */
+	std::shared_ptr<const std::vector<uint8_t>> decompress_folder(const Folder &folder) const;
+
+	/**
+	 * Look up a file entry, or return nullptr if there is none.
+	 */
+	const Entry *find_entry(const Path::parts_t &parts) const;
+
+	/**
+	 * The memory-mapped cabinet file.
+	 */
+	std::unique_ptr<MMap> file;
+
+	/**
+	 * Per-datablock reserved area size from the header.
+	 */
+	uint8_t data_reserved;
+
+	/**
+	 * Folders in the archive. Stored by pointer because of the once_flag.
+	 */
+	std::vector<std::unique_ptr<Folder>> folders;
+
+	/**
+	 * All files, indexed by their normalized '/'-joined path.
+	 */
+	std::unordered_map<std::string, Entry> entries;
+
+	/**
+	 * Directory listings, indexed by the '/'-joined directory path.
+	 * The root directory has the empty string as key.
+	 */
+	std::unordered_map<std::string, std::set<std::string>> dirs;
+
+	/**
+	 * Job manager for parallel decompression, may be nullptr.
+	 */
+	std::shared_ptr<job::JobManager> job_manager;
+};
+
+
+/**
+ * Extract all files of a CAB archive into a native directory.
+ * The folders are decompressed in parallel on all hardware threads.
+ *
+ * @param path Native filesystem path of the cabinet file.
+ * @param offset Offset of the cabinet inside the file.
+ * @param target_dir Native path of the directory. Created if it does not exist.
+ *
+ * pxd: void extract_cab(const string &path, size_t offset, const string &target_dir) except +
+ */
+OAAPI void extract_cab(const std::string &path,
+                       size_t offset,
+                       const std::string &target_dir);
+
+} // namespace fslike
+} // namespace util
+} // namespace openage
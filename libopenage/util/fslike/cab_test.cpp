@@ -0,0 +1,338 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "cab.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../job/job_manager.h"
+#include "../../testing/testing.h"
+#include "../file.h"
+#include "../path.h"
+
+
+namespace openage::util::fslike::tests {
+
+namespace {
+
+void put16(std::vector<uint8_t> &buf, uint16_t val) {
+	buf.push_back(val & 0xff);
+	buf.push_back(val >> 8);
+}
+
+
+void put32(std::vector<uint8_t> &buf, uint32_t val) {
+	put16(buf, val & 0xffff);
+	put16(buf, val >> 16);
+}
+
+
+void set32(std::vector<uint8_t> &buf, size_t pos, uint32_t val) {
+	for (size_t i = 0; i < 4; i++) {
+		buf[pos + i] = (val >> (8 * i)) & 0xff;
+	}
+}
+
+
+/**
+ * Folder of a test cabinet.
+ */
+struct TestFolder {
+	/** value of typeCompress */
+	uint16_t compression;
+	/** (compressed) folder stream */
+	std::vector<uint8_t> stream;
+	/** number of bytes after decompression */
+	size_t size;
+	/** the stream is split into data blocks of at most this size */
+	size_t block_size;
+};
+
+
+/**
+ * File of a test cabinet.
+ */
+struct TestFile {
+	std::string name;
+	uint16_t folder;
+	uint32_t offset;
+	uint32_t size;
+};
+
+
+/**
+ * Create an uncompressed folder that stores the given contents back to back.
+ * Adds their file entries to files.
+ */
+TestFolder make_folder(const std::vector<std::pair<std::string, std::string>> &contents,
+                       std::vector<TestFile> &files,
+                       uint16_t folder_id) {
+	TestFolder folder{0, {}, 0, 7};
+	for (auto &[name, content] : contents) {
+		files.push_back({name, folder_id, static_cast<uint32_t>(folder.stream.size()), static_cast<uint32_t>(content.size())});
+		folder.stream.insert(folder.stream.end(), content.begin(), content.end());
+	}
+	folder.size = folder.stream.size();
+	return folder;
+}
+
+
+/**
+ * Create an LZX folder for a single file, made of uncompressed LZX blocks
+ * of at most lzx_block_size bytes.
+ *
+ * Each block starts with its 3 bit type and 24 bit length in the bitstream,
+ * padded to 16 bits, followed by R0-R2 and the raw bytes. Odd-sized blocks
+ * are padded with a zero byte.
+ */
+TestFolder make_lzx_folder(const std::string &name,
+                           const std::string &content,
+                           size_t lzx_block_size,
+                           std::vector<TestFile> &files,
+                           uint16_t folder_id) {
+	unsigned int window_bits = 16;
+	TestFolder folder{static_cast<uint16_t>(3 | (window_bits << 8)), {}, content.size(), 64};
+	files.push_back({name, folder_id, 0, static_cast<uint32_t>(content.size())});
+
+	for (size_t pos = 0; pos < content.size(); pos += lzx_block_size) {
+		uint32_t size = std::min(lzx_block_size, content.size() - pos);
+
+		// the first block is preceded by the intel e8 header bit (0)
+		uint32_t bits = (pos == 0) ? ((3u << 28) | (size << 4)) : ((3u << 29) | (size << 5));
+		put16(folder.stream, bits >> 16);
+		put16(folder.stream, bits & 0xffff);
+
+		// R0, R1, R2
+		for (size_t i = 0; i < 3; i++) {
+			put32(folder.stream, 1);
+		}
+
+		folder.stream.insert(folder.stream.end(), content.begin() + pos, content.begin() + pos + size);
+		if (size & 1) {
+			folder.stream.push_back(0);
+		}
+	}
+
+	return folder;
+}
+
+
+/**
+ * Create a cabinet from the given folders and files.
+ */
+std::vector<uint8_t> make_cab(const std::vector<TestFolder> &folders,
+                              const std::vector<TestFile> &files) {
+	std::vector<uint8_t> cab;
+
+	// CFHEADER
+	cab.insert(cab.end(), {'M', 'S', 'C', 'F'});
+	put32(cab, 0);
+	put32(cab, 0); // cbCabinet, unused by the reader
+	put32(cab, 0);
+	size_t files_offset_pos = cab.size();
+	put32(cab, 0);
+	put32(cab, 0);
+	cab.push_back(3);
+	cab.push_back(1);
+	put16(cab, folders.size());
+	put16(cab, files.size());
+	put16(cab, 0);
+	put16(cab, 0);
+	put16(cab, 0);
+
+	// CFFOLDER, data offsets are filled in later
+	std::vector<size_t> folder_offset_pos;
+	for (auto &folder : folders) {
+		folder_offset_pos.push_back(cab.size());
+		put32(cab, 0);
+		put16(cab, (folder.stream.size() + folder.block_size - 1) / folder.block_size);
+		put16(cab, folder.compression);
+	}
+
+	// CFFILE
+	set32(cab, files_offset_pos, cab.size());
+	for (auto &file : files) {
+		put32(cab, file.size);
+		put32(cab, file.offset);
+		put16(cab, file.folder);
+		put16(cab, (44 << 9) | (3 << 5) | 14); // 2024-03-14
+		put16(cab, (12 << 11) | (30 << 5));    // 12:30:00
+		put16(cab, 0);
+		cab.insert(cab.end(), file.name.begin(), file.name.end());
+		cab.push_back(0);
+	}
+
+	// CFDATA
+	for (size_t i = 0; i < folders.size(); i++) {
+		set32(cab, folder_offset_pos[i], cab.size());
+
+		auto &folder = folders[i];
+		size_t uncompressed_left = folder.size;
+		for (size_t pos = 0; pos < folder.stream.size(); pos += folder.block_size) {
+			size_t size = std::min(folder.block_size, folder.stream.size() - pos);
+			size_t uncompressed = std::min(size, uncompressed_left);
+			uncompressed_left -= uncompressed;
+
+			// the last block holds the rest of the LZX data
+			if (pos + size == folder.stream.size()) {
+				uncompressed += uncompressed_left;
+			}
+
+			const uint8_t *data = folder.stream.data() + pos;
+
+			std::vector<uint8_t> sizes;
+			put16(sizes, size);
+			put16(sizes, uncompressed);
+
+			put32(cab, cab_checksum(sizes.data(), 4, cab_checksum(data, size)));
+			cab.insert(cab.end(), sizes.begin(), sizes.end());
+			cab.insert(cab.end(), data, data + size);
+		}
+	}
+
+	return cab;
+}
+
+
+/**
+ * Path in the temp directory that is unique for this test run.
+ */
+std::filesystem::path unique_temp_path(const std::string &prefix) {
+	std::random_device random;
+	std::filesystem::path path;
+	do {
+		path = std::filesystem::temp_directory_path() / (prefix + std::to_string(random()));
+	}
+	while (std::filesystem::exists(path));
+	return path;
+}
+
+
+void write_file(const std::filesystem::path &path, const std::vector<uint8_t> &data) {
+	std::ofstream out{path, std::ios::binary};
+	out.write(reinterpret_cast<const char *>(data.data()), data.size());
+}
+
+
+std::string read_file(const std::filesystem::path &path) {
+	std::ifstream in{path, std::ios::binary};
+	return std::string{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+}
+
+} // namespace
+
+
+void cab() {
+	TESTEQUALS(cab_checksum(nullptr, 0), 0u);
+
+	// DCBA ^ HGFE ^ 0IJK
+	const uint8_t csum_data[] = {'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K'};
+	TESTEQUALS(cab_checksum(csum_data, 11),
+	           0x44434241u ^ 0x48474645u ^ 0x00494a4bu);
+
+	// lzx blocks of odd size end with a padding byte
+	std::string long_text;
+	for (size_t i = 0; long_text.size() < 1000; i++) {
+		long_text += "line " + std::to_string(i) + " of a longer text\n";
+	}
+	std::string sound(300, '\0');
+	for (size_t i = 0; i < sound.size(); i++) {
+		sound[i] = static_cast<char>(i * 7);
+	}
+
+	std::vector<TestFile> files;
+	std::vector<TestFolder> folders{
+		make_folder({{"README.TXT", "openage cabinet test"},
+		             {"Data\\Sounds\\Horn.wav", "tuuuuut"},
+		             {"data\\empty", ""}},
+		            files,
+		            0),
+		make_lzx_folder("Data\\Text\\Long.txt", long_text, 333, files, 1),
+		make_lzx_folder("data\\sounds\\bell.wav", sound, 100, files, 2),
+	};
+	auto cab_data = make_cab(folders, files);
+
+	auto cab_path = unique_temp_path("openage_cab_test_");
+	cab_path += ".cab";
+	write_file(cab_path, cab_data);
+
+	auto job_mgr = std::make_shared<job::JobManager>(2);
+	job_mgr->start();
+
+	auto archive = std::make_shared<CAB>(cab_path.string(), 0, job_mgr);
+	archive->get_folder_count() == 3 or TESTFAIL;
+	archive->decompress_all();
+
+	Path root = archive->root();
+
+	root["readme.txt"].is_file() or TESTFAIL;
+	root["data"].is_dir() or TESTFAIL;
+	root["data"]["sounds"].is_dir() or TESTFAIL;
+	root["nope"].exists() and TESTFAIL;
+
+	TESTEQUALS(root["readme.txt"].open_r().read(), "openage cabinet test");
+	TESTEQUALS(root["data"]["sounds"]["horn.wav"].open_r().read(), "tuuuuut");
+	TESTEQUALS(root["data"]["empty"].open_r().read(), "");
+	TESTEQUALS(root["data"]["text"]["long.txt"].open_r().read(), long_text);
+	TESTEQUALS(root["data"]["sounds"]["bell.wav"].open_r().read(), sound);
+	TESTEQUALS(root["data"]["sounds"]["horn.wav"].get_filesize(), 7u);
+	TESTEQUALS(root["readme.txt"].get_mtime(), 1710419400);
+	TESTEQUALS(archive->list({"data"}).size(), 3u);
+	TESTEQUALS(archive->list({"data", "sounds"}).size(), 2u);
+
+	// extraction writes the normalized paths
+	auto extract_dir = unique_temp_path("openage_cab_test_");
+	extract_cab(cab_path.string(), 0, extract_dir.string());
+	TESTEQUALS(read_file(extract_dir / "readme.txt"), "openage cabinet test");
+	TESTEQUALS(read_file(extract_dir / "data" / "empty"), "");
+	TESTEQUALS(read_file(extract_dir / "data" / "text" / "long.txt"), long_text);
+	TESTEQUALS(read_file(extract_dir / "data" / "sounds" / "bell.wav"), sound);
+	std::filesystem::remove_all(extract_dir);
+
+	// entries must not leave the target directory
+	std::vector<TestFile> evil_files;
+	std::vector<TestFolder> evil_folders{make_folder({{"..\\evil.txt", "evil"}}, evil_files, 0)};
+	auto evil_path = unique_temp_path("openage_cab_test_");
+	write_file(evil_path, make_cab(evil_folders, evil_files));
+	TESTTHROWS(extract_cab(evil_path.string(), 0, extract_dir.string()));
+	std::filesystem::remove_all(extract_dir);
+	std::filesystem::remove(evil_path);
+
+	// the file is mapped while an archive is open
+	root = Path{};
+	archive.reset();
+
+	// corrupt the first data block of the first folder
+	std::string block = "openage";
+	auto corrupt = std::search(cab_data.begin(), cab_data.end(), block.begin(), block.end());
+	corrupt != cab_data.end() or TESTFAIL;
+	*corrupt ^= 0xff;
+	write_file(cab_path, cab_data);
+
+	auto broken = std::make_shared<CAB>(cab_path.string());
+	TESTTHROWS(broken->root()["readme.txt"].open_r());
+	TESTEQUALS(broken->root()["data"]["text"]["long.txt"].open_r().read(), long_text);
+
+	broken.reset();
+
+	// lzx streams that end early
+	std::vector<TestFile> short_files;
+	std::vector<TestFolder> short_folders{make_lzx_folder("short", long_text, 333, short_files, 0)};
+	short_folders[0].size += 1;
+	write_file(cab_path, make_cab(short_folders, short_files));
+
+	auto truncated = std::make_shared<CAB>(cab_path.string());
+	TESTTHROWS(truncated->root()["short"].open_r());
+	truncated.reset();
+
+	job_mgr->stop();
+	std::filesystem::remove(cab_path);
+}
+
+
+} // namespace openage::util::fslike::tests
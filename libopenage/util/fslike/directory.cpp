@@ -1,4 +1,4 @@
-// Copyright 2017-2019 the openage authors. See copying.md for legal info.
+// Copyright 2017-2024 the openage authors. See copying.md for legal info.
 
 #include "directory.h"
 
@@ -115,7 +115,7 @@ bool Directory::writable(const Path::parts_t &parts) {
 	}
 	const std::string path = this->resolve(parts_test);
 
-	return access(path.c_str(), W_OK);
+	return access(path.c_str(), W_OK) == 0;
 }
 
 
@@ -29,6 +29,39 @@ size_t type_hash() {
 size_t hash_combine(size_t hash1, size_t hash2);
 
 
+/**
+ * Mix the bits of a 64 bit value, e.g. to hash an integer.
+ *
+ * Unlike \p std::hash, the result is the same on all platforms, so it can
+ * be used for hashes that are compared between machines.
+ *
+ * @param value Value to mix.
+ * @return Hash.
+ */
+constexpr uint64_t hash_mix(uint64_t value) {
+	// finalizer of splitmix64
+	value ^= value >> 30;
+	value *= 0xbf58476d1ce4e5b9;
+	value ^= value >> 27;
+	value *= 0x94d049bb133111eb;
+	value ^= value >> 31;
+	return value;
+}
+
+
+/**
+ * Add a value to a hash. The result depends on the order in which
+ * values are added and is the same on all platforms.
+ *
+ * @param seed Hash of the previous values.
+ * @param value Hash of the next value.
+ * @return Hash.
+ */
+constexpr uint64_t hash_append(uint64_t seed, uint64_t value) {
+	return hash_mix(hash_mix(seed) + value);
+}
+
+
 /** \class Siphash
  * Contains a Siphash implementration.
  *
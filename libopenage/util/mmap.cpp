@@ -0,0 +1,78 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "mmap.h"
+
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "../error/error.h"
+
+
+namespace openage::util {
+
+
+MMap::MMap(const std::string &path) :
+	path{path},
+	begin{nullptr},
+	length{0} {
+
+#ifndef _WIN32
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		throw Error{ERR << "could not open file for mapping: " << path};
+	}
+
+	struct stat buf;
+	if (fstat(fd, &buf) != 0) {
+		::close(fd);
+		throw Error{ERR << "could not stat file for mapping: " << path};
+	}
+
+	this->length = buf.st_size;
+
+	if (this->length > 0) {
+		void *addr = mmap(nullptr, this->length, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+
+		if (addr == MAP_FAILED) {
+			throw Error{ERR << "could not map file: " << path};
+		}
+
+		this->begin = static_cast<const uint8_t *>(addr);
+	}
+	else {
+		::close(fd);
+	}
+#else
+	std::ifstream file{path, std::ios::binary | std::ios::ate};
+	if (not file.is_open()) {
+		throw Error{ERR << "could not open file for mapping: " << path};
+	}
+
+	this->length = static_cast<size_t>(file.tellg());
+	this->fallback.resize(this->length);
+
+	file.seekg(0, std::ios::beg);
+	file.read(reinterpret_cast<char *>(this->fallback.data()), this->length);
+
+	this->begin = this->fallback.data();
+#endif
+}
+
+
+MMap::~MMap() {
+#ifndef _WIN32
+	if (this->begin != nullptr) {
+		munmap(const_cast<uint8_t *>(this->begin), this->length);
+	}
+#endif
+}
+
+
+} // namespace openage::util
@@ -0,0 +1,71 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace openage {
+namespace util {
+
+
+/**
+ * Read-only memory mapping of a whole file.
+ *
+ * On platforms without mmap, the file contents are read into
+ * a heap buffer instead, so users can rely on data() in any case.
+ */
+class MMap {
+public:
+	/**
+	 * Map the file at the given native filesystem path.
+	 * Throws an Error if the file can't be opened or mapped.
+	 */
+	MMap(const std::string &path);
+
+	~MMap();
+
+	MMap(const MMap &) = delete;
+	MMap(MMap &&) = delete;
+	MMap &operator=(const MMap &) = delete;
+	MMap &operator=(MMap &&) = delete;
+
+	/**
+	 * Pointer to the first byte of the file.
+	 */
+	const uint8_t *data() const {
+		return this->begin;
+	}
+
+	/**
+	 * Size of the mapped file in bytes.
+	 */
+	size_t size() const {
+		return this->length;
+	}
+
+	/**
+	 * The path that was mapped.
+	 */
+	const std::string &get_path() const {
+		return this->path;
+	}
+
+private:
+	std::string path;
+
+	const uint8_t *begin;
+	size_t length;
+
+	/**
+	 * Holds the file contents when no mapping could be created.
+	 */
+	std::vector<uint8_t> fallback;
+};
+
+
+} // namespace util
+} // namespace openage
@@ -219,4 +219,17 @@ std::vector<std::string> split_newline(const std::string &txt) {
 	return lines;
 }
 
+
+void split_view(std::string_view txt, char delim, std::vector<std::string_view> &result) {
+	result.clear();
+	for (std::string_view part : split_view(txt, delim)) {
+		result.push_back(part);
+	}
+}
+
+
+void throw_number_error(std::string_view str) {
+	throw Error(MSG(err) << "'" << str << "' is not a valid number");
+}
+
 } // namespace openage::util
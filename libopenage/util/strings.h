@@ -2,12 +2,19 @@
 
 #pragma once
 
+#include <charconv>
+#include <concepts>
 #include <cstdarg>
+#include <cstddef>
 #include <functional>
 #include <iomanip>
+#include <iterator>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
 #include <vector>
 
 #if defined(__GNUC__)
@@ -121,5 +128,210 @@ std::vector<std::string> split_escape(const std::string &txt,
  */
 std::vector<std::string> split_newline(const std::string &txt);
 
+
+/**
+ * Iterates over the parts of a string that are separated by a delimiter,
+ * without copying them.
+ *
+ * Splits like split(): empty parts between two delimiters are kept,
+ * but a trailing delimiter doesn't produce an empty last part.
+ * The viewed string must outlive the splitter and its iterators.
+ */
+class StringSplitter {
+public:
+	class iterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = std::string_view;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const std::string_view *;
+		using reference = const std::string_view &;
+
+		/**
+		 * Create the end iterator.
+		 */
+		iterator() = default;
+
+		iterator(std::string_view txt, char delim, bool strip_cr) :
+			rest{txt},
+			delim{delim},
+			strip_cr{strip_cr},
+			done{false} {
+			this->next();
+		}
+
+		reference operator*() const {
+			return this->current;
+		}
+
+		pointer operator->() const {
+			return &this->current;
+		}
+
+		iterator &operator++() {
+			this->next();
+			return *this;
+		}
+
+		iterator operator++(int) {
+			iterator ret = *this;
+			this->next();
+			return ret;
+		}
+
+		bool operator==(const iterator &other) const {
+			if (this->done or other.done) {
+				return this->done == other.done;
+			}
+			return this->current.data() == other.current.data();
+		}
+
+	private:
+		/**
+		 * Advance to the next part.
+		 */
+		void next() {
+			if (this->rest.empty()) {
+				this->done = true;
+				return;
+			}
+
+			size_t pos = this->rest.find(this->delim);
+			if (pos == std::string_view::npos) {
+				this->current = this->rest;
+				this->rest = {};
+			}
+			else {
+				// a trailing delimiter leaves nothing in rest,
+				// so no empty part follows it
+				this->current = this->rest.substr(0, pos);
+				this->rest.remove_prefix(pos + 1);
+			}
+
+			if (this->strip_cr and not this->current.empty() and this->current.back() == '\r') {
+				this->current.remove_suffix(1);
+			}
+		}
+
+		/**
+		 * Unprocessed remainder of the string.
+		 */
+		std::string_view rest;
+
+		/**
+		 * Current part.
+		 */
+		std::string_view current;
+
+		char delim = '\0';
+		bool strip_cr = false;
+		bool done = true;
+	};
+
+	StringSplitter(std::string_view txt, char delim, bool strip_cr = false) :
+		txt{txt},
+		delim{delim},
+		strip_cr{strip_cr} {}
+
+	iterator begin() const {
+		return iterator{this->txt, this->delim, this->strip_cr};
+	}
+
+	iterator end() const {
+		return iterator{};
+	}
+
+private:
+	std::string_view txt;
+	char delim;
+	bool strip_cr;
+};
+
+
+/**
+ * Split a string at a delimiter without copying it.
+ *
+ * Usage: for (std::string_view part : util::split_view(txt, ' ')) { ... }
+ */
+inline StringSplitter split_view(std::string_view txt, char delim) {
+	return StringSplitter{txt, delim};
+}
+
+
+/**
+ * Split a string at a delimiter into views of the string.
+ *
+ * The result vector is cleared first. Reusing it for multiple
+ * calls avoids all allocations once it has grown large enough.
+ */
+void split_view(std::string_view txt, char delim, std::vector<std::string_view> &result);
+
+
+/**
+ * Iterate over the lines of a text without copying it.
+ * Works with both \n and \r\n.
+ */
+inline StringSplitter split_newline_view(std::string_view txt) {
+	return StringSplitter{txt, '\n', true};
+}
+
+
+/**
+ * Throws the error for a string that is not a valid number.
+ */
+[[noreturn]] void throw_number_error(std::string_view str);
+
+
+/**
+ * Number types that can be parsed by parse_number().
+ */
+template <typename T>
+concept parsable_number = std::is_arithmetic_v<T> and not std::same_as<T, bool>;
+
+
+/**
+ * Parse a number without allocating and independent of the locale.
+ *
+ * The whole string must be a number. Unlike std::stoul and friends,
+ * leading whitespace, a '+' sign or trailing characters are not accepted.
+ *
+ * @param str String to parse.
+ * @param result Set to the parsed value on success.
+ * @param base Base of integers; ignored for floating point numbers.
+ *
+ * @return true if the string was a valid number of type T.
+ */
+template <parsable_number T>
+bool try_parse_number(std::string_view str, T &result, int base = 10) {
+	const char *end = str.data() + str.size();
+	std::from_chars_result parsed;
+	if constexpr (std::is_integral_v<T>) {
+		parsed = std::from_chars(str.data(), end, result, base);
+	}
+	else {
+		parsed = std::from_chars(str.data(), end, result);
+	}
+	return parsed.ec == std::errc{} and parsed.ptr == end;
+}
+
+
+/**
+ * Parse a number without allocating and independent of the locale.
+ * Throws if the string is not a valid number of type T.
+ *
+ * @param str String to parse.
+ * @param base Base of integers; ignored for floating point numbers.
+ *
+ * @return Parsed value.
+ */
+template <parsable_number T>
+T parse_number(std::string_view str, int base = 10) {
+	T result{};
+	if (not try_parse_number(str, result, base)) [[unlikely]] {
+		throw_number_error(str);
+	}
+	return result;
+}
+
 } // namespace util
 } // namespace openage
@@ -0,0 +1,74 @@
+// Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+#include "strings.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../testing/testing.h"
+
+
+namespace openage::util::tests {
+
+namespace {
+
+std::vector<std::string> split_view_copy(std::string_view txt, char delim) {
+	std::vector<std::string> result;
+	for (std::string_view part : split_view(txt, delim)) {
+		result.emplace_back(part);
+	}
+	return result;
+}
+
+} // namespace
+
+
+void strings() {
+	// the views split like the copying split
+	for (std::string txt : {"", "a", "a b", "a  b", " a", "a ", "a b ", "  ", "version 2"}) {
+		TESTEQUALS(split_view_copy(txt, ' ') == split(txt, ' '), true);
+	}
+
+	std::vector<std::string_view> parts;
+	split_view("frame 0 1 2 3", ' ', parts);
+	TESTEQUALS(parts.size(), 5u);
+	TESTEQUALS(parts[0], "frame");
+	TESTEQUALS(parts[4], "3");
+
+	split_view("mode=loop", '=', parts);
+	TESTEQUALS(parts.size(), 2u);
+	TESTEQUALS(parts[1], "loop");
+
+	std::vector<std::string> lines;
+	for (std::string_view line : split_newline_view("a\r\nb\n\nc\n")) {
+		lines.emplace_back(line);
+	}
+	TESTEQUALS(lines == split_newline("a\r\nb\n\nc\n"), true);
+	TESTEQUALS(lines.size(), 4u);
+	TESTEQUALS(lines[0], "a");
+	TESTEQUALS(lines[2], "");
+
+	// numbers
+	TESTEQUALS(parse_number<size_t>("1337"), 1337u);
+	TESTEQUALS(parse_number<int>("-42"), -42);
+	TESTEQUALS(parse_number<uint8_t>("1010", 2), 10);
+	TESTEQUALS(parse_number<float>("1.5"), 1.5f);
+	TESTEQUALS(parse_number<float>("200"), 200.0f);
+	TESTEQUALS(parse_number<double>("-0.25"), -0.25);
+
+	TESTTHROWS(parse_number<size_t>(""));
+	TESTTHROWS(parse_number<size_t>("12px"));
+	TESTTHROWS(parse_number<size_t>(" 12"));
+	TESTTHROWS(parse_number<size_t>("-1"));
+	TESTTHROWS(parse_number<uint8_t>("256"));
+	TESTTHROWS(parse_number<float>("1.5.3"));
+
+	int value = 7;
+	TESTEQUALS(try_parse_number<int>("x", value), false);
+	TESTEQUALS(try_parse_number<int>("12", value), true);
+	TESTEQUALS(value, 12);
+}
+
+} // namespace openage::util::tests
@@ -0,0 +1,23 @@
+# Copyright 2024-2024 the openage authors. See copying.md for legal info.
+
+"""
+Extracts CAB archives with the native C++ implementation.
+"""
+
+from libcpp.string cimport string
+
+from libopenage.util.fslike.cab cimport extract_cab as cpp_extract_cab
+
+
+def extract_cab(str path, size_t offset, str target_dir):
+    """
+    Extracts all files of the cabinet at the native path into target_dir.
+
+    The folders of the archive are decompressed in parallel.
+    File and directory names are lowercase.
+    """
+    cdef string path_cpp = path.encode()
+    cdef string target_dir_cpp = target_dir.encode()
+
+    with nogil:
+        cpp_extract_cab(path_cpp, offset, target_dir_cpp)
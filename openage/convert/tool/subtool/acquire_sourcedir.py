@@ -200,37 +200,53 @@ def download_trial() -> AnyStr:
     with urlopen(TRIAL_URL) as response:
         with tempfile.NamedTemporaryFile(delete=False) as tmp_file:
             shutil.copyfileobj(response, tmp_file)
+            tmp_file.flush()
 
-            from ....cabextract.cab import CABFile
+            print(f"Extracting game files to {tempdir}...")
+            try:
+                from ....cabextract.cab_cpp import extract_cab
 
-            cab = CABFile(tmp_file, 0x65678)
+                extract_cab(tmp_file.name, 0x65678, tempdir)
 
-            sourcedir = Directory(tempdir).root
-            print(f"Extracting game files to {sourcedir}...")
-            dirs = [cab.root]
+            except Exception as exc:
+                # the module may be missing, and C++ errors are translated.
+                # pylint: disable=broad-except
+                warn(f"Native CAB extraction failed ({exc}), "
+                     "falling back to the Python implementation")
+                extract_cab_py(tmp_file, 0x65678, Directory(tempdir).root)
 
-            # Loop over all files in the CAB archive and extract them
-            # to the tempdir
-            while len(dirs) > 0:
-                cur_src_dir = dirs[0]
-                cur_tgt_dir = sourcedir
+    return tempdir
 
-                for part in cur_src_dir.parts:
-                    cur_tgt_dir = cur_tgt_dir[part]
-                cur_tgt_dir.mkdirs()
 
-                dirs.remove(cur_src_dir)
+def extract_cab_py(cab_file, offset: int, target_dir) -> None:
+    """
+    Extract a CAB archive with the (slower) Python implementation.
+    """
+    from ....cabextract.cab import CABFile
 
-                for path in cur_src_dir.iterdir():
-                    if path.is_dir():
-                        dirs.append(path)
+    cab = CABFile(cab_file, offset)
+    dirs = [cab.root]
 
-                    if path.is_file():
-                        with cur_tgt_dir[path.name].open("wb") as target_file:
-                            with path.open("rb") as source_file:
-                                target_file.write(source_file.read())
+    # Loop over all files in the CAB archive and extract them
+    # to the target directory
+    while len(dirs) > 0:
+        cur_src_dir = dirs[0]
+        cur_tgt_dir = target_dir
 
-    return tempdir
+        for part in cur_src_dir.parts:
+            cur_tgt_dir = cur_tgt_dir[part]
+        cur_tgt_dir.mkdirs()
+
+        dirs.remove(cur_src_dir)
+
+        for path in cur_src_dir.iterdir():
+            if path.is_dir():
+                dirs.append(path)
+
+            if path.is_file():
+                with cur_tgt_dir[path.name].open("wb") as target_file:
+                    with path.open("rb") as source_file:
+                        target_file.write(source_file.read())
 
 
 def wine_to_real_path(path: str) -> str:
@@ -31,6 +31,15 @@ def init_subparser(cli: ArgumentParser) -> None:
         "--modpacks", nargs="+", required=True, type=str,
         help="list of modpacks to load")
 
+    cli.add_argument(
+        "--metrics", action='store_true',
+        help="collect performance metrics and print them to the log periodically")
+
+    cli.add_argument(
+        "--metrics-file", type=str,
+        help="periodically write performance metrics to this file "
+             "in the Prometheus text format (implies --metrics)")
+
     cli.add_argument(
         "--check-updates", action='store_true',
         help="Check if the assets are up to date"
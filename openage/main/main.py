@@ -28,6 +28,24 @@ def init_subparser(cli: ArgumentParser):
         "--modpacks", nargs="+", type=str,
         help="list of modpacks to load")
 
+    cli.add_argument(
+        "--metrics", action='store_true',
+        help="collect performance metrics and print them to the log periodically")
+
+    cli.add_argument(
+        "--metrics-file", type=str,
+        help="periodically write performance metrics to this file "
+             "in the Prometheus text format (implies --metrics)")
+
+    cli.add_argument(
+        "--record-replay", type=str, metavar="FILE",
+        help="record the events of the match to a replay file")
+
+    cli.add_argument(
+        "--replay", type=str, metavar="FILE",
+        help="play a recorded replay headless as fast as possible and "
+             "check that the game state matches (implies --headless)")
+
 
 def main(args, error):
     """
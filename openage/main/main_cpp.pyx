@@ -1,4 +1,4 @@
-# Copyright 2015-2023 the openage authors. See copying.md for legal info.
+# Copyright 2015-2024 the openage authors. See copying.md for legal info.
 
 from cpython.ref cimport PyObject
 from libcpp.string cimport string
@@ -37,6 +37,17 @@ def run_game(args, root_path):
         else:
             args_cpp.mods = vector[string]()
 
+        # performance metrics
+        args_cpp.metrics = args.metrics or args.metrics_file is not None
+        if args.metrics_file is not None:
+            args_cpp.metrics_file = args.metrics_file.encode()
+
+        # replays
+        if args.record_replay is not None:
+            args_cpp.record_replay_file = args.record_replay.encode()
+        if args.replay is not None:
+            args_cpp.replay_file = args.replay.encode()
+
         # run the game!
         with nogil:
             result = run_game_cpp(args_cpp)
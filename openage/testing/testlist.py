@@ -80,17 +80,29 @@ def tests_cpp():
     If no description is required, just the name may be yielded.
     """
 
+    yield "openage::assets::tests::modpack_index"
+    yield "openage::assets::tests::nyan_files"
+    yield "openage::console::tests::buf"
     yield "openage::coord::tests::coord"
+    yield "openage::cvar::tests::typed_cvar"
     yield "openage::datastructure::tests::concurrent_queue"
     yield "openage::datastructure::tests::constexpr_map"
     yield "openage::datastructure::tests::pairing_heap"
+    yield "openage::error::tests::stackanalyzer"
     yield "openage::job::tests::test_job_manager"
+    yield "openage::metrics::tests::metrics"
+    yield "openage::metrics::tests::trace"
     yield "openage::path::tests::path_node", "pathfinding"
     yield "openage::path::tests::flow_field", "pathfinding"
     yield "openage::pyinterface::tests::pyobject"
     yield "openage::pyinterface::tests::err_py_to_cpp"
     yield "openage::renderer::tests::font"
     yield "openage::renderer::tests::font_manager"
+    yield "openage::renderer::camera::tests::frustum"
+    yield "openage::renderer::resources::tests::animation"
+    yield "openage::renderer::resources::tests::texture_manager"
+    yield "openage::renderer::resources::parser::tests::parser"
+    yield "openage::renderer::resources::sprite::tests::sprite"
     yield "openage::rng::tests::run"
     yield "openage::util::tests::constinit_vector"
     yield "openage::util::tests::enum_"
@@ -100,10 +112,23 @@ def tests_cpp():
     yield "openage::util::tests::quaternion"
     yield "openage::util::tests::vector"
     yield "openage::util::tests::siphash"
+    yield "openage::util::tests::strings"
     yield "openage::util::tests::array_conversion"
+    yield "openage::util::fslike::tests::cab"
+    yield "openage::util::compress::tests::lzxd"
     yield "openage::curve::tests::container"
     yield "openage::curve::tests::curve_types"
     yield "openage::event::tests::eventtrigger"
+    yield "openage::event::tests::command_inbox"
+    yield "openage::gamestate::tests::batch_activity"
+    yield "openage::gamestate::tests::collision"
+    yield "openage::gamestate::tests::compiled_activity"
+    yield "openage::gamestate::tests::replay"
+    yield "openage::gamestate::tests::snapshot"
+    yield "openage::gamestate::tests::state_hash"
+    yield "openage::gamestate::tests::wait_list"
+    yield "openage::input::tests::binding_table"
+    yield "openage::input::tests::motion_coalescing"
 
 
 def demos_cpp():
@@ -137,3 +162,13 @@ def benchmark_cpp():
 
     # TODO Add a real benchmark here!
     yield ("openage::test::benchmark", "Test the benchmark")
+    yield ("openage::util::compress::tests::lzxd_benchmark",
+           "LZX decompression throughput")
+    yield ("openage::console::tests::buf_benchmark",
+           "console buffer write throughput")
+    yield ("openage::gamestate::tests::collision_benchmark",
+           "collision broadphase and unit separation throughput")
+    yield ("openage::renderer::camera::tests::frustum_benchmark",
+           "batched frustum culling of 10k and 50k world objects")
+    yield ("openage::renderer::resources::parser::tests::parser_benchmark",
+           "sprite and terrain file parser throughput")